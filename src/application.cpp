@@ -1,14 +1,29 @@
 #include "application.h"
-#include "display/x11/x11_display.h"
-#include "display/wayland/wayland_display.h"
-#include "display/sdl2_window_display.h"
+#include "keyframe_index.h"
 #include <iostream>
 #include <chrono>
 #include <thread>
+#include <random>
 #include <signal.h>
 #include <algorithm>
 
-Application::Application() : running_(false), should_exit_(false), 
+// Duplicate-frame elision: only hand a frame to an output when the decoder
+// produced a changed picture since that output last showed one, or when the
+// output was resized in the meantime
+static bool needs_present(DisplayOutput* output, uint64_t frame_serial, uint64_t presented_serial) {
+    bool geometry_changed = output->consume_geometry_change();
+    return frame_serial != presented_serial || geometry_changed;
+}
+
+// Only a frame that reached the screen counts as presented. A failed, paced-out
+// or throttled one resets the serial (serials start at 1) so the next tick
+// offers the frame again instead of treating a static stretch as already shown.
+static void record_present(DisplayOutput* output, bool rendered, uint64_t frame_serial, uint64_t& presented_serial) {
+    presented_serial = (rendered && output->was_frame_presented()) ? frame_serial : 0;
+}
+
+Application::Application() : auto_mute_monitor_attempted_(false), auto_mute_monitor_ready_(false),
+                           running_(false), should_exit_(false), 
                            target_fps_(30), frame_duration_(33) {}
 
 Application::~Application() {
@@ -24,22 +39,23 @@ bool Application::initialize(const Config& config) {
         return false;
     }
     
-    // Initialize PulseAudio for auto-mute functionality
-    if (!pulse_audio_.initialize()) {
-        std::cerr << "Warning: Failed to initialize PulseAudio. Auto-mute will be disabled." << std::endl;
-    }
-    
     // Setup based on mode
     if (config_.windowed_mode) {
         if (!setup_window_mode()) {
             std::cerr << "Failed to setup window mode" << std::endl;
             return false;
         }
+        if (config_.export_frames) {
+            std::cerr << "WARNING: --export only applies to desktop backgrounds, not preview windows" << std::endl;
+        }
     } else {
         if (!setup_screen_instances()) {
             std::cerr << "Failed to setup screen instances" << std::endl;
             return false;
         }
+        if (config_.export_frames && !setup_frame_export()) {
+            std::cerr << "WARNING: Frame export unavailable, continuing without it" << std::endl;
+        }
     }
     
     // Configure FPS limiting for the application
@@ -63,100 +79,283 @@ bool Application::initialize(const Config& config) {
 }
 
 bool Application::setup_window_mode() {
-    // Create window
-    window_output_ = display_manager_.create_window(
-        config_.window_config.x, config_.window_config.y,
-        config_.window_config.width, config_.window_config.height
-    );
-    
-    if (!window_output_ || !window_output_->initialize()) {
-        std::cerr << "Failed to create window" << std::endl;
-        return false;
+    for (size_t i = 0; i < config_.window_configs.size(); i++) {
+        const WindowConfig& window_config = config_.window_configs[i];
+        ScreenConfig settings = i < config_.screen_configs.size() ? config_.screen_configs[i] : ScreenConfig();
+        
+        // Create window
+        WindowInstance instance;
+        instance.config = window_config;
+        instance.display_output = display_manager_.create_window(
+            window_config.x, window_config.y,
+            window_config.width, window_config.height
+        );
+        
+        if (!instance.display_output || !instance.display_output->initialize()) {
+            std::cerr << "Failed to create window " << i << std::endl;
+            return false;
+        }
+        
+        // Windows showing the same file share one decoder
+        if (!acquire_window_player(window_config.media_path, settings, instance.player_index)) {
+            return false;
+        }
+        
+        // Set background with window-specific scaling
+        ScalingMode scaling = parse_scaling_mode(window_config.scaling);
+        instance.display_output->set_background(window_config.media_path, scaling);
+        
+        // Use SDL2 window display (universal cross-platform solution)
+        DisplayOutput* sdl2_display = instance.display_output.get();
+        
+        // If we're using an SDL2 window display, configure its frame rate control
+        if (sdl2_display) {
+            // For SDL2 window display, use both MediaPlayer's frame skipping and SDL2's rendering control
+            // 1. Configure SDL2's frame rate limiter for the rendering stage (paced per window)
+            sdl2_display->set_target_fps(settings.fps);
+            
+            std::cout << "DEBUG: Using combined frame rate control for window " << i << ": " 
+                      << (settings.fps <= 0 ? "Native video FPS with VSync" : std::to_string(settings.fps) + " FPS")
+                      << " (MediaPlayer skips frames, SDL2 renders displayed frames)"
+                      << std::endl;
+        }
+        
+        window_instances_.push_back(std::move(instance));
+    }
+    
+    // Upload planar YUV when the decoder output and every window sharing it allow it,
+    // skipping the CPU RGBA conversion entirely
+    for (size_t p = 0; p < window_players_.size(); p++) {
+        WindowPlayer& player = window_players_[p];
+        if (player.media_player->get_media_type() != MediaType::VIDEO || 
+            !player.media_player->supports_yuv_output()) {
+            continue;
+        }
+        
+        bool all_windows_support_yuv = true;
+        for (const auto& instance : window_instances_) {
+            if (instance.player_index != p) {
+                continue;
+            }
+            DisplayOutput* sdl2_display = instance.display_output.get();
+            if (!sdl2_display || !sdl2_display->supports_yuv_textures()) {
+                all_windows_support_yuv = false;
+                break;
+            }
+        }
+        
+        if (all_windows_support_yuv) {
+            player.media_player->set_yuv_output(true);
+            player.yuv_output = true;
+            std::cout << "DEBUG: Window mode using YUV streaming textures for " << player.config.media_path << std::endl;
+        }
+    }
+    
+    // Render initial frames
+    for (size_t p = 0; p < window_players_.size(); p++) {
+        render_window_player(p);
+    }
+    
+    return true;
+}
+
+bool Application::acquire_window_player(const std::string& media_path, const ScreenConfig& settings, size_t& player_index) {
+    for (size_t p = 0; p < window_players_.size(); p++) {
+        if (window_players_[p].media_player && window_players_[p].config.media_path == media_path) {
+            std::cout << "DEBUG: Sharing decoder for " << media_path << " with window player " << p << std::endl;
+            player_index = p;
+            return true;
+        }
     }
     
     // Create media player for window
-    window_media_player_ = std::make_unique<MediaPlayer>();
-    if (!window_media_player_->initialize()) {
+    WindowPlayer player;
+    player.config = settings;
+    player.config.media_path = media_path;
+    player.stats_start = std::chrono::steady_clock::now();
+    player.media_player = std::make_unique<MediaPlayer>();
+    if (!player.media_player->initialize()) {
         std::cerr << "Failed to initialize media player for window" << std::endl;
         return false;
     }
     
-    // Set up X11 integration if we're using X11
-    if (display_manager_.get_protocol() == DisplayProtocol::X11) {
-        // Cast to X11Display to get X11-specific methods
-        X11Display* x11_display = dynamic_cast<X11Display*>(window_output_.get());
-        if (x11_display && x11_display->is_windowed_mode()) {
-            if (!window_media_player_->set_x11_window(x11_display->get_x11_display(), 
-                                                     x11_display->get_x11_window(), 
-                                                     x11_display->get_x11_screen())) {
-                std::cerr << "Warning: Failed to set X11 window for media player" << std::endl;
-            }
-        }
+    if (!player.media_player->load_media(media_path)) {
+        std::cerr << "Failed to load media: " << media_path << std::endl;
+        return false;
     }
     
-    // If there's a media path in window config, load it
-    if (!config_.window_config.media_path.empty()) {
-        if (!window_media_player_->load_media(config_.window_config.media_path)) {
-            std::cerr << "Failed to load media: " << config_.window_config.media_path << std::endl;
-            return false;
+    // Start video playbook for continuous animation
+    if (!player.media_player->play()) {
+        std::cerr << "Warning: Failed to start video playback" << std::endl;
+    }
+    
+    // 2. Enable MediaPlayer's frame skipping logic to maintain proper video speed
+    player.media_player->set_fps_limit(settings.fps);
+    player.media_player->set_playback_speed(settings.speed);
+    player.media_player->set_ping_pong(settings.ping_pong);
+    apply_start_position(*player.media_player, player.config);
+    
+    window_players_.push_back(std::move(player));
+    player_index = window_players_.size() - 1;
+    return true;
+}
+
+void Application::release_window_player(size_t player_index) {
+    for (const auto& instance : window_instances_) {
+        if (instance.player_index == player_index) {
+            return; // Still shown in another window
         }
+    }
+    
+    WindowPlayer& player = window_players_[player_index];
+    if (player.media_player) {
+        player.media_player->stop();
+        player.media_player->cleanup();
+        player.media_player.reset();
+    }
+}
+
+void Application::render_window_player(size_t player_index) {
+    WindowPlayer& player = window_players_[player_index];
+    if (!player.media_player) {
+        return;
+    }
+    
+    MediaPlayer* media_player = player.media_player.get();
+    media_player->update();
+    
+    if (media_player->get_media_type() == MediaType::VIDEO) {
+        // Process and decode frames - once per file, however many windows show it
+        unsigned char* frame_data = nullptr;
+        int frame_width = 0, frame_height = 0;
+        VideoFrame yuv_frame;
+        bool frame_available = false;
         
-        // Start video playbook for continuous animation
-        if (!window_media_player_->play()) {
-            std::cerr << "Warning: Failed to start video playback" << std::endl;
+        // Fixed for the whole tick: a fallback below only changes how the next frame is decoded
+        bool yuv_tick = player.yuv_output;
+        
+        // Always decode frames to keep video running at proper speed
+        if (yuv_tick) {
+            if (media_player->get_video_frame_yuv(&yuv_frame)) {
+                frame_available = true;
+            } else if (!media_player->supports_yuv_output()) {
+                // Decoder output is no longer I420/NV12 - use the RGBA path from now on
+                // (a plain miss, e.g. EAGAIN or the loop boundary, keeps YUV)
+                media_player->set_yuv_output(false);
+                player.yuv_output = false;
+            }
+        } else if (media_player->get_video_frame_cpu(&frame_data, &frame_width, &frame_height)) {
+            frame_available = true;
+        } else if (media_player->get_video_frame_ffmpeg(&frame_data, &frame_width, &frame_height)) {
+            frame_available = true;
         }
         
-        // Get the FPS setting from config
-        int fps_setting = !config_.screen_configs.empty() ? config_.screen_configs[0].fps : config_.default_fps;
+        if (frame_available) {
+            player.processed_frames++;
+        }
         
-        // Set background with window-specific scaling
-        ScalingMode scaling = parse_scaling_mode(config_.window_config.scaling);
-        window_output_->set_background(config_.window_config.media_path, scaling);
+        // Log frame processing rate every 5 seconds to verify proper speed
+        auto now_time = std::chrono::steady_clock::now();
+        auto frame_count_elapsed = std::chrono::duration_cast<std::chrono::seconds>(now_time - player.stats_start);
+        if (frame_count_elapsed.count() >= 5) {
+            double fps = static_cast<double>(player.processed_frames) / frame_count_elapsed.count();
+            std::cout << "WINDOW MODE: Processed " << player.processed_frames 
+                      << " frames in " << frame_count_elapsed.count() 
+                      << "s (" << fps << " fps) for " << player.config.media_path << std::endl;
+            player.processed_frames = 0;
+            player.stats_start = now_time;
+        }
         
-        // Use SDL2 window display (universal cross-platform solution)
-        SDL2WindowDisplay* sdl2_display = dynamic_cast<SDL2WindowDisplay*>(window_output_.get());
+        // Use MediaPlayer's frame skipping logic to determine if this frame should be displayed
+        // This ensures consistency between background mode and windowed mode
+        if (!frame_available || !media_player->should_display_frame()) {
+            return;
+        }
         
-        // If we're using an SDL2 window display, configure its frame rate control
-        if (sdl2_display) {
-            // For SDL2 window display, use both MediaPlayer's frame skipping and SDL2's rendering control
-            // 1. Configure SDL2's frame rate limiter for the rendering stage
-            sdl2_display->set_target_fps(fps_setting);
-            
-            // 2. Enable MediaPlayer's frame skipping logic to maintain proper video speed
-            window_media_player_->set_fps_limit(fps_setting);
+        for (auto& instance : window_instances_) {
+            if (instance.player_index != player_index) {
+                continue;
+            }
+            DisplayOutput* sdl2_display = instance.display_output.get();
+            if (!sdl2_display || !needs_present(sdl2_display, media_player->get_frame_serial(), instance.presented_serial)) {
+                continue;
+            }
             
-            std::cout << "DEBUG: Using combined frame rate control for window mode: " 
-                      << (fps_setting <= 0 ? "Native video FPS with VSync" : std::to_string(fps_setting) + " FPS")
-                      << " (MediaPlayer skips frames, SDL2 renders displayed frames)"
-                      << std::endl;
-        } else {
-            // Non-SDL2 renderer - use MediaPlayer's frame rate limiting
-            window_media_player_->set_fps_limit(fps_setting);
-        }
-        if (sdl2_display) {
+            // ============================================================================
+            // CRITICAL SCALING MODE PARSING FIX - PREVENTS FLICKERING - DO NOT MODIFY
+            // 
+            // This fix resolves the SDL2 window mode scaling flickering issue.
+            // BUG: Previously used config_.screen_configs[0].scaling (for background mode)
+            // FIX: Now correctly uses the window config scaling (for window mode)
+            // 
+            // This ensures command line --scaling argument is parsed correctly in window mode.
+            // Without this fix, scaling mode flickered between FILL(2) and DEFAULT(3).
+            // ============================================================================
+            ScalingMode scaling = parse_scaling_mode(instance.config.scaling);
             
-            // For video content, start video playback for continuous animation
-            if (window_media_player_->get_media_type() == MediaType::VIDEO) {
-                // Render initial video frame
-                unsigned char* frame_data;
-                int frame_width, frame_height;
-                if (window_media_player_->get_video_frame(&frame_data, &frame_width, &frame_height)) {
-                    sdl2_display->render_video_frame(frame_data, frame_width, frame_height, scaling);
-                }
-            } else if (window_media_player_->get_media_type() == MediaType::IMAGE) {
-                // For images, render immediately
-                const unsigned char* image_data = window_media_player_->get_image_data();
-                if (image_data) {
-                    sdl2_display->render_image_data(image_data, 
-                                                   window_media_player_->get_width(),
-                                                   window_media_player_->get_height(),
-                                                   scaling);
+            // Render the frame using SDL2's renderer (each window paces itself)
+            bool rendered;
+            if (yuv_tick) {
+                rendered = sdl2_display->render_frame(yuv_frame, scaling);
+                if (!rendered) {
+                    // Renderer rejected the YUV texture - fall back to RGBA uploads
+                    // (takes effect from the next decoded frame for all windows sharing it)
+                    std::cerr << "WARNING: YUV texture upload failed, falling back to RGBA path" << std::endl;
+                    media_player->set_yuv_output(false);
+                    player.yuv_output = false;
                 }
+            } else {
+                rendered = sdl2_display->render_frame(VideoFrame::rgba(frame_data, frame_width, frame_height), scaling);
+            }
+            record_present(sdl2_display, rendered, media_player->get_frame_serial(), instance.presented_serial);
+        }
+    } else if (media_player->get_media_type() == MediaType::IMAGE) {
+        // For images, render immediately
+        const unsigned char* image_data = media_player->get_image_data();
+        if (!image_data) {
+            return;
+        }
+        for (auto& instance : window_instances_) {
+            DisplayOutput* sdl2_display = instance.display_output.get();
+            if (instance.player_index == player_index && sdl2_display) {
+                sdl2_display->render_image_data(image_data, 
+                                               media_player->get_width(),
+                                               media_player->get_height(),
+                                               parse_scaling_mode(instance.config.scaling));
             }
         }
     }
+}
+
+void Application::update_window_instances() {
+    // One event pump for all windows, then drop the ones the user closed
+    display_manager_.pump_window_events();
     
-    return true;
+    for (size_t i = 0; i < window_instances_.size();) {
+        DisplayOutput* sdl2_display = window_instances_[i].display_output.get();
+        if (sdl2_display && sdl2_display->should_close()) {
+            size_t player_index = window_instances_[i].player_index;
+            window_instances_[i].display_output->cleanup();
+            window_instances_.erase(window_instances_.begin() + i);
+            release_window_player(player_index);
+            std::cout << "Closed preview window, " << window_instances_.size() << " remaining" << std::endl;
+            continue;
+        }
+        i++;
+    }
+    
+    if (window_instances_.empty()) {
+        should_exit_ = true;
+        return;
+    }
+    
+    for (size_t p = 0; p < window_players_.size(); p++) {
+        render_window_player(p);
+    }
+    
+    for (auto& instance : window_instances_) {
+        instance.display_output->update();
+    }
 }
 
 bool Application::setup_screen_instances() {
@@ -178,18 +377,63 @@ bool Application::setup_screen_instances() {
     return true;
 }
 
-bool Application::initialize_screen_instance(ScreenInstance& instance) {
+bool Application::setup_frame_export() {
+    export_server_ = std::make_unique<FrameExportServer>();
+    for (const auto& instance : screen_instances_) {
+        if (instance.export_ring) {
+            export_server_->add_ring(instance.config.screen_name, instance.export_ring.get());
+        }
+    }
     
-    // Get display output
-    instance.display_output = display_manager_.get_output_by_name(instance.config.screen_name);
-    if (!instance.display_output) {
-        std::cerr << "Failed to get display output: " << instance.config.screen_name << std::endl;
+    std::string socket_path = config_.export_socket.empty() ? FrameExportServer::get_default_socket_path()
+                                                            : config_.export_socket;
+    if (!export_server_->start(socket_path)) {
+        export_server_.reset();
         return false;
     }
+    return true;
+}
+
+bool Application::initialize_screen_instance(ScreenInstance& instance) {
     
-    if (!instance.display_output->initialize()) {
-        std::cerr << "Failed to initialize display output: " << instance.config.screen_name << std::endl;
-        return false;
+    // --isolate group workers: one decodes into a shared frame ring, the others present from it
+    bool ring_writer = false;
+    if (instance.config.frame_ring_fd >= 0) {
+        instance.frame_ring = std::make_unique<FrameRing>();
+        if (!instance.frame_ring->attach(instance.config.frame_ring_fd)) {
+            std::cerr << "Failed to attach frame ring for: " << instance.config.screen_name << std::endl;
+            return false;
+        }
+        ring_writer = instance.config.frame_ring_reader < 0;
+    }
+    
+    if (!instance.config.span_outputs.empty()) {
+        if (!setup_span_outputs(instance)) {
+            std::cerr << "Failed to set up spanned outputs" << std::endl;
+            return false;
+        }
+    } else if (!ring_writer) {
+        // Get display output
+        instance.display_output = display_manager_.get_output_by_name(instance.config.screen_name);
+        if (!instance.display_output) {
+            std::cerr << "Failed to get display output: " << instance.config.screen_name << std::endl;
+            return false;
+        }
+        
+        if (!instance.display_output->initialize()) {
+            std::cerr << "Failed to initialize display output: " << instance.config.screen_name << std::endl;
+            return false;
+        }
+    }
+    
+    if (instance.frame_ring && !ring_writer) {
+        // Frames arrive decoded; only the output side needs setting up
+        configure_screen_outputs(instance, true);
+        instance.frame_ring_counter = instance.frame_ring->get_counter();
+        instance.initialized = true;
+        std::cout << "Initialized screen: " << instance.config.screen_name << " (frames from "
+                  << instance.frame_ring->get_name() << ")" << std::endl;
+        return true;
     }
     
     // Create media player
@@ -199,23 +443,16 @@ bool Application::initialize_screen_instance(ScreenInstance& instance) {
         return false;
     }
     
-    // For video content, we need to establish OpenGL context before loading media
-    // This ensures MPV can initialize its render context properly
-    WaylandDisplay* wayland_display = dynamic_cast<WaylandDisplay*>(instance.display_output.get());
-    if (wayland_display && !instance.config.media_path.empty()) {
-        // Detect media type first
-        MediaType media_type = instance.media_player->detect_media_type(instance.config.media_path);
-        if (media_type == MediaType::VIDEO || media_type == MediaType::GIF) {
-            // Note: We'll make EGL context current during the rendering phase when the surface is ready
-        }
-    }
-    
     // Load media if specified
     if (!instance.config.media_path.empty()) {
         if (!instance.media_player->load_media(instance.config.media_path)) {
             std::cerr << "Failed to load media: " << instance.config.media_path << std::endl;
             return false;
         }
+        // Before the outputs are configured: ping-pong rules out YUV passthrough
+        instance.media_player->set_ping_pong(instance.config.ping_pong);
+        apply_start_position(*instance.media_player, instance.config);
+        instance.resume_saved = std::chrono::steady_clock::now();
         
         // Apply audio settings
         if (instance.config.silent) {
@@ -224,14 +461,8 @@ bool Application::initialize_screen_instance(ScreenInstance& instance) {
             instance.media_player->set_volume(instance.config.volume);
         }
         
-        // Auto-mute setting
-        if (!instance.config.no_auto_mute) {
-            pulse_audio_.set_auto_mute_enabled(true);
-        }
-        
-        // Set background
         ScalingMode scaling = parse_scaling_mode(instance.config.scaling);
-        instance.display_output->set_background(instance.config.media_path, scaling);
+        configure_screen_outputs(instance, instance.media_player->get_media_type() == MediaType::VIDEO);
         
         // Start playback first so MediaPlayer can detect native frame rate
         instance.media_player->play();
@@ -239,35 +470,65 @@ bool Application::initialize_screen_instance(ScreenInstance& instance) {
         // FIXED: Set FPS limit AFTER starting playback so native frame rate is detected
         // This allows -1 (native frame rate) to work correctly
         instance.media_player->set_fps_limit(instance.config.fps);
+        instance.media_player->set_playback_speed(instance.config.speed);
+        if (instance.frame_ring) {
+            instance.frame_ring->set_frame_rate(instance.config.fps > 0 ? instance.config.fps
+                                                : instance.media_player->get_frame_rate());
+        }
+        if (instance.stats_overlay) {
+            instance.stats_overlay->set_target_fps(instance.config.fps > 0 ? instance.config.fps
+                                                   : instance.media_player->get_frame_rate());
+        }
+        if (config_.export_frames) {
+            instance.export_ring = std::make_unique<FrameRing>();
+            // Handed to other users' processes: sealed before anyone sees the descriptor
+            if (instance.export_ring->create("export-" + instance.config.screen_name, 0, EXPORT_RING_SPARE_SLOTS) &&
+                instance.export_ring->seal()) {
+                instance.export_ring->set_frame_rate(instance.config.fps > 0 ? instance.config.fps
+                                                     : instance.media_player->get_frame_rate());
+            } else {
+                std::cerr << "WARNING: Frames of " << instance.config.screen_name << " will not be exported" << std::endl;
+                instance.export_ring.reset();
+            }
+        }
         
         // Render image if it's a static image
-        if (instance.media_player->get_media_type() == MediaType::IMAGE) {
-            WaylandDisplay* wayland_display = dynamic_cast<WaylandDisplay*>(instance.display_output.get());
-            X11Display* x11_display = dynamic_cast<X11Display*>(instance.display_output.get());
-            
-            if (wayland_display) {
-                const unsigned char* image_data = instance.media_player->get_image_data();
-                if (image_data) {
-                    wayland_display->render_image_data(image_data, 
-                                                      instance.media_player->get_width(),
-                                                      instance.media_player->get_height(),
-                                                      scaling);
-                } else {
-                }
-            } else if (x11_display) {
-                const unsigned char* image_data = instance.media_player->get_image_data();
-                if (image_data) {
-                    x11_display->render_image_data(image_data, 
-                                                  instance.media_player->get_width(),
-                                                  instance.media_player->get_height(),
-                                                  scaling);
-                } else {
-                }
-            } else {
+        if (instance.media_player->get_media_type() == MediaType::IMAGE && instance.span_compositor) {
+            const unsigned char* image_data = instance.media_player->get_image_data();
+            if (image_data) {
+                render_span_frame(instance, image_data,
+                                  instance.media_player->get_width(),
+                                  instance.media_player->get_height());
+            }
+        } else if (instance.media_player->get_media_type() == MediaType::IMAGE && instance.display_output) {
+            const unsigned char* image_data = instance.media_player->get_image_data();
+            if (image_data) {
+                instance.display_output->render_image_data(image_data, 
+                                                           instance.media_player->get_width(),
+                                                           instance.media_player->get_height(),
+                                                           scaling);
             }
         } else if (instance.media_player->get_media_type() == MediaType::VIDEO) {
             // For videos, we need to render frames continuously in the update loop
             // Initial frame rendering will be handled in the update loop
+            
+            // GL-backed outputs take decoder planes directly, no CPU RGBA conversion
+            // (exported screens keep converting: export clients read RGBA)
+            if (instance.display_output && !instance.dirty_tiles && !instance.export_ring &&
+                instance.display_output->enable_gl_video() &&
+                instance.display_output->supports_yuv_textures() &&
+                instance.media_player->supports_yuv_output()) {
+                instance.media_player->set_yuv_output(true);
+                instance.yuv_output = true;
+                std::cout << "DEBUG: " << instance.config.screen_name << " streaming YUV frames to GL" << std::endl;
+            }
+        }
+        
+        // A still picture is exported once
+        if (instance.export_ring && instance.media_player->get_media_type() == MediaType::IMAGE &&
+            instance.media_player->get_image_data()) {
+            instance.export_ring->publish(instance.media_player->get_image_data(), instance.media_player->get_width(),
+                                          instance.media_player->get_height(), 1);
         }
     }
     
@@ -276,6 +537,170 @@ bool Application::initialize_screen_instance(ScreenInstance& instance) {
     return true;
 }
 
+// Per-output settings that have to be in place before the first frame is shown
+void Application::configure_screen_outputs(ScreenInstance& instance, bool is_video) {
+    // Cinemagraph mode has to be chosen before the first frame picks a render path
+    if (instance.config.dirty_tiles && is_video) {
+        instance.dirty_tiles = true;
+        if (instance.display_output) {
+            instance.dirty_tiles = instance.display_output->set_dirty_tracking(true);
+        }
+        for (auto& output : instance.span_outputs) {
+            instance.dirty_tiles = output->set_dirty_tracking(true) && instance.dirty_tiles;
+        }
+        if (!instance.dirty_tiles) {
+            std::cerr << "WARNING: --dirty-tiles is not supported by this output, redrawing full frames" << std::endl;
+        }
+    }
+    
+    // Color effects are applied by each output while it scales the frame
+    if (!instance.config.effects.is_identity()) {
+        bool supported = !instance.display_output || instance.display_output->set_post_effects(instance.config.effects);
+        for (auto& output : instance.span_outputs) {
+            supported = output->set_post_effects(instance.config.effects) && supported;
+        }
+        if (!supported) {
+            std::cerr << "WARNING: Color effects are not supported by this output" << std::endl;
+        }
+    }
+    
+    // XRender scaling replaces the CPU scaler; it cannot apply effects or dirty tiles
+    if (instance.config.xrender && is_video) {
+        bool supported = !instance.display_output || instance.display_output->set_server_scaling(true);
+        for (auto& output : instance.span_outputs) {
+            supported = output->set_server_scaling(true) && supported;
+        }
+        if (!supported) {
+            std::cerr << "WARNING: --xrender is not supported by this output, scaling on the CPU" << std::endl;
+        }
+    }
+
+    // Blurred bars are the default; spanned outputs are always stretched
+    if (instance.display_output) {
+        instance.display_output->set_letterbox(instance.config.letterbox);
+    }
+    
+    // Performance HUD: the application feeds decode/queue numbers, the output its own timings
+    if (instance.config.stats_overlay) {
+        instance.stats_overlay = std::make_unique<StatsOverlay>(instance.config.screen_name);
+        DisplayOutput* hud_output = instance.display_output ? instance.display_output.get()
+                                  : (instance.span_outputs.empty() ? nullptr : instance.span_outputs[0].get());
+        if (!hud_output || !hud_output->set_stats_overlay(instance.stats_overlay.get())) {
+            std::cerr << "WARNING: --stats-overlay is not supported by this output" << std::endl;
+            instance.stats_overlay.reset();
+        }
+    }
+    
+    // Set background
+    ScalingMode scaling = parse_scaling_mode(instance.config.scaling);
+    if (instance.display_output) {
+        instance.display_output->set_background(instance.config.media_path, scaling);
+    }
+    for (auto& output : instance.span_outputs) {
+        output->set_background(instance.config.media_path, ScalingMode::STRETCH);
+    }
+}
+
+bool Application::setup_span_outputs(ScreenInstance& instance) {
+    std::vector<SpanRegion> regions;
+    
+    if (display_manager_.get_protocol() == DisplayProtocol::X11) {
+        // X11 backgrounds live on the root window, which already covers every
+        // monitor - use one root-sized output and place each crop at its RandR position
+        auto root_output = display_manager_.get_output_by_name("all");
+        if (!root_output || !root_output->initialize()) {
+            std::cerr << "Failed to open X11 root window for spanning" << std::endl;
+            return false;
+        }
+        
+        for (const auto& name : instance.config.span_outputs) {
+            SpanRegion region;
+            region.name = name;
+            if (!root_output->get_monitor_geometry(name, region.x, region.y, region.width, region.height)) {
+                std::cerr << "Monitor " << name << " not found" << std::endl;
+                return false;
+            }
+            regions.push_back(region);
+        }
+        instance.span_outputs.push_back(std::move(root_output));
+    } else {
+        // Wayland: one layer surface per output, each fed its own crop
+        for (const auto& name : instance.config.span_outputs) {
+            auto output = display_manager_.get_output_by_name(name);
+            if (!output || !output->initialize()) {
+                std::cerr << "Failed to get display output: " << name << std::endl;
+                return false;
+            }
+            
+            SpanRegion region;
+            region.name = name;
+            if (!output->get_geometry(region.x, region.y, region.width, region.height)) {
+                std::cerr << "Output " << name << " does not report its position" << std::endl;
+                return false;
+            }
+            regions.push_back(region);
+            instance.span_outputs.push_back(std::move(output));
+        }
+    }
+    
+    instance.span_compositor = std::make_unique<SpanCompositor>();
+    return instance.span_compositor->initialize(regions, parse_scaling_mode(instance.config.scaling));
+}
+
+bool Application::render_span_frame(ScreenInstance& instance, const unsigned char* frame_data,
+                                    int frame_width, int frame_height) {
+    SpanCompositor* compositor = instance.span_compositor.get();
+    if (!compositor || !frame_data) {
+        return false;
+    }
+    
+    if (instance.span_outputs.size() == compositor->get_region_count()) {
+        // One surface per output: each already has the output's size, so no further scaling
+        bool presented = true;
+        for (size_t i = 0; i < instance.span_outputs.size(); i++) {
+            const SpanRegion& region = compositor->get_region(i);
+            const unsigned char* region_data = compositor->compose_region(i, frame_data, frame_width, frame_height);
+            DisplayOutput* span_output = instance.span_outputs[i].get();
+            if (!region_data ||
+                !span_output->render_frame(VideoFrame::rgba(region_data, region.width, region.height),
+                                           ScalingMode::STRETCH) ||
+                !span_output->was_frame_presented()) {
+                presented = false;
+            }
+        }
+        return presented;
+    } else if (instance.span_outputs.size() == 1) {
+        // Single root-window output: write every crop straight into a root-sized canvas
+        DisplayOutput* root_output = instance.span_outputs[0].get();
+        int root_x, root_y, root_width, root_height;
+        if (!root_output->get_geometry(root_x, root_y, root_width, root_height)) {
+            return false;
+        }
+        
+        size_t canvas_size = (size_t)root_width * root_height * 4;
+        if (instance.span_canvas.size() != canvas_size) {
+            instance.span_canvas.assign(canvas_size, 0);
+        }
+        
+        for (size_t i = 0; i < compositor->get_region_count(); i++) {
+            const SpanRegion& region = compositor->get_region(i);
+            int offset_x = region.x - root_x;
+            int offset_y = region.y - root_y;
+            if (offset_x < 0 || offset_y < 0 ||
+                offset_x + region.width > root_width || offset_y + region.height > root_height) {
+                continue;
+            }
+            unsigned char* dst = instance.span_canvas.data() + ((size_t)offset_y * root_width + offset_x) * 4;
+            compositor->compose_region_into(i, frame_data, frame_width, frame_height, dst, root_width * 4);
+        }
+        
+        return root_output->render_frame(VideoFrame::rgba(instance.span_canvas.data(), root_width, root_height),
+                                         ScalingMode::STRETCH) &&
+               root_output->was_frame_presented();
+    }
+    return false;
+}
+
 ScalingMode Application::parse_scaling_mode(const std::string& scaling) {
     if (scaling == "stretch") return ScalingMode::STRETCH;
     if (scaling == "fit") return ScalingMode::FIT;
@@ -288,12 +713,163 @@ void Application::run() {
     
     std::cout << "Starting application main loop..." << std::endl;
     
-    // Main update loop
-    update_loop();
+    // Main update loop, or one task chain per screen on the scheduler workers
+    if (!config_.windowed_mode && config_.scheduler_workers >= 0) {
+        scheduled_loop();
+    } else {
+        update_loop();
+    }
     
     std::cout << "Application main loop ended" << std::endl;
 }
 
+void Application::decode_screen_frame(ScreenInstance& instance) {
+    DecodedFrame& decoded = instance.decoded;
+    decoded = DecodedFrame();
+    if (!instance.media_player) {
+        return;
+    }
+    
+    instance.media_player->update();
+    if (instance.media_player->get_media_type() != MediaType::VIDEO) {
+        return;
+    }
+    
+    // Render video frames continuously for background mode
+    StatsOverlay* stats = instance.stats_overlay.get();
+    auto decode_start = std::chrono::steady_clock::now();
+    
+    // FIXED: Apply FPS control at application level instead of decode level
+    // Only render frame if enough time has passed according to target FPS
+    if (!instance.media_player->should_display_frame()) {
+        // Still need to advance video timing even if not displaying
+        // This ensures video runs at native speed regardless of display FPS
+        unsigned char* dummy_frame_data;
+        int dummy_width, dummy_height;
+        bool got_frame = instance.media_player->get_video_frame_cpu(&dummy_frame_data, &dummy_width, &dummy_height);
+        if (stats && got_frame) {
+            stats->record_decode(StatsOverlay::elapsed_ms(decode_start));
+            stats->record_drop();
+        }
+        decoded.target = DecodedFrame::Target::SKIPPED;
+        return;
+    }
+    
+    DisplayOutput* output = instance.display_output.get();
+    unsigned char* frame_data = nullptr;
+    int frame_width = 0, frame_height = 0;
+    if (instance.frame_ring) {
+        // Decoder worker: publish each changed picture for the presenter workers
+        decoded.target = DecodedFrame::Target::RING;
+        decoded.got_frame = instance.media_player->get_video_frame_cpu(&frame_data, &frame_width, &frame_height);
+    } else if (instance.span_compositor) {
+        // Spanned: decode once, crop per output
+        decoded.target = DecodedFrame::Target::SPAN;
+        decoded.got_frame = instance.media_player->get_video_frame_cpu(&frame_data, &frame_width, &frame_height);
+    } else if (output && instance.yuv_output) {
+        decoded.target = DecodedFrame::Target::OUTPUT;
+        decoded.got_frame = instance.media_player->get_video_frame_yuv(&decoded.frame);
+    } else if (output && display_manager_.get_protocol() == DisplayProtocol::WAYLAND) {
+        // PREFER CPU-based rendering for KDE Wayland stability
+        decoded.target = DecodedFrame::Target::OUTPUT;
+        decoded.got_frame = instance.media_player->get_video_frame_cpu(&frame_data, &frame_width, &frame_height);
+        if (!decoded.got_frame) {
+            // Final fallback to FFmpeg if CPU extraction fails
+            decoded.got_frame = instance.media_player->get_video_frame_ffmpeg(&frame_data, &frame_width, &frame_height);
+        }
+    } else if (output) {
+        // X11: uses the GL texture path when EGL is up, CPU scaling otherwise
+        decoded.target = DecodedFrame::Target::OUTPUT;
+        decoded.got_frame = instance.media_player->get_video_frame(&frame_data, &frame_width, &frame_height);
+    } else {
+        return;
+    }
+    
+    if (stats && decoded.target != DecodedFrame::Target::RING) {
+        stats->record_decode(StatsOverlay::elapsed_ms(decode_start));
+    }
+    if (decoded.got_frame && frame_data) {
+        decoded.frame = VideoFrame::rgba(frame_data, frame_width, frame_height);
+    }
+    decoded.serial = instance.media_player->get_frame_serial();
+}
+
+void Application::present_screen_frame(ScreenInstance& instance) {
+    const DecodedFrame& decoded = instance.decoded;
+    if (instance.media_player) {
+        if (instance.media_player->get_media_type() == MediaType::VIDEO) {
+            if (decoded.target == DecodedFrame::Target::RING) {
+                if (decoded.got_frame && decoded.serial != instance.presented_serial &&
+                    instance.frame_ring->publish(decoded.frame.planes[0], decoded.frame.width,
+                                                 decoded.frame.height, decoded.serial)) {
+                    instance.presented_serial = decoded.serial;
+                }
+            } else if (decoded.target == DecodedFrame::Target::SPAN && decoded.got_frame) {
+                bool geometry_changed = false;
+                for (auto& span_output : instance.span_outputs) {
+                    geometry_changed = span_output->consume_geometry_change() || geometry_changed;
+                }
+                if (decoded.serial != instance.presented_serial || geometry_changed) {
+                    bool presented = render_span_frame(instance, decoded.frame.planes[0],
+                                                       decoded.frame.width, decoded.frame.height);
+                    instance.presented_serial = presented ? decoded.serial : 0;
+                }
+            } else if (decoded.target == DecodedFrame::Target::OUTPUT) {
+                DisplayOutput* output = instance.display_output.get();
+                ScalingMode scaling = parse_scaling_mode(instance.config.scaling);
+                if (instance.yuv_output) {
+                    // A plain miss (EAGAIN, EOF at the loop boundary) keeps YUV; only a
+                    // decoder that stopped producing I420/NV12 or a failed upload leaves it
+                    bool failed = !decoded.got_frame && !instance.media_player->supports_yuv_output();
+                    if (decoded.got_frame && needs_present(output, decoded.serial, instance.presented_serial)) {
+                        failed = !output->render_frame(decoded.frame, scaling);
+                        record_present(output, !failed, decoded.serial, instance.presented_serial);
+                    }
+                    if (failed) {
+                        // Decoder output or GL upload no longer usable - back to RGBA
+                        std::cerr << "WARNING: YUV frame path failed, falling back to RGBA" << std::endl;
+                        instance.media_player->set_yuv_output(false);
+                        instance.yuv_output = false;
+                    }
+                } else if (decoded.got_frame && needs_present(output, decoded.serial, instance.presented_serial)) {
+                    record_present(output, output->render_frame(decoded.frame, scaling),
+                                   decoded.serial, instance.presented_serial);
+                }
+            }
+            
+            if (instance.export_ring && decoded.got_frame && !decoded.frame.is_yuv() &&
+                decoded.serial != instance.exported_serial &&
+                instance.export_ring->publish(decoded.frame.planes[0], decoded.frame.width,
+                                              decoded.frame.height, decoded.serial)) {
+                instance.exported_serial = decoded.serial;
+            }
+            
+            StatsOverlay* stats = instance.stats_overlay.get();
+            if (stats) {
+                PacketQueueStats queue = instance.media_player->get_demux_queue_stats();
+                stats->set_queue(queue.packets, queue.seconds);
+                stats->set_decoder_drops(instance.media_player->get_frames_dropped());
+            }
+            
+            // Also kept current while running: logout may not leave time for shutdown()
+            auto now = std::chrono::steady_clock::now();
+            if (instance.config.start_position == "resume" &&
+                now - instance.resume_saved >= std::chrono::seconds(RESUME_SAVE_INTERVAL_S)) {
+                save_resume_position(*instance.media_player, instance.config);
+                instance.resume_saved = now;
+            }
+        }
+    } else if (instance.frame_ring && instance.display_output) {
+        present_ring_frame(instance);
+    }
+    if (instance.display_output) {
+        instance.display_output->update();
+    }
+    for (auto& output : instance.span_outputs) {
+        output->update();
+    }
+}
+
 void Application::update_loop() {
     auto last_auto_mute_check = std::chrono::steady_clock::now();
     const auto auto_mute_check_interval = std::chrono::milliseconds(1000); // Check every second
@@ -307,153 +883,15 @@ void Application::update_loop() {
         
         // Update media players
         if (config_.windowed_mode) {
-            if (window_media_player_) {
-                window_media_player_->update();
-                
-                // ============================================================================
-                // CRITICAL SCALING MODE PARSING FIX - PREVENTS FLICKERING - DO NOT MODIFY
-                // 
-                // This fix resolves the SDL2 window mode scaling flickering issue.
-                // BUG: Previously used config_.screen_configs[0].scaling (for background mode)
-                // FIX: Now correctly uses config_.window_config.scaling (for window mode)
-                // 
-                // This ensures command line --scaling argument is parsed correctly in window mode.
-                // Without this fix, scaling mode flickered between FILL(2) and DEFAULT(3).
-                // ============================================================================
-                // Render video frames continuously for windowed mode
-                // FIX: Use window_config.scaling instead of screen_configs[0].scaling for window mode
-                ScalingMode scaling = parse_scaling_mode(config_.window_config.scaling);
-                
-                // ============================================================================
-                // APPLICATION UPDATE LOOP DEBUG FOR SDL2 FLICKERING INVESTIGATION
-                // ============================================================================
-                static int app_update_call_count = 0;
-                app_update_call_count++;
-                
-                
-                // Use SDL2 window display (universal solution)
-                SDL2WindowDisplay* sdl2_display = dynamic_cast<SDL2WindowDisplay*>(window_output_.get());
-                
-                if (window_media_player_->get_media_type() == MediaType::VIDEO) {
-                    if (sdl2_display) {
-                        // Check if window should close
-                        if (sdl2_display->should_close()) {
-                            should_exit_ = true;
-                            break;
-                        }
-                        
-                        // Process and decode frames
-                        unsigned char* frame_data;
-                        int frame_width, frame_height;
-                        bool frame_available = false;
-                        
-                        // With SDL2's frame rate control, we always display all decoded frames
-                        // IMPORTANT: We rely on the target_fps_ setting in SDL2WindowDisplay
-                        // to limit the frame rate and properly skip frames
-                        
-                        // Track frame processing metrics
-                        static int processed_frame_count = 0;
-                        static auto last_frame_count_time = std::chrono::steady_clock::now();
-                        auto now_time = std::chrono::steady_clock::now();
-                        
-                        // Always decode frames to keep video running at proper speed
-                        if (window_media_player_->get_video_frame_cpu(&frame_data, &frame_width, &frame_height)) {
-                            frame_available = true;
-                            processed_frame_count++;
-                        } else if (window_media_player_->get_video_frame_ffmpeg(&frame_data, &frame_width, &frame_height)) {
-                            frame_available = true;
-                            processed_frame_count++;
-                        }
-                        
-                        // Log frame processing rate every 5 seconds to verify proper speed
-                        auto frame_count_elapsed = std::chrono::duration_cast<std::chrono::seconds>(now_time - last_frame_count_time);
-                        if (frame_count_elapsed.count() >= 5) {
-                            double fps = static_cast<double>(processed_frame_count) / frame_count_elapsed.count();
-                            std::cout << "WINDOW MODE: Processed " << processed_frame_count 
-                                      << " frames in " << frame_count_elapsed.count() 
-                                      << "s (" << fps << " fps)" << std::endl;
-                            processed_frame_count = 0;
-                            last_frame_count_time = now_time;
-                        }
-                        
-                        // Use MediaPlayer's frame skipping logic to determine if this frame should be displayed
-                        // This ensures consistency between background mode and windowed mode
-                        if (frame_available && window_media_player_->should_display_frame()) {
-                            // Render the frame using SDL2's renderer
-                            sdl2_display->render_video_frame(frame_data, frame_width, frame_height, scaling);
-                            
-                            // Add debug logging every 100 frames
-                            static int debug_frame_count = 0;
-                            if (++debug_frame_count % 100 == 0) {
-                                std::cout << "WINDOW MODE: Rendered frame " << debug_frame_count << std::endl;
-                            }
-                        }
-                        // NOTE: We always process frames to keep the video advancing at the native rate
-                    }
-                } else if (window_media_player_->get_media_type() == MediaType::IMAGE) {
-                    // For images, render immediately
-                    const unsigned char* image_data = window_media_player_->get_image_data();
-                    if (image_data && sdl2_display) {
-                        sdl2_display->render_image_data(image_data, 
-                                                       window_media_player_->get_width(),
-                                                       window_media_player_->get_height(),
-                                                       scaling);
-                    }
-                }
-            }
-            if (window_output_) {
-                window_output_->update();
+            update_window_instances();
+            if (should_exit_) {
+                break;
             }
         } else {
             for (auto& instance : screen_instances_) {
                 if (instance.initialized) {
-                    if (instance.media_player) {
-                        instance.media_player->update();
-                        
-                        // Render video frames continuously for background mode
-                        if (instance.media_player->get_media_type() == MediaType::VIDEO) {
-                            ScalingMode scaling = parse_scaling_mode(instance.config.scaling);
-                            
-                            // FIXED: Apply FPS control at application level instead of decode level
-                            // Only render frame if enough time has passed according to target FPS
-                            if (instance.media_player->should_display_frame()) {
-                                WaylandDisplay* wayland_display = dynamic_cast<WaylandDisplay*>(instance.display_output.get());
-                                X11Display* x11_display = dynamic_cast<X11Display*>(instance.display_output.get());
-                                
-                                if (wayland_display) {
-                                    // PREFER CPU-based rendering for KDE Wayland stability
-                                    unsigned char* frame_data;
-                                    int frame_width, frame_height;
-                                    if (instance.media_player->get_video_frame_cpu(&frame_data, &frame_width, &frame_height)) {
-                                        wayland_display->render_video_frame(frame_data, frame_width, frame_height, scaling);
-                                    } else {
-                                        // Final fallback to FFmpeg if CPU extraction fails
-                                        if (instance.media_player->get_video_frame_ffmpeg(&frame_data, &frame_width, &frame_height)) {
-                                            wayland_display->render_video_frame(frame_data, frame_width, frame_height, scaling);
-                                        }
-                                    }
-                                } else if (x11_display) {
-                                    // Make context current (no-op for X11 but for API consistency)
-                                    if (x11_display->make_egl_current()) {
-                                        unsigned char* frame_data;
-                                        int frame_width, frame_height;
-                                        if (instance.media_player->get_video_frame(&frame_data, &frame_width, &frame_height)) {
-                                            x11_display->render_video_frame(frame_data, frame_width, frame_height, scaling);
-                                        }
-                                    }
-                                }
-                            } else {
-                                // Still need to advance video timing even if not displaying
-                                // This ensures video runs at native speed regardless of display FPS
-                                unsigned char* dummy_frame_data;
-                                int dummy_width, dummy_height;
-                                instance.media_player->get_video_frame_cpu(&dummy_frame_data, &dummy_width, &dummy_height);
-                            }
-                        }
-                    }
-                    if (instance.display_output) {
-                        instance.display_output->update();
-                    }
+                    decode_screen_frame(instance);
+                    present_screen_frame(instance);
                 }
             }
         }
@@ -468,15 +906,237 @@ void Application::update_loop() {
         auto elapsed_since_last_frame = now - last_frame_time;
         if (elapsed_since_last_frame < frame_duration_) {
             auto sleep_time = frame_duration_ - elapsed_since_last_frame;
-            std::this_thread::sleep_for(sleep_time);
+            if (screen_instances_.size() == 1 && screen_instances_[0].frame_ring && !screen_instances_[0].media_player) {
+                // Presenter worker: wake up as soon as the decoder publishes instead of sleeping blind
+                const ScreenInstance& presenter = screen_instances_[0];
+                presenter.frame_ring->wait_for_frame(presenter.frame_ring_counter,
+                    (int)std::chrono::duration_cast<std::chrono::milliseconds>(sleep_time).count());
+            } else {
+                std::this_thread::sleep_for(sleep_time);
+            }
         }
         last_frame_time = std::chrono::steady_clock::now();
     }
     
 }
 
+void Application::scheduled_loop() {
+    scheduler_ = std::make_unique<TaskScheduler>();
+    if (!scheduler_->start(config_.scheduler_workers)) {
+        std::cerr << "WARNING: Task scheduler unavailable, running screens in the update loop" << std::endl;
+        scheduler_.reset();
+        update_loop();
+        return;
+    }
+    
+    auto start = std::chrono::steady_clock::now();
+    int next_worker = 0;
+    for (auto& instance : screen_instances_) {
+        if (!instance.initialized) {
+            continue;
+        }
+        // Setup left the GL contexts current on this thread; presents make
+        // them current on the home worker from now on
+        if (instance.display_output) {
+            instance.display_output->release_thread_context();
+        }
+        for (auto& output : instance.span_outputs) {
+            output->release_thread_context();
+        }
+        instance.home_worker = next_worker++ % scheduler_->get_worker_count();
+        instance.frame_interval = get_screen_frame_interval(instance);
+        std::cout << "DEBUG: Screen " << instance.config.screen_name << " on worker " << instance.home_worker
+                  << ", " << instance.frame_interval.count() / 1000.0 << "ms per frame" << std::endl;
+        submit_screen_frame(instance, start);
+    }
+    
+    // The main thread only keeps the auto-mute state current
+    const auto auto_mute_check_interval = std::chrono::milliseconds(1000);
+    auto last_auto_mute_check = std::chrono::steady_clock::now();
+    while (running_ && !should_exit_) {
+        auto now = std::chrono::steady_clock::now();
+        if (now - last_auto_mute_check >= auto_mute_check_interval) {
+            update_auto_mute();
+            last_auto_mute_check = now;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    
+    // Screen chains end on their own now; hand the GL contexts back so
+    // shutdown() can release them from this thread
+    auto now = std::chrono::steady_clock::now();
+    for (auto& instance : screen_instances_) {
+        if (!instance.initialized) {
+            continue;
+        }
+        ScreenInstance* screen = &instance;
+        TaskScheduler::Task release;
+        release.run = [screen]() {
+            if (screen->display_output) {
+                screen->display_output->release_thread_context();
+            }
+            for (auto& output : screen->span_outputs) {
+                output->release_thread_context();
+            }
+        };
+        release.ready = now;
+        release.deadline = now;
+        release.worker = instance.home_worker;
+        release.pinned = true;
+        scheduler_->submit(std::move(release));
+    }
+    scheduler_->stop();
+    scheduler_.reset();
+}
+
+// One frame of a screen as two tasks: decode (and RGBA/YUV conversion) may be
+// stolen by any idle worker, present (scaling, upload, swap) stays on the home
+// worker. Both share the tick's deadline; the present task submits the next tick.
+void Application::submit_screen_frame(ScreenInstance& instance, std::chrono::steady_clock::time_point tick) {
+    ScreenInstance* screen = &instance;
+    auto deadline = tick + instance.frame_interval;
+    
+    TaskScheduler::Task decode;
+    decode.ready = tick;
+    decode.deadline = deadline;
+    decode.worker = instance.home_worker;
+    decode.run = [this, screen, tick, deadline]() {
+        if (!running_ || should_exit_) {
+            return;
+        }
+        decode_screen_frame(*screen);
+        
+        TaskScheduler::Task present;
+        present.ready = std::chrono::steady_clock::now();
+        present.deadline = deadline;
+        present.worker = screen->home_worker;
+        present.pinned = true;
+        present.run = [this, screen, tick]() {
+            if (!running_ || should_exit_) {
+                return;
+            }
+            present_screen_frame(*screen);
+            
+            // A screen that fell behind skips ahead instead of queueing a burst of late ticks
+            auto next = tick + screen->frame_interval;
+            auto now = std::chrono::steady_clock::now();
+            if (next < now) {
+                next = now;
+            }
+            submit_screen_frame(*screen, next);
+        };
+        scheduler_->submit(std::move(present));
+    };
+    scheduler_->submit(std::move(decode));
+}
+
+// Each screen ticks at its own --fps (or the video's rate) rather than the
+// fastest screen's rate that update_loop() runs every screen at
+std::chrono::microseconds Application::get_screen_frame_interval(const ScreenInstance& instance) const {
+    double fps = target_fps_;
+    if (instance.config.fps > 0) {
+        fps = instance.config.fps;
+    } else if (instance.media_player && instance.media_player->is_video()) {
+        fps = instance.media_player->get_frame_rate() * instance.media_player->get_playback_speed();
+    }
+    fps = std::max(1.0, std::min(120.0, fps));
+    return std::chrono::microseconds(static_cast<int64_t>(1000000.0 / fps));
+}
+
+void Application::apply_start_position(MediaPlayer& player, const ScreenConfig& config) {
+    const std::string& start = config.start_position;
+    if (start.empty() || player.get_media_type() != MediaType::VIDEO) {
+        return;
+    }
+    
+    double position = 0.0;
+    if (start == "random") {
+        // Desynchronizes screens showing the same file
+        static std::mt19937 random_engine(std::random_device{}());
+        double duration = player.get_duration();
+        if (duration <= 0.0) {
+            return;
+        }
+        position = std::uniform_real_distribution<double>(0.0, duration)(random_engine);
+    } else if (start == "resume") {
+        if (!KeyframeIndex::load_resume_position(config.media_path, config.screen_name, &position)) {
+            return;
+        }
+    } else {
+        position = std::stod(start);
+    }
+    
+    std::cout << "Starting " << config.screen_name << " at " << position << "s (" << start << ")" << std::endl;
+    player.seek(position);
+}
+
+void Application::save_resume_position(MediaPlayer& player, const ScreenConfig& config) {
+    if (config.start_position != "resume" || player.get_media_type() != MediaType::VIDEO) {
+        return;
+    }
+    if (!KeyframeIndex::save_resume_position(config.media_path, config.screen_name, player.get_position())) {
+        std::cerr << "WARNING: Could not save playback position for " << config.screen_name << std::endl;
+    }
+}
+
+void Application::present_ring_frame(ScreenInstance& instance) {
+    // Read the counter first so a frame published meanwhile still wakes the next wait
+    instance.frame_ring_counter = instance.frame_ring->get_counter();
+    
+    FrameRingView frame;
+    if (!instance.frame_ring->acquire(instance.config.frame_ring_reader, &frame)) {
+        return;
+    }
+    DisplayOutput* output = instance.display_output.get();
+    if (needs_present(output, frame.serial, instance.presented_serial)) {
+        if (instance.stats_overlay) {
+            instance.stats_overlay->set_target_fps(instance.config.fps > 0 ? instance.config.fps
+                                                   : instance.frame_ring->get_frame_rate());
+        }
+        // Straight from the shared slot, stride included
+        bool rendered = output->render_frame(VideoFrame::rgba(frame.data, frame.width, frame.height, frame.stride),
+                                             parse_scaling_mode(instance.config.scaling));
+        record_present(output, rendered, frame.serial, instance.presented_serial);
+    }
+    instance.frame_ring->release(instance.config.frame_ring_reader);
+}
+
+bool Application::ensure_auto_mute_monitor() {
+    if (auto_mute_monitor_attempted_) {
+        return auto_mute_monitor_ready_;
+    }
+    auto_mute_monitor_attempted_ = true;
+    
+    // Initialize PulseAudio for auto-mute functionality
+    audio_monitor_ = create_audio_output();
+    auto_mute_monitor_ready_ = audio_monitor_ && audio_monitor_->initialize();
+    if (!auto_mute_monitor_ready_) {
+        audio_monitor_.reset();
+        std::cerr << "Warning: Failed to initialize PulseAudio. Auto-mute will be disabled." << std::endl;
+    }
+    return auto_mute_monitor_ready_;
+}
+
 void Application::update_auto_mute() {
-    bool should_mute = pulse_audio_.should_mute_background_audio();
+    // The monitor connection is only opened once some playing media has audio to mute
+    bool has_audio = false;
+    for (const auto& instance : screen_instances_) {
+        if (instance.initialized && instance.media_player && instance.media_player->is_audio_enabled() &&
+            !instance.config.no_auto_mute && !instance.config.silent) {
+            has_audio = true;
+        }
+    }
+    for (const auto& player : window_players_) {
+        if (player.media_player && player.media_player->is_audio_enabled() &&
+            !player.config.no_auto_mute && !player.config.silent) {
+            has_audio = true;
+        }
+    }
+    
+    bool should_mute = false;
+    if (has_audio && ensure_auto_mute_monitor()) {
+        should_mute = audio_monitor_->should_mute_background_audio();
+    }
     static bool last_mute_state = false;
     
     // Only log when mute state changes to avoid spam
@@ -490,9 +1150,10 @@ void Application::update_auto_mute() {
     }
     
     if (config_.windowed_mode) {
-        if (window_media_player_ && !config_.screen_configs.empty() && 
-            !config_.screen_configs[0].no_auto_mute && !config_.screen_configs[0].silent) {
-            window_media_player_->set_muted(should_mute);
+        for (auto& player : window_players_) {
+            if (player.media_player && !player.config.no_auto_mute && !player.config.silent) {
+                player.media_player->set_muted(should_mute);
+            }
         }
     } else {
         for (auto& instance : screen_instances_) {
@@ -510,31 +1171,54 @@ void Application::shutdown() {
     
     std::cout << "Shutting down application..." << std::endl;
     
+    if (scheduler_) {
+        scheduler_->stop();
+        scheduler_.reset();
+    }
+    if (export_server_) {
+        export_server_->stop();
+        export_server_.reset();
+    }
+    
     // Cleanup screen instances
     for (auto& instance : screen_instances_) {
         if (instance.media_player) {
+            save_resume_position(*instance.media_player, instance.config);
             instance.media_player->stop();
             instance.media_player->cleanup();
         }
         if (instance.display_output) {
             instance.display_output->cleanup();
         }
+        for (auto& output : instance.span_outputs) {
+            output->cleanup();
+        }
+        instance.span_compositor.reset();
     }
     screen_instances_.clear();
     
     // Cleanup window mode
-    if (window_media_player_) {
-        window_media_player_->stop();
-        window_media_player_->cleanup();
-        window_media_player_.reset();
+    for (auto& player : window_players_) {
+        if (player.media_player) {
+            save_resume_position(*player.media_player, player.config);
+            player.media_player->stop();
+            player.media_player->cleanup();
+            player.media_player.reset();
+        }
     }
-    if (window_output_) {
-        window_output_->cleanup();
-        window_output_.reset();
+    window_players_.clear();
+    for (auto& instance : window_instances_) {
+        if (instance.display_output) {
+            instance.display_output->cleanup();
+        }
     }
+    window_instances_.clear();
     
     // Cleanup subsystems
-    pulse_audio_.cleanup();
+    if (audio_monitor_) {
+        audio_monitor_->cleanup();
+        audio_monitor_.reset();
+    }
     display_manager_.cleanup();
     
     std::cout << "Application shutdown complete" << std::endl;
@@ -549,26 +1233,26 @@ int Application::calculate_effective_fps() const {
     int effective_fps = 30; // Default FPS fallback
     
     if (config_.windowed_mode) {
-        // For window mode, check if FPS was explicitly set
-        if (!config_.screen_configs.empty()) {
-            if (config_.screen_configs[0].fps > 0) {
-                effective_fps = config_.screen_configs[0].fps;
-            } else {
-                // fps == -1: Use native video frame rate if available
-                if (window_media_player_ && window_media_player_->is_video()) {
-                    // Try to get native frame rate from the media player
-                    // For now, use a reasonable default for application loop
-                    effective_fps = 60; // Higher app FPS for smooth native video playback
-                } else {
-                    effective_fps = 30; // Default for non-video content
-                }
+        // For window mode, use the highest FPS among all preview windows
+        bool found_explicit_fps = false;
+        bool has_video = false;
+        for (const auto& player : window_players_) {
+            if (player.config.fps > 0) {
+                effective_fps = found_explicit_fps ? std::max(effective_fps, player.config.fps) : player.config.fps;
+                found_explicit_fps = true;
             }
-        } else {
-            if (config_.default_fps > 0) {
+            if (player.media_player && player.media_player->is_video()) {
+                has_video = true;
+            }
+        }
+        
+        if (!found_explicit_fps) {
+            if (window_players_.empty() && config_.default_fps > 0) {
                 effective_fps = config_.default_fps;
             } else {
-                // Use native video frame rate logic
-                effective_fps = window_media_player_ && window_media_player_->is_video() ? 60 : 30;
+                // fps == -1: Use native video frame rate if available
+                // For now, use a reasonable default for application loop
+                effective_fps = has_video ? 60 : 30; // Higher app FPS for smooth native video playback
             }
         }
     } else {
@@ -585,8 +1269,8 @@ int Application::calculate_effective_fps() const {
         // If no explicit FPS was set and we have video content, use higher app FPS
         if (!found_explicit_fps) {
             for (const auto& instance : screen_instances_) {
-                if (instance.initialized && instance.media_player && 
-                    instance.media_player->is_video()) {
+                if (instance.initialized && (instance.frame_ring ||
+                    (instance.media_player && instance.media_player->is_video()))) {
                     effective_fps = 60; // Higher app FPS for native video playback
                     break;
                 }
@@ -605,22 +1289,15 @@ int Application::calculate_effective_fps() const {
 
 void Application::apply_audio_settings() {
     if (config_.windowed_mode) {
-        if (window_media_player_) {
-            // Apply audio settings from first screen config or defaults
-            if (!config_.screen_configs.empty()) {
-                const auto& screen_config = config_.screen_configs[0];
-                window_media_player_->set_volume(screen_config.volume);
-                window_media_player_->set_muted(screen_config.silent);
-                
-                std::cout << "Applied window audio settings: volume=" << screen_config.volume 
-                          << "%, muted=" << (screen_config.silent ? "yes" : "no") << std::endl;
-            } else {
-                // Use global defaults
-                window_media_player_->set_volume(config_.default_volume);
-                window_media_player_->set_muted(config_.default_silent);
+        // Apply audio settings of the window that opened each shared player
+        for (auto& player : window_players_) {
+            if (player.media_player) {
+                player.media_player->set_volume(player.config.volume);
+                player.media_player->set_muted(player.config.silent);
                 
-                std::cout << "Applied window default audio settings: volume=" << config_.default_volume 
-                          << "%, muted=" << (config_.default_silent ? "yes" : "no") << std::endl;
+                std::cout << "Applied window audio settings for '" << player.config.media_path 
+                          << "': volume=" << player.config.volume 
+                          << "%, muted=" << (player.config.silent ? "yes" : "no") << std::endl;
             }
         }
     } else {
@@ -3,17 +3,85 @@
 #include "argument_parser.h"
 #include "media_player.h"
 #include "display/display_manager.h"
-#include "audio/pulse_audio.h"
+#include "display/span_compositor.h"
+#include "display/stats_overlay.h"
+#include "frame_ring.h"
+#include "task_scheduler.h"
+#include "frame_export.h"
+#include "audio/audio_output.h"
 #include <vector>
 #include <memory>
 #include <thread>
 #include <atomic>
+#include <chrono>
+
+// Result of a screen's decode step, consumed by its present step. The pixels
+// belong to the MediaPlayer and stay valid until that screen decodes again.
+struct DecodedFrame {
+    enum class Target {
+        NONE,       // Not a video, or nothing to present this tick
+        SKIPPED,    // Decoded only to keep video time moving (FPS limit)
+        RING,       // --isolate decoder worker: publish to the frame ring
+        SPAN,       // Crop per span output
+        OUTPUT      // Hand to display_output
+    };
+    Target target = Target::NONE;
+    bool got_frame = false;
+    VideoFrame frame;
+    uint64_t serial = 0;
+};
 
 struct ScreenInstance {
     std::unique_ptr<DisplayOutput> display_output;
     std::unique_ptr<MediaPlayer> media_player;
     ScreenConfig config;
     bool initialized = false;
+    bool yuv_output = false;        // Display uploads planar YUV (GL path) instead of RGBA
+    uint64_t presented_serial = 0;  // MediaPlayer frame serial last sent to the display(s)
+    bool dirty_tiles = false;       // Outputs redraw only changed tiles (keeps them off GL)
+    
+    // Spanned wallpaper (config.span_outputs): one output per monitor on Wayland,
+    // a single root-window output on X11; display_output stays empty
+    std::vector<std::unique_ptr<DisplayOutput>> span_outputs;
+    std::unique_ptr<SpanCompositor> span_compositor;
+    std::vector<unsigned char> span_canvas;
+    
+    // --stats-overlay HUD, drawn by display_output (or the first span output)
+    std::unique_ptr<StatsOverlay> stats_overlay;
+    
+    // --isolate group worker: decoded frames are published to (no display_output)
+    // or presented from (no media_player) a ring shared with the other workers
+    std::unique_ptr<FrameRing> frame_ring;
+    uint32_t frame_ring_counter = 0;    // Ring counter seen before the last present
+    
+    // --start resume: playback position is saved periodically and on shutdown
+    std::chrono::steady_clock::time_point resume_saved;
+    
+    // --export: decoded frames for other processes (see FrameExportServer)
+    std::unique_ptr<FrameRing> export_ring;
+    uint64_t exported_serial = 0;
+    
+    // --scheduler: decode runs on any worker, present stays on home_worker
+    // (the output's GL context and display connection live there)
+    DecodedFrame decoded;
+    int home_worker = 0;
+    std::chrono::microseconds frame_interval{0};
+};
+
+// Decoder shared by every preview window showing the same file
+struct WindowPlayer {
+    std::unique_ptr<MediaPlayer> media_player;
+    ScreenConfig config;            // Settings of the first window that opened this file
+    bool yuv_output = false;        // Windows upload planar YUV instead of RGBA
+    int processed_frames = 0;
+    std::chrono::steady_clock::time_point stats_start;
+};
+
+struct WindowInstance {
+    std::unique_ptr<DisplayOutput> display_output;
+    WindowConfig config;
+    size_t player_index = 0;        // Index into Application::window_players_
+    uint64_t presented_serial = 0;  // Frame serial this window last presented
 };
 
 class Application {
@@ -31,25 +99,56 @@ public:
 private:
     Config config_;
     DisplayManager display_manager_;
-    PulseAudio pulse_audio_;
+    std::unique_ptr<AudioOutput> audio_monitor_;    // Auto-mute monitor, connected on first need
+    bool auto_mute_monitor_attempted_;
+    bool auto_mute_monitor_ready_;
     
     std::vector<ScreenInstance> screen_instances_;
-    std::unique_ptr<DisplayOutput> window_output_;
-    std::unique_ptr<MediaPlayer> window_media_player_;
+    std::vector<WindowInstance> window_instances_;
+    std::vector<WindowPlayer> window_players_;
     
     std::atomic<bool> running_;
     std::atomic<bool> should_exit_;
     
+    static constexpr int RESUME_SAVE_INTERVAL_S = 30;
+    
+    // --scheduler: screens run as decode/present tasks instead of in update_loop()
+    std::unique_ptr<TaskScheduler> scheduler_;
+    
+    // --export: socket handing out each screen's export ring. Clients copy
+    // without pinning, so the ring has no reader pins, just slots beyond the
+    // two the writer keeps (newest and the one being written)
+    static constexpr int EXPORT_RING_SPARE_SLOTS = 2;
+    std::unique_ptr<FrameExportServer> export_server_;
+    
     // FPS limiting
     int target_fps_;
     std::chrono::milliseconds frame_duration_;
     
     bool setup_screen_instances();
     bool setup_window_mode();
+    bool acquire_window_player(const std::string& media_path, const ScreenConfig& settings, size_t& player_index);
+    void release_window_player(size_t player_index);
+    void update_window_instances();
+    void render_window_player(size_t player_index);
     bool initialize_screen_instance(ScreenInstance& instance);
+    bool setup_span_outputs(ScreenInstance& instance);
+    void configure_screen_outputs(ScreenInstance& instance, bool is_video);
+    void present_ring_frame(ScreenInstance& instance);
+    bool setup_frame_export();
+    void apply_start_position(MediaPlayer& player, const ScreenConfig& config);
+    void save_resume_position(MediaPlayer& player, const ScreenConfig& config);
+    // True only if every span output presented the frame (none failed or was throttled)
+    bool render_span_frame(ScreenInstance& instance, const unsigned char* frame_data, int frame_width, int frame_height);
+    void decode_screen_frame(ScreenInstance& instance);
+    void present_screen_frame(ScreenInstance& instance);
     
     void update_loop();
+    void scheduled_loop();
+    void submit_screen_frame(ScreenInstance& instance, std::chrono::steady_clock::time_point tick);
+    std::chrono::microseconds get_screen_frame_interval(const ScreenInstance& instance) const;
     void update_auto_mute();
+    bool ensure_auto_mute_monitor();
     void apply_audio_settings();
     
     ScalingMode parse_scaling_mode(const std::string& scaling);
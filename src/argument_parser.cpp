@@ -14,6 +14,10 @@ Config ArgumentParser::parse(int argc, char* argv[]) {
         throw std::runtime_error("No arguments provided");
     }
     
+    if (parse_command(argc, argv, config)) {
+        return config;
+    }
+    
     // ============================================================================
     // COMPLETELY REWRITTEN ARGUMENT PARSER - CLEAN AND INTUITIVE LOGIC
     // 
@@ -37,6 +41,45 @@ Config ArgumentParser::parse(int argc, char* argv[]) {
         else if (arg == "--screen-root" && i + 1 < argc) {
             current.is_window_mode = false;
             current.screen_name = argv[++i];
+            current.span_outputs.clear();
+        }
+        else if (arg == "--span" && i + 1 < argc) {
+            current.is_window_mode = false;
+            current.span_outputs = split_output_list(argv[++i]);
+            if (current.span_outputs.size() < 2) {
+                throw std::runtime_error("--span needs at least two comma-separated outputs");
+            }
+        }
+        else if (arg == "--isolate" && i + 1 < argc) {
+            std::string mode = argv[++i];
+            if (mode != "output" && mode != "group") {
+                throw std::runtime_error("Invalid isolation mode (output, group): " + mode);
+            }
+            config.isolate_mode = mode;
+        }
+        else if (arg == "--huge-pages" && i + 1 < argc) {
+            std::string mode = argv[++i];
+            if (!FramePool::parse_huge_page_mode(mode, &config.huge_pages)) {
+                throw std::runtime_error("Invalid huge page mode (off, thp, hugetlb): " + mode);
+            }
+        }
+        else if (arg == "--scheduler" && i + 1 < argc) {
+            std::string workers = argv[++i];
+            if (workers == "auto") {
+                config.scheduler_workers = 0;
+            } else {
+                config.scheduler_workers = std::stoi(workers);
+                if (config.scheduler_workers < 1) {
+                    throw std::runtime_error("Invalid scheduler worker count (auto or 1+): " + workers);
+                }
+            }
+        }
+        else if (arg == "--export") {
+            config.export_frames = true;
+        }
+        else if (arg == "--export-socket" && i + 1 < argc) {
+            config.export_frames = true;
+            config.export_socket = argv[++i];
         }
         else if (arg == "--silent" || arg == "--mute") {
             current.silent = true;
@@ -50,6 +93,62 @@ Config ArgumentParser::parse(int argc, char* argv[]) {
         else if (arg == "--fps" && i + 1 < argc) {
             current.fps = std::stoi(argv[++i]);
         }
+        else if (arg == "--speed" && i + 1 < argc) {
+            double speed = std::stod(argv[++i]);
+            if (speed < 0.25 || speed > 4.0) {
+                throw std::runtime_error("Invalid playback speed (0.25 - 4.0): " + std::string(argv[i]));
+            }
+            current.speed = speed;
+        }
+        else if (arg == "--loop" && i + 1 < argc) {
+            std::string mode = argv[++i];
+            if (mode != "normal" && mode != "pingpong") {
+                throw std::runtime_error("Invalid loop mode (normal or pingpong): " + mode);
+            }
+            current.ping_pong = mode == "pingpong";
+        }
+        else if (arg == "--start" && i + 1 < argc) {
+            std::string start = argv[++i];
+            if (start != "random" && start != "resume" && std::stod(start) < 0.0) {
+                throw std::runtime_error("Invalid start position (seconds, random or resume): " + start);
+            }
+            current.start_position = start;
+        }
+        else if (arg == "--dirty-tiles") {
+            current.dirty_tiles = true;
+        }
+        else if (arg == "--xrender") {
+            current.xrender = true;
+        }
+        else if (arg == "--dim" && i + 1 < argc) {
+            current.effects.dim = parse_percentage(arg, argv[++i]);
+        }
+        else if (arg == "--desaturate" && i + 1 < argc) {
+            current.effects.desaturate = parse_percentage(arg, argv[++i]);
+        }
+        else if (arg == "--vignette" && i + 1 < argc) {
+            current.effects.vignette = parse_percentage(arg, argv[++i]);
+        }
+        else if (arg == "--tint" && i + 1 < argc) {
+            parse_tint(argv[++i], current.effects);
+        }
+        else if (arg == "--stats-overlay") {
+            current.stats_overlay = true;
+        }
+        else if (arg == "--letterbox" && i + 1 < argc) {
+            std::string style = argv[++i];
+            if (style != "blur" && style != "black") {
+                throw std::runtime_error("Invalid letterbox style (blur, black): " + style);
+            }
+            current.letterbox.blur = style == "blur";
+        }
+        else if (arg == "--letterbox-fps" && i + 1 < argc) {
+            int fps = std::stoi(argv[++i]);
+            if (fps < 1 || fps > 60) {
+                throw std::runtime_error("Invalid letterbox refresh rate (1 - 60): " + std::string(argv[i]));
+            }
+            current.letterbox.refresh_fps = fps;
+        }
         else if (arg == "--scaling" && i + 1 < argc) {
             std::string scaling = argv[++i];
             if (scaling != "stretch" && scaling != "fit" && scaling != "fill" && scaling != "default") {
@@ -77,16 +176,97 @@ Config ArgumentParser::parse(int argc, char* argv[]) {
     }
     
     // Validation
-    if (config.windowed_mode && config.window_config.media_path.empty()) {
+    if (config.windowed_mode && config.window_configs.empty()) {
         throw std::runtime_error("Window mode specified but no media path provided");
     }
     if (!config.windowed_mode && config.screen_configs.empty()) {
         throw std::runtime_error("No screen configurations provided");
     }
+    if (config.windowed_mode && !config.isolate_mode.empty()) {
+        throw std::runtime_error("--isolate only applies to desktop background mode");
+    }
     
     return config;
 }
 
+// Subcommands take the first argument; they run once and exit instead of
+// showing wallpapers
+bool ArgumentParser::parse_command(int argc, char* argv[], Config& config) {
+    std::string command = argv[1];
+    if (command != "autotune" && command != "thumbnail" && command != "probe") {
+        return false;
+    }
+    
+    config.command = command;
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            print_help();
+            exit(0);
+        }
+        if (command == "thumbnail" && arg == "--output" && i + 1 < argc) {
+            config.thumbnail.output_dir = argv[++i];
+            continue;
+        }
+        if (command == "thumbnail" && arg == "--size" && i + 1 < argc) {
+            config.thumbnail.size = std::stoi(argv[++i]);
+            if (config.thumbnail.size < 16 || config.thumbnail.size > 4096) {
+                throw std::runtime_error("Invalid thumbnail size (16 - 4096): " + std::string(argv[i]));
+            }
+            continue;
+        }
+        if (command == "thumbnail" && arg == "--preview" && i + 1 < argc) {
+            config.thumbnail.preview_seconds = std::stod(argv[++i]);
+            if (config.thumbnail.preview_seconds < 0.0 || config.thumbnail.preview_seconds > 60.0) {
+                throw std::runtime_error("Invalid preview length (0 - 60 seconds): " + std::string(argv[i]));
+            }
+            continue;
+        }
+        if (command == "thumbnail" && arg == "--jobs" && i + 1 < argc) {
+            config.thumbnail.jobs = std::stoi(argv[++i]);
+            if (config.thumbnail.jobs < 1) {
+                throw std::runtime_error("Invalid job count (1+): " + std::string(argv[i]));
+            }
+            continue;
+        }
+        if (command == "probe" && arg == "--fps" && i + 1 < argc) {
+            config.probe.fps = std::stoi(argv[++i]);
+            continue;
+        }
+        if (command == "probe" && arg == "--scaling" && i + 1 < argc) {
+            std::string scaling = argv[++i];
+            if (scaling != "stretch" && scaling != "fit" && scaling != "fill" && scaling != "default") {
+                throw std::runtime_error("Invalid scaling mode: " + scaling);
+            }
+            config.probe.scaling = scaling;
+            continue;
+        }
+        if (command == "probe" && arg == "--output" && i + 1 < argc) {
+            std::string size = argv[++i];
+            size_t x_pos = size.find('x');
+            int width = x_pos == std::string::npos ? 0 : std::stoi(size.substr(0, x_pos));
+            int height = x_pos == std::string::npos ? 0 : std::stoi(size.substr(x_pos + 1));
+            if (width < 1 || height < 1) {
+                throw std::runtime_error("Invalid output size (WxH): " + size);
+            }
+            config.probe.outputs.emplace_back(width, height);
+            continue;
+        }
+        if (arg.find("--") == 0) {
+            throw std::runtime_error("Unknown " + command + " option: " + arg);
+        }
+        config.command_args.push_back(arg);
+    }
+    if (config.command_args.empty()) {
+        if (command == "autotune") {
+            throw std::runtime_error("autotune needs at least one sample video");
+        }
+        throw std::runtime_error(command + (command == "probe" ? " needs a media file"
+                                                               : " needs at least one file or directory"));
+    }
+    return true;
+}
+
 void ArgumentParser::parse_window_geometry(const std::string& geometry, WindowConfig& config) {
     // Parse format: XxYxWxH
     size_t x_pos = geometry.find('x');
@@ -114,18 +294,65 @@ void ArgumentParser::parse_window_geometry(const std::string& geometry, WindowCo
     }
 }
 
+float ArgumentParser::parse_percentage(const std::string& option, const std::string& value) {
+    int percent = 0;
+    try {
+        percent = std::stoi(value);
+    } catch (const std::exception& e) {
+        throw std::runtime_error("Invalid value for " + option + " (0 - 100): " + value);
+    }
+    if (percent < 0 || percent > 100) {
+        throw std::runtime_error("Invalid value for " + option + " (0 - 100): " + value);
+    }
+    return percent / 100.0f;
+}
+
+void ArgumentParser::parse_tint(const std::string& value, PostEffects& effects) {
+    // Parse format: RRGGBB or #RRGGBB (ffffff = no tint)
+    std::string hex = !value.empty() && value[0] == '#' ? value.substr(1) : value;
+    if (hex.size() != 6 || hex.find_first_not_of("0123456789abcdefABCDEF") != std::string::npos) {
+        throw std::runtime_error("Invalid tint color. Expected: RRGGBB");
+    }
+    for (int i = 0; i < 3; i++) {
+        effects.tint[i] = std::stoi(hex.substr(i * 2, 2), nullptr, 16) / 255.0f;
+    }
+}
+
+std::vector<std::string> ArgumentParser::split_output_list(const std::string& list) {
+    // Parse format: OUT1,OUT2,...
+    std::vector<std::string> outputs;
+    size_t start = 0;
+    while (start <= list.size()) {
+        size_t comma = list.find(',', start);
+        if (comma == std::string::npos) {
+            comma = list.size();
+        }
+        std::string name = list.substr(start, comma - start);
+        if (!name.empty()) {
+            outputs.push_back(name);
+        }
+        start = comma + 1;
+    }
+    return outputs;
+}
+
 void ArgumentParser::apply_current_settings_to_config(Config& config, const CurrentSettings& current, const std::string& media_path) {
     if (current.is_window_mode) {
-        // Window mode - clear any existing screen configs and set up window
-        config.windowed_mode = true;
-        config.screen_configs.clear();
+        // Window mode - first window clears any existing screen configs,
+        // every further --window adds another preview window
+        if (!config.windowed_mode) {
+            config.windowed_mode = true;
+            config.screen_configs.clear();
+            config.window_configs.clear();
+        }
         
         // Apply settings to window config
-        config.window_config = current.window_config;
-        config.window_config.media_path = media_path;
-        config.window_config.scaling = current.scaling;
+        WindowConfig window_config = current.window_config;
+        window_config.media_path = media_path;
+        window_config.scaling = current.scaling;
+        config.window_configs.push_back(window_config);
         
-        // Create a single screen config for compatibility with existing application logic
+        // Matching screen config (same index) carries audio/fps settings for the window
         ScreenConfig window_screen_config;
         window_screen_config.screen_name = "window";
         window_screen_config.media_path = media_path;
@@ -134,19 +361,31 @@ void ArgumentParser::apply_current_settings_to_config(Config& config, const Curr
         window_screen_config.no_auto_mute = current.no_auto_mute;
         window_screen_config.fps = current.fps;
         window_screen_config.scaling = current.scaling;
+        window_screen_config.speed = current.speed;
+        window_screen_config.ping_pong = current.ping_pong;
+        window_screen_config.start_position = current.start_position;
         config.screen_configs.push_back(window_screen_config);
     } else {
         // Screen mode - add a new screen configuration
         config.windowed_mode = false;
         
         ScreenConfig screen_config;
-        screen_config.screen_name = current.screen_name;
+        screen_config.screen_name = current.span_outputs.empty() ? current.screen_name : "span";
+        screen_config.span_outputs = current.span_outputs;
         screen_config.media_path = media_path;
         screen_config.silent = current.silent;
         screen_config.volume = current.volume;
         screen_config.no_auto_mute = current.no_auto_mute;
         screen_config.fps = current.fps;
         screen_config.scaling = current.scaling;
+        screen_config.speed = current.speed;
+        screen_config.ping_pong = current.ping_pong;
+        screen_config.start_position = current.start_position;
+        screen_config.dirty_tiles = current.dirty_tiles;
+        screen_config.xrender = current.xrender;
+        screen_config.effects = current.effects;
+        screen_config.letterbox = current.letterbox;
+        screen_config.stats_overlay = current.stats_overlay;
         config.screen_configs.push_back(screen_config);
     }
 }
@@ -160,13 +399,44 @@ void ArgumentParser::print_help() const {
     std::cout << "  --volume <val>             Set audio volume (0-100)\n";
     std::cout << "  --noautomute              Don't mute when other apps play audio\n";
     std::cout << "  --fps <val>               Limit frame rate\n";
-    std::cout << "  --window <XxYxWxH>        Run in windowed mode with custom size/position\n";
+    std::cout << "  --speed <val>             Playback speed, 0.25 to 4.0 (audio is muted when not 1.0)\n";
+    std::cout << "  --loop <mode>             Video looping: normal (default) or pingpong (play back in reverse)\n";
+    std::cout << "  --start <pos>             Start videos at <seconds>, a random offset, or where they stopped (resume)\n";
+    std::cout << "  --dim <0-100>             Darken the wallpaper by this percentage\n";
+    std::cout << "  --desaturate <0-100>      Remove this percentage of the color saturation\n";
+    std::cout << "  --tint <RRGGBB>           Multiply the wallpaper by a color\n";
+    std::cout << "  --vignette <0-100>        Darken the edges and corners\n";
+    std::cout << "  --letterbox <style>       Bars in fit/default scaling: blur (default) or black\n";
+    std::cout << "  --letterbox-fps <val>     Blurred bar refreshes per second for videos (default 4)\n";
+    std::cout << "  --stats-overlay           Show decode/scale/present times, FPS, drops and queue depth on screen\n";
+    std::cout << "  --dirty-tiles             Redraw only changed screen tiles (CPU rendering, for cinemagraphs)\n";
+    std::cout << "  --xrender                 X11: upload frames at source size and let the X server scale them\n";
+    std::cout << "  --window <XxYxWxH>        Run in windowed mode with custom size/position (repeatable)\n";
     std::cout << "  --screen-root <screen>    Set as background for specific screen\n";
+    std::cout << "  --span <OUT1,OUT2,...>    Span one wallpaper across several outputs (single decode)\n";
     std::cout << "  --scaling <mode>          Wallpaper scaling: stretch, fit, fill, or default\n";
+    std::cout << "  --isolate <mode>          One worker process per output, or per group of outputs sharing a video\n";
+    std::cout << "  --huge-pages <mode>       Frame buffer backing: off, thp (default), or hugetlb (reserved pages)\n";
+    std::cout << "  --scheduler <auto|N>      Run screens as deadline-ordered tasks on N worker threads (auto = one per core)\n";
+    std::cout << "  --export                  Share decoded frames with lock screens/greeters over a socket (no second decode)\n";
+    std::cout << "  --export-socket <path>    Export on this socket instead of $XDG_RUNTIME_DIR/linux-wallpaperengine-ext/export.sock\n";
     std::cout << "  --help, -h                Show this help message\n\n";
+    std::cout << "Commands:\n";
+    std::cout << "  autotune <video>...       Benchmark decoders, threads and scalers on these samples and\n";
+    std::cout << "                            save the fastest setup per codec and resolution for playback\n";
+    std::cout << "  thumbnail <file|dir>...   PNG thumbnails (and MP4 previews) for a wallpaper library, skipping\n";
+    std::cout << "                            unchanged files; --output <dir>, --size <px> (320), --preview <s>, --jobs <N>\n";
+    std::cout << "  probe <media>...          Codec, GOP and a timed decode sample: estimated CPU and memory and whether\n";
+    std::cout << "                            it plays smoothly here; --fps <N>, --scaling <mode>, --output <WxH> (repeatable)\n\n";
     std::cout << "Examples:\n";
     std::cout << "  " << program_name_ << " --path-to-media /path/to/video.mp4\n";
     std::cout << "  " << program_name_ << " /path/to/video.mp4  # Direct path usage\n";
     std::cout << "  " << program_name_ << " --screen-root HDMI-1 --volume 50 --fps 60 --scaling fill /path/to/video.mp4 --screen-root HDMI-2 --silent --fps 30 --scaling fill /path/to/video2.mov\n";
+    std::cout << "  " << program_name_ << " --dim 30 --desaturate 50 --vignette 40 /path/to/video.mp4\n";
+    std::cout << "  " << program_name_ << " --span DP-1,HDMI-1 --scaling fill /path/to/panorama.mp4\n";
     std::cout << "  " << program_name_ << " --window 0x0x800x600 /path/to/image.jpg\n";
+    std::cout << "  " << program_name_ << " --window 0x0x640x360 /path/to/a.mp4 --window 660x0x640x360 /path/to/b.mp4\n";
+    std::cout << "  " << program_name_ << " autotune /path/to/video.mp4 /path/to/4k-video.webm\n";
+    std::cout << "  " << program_name_ << " thumbnail --size 256 --preview 3 ~/Videos/wallpapers\n";
+    std::cout << "  " << program_name_ << " probe --fps 30 --scaling fill --output 2560x1440 --output 1920x1080 /path/to/video.mp4\n";
 }
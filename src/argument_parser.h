@@ -4,6 +4,12 @@
 #include <vector>
 #include <map>
 
+#include "display/post_effects.h"
+#include "display/letterbox_fill.h"
+#include "frame_pool.h"
+#include "thumbnailer.h"
+#include "media_probe.h"
+
 struct ScreenConfig {
     std::string screen_name;
     std::string media_path;
@@ -12,6 +18,19 @@ struct ScreenConfig {
     bool no_auto_mute = false;
     int fps = -1; // -1 means use native video frame rate
     std::string scaling = "fit"; // stretch, fit, fill, default
+    double speed = 1.0; // Playback rate, 0.25 - 4.0
+    bool ping_pong = false; // --loop pingpong: play back to the start in reverse at the end
+    std::string start_position; // --start: seconds, "random" or "resume"; empty = from the beginning
+    bool dirty_tiles = false; // Redraw only changed tiles (CPU paths, cinemagraphs)
+    bool xrender = false; // X11: upload at source size, the X server scales (no CPU scaling)
+    PostEffects effects; // Dim/desaturate/tint/vignette folded into the scaling pass
+    LetterboxSettings letterbox; // Blurred or black bars in fit/default scaling
+    bool stats_overlay = false; // Draw the performance HUD into the output
+    std::vector<std::string> span_outputs; // Non-empty: one wallpaper spanned across these outputs
+    
+    // Filled in by the --isolate supervisor for its workers, never parsed
+    int frame_ring_fd = -1; // Shared FrameRing memfd; -1 = decode and present in-process
+    int frame_ring_reader = -1; // -1 = decode into the ring, >= 0 = present from it as this reader
 };
 
 struct WindowConfig {
@@ -26,7 +45,9 @@ struct WindowConfig {
 struct Config {
     std::vector<ScreenConfig> screen_configs;
     bool windowed_mode = false;
-    WindowConfig window_config;
+    // One entry per preview window; in windowed mode screen_configs[i] holds
+    // the playback settings (audio, fps) of window_configs[i]
+    std::vector<WindowConfig> window_configs;
     
     // Global defaults (can be overridden per screen)
     bool default_silent = false;
@@ -34,6 +55,28 @@ struct Config {
     bool default_no_auto_mute = false;
     int default_fps = -1; // -1 means use native video frame rate
     std::string default_scaling = "fit";
+    
+    // --isolate: "output" runs every screen in its own worker process, "group"
+    // additionally shares one decoder worker between screens playing the same video
+    std::string isolate_mode;
+
+    // --huge-pages: backing of frame pool buffers of 2 MiB and up
+    HugePageMode huge_pages = HugePageMode::THP;
+    
+    // --scheduler: screens run as deadline-ordered tasks on this many worker
+    // threads (0 = one per core); -1 keeps the single update loop
+    int scheduler_workers = -1;
+    
+    // --export: publish every screen's decoded frames for other local
+    // processes on a Unix socket (empty path = default runtime location)
+    bool export_frames = false;
+    std::string export_socket;
+    
+    // Subcommand run instead of any wallpaper ("autotune", "thumbnail", "probe"), with its operands
+    std::string command;
+    std::vector<std::string> command_args;
+    ThumbnailSettings thumbnail;
+    ProbeSettings probe;
 };
 
 class ArgumentParser {
@@ -41,20 +84,33 @@ public:
     ArgumentParser();
     Config parse(int argc, char* argv[]);
     void print_help() const;
+    bool parse_command(int argc, char* argv[], Config& config);
 
 private:
     struct CurrentSettings {
         bool is_window_mode = false;
         WindowConfig window_config;
         std::string screen_name = "default";
+        std::vector<std::string> span_outputs;
         bool silent = false;
         int volume = 100;
         bool no_auto_mute = false;
         int fps = -1; // -1 means use native video frame rate
         std::string scaling = "fit";
+        double speed = 1.0;
+        bool ping_pong = false;
+        std::string start_position;
+        bool dirty_tiles = false;
+        bool xrender = false;
+        PostEffects effects;
+        LetterboxSettings letterbox;
+        bool stats_overlay = false;
     };
     
     void parse_window_geometry(const std::string& geometry, WindowConfig& config);
+    std::vector<std::string> split_output_list(const std::string& list);
+    float parse_percentage(const std::string& option, const std::string& value);
+    void parse_tint(const std::string& value, PostEffects& effects);
     void apply_current_settings_to_config(Config& config, const CurrentSettings& current, const std::string& media_path);
     std::string program_name_;
 };
@@ -0,0 +1,20 @@
+#include "audio_output.h"
+#include "../backend_loader.h"
+#include <iostream>
+
+std::unique_ptr<AudioOutput> create_audio_output() {
+#ifdef LWE_BACKEND_PLUGINS
+    static auto entry = reinterpret_cast<AudioBackendEntry>(load_backend_symbol("audio", "pulse"));
+#else
+    static AudioBackendEntry entry = lwe_audio_backend_pulse;
+#endif
+    if (!entry) {
+        return nullptr;
+    }
+    
+    AudioOutput* output = entry(LWE_AUDIO_BACKEND_ABI);
+    if (!output) {
+        std::cerr << "ERROR: Audio backend was built for a different version" << std::endl;
+    }
+    return std::unique_ptr<AudioOutput>(output);
+}
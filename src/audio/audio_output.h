@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// Bumped whenever the AudioOutput interface changes layout
+#define LWE_AUDIO_BACKEND_ABI 1
+
+/**
+ * Audio playback and "is anything else playing" monitoring.
+ *
+ * Implemented by the PulseAudio backend, which is built as a separate module
+ * (liblwe-audio-pulse.so) and only loaded once some media actually has audio.
+ */
+class AudioOutput {
+public:
+    virtual ~AudioOutput() = default;
+    
+    virtual bool initialize() = 0;
+    virtual void cleanup() = 0;
+    
+    virtual bool is_any_application_playing_audio() = 0;
+    virtual void set_auto_mute_enabled(bool enabled) = 0;
+    virtual bool should_mute_background_audio() = 0;
+    
+    // Audio playback functionality
+    virtual bool create_audio_stream(int sample_rate, int channels) = 0;
+    virtual void destroy_audio_stream() = 0;
+    virtual bool write_audio_data(const uint8_t* data, size_t size) = 0;
+    virtual void set_playback_volume(int volume) = 0;  // 0-100
+    virtual void set_playback_muted(bool muted) = 0;
+    virtual bool is_audio_stream_active() const = 0;
+};
+
+typedef AudioOutput* (*AudioBackendEntry)(int abi_version);
+
+extern "C" AudioOutput* lwe_audio_backend_pulse(int abi_version);
+
+// New, uninitialized audio output from the audio backend module, or nullptr
+std::unique_ptr<AudioOutput> create_audio_output();
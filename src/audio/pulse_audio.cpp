@@ -431,3 +431,11 @@ void PulseAudio::process_audio_buffer() {
         }
     }
 }
+
+// Module entry point (see audio_output.h)
+extern "C" AudioOutput* lwe_audio_backend_pulse(int abi_version) {
+    if (abi_version != LWE_AUDIO_BACKEND_ABI) {
+        return nullptr;
+    }
+    return new PulseAudio();
+}
@@ -1,30 +1,31 @@
 #pragma once
 
+#include "audio_output.h"
 #include <pulse/pulseaudio.h>
 #include <memory>
 #include <string>
 #include <queue>
 #include <mutex>
 
-class PulseAudio {
+class PulseAudio : public AudioOutput {
 public:
     PulseAudio();
-    ~PulseAudio();
+    ~PulseAudio() override;
     
-    bool initialize();
-    void cleanup();
+    bool initialize() override;
+    void cleanup() override;
     
-    bool is_any_application_playing_audio();
-    void set_auto_mute_enabled(bool enabled);
-    bool should_mute_background_audio();
+    bool is_any_application_playing_audio() override;
+    void set_auto_mute_enabled(bool enabled) override;
+    bool should_mute_background_audio() override;
     
     // Audio playback functionality
-    bool create_audio_stream(int sample_rate, int channels);
-    void destroy_audio_stream();
-    bool write_audio_data(const uint8_t* data, size_t size);
-    void set_playback_volume(int volume);  // 0-100
-    void set_playback_muted(bool muted);
-    bool is_audio_stream_active() const;
+    bool create_audio_stream(int sample_rate, int channels) override;
+    void destroy_audio_stream() override;
+    bool write_audio_data(const uint8_t* data, size_t size) override;
+    void set_playback_volume(int volume) override;  // 0-100
+    void set_playback_muted(bool muted) override;
+    bool is_audio_stream_active() const override;
 
 private:
     // Monitoring functionality
@@ -0,0 +1,82 @@
+#include "backend_loader.h"
+#include <dlfcn.h>
+#include <unistd.h>
+#include <climits>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <vector>
+
+#ifndef LWE_PLUGIN_INSTALL_DIR
+#define LWE_PLUGIN_INSTALL_DIR "/usr/local/lib/linux-wallpaperengine-ext"
+#endif
+
+namespace {
+
+std::string executable_dir() {
+    char path[PATH_MAX];
+    ssize_t length = readlink("/proc/self/exe", path, sizeof(path) - 1);
+    if (length <= 0) {
+        return "";
+    }
+    path[length] = '\0';
+    std::string exe(path);
+    size_t slash = exe.find_last_of('/');
+    return slash == std::string::npos ? "" : exe.substr(0, slash);
+}
+
+void* open_module(const std::string& file) {
+    // Handles are never closed: vtables of objects the module created live in it
+    static std::map<std::string, void*> modules;
+    auto it = modules.find(file);
+    if (it != modules.end()) {
+        return it->second;
+    }
+    
+    std::vector<std::string> directories;
+    if (const char* override_dir = std::getenv("LWE_PLUGIN_DIR")) {
+        directories.push_back(override_dir);
+    }
+    std::string exe_dir = executable_dir();
+    if (!exe_dir.empty()) {
+        directories.push_back(exe_dir);
+    }
+    directories.push_back(LWE_PLUGIN_INSTALL_DIR);
+    
+    std::string errors;
+    for (const auto& directory : directories) {
+        std::string path = directory + "/" + file;
+        if (access(path.c_str(), R_OK) != 0) {
+            continue;
+        }
+        // RTLD_LOCAL keeps each backend's libraries out of the global namespace
+        void* handle = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+        if (handle) {
+            std::cout << "DEBUG: Loaded backend module " << path << std::endl;
+            modules[file] = handle;
+            return handle;
+        }
+        errors += std::string("\n  ") + dlerror();
+    }
+    
+    std::cerr << "ERROR: Could not load backend module " << file
+              << (errors.empty() ? " (not found)" : errors) << std::endl;
+    modules[file] = nullptr;
+    return nullptr;
+}
+
+} // namespace
+
+void* load_backend_symbol(const std::string& kind, const std::string& name) {
+    void* handle = open_module("liblwe-" + kind + "-" + name + ".so");
+    if (!handle) {
+        return nullptr;
+    }
+    
+    std::string symbol = "lwe_" + kind + "_backend_" + name;
+    void* entry = dlsym(handle, symbol.c_str());
+    if (!entry) {
+        std::cerr << "ERROR: Backend module for " << name << " has no " << symbol << std::endl;
+    }
+    return entry;
+}
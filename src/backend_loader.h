@@ -0,0 +1,13 @@
+#pragma once
+
+#include <string>
+
+/**
+ * Resolves an entry point in a runtime-loaded backend module.
+ *
+ * Modules are named liblwe-<kind>-<name>.so and searched in $LWE_PLUGIN_DIR,
+ * next to the executable, and in the install directory. A module stays loaded
+ * for the life of the process once opened (objects created by it keep
+ * pointing at its code). Returns nullptr and logs why on failure.
+ */
+void* load_backend_symbol(const std::string& kind, const std::string& name);
@@ -0,0 +1,357 @@
+#include "decoder_profile.h"
+#include "keyframe_index.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <cstdio>
+#include <unistd.h>
+
+extern "C" {
+#include <libavformat/avformat.h>
+#include <libavcodec/avcodec.h>
+#include <libavutil/imgutils.h>
+#include <libswscale/swscale.h>
+}
+
+// Profiles read once per process; store() drops the copy
+static std::mutex g_profiles_mutex;
+static bool g_profiles_loaded = false;
+static std::vector<std::pair<std::string, DecoderProfile>> g_profiles;
+
+std::string DecoderProfiles::resolution_class(int width, int height) {
+    long pixels = (long)width * height;
+    if (pixels <= 1024L * 576) {
+        return "sd";
+    }
+    if (pixels <= 1920L * 1080) {
+        return "hd";
+    }
+    if (pixels <= 3840L * 2160) {
+        return "uhd";
+    }
+    return "8k";
+}
+
+const char* DecoderProfiles::sws_flags_name(int flags) {
+    switch (flags) {
+        case SWS_FAST_BILINEAR: return "fast_bilinear";
+        case SWS_BICUBIC: return "bicubic";
+        case SWS_POINT: return "point";
+        default: return "bilinear";
+    }
+}
+
+int DecoderProfiles::parse_sws_flags(const std::string& name) {
+    if (name == "fast_bilinear") {
+        return SWS_FAST_BILINEAR;
+    }
+    if (name == "bicubic") {
+        return SWS_BICUBIC;
+    }
+    if (name == "point") {
+        return SWS_POINT;
+    }
+    return SWS_BILINEAR;
+}
+
+std::string DecoderProfiles::get_profile_path() {
+    std::string directory = KeyframeIndex::get_cache_directory();
+    return directory.empty() ? std::string() : directory + "/decoder_profiles";
+}
+
+// One line per profile: codec class decoder threads frame|slice scaler fps
+bool DecoderProfiles::load_all(std::vector<std::pair<std::string, DecoderProfile>>* entries) {
+    entries->clear();
+    std::string path = get_profile_path();
+    std::ifstream file(path);
+    if (path.empty() || !file) {
+        return false;
+    }
+
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::istringstream fields(line);
+        std::string codec, size_class, threading, scaler;
+        DecoderProfile profile;
+        if (!(fields >> codec >> size_class >> profile.decoder >> profile.threads >> threading >> scaler >> profile.fps) ||
+            profile.threads < 1 || profile.threads > 256) {
+            continue;
+        }
+        profile.slice_threads = threading == "slice";
+        profile.sws_flags = parse_sws_flags(scaler);
+        entries->emplace_back(codec + " " + size_class, profile);
+    }
+    return !entries->empty();
+}
+
+bool DecoderProfiles::lookup(const std::string& codec, int width, int height, DecoderProfile* profile) {
+    std::lock_guard<std::mutex> lock(g_profiles_mutex);
+    if (!g_profiles_loaded) {
+        load_all(&g_profiles);
+        g_profiles_loaded = true;
+    }
+
+    std::string key = codec + " " + resolution_class(width, height);
+    for (const auto& entry : g_profiles) {
+        if (entry.first == key) {
+            *profile = entry.second;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool DecoderProfiles::store(const std::string& codec, const std::string& resolution_class, const DecoderProfile& profile) {
+    std::lock_guard<std::mutex> lock(g_profiles_mutex);
+    std::string path = get_profile_path();
+    if (path.empty()) {
+        return false;
+    }
+
+    std::vector<std::pair<std::string, DecoderProfile>> entries;
+    load_all(&entries);
+    std::string key = codec + " " + resolution_class;
+    entries.erase(std::remove_if(entries.begin(), entries.end(),
+                                 [&key](const std::pair<std::string, DecoderProfile>& entry) { return entry.first == key; }),
+                  entries.end());
+    entries.emplace_back(key, profile);
+
+    std::error_code error;
+    std::filesystem::create_directories(std::filesystem::path(path).parent_path(), error);
+    if (error) {
+        std::cerr << "WARNING: Could not create cache directory: " << error.message() << std::endl;
+        return false;
+    }
+
+    // Written aside and renamed, like the keyframe indexes
+    std::string temporary = path + ".tmp" + std::to_string(getpid());
+    {
+        std::ofstream file(temporary, std::ios::trunc);
+        file << "# codec class decoder threads threading scaler fps (written by autotune)\n";
+        for (const auto& entry : entries) {
+            const DecoderProfile& p = entry.second;
+            file << entry.first << " " << p.decoder << " " << p.threads << " " << (p.slice_threads ? "slice" : "frame")
+                 << " " << sws_flags_name(p.sws_flags) << " " << p.fps << "\n";
+        }
+        if (!file) {
+            file.close();
+            std::remove(temporary.c_str());
+            return false;
+        }
+    }
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        std::remove(temporary.c_str());
+        return false;
+    }
+    g_profiles_loaded = false;
+    return true;
+}
+
+namespace {
+
+// Everything one benchmark run opens, released in any exit order
+struct BenchContext {
+    AVFormatContext* format = nullptr;
+    AVCodecContext* codec = nullptr;
+    AVFrame* frame = nullptr;
+    AVPacket* packet = nullptr;
+    SwsContext* sws = nullptr;
+
+    ~BenchContext() {
+        sws_freeContext(sws);
+        av_packet_free(&packet);
+        av_frame_free(&frame);
+        avcodec_free_context(&codec);
+        avformat_close_input(&format);
+    }
+};
+
+}
+
+double DecoderProfiles::benchmark(const std::string& path, const std::string& decoder, int threads,
+                                  bool slice_threads, int sws_flags) {
+    BenchContext bench;
+    const AVCodec* codec = avcodec_find_decoder_by_name(decoder.c_str());
+    if (!codec || avformat_open_input(&bench.format, path.c_str(), nullptr, nullptr) < 0 ||
+        avformat_find_stream_info(bench.format, nullptr) < 0) {
+        return -1.0;
+    }
+    int stream = av_find_best_stream(bench.format, AVMEDIA_TYPE_VIDEO, -1, -1, nullptr, 0);
+    if (stream < 0) {
+        return -1.0;
+    }
+
+    bench.codec = avcodec_alloc_context3(codec);
+    if (!bench.codec || avcodec_parameters_to_context(bench.codec, bench.format->streams[stream]->codecpar) < 0) {
+        return -1.0;
+    }
+    bench.codec->thread_count = threads;
+    bench.codec->thread_type = slice_threads ? FF_THREAD_SLICE : FF_THREAD_FRAME;
+    if (avcodec_open2(bench.codec, codec, nullptr) < 0) {
+        return -1.0;
+    }
+    bench.frame = av_frame_alloc();
+    bench.packet = av_packet_alloc();
+    if (!bench.frame || !bench.packet) {
+        return -1.0;
+    }
+
+    // Decode and convert to RGBA, as the playback path does
+    std::vector<uint8_t> rgba;
+    uint8_t* rgba_data[4];
+    int rgba_linesize[4];
+    int decoded = 0;
+    bool flushed = false;
+    auto start = std::chrono::steady_clock::now();
+    while (decoded <= BENCH_FRAMES) {
+        if (decoded > 0 &&
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() > BENCH_SECONDS) {
+            break;
+        }
+
+        int ret = avcodec_receive_frame(bench.codec, bench.frame);
+        if (ret == 0) {
+            int width = bench.frame->width;
+            int height = bench.frame->height;
+            if (!bench.sws) {
+                bench.sws = sws_getContext(width, height, (AVPixelFormat)bench.frame->format, width, height,
+                                           AV_PIX_FMT_RGBA, sws_flags, nullptr, nullptr, nullptr);
+                rgba.resize(av_image_get_buffer_size(AV_PIX_FMT_RGBA, width, height, 1));
+                av_image_fill_arrays(rgba_data, rgba_linesize, rgba.data(), AV_PIX_FMT_RGBA, width, height, 1);
+                if (!bench.sws) {
+                    return -1.0;
+                }
+            }
+            sws_scale(bench.sws, bench.frame->data, bench.frame->linesize, 0, height, rgba_data, rgba_linesize);
+            av_frame_unref(bench.frame);
+
+            // The clock starts at the first picture: frame threads are filled by then
+            if (decoded == 0) {
+                start = std::chrono::steady_clock::now();
+            }
+            decoded++;
+            continue;
+        }
+        if (ret != AVERROR(EAGAIN) || flushed) {
+            break;
+        }
+
+        if (av_read_frame(bench.format, bench.packet) < 0) {
+            avcodec_send_packet(bench.codec, nullptr);
+            flushed = true;
+            continue;
+        }
+        if (bench.packet->stream_index == stream) {
+            avcodec_send_packet(bench.codec, bench.packet);
+        }
+        av_packet_unref(bench.packet);
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (decoded < 2 || seconds <= 0.0) {
+        return -1.0;
+    }
+    return (decoded - 1) / seconds;
+}
+
+int DecoderProfiles::run_autotune(const std::vector<std::string>& samples) {
+    av_log_set_level(AV_LOG_ERROR);
+
+    // Powers of two up to the core count, plus the core count itself
+    int cores = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<int> thread_counts;
+    for (int threads = 1; threads < cores && threads <= 16; threads *= 2) {
+        thread_counts.push_back(threads);
+    }
+    thread_counts.push_back(cores);
+
+    int tuned = 0;
+    for (const auto& sample : samples) {
+        AVFormatContext* format = nullptr;
+        int stream = -1;
+        if (avformat_open_input(&format, sample.c_str(), nullptr, nullptr) >= 0 &&
+            avformat_find_stream_info(format, nullptr) >= 0) {
+            stream = av_find_best_stream(format, AVMEDIA_TYPE_VIDEO, -1, -1, nullptr, 0);
+        }
+        if (stream < 0) {
+            std::cerr << "ERROR: No video stream in " << sample << std::endl;
+            avformat_close_input(&format);
+            continue;
+        }
+        AVCodecID codec_id = format->streams[stream]->codecpar->codec_id;
+        int width = format->streams[stream]->codecpar->width;
+        int height = format->streams[stream]->codecpar->height;
+        avformat_close_input(&format);
+
+        std::string codec_name = avcodec_get_name(codec_id);
+        std::string size_class = resolution_class(width, height);
+        std::cout << "AUTOTUNE: " << sample << " - " << codec_name << " " << width << "x" << height
+                  << " (" << size_class << ")" << std::endl;
+
+        // Every software decoder for the codec, every threading setup it supports
+        DecoderProfile best;
+        void* iterator = nullptr;
+        while (const AVCodec* codec = av_codec_iterate(&iterator)) {
+            if (!av_codec_is_decoder(codec) || codec->id != codec_id ||
+                (codec->capabilities & (AV_CODEC_CAP_HARDWARE | AV_CODEC_CAP_EXPERIMENTAL))) {
+                continue;
+            }
+            for (int threads : thread_counts) {
+                for (bool slice : { false, true }) {
+                    bool supported = threads == 1 ? !slice
+                                   : (slice ? (codec->capabilities & AV_CODEC_CAP_SLICE_THREADS)
+                                            : (codec->capabilities & AV_CODEC_CAP_FRAME_THREADS)) != 0;
+                    if (!supported) {
+                        continue;
+                    }
+                    double fps = benchmark(sample, codec->name, threads, slice, SWS_BILINEAR);
+                    std::cout << "  " << codec->name << " threads=" << threads << (slice ? " slice" : " frame")
+                              << ": " << (fps > 0.0 ? std::to_string((int)fps) + " fps" : std::string("failed")) << std::endl;
+                    if (fps > best.fps) {
+                        best.decoder = codec->name;
+                        best.threads = threads;
+                        best.slice_threads = slice;
+                        best.sws_flags = SWS_BILINEAR;
+                        best.fps = fps;
+                    }
+                }
+            }
+        }
+        if (best.fps <= 0.0) {
+            std::cerr << "ERROR: No decoder could play " << sample << std::endl;
+            continue;
+        }
+
+        // Scaler variant on the winning decoder; only a clear gain is worth the lower quality
+        double fast = benchmark(sample, best.decoder, best.threads, best.slice_threads, SWS_FAST_BILINEAR);
+        std::cout << "  scaler fast_bilinear: " << (int)fast << " fps" << std::endl;
+        if (fast > best.fps * 1.05) {
+            best.sws_flags = SWS_FAST_BILINEAR;
+            best.fps = fast;
+        }
+
+        std::cout << "AUTOTUNE: " << codec_name << " " << size_class << " -> " << best.decoder << ", "
+                  << best.threads << (best.slice_threads ? " slice" : " frame") << " threads, "
+                  << sws_flags_name(best.sws_flags) << " (" << (int)best.fps << " fps)" << std::endl;
+        if (store(codec_name, size_class, best)) {
+            tuned++;
+        } else {
+            std::cerr << "ERROR: Could not save decoder profile to " << get_profile_path() << std::endl;
+        }
+    }
+
+    std::cout << "AUTOTUNE: " << tuned << " profile(s) saved";
+    if (tuned > 0) {
+        std::cout << " to " << get_profile_path();
+    }
+    std::cout << std::endl;
+    return tuned > 0 ? 0 : 1;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// Decode settings that won the `autotune` benchmark for one codec at one
+// resolution class on this machine
+struct DecoderProfile {
+    std::string decoder;            // avcodec decoder name (e.g. libdav1d rather than libaom-av1)
+    int threads = 1;
+    bool slice_threads = false;     // Slice instead of frame threading
+    int sws_flags = 0;              // Scaler algorithm for the RGBA conversion
+    double fps = 0.0;               // Measured decode + convert rate, for the record
+};
+
+// Profiles are stored as one text line per codec/class in the cache
+// directory; setup_ffmpeg_decoder() looks them up and falls back to the
+// FFmpeg defaults (first registered decoder, one thread, bilinear) without one.
+class DecoderProfiles {
+public:
+    // "sd", "hd", "uhd" or "8k" by pixel count
+    static std::string resolution_class(int width, int height);
+
+    static bool lookup(const std::string& codec, int width, int height, DecoderProfile* profile);
+    static bool store(const std::string& codec, const std::string& resolution_class, const DecoderProfile& profile);
+
+    // `autotune <video>...`: benchmark every decoder, thread count, threading
+    // mode and scaler variant on each sample and keep the fastest. Returns the
+    // process exit code.
+    static int run_autotune(const std::vector<std::string>& samples);
+
+    static const char* sws_flags_name(int flags);
+    static int parse_sws_flags(const std::string& name);
+
+private:
+    static constexpr int BENCH_FRAMES = 120;        // Per candidate, after the first frame
+    static constexpr double BENCH_SECONDS = 2.0;    // Or until this much time has passed
+
+    static std::string get_profile_path();
+    static bool load_all(std::vector<std::pair<std::string, DecoderProfile>>* entries);
+
+    static double benchmark(const std::string& path, const std::string& decoder, int threads,
+                            bool slice_threads, int sws_flags);
+};
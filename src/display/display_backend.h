@@ -0,0 +1,37 @@
+#pragma once
+
+#include "display_manager.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+// Bumped whenever DisplayOutput or this table changes layout
+#define LWE_DISPLAY_BACKEND_ABI 5
+
+/**
+ * Entry table exported by each display backend module
+ * (liblwe-display-<name>.so, symbol lwe_display_backend_<name>).
+ *
+ * DisplayManager only dlopens the module for the protocol it detected, so a
+ * Wayland session never maps X11, Xrandr or SDL2 and vice versa. When the
+ * backends are linked statically the same tables are used directly.
+ */
+struct DisplayBackend {
+    int abi_version;
+    const char* name;
+    std::vector<std::unique_ptr<DisplayOutput>> (*get_outputs)();
+    std::unique_ptr<DisplayOutput> (*get_output_by_name)(const std::string& name);
+    std::unique_ptr<DisplayOutput> (*create_window)(int x, int y, int width, int height);
+    void (*pump_events)();
+};
+
+typedef const DisplayBackend* (*DisplayBackendEntry)();
+
+extern "C" {
+const DisplayBackend* lwe_display_backend_x11();
+const DisplayBackend* lwe_display_backend_wayland();
+const DisplayBackend* lwe_display_backend_sdl2();
+}
+
+// Returns the backend table for "x11", "wayland" or "sdl2", or nullptr
+const DisplayBackend* load_display_backend(const std::string& name);
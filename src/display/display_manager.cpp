@@ -1,14 +1,56 @@
 #include "display_manager.h"
-#include "x11/x11_display.h"
-#include "wayland/wayland_display.h"
-#include "sdl2_window_display.h"
+#include "display_backend.h"
+#include "../backend_loader.h"
 #include <cstdlib>
 #include <cstring>
 #include <iostream>
-#include <X11/Xlib.h>
-#include <wayland-client.h>
+#include <unistd.h>
 
-DisplayManager::DisplayManager() : protocol_(DisplayProtocol::UNKNOWN), initialized_(false) {}
+namespace {
+
+// Whether the socket WAYLAND_DISPLAY points at exists, without linking libwayland
+bool wayland_socket_exists() {
+    const char* name = std::getenv("WAYLAND_DISPLAY");
+    if (!name || !*name) {
+        return false;
+    }
+    std::string path = name;
+    if (path[0] != '/') {
+        const char* runtime_dir = std::getenv("XDG_RUNTIME_DIR");
+        if (!runtime_dir) {
+            return false;
+        }
+        path = std::string(runtime_dir) + "/" + path;
+    }
+    return access(path.c_str(), F_OK) == 0;
+}
+
+} // namespace
+
+const DisplayBackend* load_display_backend(const std::string& name) {
+#ifdef LWE_BACKEND_PLUGINS
+    auto entry = reinterpret_cast<DisplayBackendEntry>(load_backend_symbol("display", name));
+#else
+    DisplayBackendEntry entry = nullptr;
+    if (name == "x11") entry = lwe_display_backend_x11;
+    else if (name == "wayland") entry = lwe_display_backend_wayland;
+    else if (name == "sdl2") entry = lwe_display_backend_sdl2;
+#endif
+    if (!entry) {
+        return nullptr;
+    }
+    
+    const DisplayBackend* backend = entry();
+    if (!backend || backend->abi_version != LWE_DISPLAY_BACKEND_ABI) {
+        std::cerr << "ERROR: Display backend " << name << " was built for a different version" << std::endl;
+        return nullptr;
+    }
+    return backend;
+}
+
+DisplayManager::DisplayManager()
+    : protocol_(DisplayProtocol::UNKNOWN), backend_(nullptr), window_backend_(nullptr),
+      protocol_verified_(false), initialized_(false) {}
 
 DisplayManager::~DisplayManager() {
     cleanup();
@@ -28,32 +70,19 @@ DisplayProtocol DisplayManager::detect_protocol() {
               << ", WAYLAND_DISPLAY: " << (wayland_display ? wayland_display : "null")
               << ", DISPLAY: " << (display ? display : "null") << std::endl;
     
-    // Check if Wayland is available and working
+    // Decide from the environment alone; the first real output connection
+    // verifies the choice (see get_output_by_name) instead of a throwaway
+    // connect/disconnect here
     if (wayland_display && strlen(wayland_display) > 0) {
-        // Try to connect to Wayland to see if it's actually working
-        struct wl_display* wl_test = wl_display_connect(nullptr);
-        if (wl_test) {
-            wl_display_disconnect(wl_test);
-            protocol_ = DisplayProtocol::WAYLAND;
-            std::cout << "Detected Wayland display protocol" << std::endl;
-            return protocol_;
-        } else {
-            std::cout << "Wayland display available but connection failed, trying X11" << std::endl;
-        }
+        protocol_ = DisplayProtocol::WAYLAND;
+        std::cout << "Detected Wayland display protocol" << std::endl;
+        return protocol_;
     }
     
-    // Check if X11 is available
     if (display && strlen(display) > 0) {
-        // Try to connect to X11 to see if it's actually working
-        Display* x11_test = XOpenDisplay(nullptr);
-        if (x11_test) {
-            XCloseDisplay(x11_test);
-            protocol_ = DisplayProtocol::X11;
-            std::cout << "Detected X11 display protocol" << std::endl;
-            return protocol_;
-        } else {
-            std::cout << "X11 display available but connection failed" << std::endl;
-        }
+        protocol_ = DisplayProtocol::X11;
+        std::cout << "Detected X11 display protocol" << std::endl;
+        return protocol_;
     }
     
     // Final fallback based on session type
@@ -103,36 +132,52 @@ void DisplayManager::cleanup() {
     initialized_ = false;
 }
 
-std::vector<std::unique_ptr<DisplayOutput>> DisplayManager::get_outputs() {
-    std::vector<std::unique_ptr<DisplayOutput>> outputs;
-    
-    if (!initialized_) {
-        return outputs;
+const DisplayBackend* DisplayManager::protocol_backend() {
+    if (!backend_) {
+        switch (protocol_) {
+            case DisplayProtocol::X11:
+                backend_ = load_display_backend("x11");
+                break;
+            case DisplayProtocol::WAYLAND:
+                backend_ = load_display_backend("wayland");
+                break;
+            default:
+                break;
+        }
     }
-    
-    switch (protocol_) {
-        case DisplayProtocol::X11:
-            return X11Display::get_outputs();
-        case DisplayProtocol::WAYLAND:
-            return WaylandDisplay::get_outputs();
-        default:
-            return outputs;
+    return backend_;
+}
+
+std::vector<std::unique_ptr<DisplayOutput>> DisplayManager::get_outputs() {
+    if (!initialized_ || !protocol_backend()) {
+        return {};
     }
+    return backend_->get_outputs();
 }
 
 std::unique_ptr<DisplayOutput> DisplayManager::get_output_by_name(const std::string& name) {
-    if (!initialized_) {
+    if (!initialized_ || !protocol_backend()) {
         return nullptr;
     }
     
-    switch (protocol_) {
-        case DisplayProtocol::X11:
-            return X11Display::get_output_by_name(name);
-        case DisplayProtocol::WAYLAND:
-            return WaylandDisplay::get_output_by_name(name);
-        default:
-            return nullptr;
+    auto output = backend_->get_output_by_name(name);
+    if (output || protocol_ != DisplayProtocol::WAYLAND) {
+        protocol_verified_ = protocol_verified_ || output != nullptr;
+        return output;
+    }
+    
+    // WAYLAND_DISPLAY may be stale (e.g. an X11 session started from a
+    // Wayland terminal); fall back to X11 if nothing has connected yet
+    const char* display = std::getenv("DISPLAY");
+    if (!protocol_verified_ && display && strlen(display) > 0 && !wayland_socket_exists()) {
+        std::cout << "Wayland display available but connection failed, trying X11" << std::endl;
+        protocol_ = DisplayProtocol::X11;
+        backend_ = nullptr;
+        if (protocol_backend()) {
+            return backend_->get_output_by_name(name);
+        }
     }
+    return nullptr;
 }
 
 std::unique_ptr<DisplayOutput> DisplayManager::create_window(int x, int y, int width, int height) {
@@ -144,7 +189,11 @@ std::unique_ptr<DisplayOutput> DisplayManager::create_window(int x, int y, int w
     // SDL2 provides excellent performance and works on all platforms
     std::cout << "DEBUG: Creating SDL2 window (universal cross-platform)" << std::endl;
     
-    auto sdl2_window = SDL2WindowDisplay::create_window(x, y, width, height);
+    if (!window_backend_) {
+        window_backend_ = load_display_backend("sdl2");
+    }
+    
+    auto sdl2_window = window_backend_ ? window_backend_->create_window(x, y, width, height) : nullptr;
     if (sdl2_window) {
         std::cout << "DEBUG: Successfully created SDL2 window" << std::endl;
         return sdl2_window;
@@ -153,3 +202,9 @@ std::unique_ptr<DisplayOutput> DisplayManager::create_window(int x, int y, int w
     std::cerr << "ERROR: Failed to create SDL2 window" << std::endl;
     return nullptr;
 }
+
+void DisplayManager::pump_window_events() {
+    if (window_backend_ && window_backend_->pump_events) {
+        window_backend_->pump_events();
+    }
+}
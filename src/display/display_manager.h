@@ -4,6 +4,13 @@
 #include <memory>
 #include <vector>
 
+#include "post_effects.h"
+#include "letterbox_fill.h"
+#include "video_frame.h"
+
+struct DisplayBackend;
+class StatsOverlay;
+
 enum class DisplayProtocol {
     X11,
     WAYLAND,
@@ -37,6 +44,57 @@ public:
     virtual bool set_background(const std::string& media_path, ScalingMode scaling) = 0;
     virtual void update() = 0;
     virtual std::string get_name() const = 0;
+    
+    // Output rectangle in desktop coordinates (used to span one wallpaper
+    // across several monitors). Returns false if the backend cannot tell.
+    virtual bool get_geometry(int& x, int& y, int& width, int& height) const { return false; }
+    
+    // Frame submission. Backends live in separately loaded modules, so the
+    // application only talks to them through this interface.
+    virtual bool render_image_data(const unsigned char* image_data, int img_width, int img_height, ScalingMode scaling) { return false; }
+    // Video frames come as descriptors: backends choose their path by pixel
+    // format and stride. YUV is only sent when supports_yuv_textures() is true.
+    virtual bool render_frame(const VideoFrame& frame, ScalingMode scaling) { return false; }
+    virtual bool supports_yuv_textures() const { return false; }
+    // False when the last render_frame() returned true but only skipped the
+    // frame (window pacing, compositor throttling); callers offer it again
+    virtual bool was_frame_presented() const { return true; }
+    
+    // Bring up GPU video streaming if the backend has one (true = active)
+    virtual bool enable_gl_video() { return false; }
+    
+    // Detach the output's GL context from the calling thread so the next
+    // present may make it current on another one (--scheduler workers)
+    virtual void release_thread_context() {}
+    
+    // Cinemagraph mode: keep video on the CPU path and only rescale/damage the
+    // tiles that changed (false if the backend has no partial-update path)
+    virtual bool set_dirty_tracking(bool enabled) { return false; }
+    
+    // Upload frames at source resolution and let the display server scale
+    // them (X11 XRender); false if the backend has no server-side scaler
+    virtual bool set_server_scaling(bool enabled) { return false; }
+    
+    // Color effects folded into the scaling pass (false if unsupported)
+    virtual bool set_post_effects(const PostEffects& effects) { return false; }
+    
+    // What fills the FIT/DEFAULT bars (false if the backend only has black)
+    virtual bool set_letterbox(const LetterboxSettings& settings) { return false; }
+    
+    // Performance HUD drawn into every presented frame; the output reports its
+    // scale/present times to it (false if the backend cannot draw it)
+    virtual bool set_stats_overlay(StatsOverlay* overlay) { return false; }
+    
+    // Rectangle of a named monitor relative to this output (X11 root outputs)
+    virtual bool get_monitor_geometry(const std::string& name, int& x, int& y, int& width, int& height) const { return false; }
+    
+    // True once after a resize/reconfigure: the next frame must be presented
+    // even if the decoder reported it unchanged
+    virtual bool consume_geometry_change() { return false; }
+    
+    // Preview windows
+    virtual void set_target_fps(int fps) {}
+    virtual bool should_close() const { return false; }
 };
 
 class DisplayManager {
@@ -54,8 +112,14 @@ public:
     
     // For windowed mode
     std::unique_ptr<DisplayOutput> create_window(int x, int y, int width, int height);
+    void pump_window_events();
 
 private:
     DisplayProtocol protocol_;
+    const DisplayBackend* backend_;         // Module for protocol_, loaded on first use
+    const DisplayBackend* window_backend_;  // SDL2 preview windows
+    bool protocol_verified_;    // A real output connection succeeded with protocol_
     bool initialized_;
+    
+    const DisplayBackend* protocol_backend();
 };
@@ -0,0 +1,655 @@
+#include "gl_video_renderer.h"
+#include "../media_player.h"
+#include "stats_overlay.h"
+#include <iostream>
+#include <cstring>
+#include <algorithm>
+#include <string>
+
+namespace {
+
+const char* VERTEX_SHADER = R"(#version 120
+attribute vec2 a_position;
+attribute vec2 a_texcoord;
+varying vec2 v_texcoord;
+void main() {
+    v_texcoord = a_texcoord;
+    gl_Position = vec4(a_position, 0.0, 1.0);
+}
+)";
+
+// Prepended to every fragment shader: post effects are a few ALU ops on the
+// final color, so the identity settings cost next to nothing
+const char* FRAGMENT_PREAMBLE = R"(#version 120
+uniform vec3 u_gain;
+uniform float u_desaturate;
+uniform float u_vignette;
+uniform vec2 u_viewport;
+vec3 apply_effects(vec3 color) {
+    float luma = dot(color, vec3(0.299, 0.587, 0.114));
+    color = mix(color, vec3(luma), u_desaturate) * u_gain;
+    vec2 d = gl_FragCoord.xy / u_viewport * 2.0 - 1.0;
+    vec2 falloff = max(1.0 - u_vignette * d * d, 0.0);
+    return color * falloff.x * falloff.y;
+}
+)";
+
+const char* RGBA_FRAGMENT_SHADER = R"(
+uniform sampler2D u_plane0;
+varying vec2 v_texcoord;
+void main() {
+    gl_FragColor = vec4(apply_effects(texture2D(u_plane0, v_texcoord).rgb), 1.0);
+}
+)";
+
+const char* I420_FRAGMENT_SHADER = R"(
+uniform sampler2D u_plane0;
+uniform sampler2D u_plane1;
+uniform sampler2D u_plane2;
+uniform vec3 u_offset;
+uniform vec3 u_scale;
+uniform mat3 u_matrix;
+varying vec2 v_texcoord;
+void main() {
+    vec3 yuv = vec3(texture2D(u_plane0, v_texcoord).r,
+                    texture2D(u_plane1, v_texcoord).r,
+                    texture2D(u_plane2, v_texcoord).r);
+    gl_FragColor = vec4(apply_effects(clamp(u_matrix * ((yuv - u_offset) * u_scale), 0.0, 1.0)), 1.0);
+}
+)";
+
+const char* NV12_FRAGMENT_SHADER = R"(
+uniform sampler2D u_plane0;
+uniform sampler2D u_plane1;
+uniform vec3 u_offset;
+uniform vec3 u_scale;
+uniform mat3 u_matrix;
+varying vec2 v_texcoord;
+void main() {
+    vec3 yuv = vec3(texture2D(u_plane0, v_texcoord).r,
+                    texture2D(u_plane1, v_texcoord).ra);
+    gl_FragColor = vec4(apply_effects(clamp(u_matrix * ((yuv - u_offset) * u_scale), 0.0, 1.0)), 1.0);
+}
+)";
+
+const GLuint ATTRIB_POSITION = 0;
+const GLuint ATTRIB_TEXCOORD = 1;
+
+GLuint compile_shader(GLenum type, const char* source) {
+    GLuint shader = glCreateShader(type);
+    glShaderSource(shader, 1, &source, nullptr);
+    glCompileShader(shader);
+
+    GLint status = GL_FALSE;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+    if (status != GL_TRUE) {
+        char log[1024];
+        glGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+        std::cerr << "ERROR: Shader compilation failed: " << log << std::endl;
+        glDeleteShader(shader);
+        return 0;
+    }
+    return shader;
+}
+
+} // namespace
+
+GLVideoRenderer::GLVideoRenderer()
+    : initialized_(false), pbo_supported_(false), format_(FrameFormat::NONE),
+      frame_width_(0), frame_height_(0), full_range_(false), plane_count_(0),
+      pbos_{0, 0, 0}, pbo_index_(0),
+      backdrop_texture_(0), backdrop_dirty_(false),
+      overlay_(nullptr), overlay_texture_(0), overlay_generation_(0),
+      rgba_program_(0), i420_program_(0), nv12_program_(0) {}
+
+GLVideoRenderer::~GLVideoRenderer() {
+    // GL objects belong to the owner's context, which may already be gone here;
+    // owners release them through cleanup() while the context is current
+}
+
+bool GLVideoRenderer::initialize() {
+    if (initialized_) {
+        return true;
+    }
+
+    // GLEW may report an error on EGL-only (Wayland) setups even though the
+    // entry points resolved, so check the functions actually needed instead
+    static bool glew_initialized = false;
+    if (!glew_initialized) {
+        glewExperimental = GL_TRUE;
+        GLenum err = glewInit();
+        if (err != GLEW_OK) {
+            std::cout << "DEBUG: glewInit reported: " << glewGetErrorString(err) << std::endl;
+        }
+        glew_initialized = true;
+    }
+
+    if (!glCreateShader || !glShaderSource || !glUseProgram || !glVertexAttribPointer) {
+        std::cerr << "ERROR: OpenGL 2.0 shader support not available" << std::endl;
+        return false;
+    }
+
+    pbo_supported_ = glGenBuffers && glBufferData && glMapBuffer && glUnmapBuffer;
+    if (pbo_supported_) {
+        glGenBuffers(PBO_RING_SIZE, pbos_);
+    } else {
+        std::cout << "DEBUG: Pixel buffer objects unavailable, uploading from client memory" << std::endl;
+    }
+
+    rgba_program_ = build_program(RGBA_FRAGMENT_SHADER);
+    i420_program_ = build_program(I420_FRAGMENT_SHADER);
+    nv12_program_ = build_program(NV12_FRAGMENT_SHADER);
+    if (!rgba_program_ || !i420_program_ || !nv12_program_) {
+        cleanup();
+        return false;
+    }
+
+    const char* renderer = reinterpret_cast<const char*>(glGetString(GL_RENDERER));
+    std::cout << "DEBUG: GL video renderer ready on " << (renderer ? renderer : "unknown")
+              << (pbo_supported_ ? " (PBO streaming)" : "") << std::endl;
+
+    initialized_ = true;
+    return true;
+}
+
+void GLVideoRenderer::cleanup() {
+    destroy_planes();
+
+    if (backdrop_texture_) {
+        glDeleteTextures(1, &backdrop_texture_);
+        backdrop_texture_ = 0;
+    }
+    if (overlay_texture_) {
+        glDeleteTextures(1, &overlay_texture_);
+        overlay_texture_ = 0;
+    }
+
+    if (pbos_[0]) {
+        glDeleteBuffers(PBO_RING_SIZE, pbos_);
+        std::fill(pbos_, pbos_ + PBO_RING_SIZE, 0);
+    }
+
+    GLuint* programs[] = { &rgba_program_, &i420_program_, &nv12_program_ };
+    for (GLuint* program : programs) {
+        if (*program) {
+            glDeleteProgram(*program);
+            *program = 0;
+        }
+    }
+
+    format_ = FrameFormat::NONE;
+    initialized_ = false;
+}
+
+GLuint GLVideoRenderer::build_program(const char* fragment_source) {
+    std::string fragment = std::string(FRAGMENT_PREAMBLE) + fragment_source;
+    GLuint vertex_shader = compile_shader(GL_VERTEX_SHADER, VERTEX_SHADER);
+    GLuint fragment_shader = compile_shader(GL_FRAGMENT_SHADER, fragment.c_str());
+    if (!vertex_shader || !fragment_shader) {
+        if (vertex_shader) glDeleteShader(vertex_shader);
+        if (fragment_shader) glDeleteShader(fragment_shader);
+        return 0;
+    }
+
+    GLuint program = glCreateProgram();
+    glAttachShader(program, vertex_shader);
+    glAttachShader(program, fragment_shader);
+    glBindAttribLocation(program, ATTRIB_POSITION, "a_position");
+    glBindAttribLocation(program, ATTRIB_TEXCOORD, "a_texcoord");
+    glLinkProgram(program);
+    glDeleteShader(vertex_shader);
+    glDeleteShader(fragment_shader);
+
+    GLint status = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &status);
+    if (status != GL_TRUE) {
+        char log[1024];
+        glGetProgramInfoLog(program, sizeof(log), nullptr, log);
+        std::cerr << "ERROR: Shader program link failed: " << log << std::endl;
+        glDeleteProgram(program);
+        return 0;
+    }
+
+    // Sampler units never change
+    glUseProgram(program);
+    const char* samplers[] = { "u_plane0", "u_plane1", "u_plane2" };
+    for (int i = 0; i < MAX_PLANES; i++) {
+        GLint location = glGetUniformLocation(program, samplers[i]);
+        if (location >= 0) {
+            glUniform1i(location, i);
+        }
+    }
+    glUseProgram(0);
+    return program;
+}
+
+void GLVideoRenderer::destroy_planes() {
+    for (int i = 0; i < plane_count_; i++) {
+        if (planes_[i].texture) {
+            glDeleteTextures(1, &planes_[i].texture);
+        }
+        planes_[i] = Plane();
+    }
+    plane_count_ = 0;
+    frame_width_ = 0;
+    frame_height_ = 0;
+}
+
+bool GLVideoRenderer::ensure_planes(FrameFormat format, int width, int height) {
+    if (format == format_ && width == frame_width_ && height == frame_height_ && plane_count_ > 0) {
+        return true;
+    }
+
+    destroy_planes();
+
+    int chroma_width = (width + 1) / 2;
+    int chroma_height = (height + 1) / 2;
+    switch (format) {
+        case FrameFormat::RGBA:
+            plane_count_ = 1;
+            planes_[0] = { 0, width, height, GL_RGBA, 4 };
+            break;
+        case FrameFormat::I420:
+            plane_count_ = 3;
+            planes_[0] = { 0, width, height, GL_LUMINANCE, 1 };
+            planes_[1] = { 0, chroma_width, chroma_height, GL_LUMINANCE, 1 };
+            planes_[2] = { 0, chroma_width, chroma_height, GL_LUMINANCE, 1 };
+            break;
+        case FrameFormat::NV12:
+            plane_count_ = 2;
+            planes_[0] = { 0, width, height, GL_LUMINANCE, 1 };
+            planes_[1] = { 0, chroma_width, chroma_height, GL_LUMINANCE_ALPHA, 2 };
+            break;
+        default:
+            return false;
+    }
+
+    // Allocate storage once; frames are streamed in with glTexSubImage2D
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    for (int i = 0; i < plane_count_; i++) {
+        Plane& plane = planes_[i];
+        glGenTextures(1, &plane.texture);
+        glBindTexture(GL_TEXTURE_2D, plane.texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexImage2D(GL_TEXTURE_2D, 0, plane.format, plane.width, plane.height, 0,
+                     plane.format, GL_UNSIGNED_BYTE, nullptr);
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    if (glGetError() != GL_NO_ERROR) {
+        std::cerr << "ERROR: Failed to allocate " << width << "x" << height << " frame textures" << std::endl;
+        destroy_planes();
+        format_ = FrameFormat::NONE;
+        return false;
+    }
+
+    format_ = format;
+    frame_width_ = width;
+    frame_height_ = height;
+    std::cout << "DEBUG: GL frame textures allocated: " << width << "x" << height
+              << " (" << plane_count_ << " planes)" << std::endl;
+    return true;
+}
+
+bool GLVideoRenderer::upload_planes(const PlaneData* data) {
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    // Row length in pixels lets GL read padded decoder rows directly;
+    // odd pitches (not a whole number of pixels) are repacked tightly
+    int row_lengths[MAX_PLANES];
+    size_t offsets[MAX_PLANES];
+    size_t total_size = 0;
+    for (int i = 0; i < plane_count_; i++) {
+        const Plane& plane = planes_[i];
+        bool padded = data[i].pitch >= plane.width * plane.bytes_per_pixel &&
+                      data[i].pitch % plane.bytes_per_pixel == 0;
+        row_lengths[i] = padded ? data[i].pitch / plane.bytes_per_pixel : plane.width;
+        offsets[i] = total_size;
+        total_size += (size_t)row_lengths[i] * plane.bytes_per_pixel * plane.height;
+    }
+
+    unsigned char* mapped = nullptr;
+    if (pbo_supported_) {
+        // Orphan the next buffer in the ring so the driver never stalls on a
+        // transfer that is still in flight
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbos_[pbo_index_]);
+        pbo_index_ = (pbo_index_ + 1) % PBO_RING_SIZE;
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, total_size, nullptr, GL_STREAM_DRAW);
+        mapped = static_cast<unsigned char*>(glMapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY));
+        if (!mapped) {
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        }
+    }
+
+    if (mapped) {
+        for (int i = 0; i < plane_count_; i++) {
+            const Plane& plane = planes_[i];
+            size_t row_bytes = (size_t)row_lengths[i] * plane.bytes_per_pixel;
+            if ((size_t)data[i].pitch == row_bytes) {
+                std::memcpy(mapped + offsets[i], data[i].data, row_bytes * plane.height);
+            } else {
+                for (int y = 0; y < plane.height; y++) {
+                    std::memcpy(mapped + offsets[i] + y * row_bytes, data[i].data + (size_t)y * data[i].pitch,
+                                (size_t)plane.width * plane.bytes_per_pixel);
+                }
+            }
+        }
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+    }
+
+    for (int i = 0; i < plane_count_; i++) {
+        const Plane& plane = planes_[i];
+        glBindTexture(GL_TEXTURE_2D, plane.texture);
+        if (mapped) {
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, row_lengths[i]);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, plane.width, plane.height, plane.format, GL_UNSIGNED_BYTE,
+                            reinterpret_cast<const void*>(offsets[i]));
+        } else {
+            bool padded = data[i].pitch % plane.bytes_per_pixel == 0;
+            if (padded) {
+                glPixelStorei(GL_UNPACK_ROW_LENGTH, data[i].pitch / plane.bytes_per_pixel);
+                glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, plane.width, plane.height, plane.format, GL_UNSIGNED_BYTE,
+                                data[i].data);
+            } else {
+                glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+                for (int y = 0; y < plane.height; y++) {
+                    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, y, plane.width, 1, plane.format, GL_UNSIGNED_BYTE,
+                                    data[i].data + (size_t)y * data[i].pitch);
+                }
+            }
+        }
+    }
+
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    if (mapped) {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    }
+    return true;
+}
+
+bool GLVideoRenderer::upload(const VideoFrame& frame) {
+    if (!initialized_ || !frame.is_valid()) {
+        return false;
+    }
+
+    FrameFormat format = FrameFormat::RGBA;
+    if (frame.format == VideoPixelFormat::I420) {
+        format = FrameFormat::I420;
+    } else if (frame.format == VideoPixelFormat::NV12) {
+        format = FrameFormat::NV12;
+    }
+    if (!ensure_planes(format, frame.width, frame.height)) {
+        return false;
+    }
+
+    if (letterbox_.update(frame)) {
+        backdrop_dirty_ = true;
+    }
+
+    full_range_ = frame.full_range;
+    PlaneData planes[MAX_PLANES] = {
+        { frame.planes[0], frame.strides[0] },
+        { frame.planes[1], frame.strides[1] },
+        { frame.planes[2], frame.strides[2] }
+    };
+    return upload_planes(planes);
+}
+
+void GLVideoRenderer::set_color_uniforms(GLuint program) {
+    // Same choice as SDL's automatic mode: JPEG range for full-range sources,
+    // BT.709 for HD and BT.601 below 720 lines
+    bool bt709 = !full_range_ && frame_height_ >= 720;
+    float offset[3];
+    float scale[3];
+    if (full_range_) {
+        offset[0] = 0.0f;
+        scale[0] = 1.0f;
+        scale[1] = scale[2] = 1.0f;
+    } else {
+        offset[0] = 16.0f / 255.0f;
+        scale[0] = 255.0f / 219.0f;
+        scale[1] = scale[2] = 255.0f / 224.0f;
+    }
+    offset[1] = offset[2] = 128.0f / 255.0f;
+
+    // Column-major: columns are the Y, U and V contributions to RGB
+    const float bt601[9] = { 1.0f, 1.0f, 1.0f,   0.0f, -0.344136f, 1.772f,   1.402f, -0.714136f, 0.0f };
+    const float bt709_matrix[9] = { 1.0f, 1.0f, 1.0f,   0.0f, -0.187324f, 1.8556f,   1.5748f, -0.468124f, 0.0f };
+
+    glUniform3fv(glGetUniformLocation(program, "u_offset"), 1, offset);
+    glUniform3fv(glGetUniformLocation(program, "u_scale"), 1, scale);
+    glUniformMatrix3fv(glGetUniformLocation(program, "u_matrix"), 1, GL_FALSE, bt709 ? bt709_matrix : bt601);
+}
+
+void GLVideoRenderer::set_effect_uniforms(GLuint program, const PostEffects& effects,
+                                          int surface_width, int surface_height) {
+    float brightness = 1.0f - std::clamp(effects.dim, 0.0f, 1.0f);
+    float gain[3];
+    for (int i = 0; i < 3; i++) {
+        gain[i] = brightness * std::clamp(effects.tint[i], 0.0f, 1.0f);
+    }
+
+    glUniform3fv(glGetUniformLocation(program, "u_gain"), 1, gain);
+    glUniform1f(glGetUniformLocation(program, "u_desaturate"), std::clamp(effects.desaturate, 0.0f, 1.0f));
+    glUniform1f(glGetUniformLocation(program, "u_vignette"), effects.vignette_axis_strength());
+    glUniform2f(glGetUniformLocation(program, "u_viewport"), (float)surface_width, (float)surface_height);
+}
+
+void GLVideoRenderer::calculate_quad(int surface_width, int surface_height, ScalingMode scaling,
+                                     float* positions) const {
+    // Quad size in normalized device coordinates; FILL overflows and is clipped by the viewport
+    float quad_width = 1.0f;
+    float quad_height = 1.0f;
+    double frame_aspect = (double)frame_width_ / frame_height_;
+    double surface_aspect = (double)surface_width / surface_height;
+
+    switch (scaling) {
+        case ScalingMode::STRETCH:
+            break;
+        case ScalingMode::FILL:
+            if (frame_aspect > surface_aspect) {
+                quad_width = (float)(frame_aspect / surface_aspect);
+            } else {
+                quad_height = (float)(surface_aspect / frame_aspect);
+            }
+            break;
+        case ScalingMode::FIT:
+        case ScalingMode::DEFAULT:
+        default:
+            if (frame_aspect > surface_aspect) {
+                quad_height = (float)(surface_aspect / frame_aspect);
+            } else {
+                quad_width = (float)(frame_aspect / surface_aspect);
+            }
+            break;
+    }
+
+    // Triangle strip: top-left, bottom-left, top-right, bottom-right
+    const float corners[8] = {
+        -quad_width,  quad_height,
+        -quad_width, -quad_height,
+         quad_width,  quad_height,
+         quad_width, -quad_height
+    };
+    std::memcpy(positions, corners, sizeof(corners));
+}
+
+bool GLVideoRenderer::draw(int surface_width, int surface_height, ScalingMode scaling) {
+    if (!initialized_ || surface_width <= 0 || surface_height <= 0) {
+        return false;
+    }
+
+    glViewport(0, 0, surface_width, surface_height);
+    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    if (format_ == FrameFormat::NONE) {
+        return true;
+    }
+
+    float positions[8];
+    calculate_quad(surface_width, surface_height, scaling, positions);
+    if (positions[4] < 1.0f || positions[1] < 1.0f) {
+        // Letterboxed: fill the bars before the frame goes on top
+        draw_backdrop(surface_width, surface_height);
+    }
+
+    GLuint program = format_ == FrameFormat::RGBA ? rgba_program_ :
+                     format_ == FrameFormat::NV12 ? nv12_program_ : i420_program_;
+    glUseProgram(program);
+    if (format_ != FrameFormat::RGBA) {
+        set_color_uniforms(program);
+    }
+    set_effect_uniforms(program, effects_, surface_width, surface_height);
+
+    for (int i = 0; i < plane_count_; i++) {
+        glActiveTexture(GL_TEXTURE0 + i);
+        glBindTexture(GL_TEXTURE_2D, planes_[i].texture);
+    }
+    glActiveTexture(GL_TEXTURE0);
+
+    // Texture row 0 is the top of the frame
+    const float texcoords[8] = {
+        0.0f, 0.0f,
+        0.0f, 1.0f,
+        1.0f, 0.0f,
+        1.0f, 1.0f
+    };
+    draw_quad(positions, texcoords);
+
+    for (int i = plane_count_ - 1; i >= 0; i--) {
+        glActiveTexture(GL_TEXTURE0 + i);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+    if (overlay_) {
+        draw_overlay(surface_width, surface_height);
+    }
+    glUseProgram(0);
+
+    GLenum error = glGetError();
+    if (error != GL_NO_ERROR) {
+        std::cerr << "ERROR: GL frame draw failed: 0x" << std::hex << error << std::dec << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void GLVideoRenderer::draw_quad(const float* positions, const float* texcoords) {
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glEnableVertexAttribArray(ATTRIB_POSITION);
+    glEnableVertexAttribArray(ATTRIB_TEXCOORD);
+    glVertexAttribPointer(ATTRIB_POSITION, 2, GL_FLOAT, GL_FALSE, 0, positions);
+    glVertexAttribPointer(ATTRIB_TEXCOORD, 2, GL_FLOAT, GL_FALSE, 0, texcoords);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    glDisableVertexAttribArray(ATTRIB_POSITION);
+    glDisableVertexAttribArray(ATTRIB_TEXCOORD);
+}
+
+void GLVideoRenderer::draw_backdrop(int surface_width, int surface_height) {
+    if (!letterbox_.is_enabled() || !letterbox_.has_image()) {
+        return;
+    }
+
+    if (!backdrop_texture_) {
+        glGenTextures(1, &backdrop_texture_);
+        glBindTexture(GL_TEXTURE_2D, backdrop_texture_);
+        // Bilinear magnification of the blurred thumbnail is the upscale
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        backdrop_dirty_ = true;
+    } else {
+        glBindTexture(GL_TEXTURE_2D, backdrop_texture_);
+    }
+    if (backdrop_dirty_) {
+        // A few kilobytes a few times per second - no PBO needed
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, letterbox_.get_width(), letterbox_.get_height(), 0,
+                     GL_RGBA, GL_UNSIGNED_BYTE, letterbox_.get_pixels());
+        backdrop_dirty_ = false;
+    }
+
+    // Cover-crop the thumbnail to the viewport aspect
+    double thumb_aspect = (double)letterbox_.get_width() / letterbox_.get_height();
+    double surface_aspect = (double)surface_width / surface_height;
+    float span_u = 1.0f;
+    float span_v = 1.0f;
+    if (thumb_aspect > surface_aspect) {
+        span_u = (float)(surface_aspect / thumb_aspect);
+    } else {
+        span_v = (float)(thumb_aspect / surface_aspect);
+    }
+    float u0 = 0.5f - span_u * 0.5f;
+    float u1 = 0.5f + span_u * 0.5f;
+    float v0 = 0.5f - span_v * 0.5f;
+    float v1 = 0.5f + span_v * 0.5f;
+
+    const float positions[8] = {
+        -1.0f,  1.0f,
+        -1.0f, -1.0f,
+         1.0f,  1.0f,
+         1.0f, -1.0f
+    };
+    const float texcoords[8] = {
+        u0, v0,
+        u0, v1,
+        u1, v0,
+        u1, v1
+    };
+
+    glUseProgram(rgba_program_);
+    set_effect_uniforms(rgba_program_, effects_, surface_width, surface_height);
+    glActiveTexture(GL_TEXTURE0);
+    draw_quad(positions, texcoords);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void GLVideoRenderer::draw_overlay(int surface_width, int surface_height) {
+    overlay_->refresh();
+    glActiveTexture(GL_TEXTURE0);
+    if (!overlay_texture_) {
+        glGenTextures(1, &overlay_texture_);
+        glBindTexture(GL_TEXTURE_2D, overlay_texture_);
+        // Drawn 1:1, so nearest sampling keeps the font crisp
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        overlay_generation_ = overlay_->get_generation() - 1;
+    } else {
+        glBindTexture(GL_TEXTURE_2D, overlay_texture_);
+    }
+    if (overlay_generation_ != overlay_->get_generation()) {
+        // Gray levels only, so the bytes are valid RGBA as they are
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, overlay_->get_width(), overlay_->get_height(), 0,
+                     GL_RGBA, GL_UNSIGNED_BYTE, overlay_->get_pixels());
+        overlay_generation_ = overlay_->get_generation();
+    }
+
+    float left = -1.0f + 2.0f * StatsOverlay::MARGIN / surface_width;
+    float right = -1.0f + 2.0f * (StatsOverlay::MARGIN + overlay_->get_width()) / surface_width;
+    float top = 1.0f - 2.0f * StatsOverlay::MARGIN / surface_height;
+    float bottom = 1.0f - 2.0f * (StatsOverlay::MARGIN + overlay_->get_height()) / surface_height;
+    const float positions[8] = {
+        left,  top,
+        left,  bottom,
+        right, top,
+        right, bottom
+    };
+    const float texcoords[8] = {
+        0.0f, 0.0f,
+        0.0f, 1.0f,
+        1.0f, 0.0f,
+        1.0f, 1.0f
+    };
+
+    // The HUD itself is not dimmed or vignetted
+    glUseProgram(rgba_program_);
+    set_effect_uniforms(rgba_program_, PostEffects(), surface_width, surface_height);
+    draw_quad(positions, texcoords);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "display_manager.h"
+#include "post_effects.h"
+#include "letterbox_fill.h"
+#include "video_frame.h"
+#include <GL/glew.h>
+
+/**
+ * Streaming OpenGL frame presenter shared by the EGL display paths.
+ *
+ * Textures are created once per frame size and updated in place through a
+ * small ring of pixel-buffer objects, so the driver can DMA one frame while
+ * the next is being filled. Planar YUV is converted to RGB and scaled in a
+ * fragment shader - the CPU only copies plane data into the PBO.
+ *
+ * Sticks to GL 2.1 / GLSL 1.20 with luminance textures so it also runs on
+ * Mesa llvmpipe. Every method must be called with the owner's context current;
+ * call cleanup() before the context is destroyed.
+ */
+class GLVideoRenderer {
+public:
+    GLVideoRenderer();
+    ~GLVideoRenderer();
+
+    bool initialize();
+    void cleanup();
+    bool is_initialized() const { return initialized_; }
+
+    // Stream a new frame into the persistent textures (any VideoPixelFormat,
+    // padded rows are read in place)
+    bool upload(const VideoFrame& frame);
+    bool has_frame() const { return format_ != FrameFormat::NONE; }
+
+    // Draw the last uploaded frame into a surface_width x surface_height viewport
+    bool draw(int surface_width, int surface_height, ScalingMode scaling);
+    
+    // Dim/desaturate/tint/vignette, evaluated in the same fragment shader
+    void set_post_effects(const PostEffects& effects) { effects_ = effects; }
+    
+    // Blurred backdrop behind FIT/DEFAULT frames: a thumbnail of every few
+    // frames uploaded as a tiny texture and stretched over the whole viewport
+    void set_letterbox(const LetterboxSettings& settings) { letterbox_.configure(settings); }
+    
+    // Performance HUD drawn as a small quad on top of the frame (nullptr = off)
+    void set_stats_overlay(StatsOverlay* overlay) { overlay_ = overlay; }
+
+private:
+    enum class FrameFormat { NONE, RGBA, I420, NV12 };
+
+    struct Plane {
+        GLuint texture = 0;
+        int width = 0;
+        int height = 0;
+        GLenum format = GL_LUMINANCE;   // GL_LUMINANCE, GL_LUMINANCE_ALPHA or GL_RGBA
+        int bytes_per_pixel = 1;
+    };
+
+    struct PlaneData {
+        const unsigned char* data;
+        int pitch;
+    };
+
+    static constexpr int PBO_RING_SIZE = 3;
+    static constexpr int MAX_PLANES = 3;
+
+    bool initialized_;
+    bool pbo_supported_;
+    FrameFormat format_;
+    int frame_width_;
+    int frame_height_;
+    bool full_range_;
+
+    Plane planes_[MAX_PLANES];
+    int plane_count_;
+
+    GLuint pbos_[PBO_RING_SIZE];
+    int pbo_index_;
+
+    PostEffects effects_;
+
+    LetterboxFill letterbox_;
+    GLuint backdrop_texture_;
+    bool backdrop_dirty_;
+
+    StatsOverlay* overlay_;
+    GLuint overlay_texture_;
+    unsigned long overlay_generation_;
+
+    GLuint rgba_program_;
+    GLuint i420_program_;
+    GLuint nv12_program_;
+
+    bool ensure_planes(FrameFormat format, int width, int height);
+    void destroy_planes();
+    bool upload_planes(const PlaneData* data);
+    GLuint build_program(const char* fragment_source);
+    void set_color_uniforms(GLuint program);
+    void set_effect_uniforms(GLuint program, const PostEffects& effects, int surface_width, int surface_height);
+    void calculate_quad(int surface_width, int surface_height, ScalingMode scaling, float* positions) const;
+    void draw_backdrop(int surface_width, int surface_height);
+    void draw_overlay(int surface_width, int surface_height);
+    void draw_quad(const float* positions, const float* texcoords);
+};
@@ -0,0 +1,309 @@
+#include "letterbox_fill.h"
+#include "post_effects.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+constexpr int BLUR_RADIUS = 2;              // Thumbnail pixels, i.e. ~32 output pixels per pass
+constexpr int BLUR_PASSES = 2;              // Two box passes approximate a gaussian
+constexpr int BACKDROP_BRIGHTNESS = 180;    // 0-256, keeps the bars behind the content
+
+inline unsigned char clamp_channel(int value) {
+    return (unsigned char)std::min(255, std::max(0, value));
+}
+
+// Thumbnail coordinate for output pixel i, with the thumbnail cover-scaled and
+// centered on the output; returns the left/top tap and its blend weight (0-256)
+inline void axis_tap(int i, int dst_size, int thumb_size, float scale, int& index, int& weight) {
+    float position = (i + 0.5f - dst_size * 0.5f) / scale + thumb_size * 0.5f - 0.5f;
+    if (position <= 0.0f) {
+        index = 0;
+        weight = 0;
+        return;
+    }
+    if (position >= thumb_size - 1) {
+        index = thumb_size - 1;
+        weight = 0;
+        return;
+    }
+    index = (int)position;
+    weight = (int)((position - index) * 256.0f);
+}
+
+} // namespace
+
+LetterboxFill::LetterboxFill()
+    : thumb_width_(0), thumb_height_(0), source_width_(0), source_height_(0),
+      generation_(0) {}
+
+void LetterboxFill::configure(const LetterboxSettings& settings) {
+    settings_ = settings;
+    settings_.refresh_fps = std::max(1, settings.refresh_fps);
+    if (!settings_.blur) {
+        pixels_.clear();
+        thumb_width_ = thumb_height_ = 0;
+    }
+    source_width_ = source_height_ = 0;
+    painted_.clear();
+}
+
+bool LetterboxFill::refresh_due(int width, int height) {
+    if (pixels_.empty() || width != source_width_ || height != source_height_) {
+        return true;
+    }
+    auto interval = std::chrono::microseconds(1000000 / settings_.refresh_fps);
+    return std::chrono::steady_clock::now() - last_refresh_ >= interval;
+}
+
+void LetterboxFill::begin_thumbnail(int width, int height) {
+    source_width_ = width;
+    source_height_ = height;
+    thumb_width_ = std::max(1, width / DOWNSCALE);
+    thumb_height_ = std::max(1, height / DOWNSCALE);
+    pixels_.resize((size_t)thumb_width_ * thumb_height_ * 4);
+    last_refresh_ = std::chrono::steady_clock::now();
+    generation_++;
+}
+
+bool LetterboxFill::update(const VideoFrame& frame) {
+    if (!settings_.blur || !frame.is_valid() || !refresh_due(frame.width, frame.height)) {
+        return false;
+    }
+    begin_thumbnail(frame.width, frame.height);
+    if (frame.is_yuv()) {
+        sample_yuv(frame);
+    } else {
+        sample_rgba(frame);
+    }
+    blur_and_darken();
+    return true;
+}
+
+void LetterboxFill::sample_rgba(const VideoFrame& frame) {
+    int width = frame.width;
+    int height = frame.height;
+
+    // Four taps per block (at 1/4 and 3/4 of it) are plenty before a blur;
+    // a 4K frame costs ~130k reads instead of 8M
+    for (int ty = 0; ty < thumb_height_; ty++) {
+        int block_y = ty * height / thumb_height_;
+        int block_h = std::max(1, height / thumb_height_);
+        int rows[2] = { std::min(height - 1, block_y + block_h / 4), std::min(height - 1, block_y + block_h * 3 / 4) };
+        unsigned char* out = pixels_.data() + (size_t)ty * thumb_width_ * 4;
+
+        for (int tx = 0; tx < thumb_width_; tx++) {
+            int block_x = tx * width / thumb_width_;
+            int block_w = std::max(1, width / thumb_width_);
+            int columns[2] = { std::min(width - 1, block_x + block_w / 4), std::min(width - 1, block_x + block_w * 3 / 4) };
+
+            int sum[3] = { 0, 0, 0 };
+            for (int row : rows) {
+                for (int column : columns) {
+                    const unsigned char* pixel = frame.planes[0] + (size_t)row * frame.strides[0] + (size_t)column * 4;
+                    sum[0] += pixel[0];
+                    sum[1] += pixel[1];
+                    sum[2] += pixel[2];
+                }
+            }
+            out[tx * 4 + 0] = (unsigned char)(sum[0] >> 2);
+            out[tx * 4 + 1] = (unsigned char)(sum[1] >> 2);
+            out[tx * 4 + 2] = (unsigned char)(sum[2] >> 2);
+            out[tx * 4 + 3] = 255;
+        }
+    }
+}
+
+void LetterboxFill::sample_yuv(const VideoFrame& frame) {
+    // One tap per block straight from the planes (the GL path never has RGB
+    // on the CPU); integer BT.601, which is close enough for a blurred backdrop
+    int width = frame.width;
+    int height = frame.height;
+    bool nv12 = frame.format == VideoPixelFormat::NV12;
+    for (int ty = 0; ty < thumb_height_; ty++) {
+        int y = std::min(height - 1, ty * height / thumb_height_ + std::max(1, height / thumb_height_) / 2);
+        const unsigned char* luma_row = frame.planes[0] + (size_t)y * frame.strides[0];
+        const unsigned char* u_row = frame.planes[1] + (size_t)(y / 2) * frame.strides[1];
+        const unsigned char* v_row = nv12 ? u_row : frame.planes[2] + (size_t)(y / 2) * frame.strides[2];
+        unsigned char* out = pixels_.data() + (size_t)ty * thumb_width_ * 4;
+
+        for (int tx = 0; tx < thumb_width_; tx++) {
+            int x = std::min(width - 1, tx * width / thumb_width_ + std::max(1, width / thumb_width_) / 2);
+            int luma = luma_row[x];
+            int u = (nv12 ? u_row[(x / 2) * 2] : u_row[x / 2]) - 128;
+            int v = (nv12 ? v_row[(x / 2) * 2 + 1] : v_row[x / 2]) - 128;
+
+            int r, g, b;
+            if (frame.full_range) {
+                r = luma + ((359 * v) >> 8);
+                g = luma - ((88 * u + 183 * v) >> 8);
+                b = luma + ((454 * u) >> 8);
+            } else {
+                int c = 298 * (luma - 16);
+                r = (c + 409 * v + 128) >> 8;
+                g = (c - 100 * u - 208 * v + 128) >> 8;
+                b = (c + 516 * u + 128) >> 8;
+            }
+            out[tx * 4 + 0] = clamp_channel(r);
+            out[tx * 4 + 1] = clamp_channel(g);
+            out[tx * 4 + 2] = clamp_channel(b);
+            out[tx * 4 + 3] = 255;
+        }
+    }
+}
+
+void LetterboxFill::blur_and_darken() {
+    for (int pass = 0; pass < BLUR_PASSES; pass++) {
+        box_blur_pass(true);
+        box_blur_pass(false);
+    }
+
+    for (size_t i = 0; i < pixels_.size(); i += 4) {
+        pixels_[i + 0] = (unsigned char)((pixels_[i + 0] * BACKDROP_BRIGHTNESS) >> 8);
+        pixels_[i + 1] = (unsigned char)((pixels_[i + 1] * BACKDROP_BRIGHTNESS) >> 8);
+        pixels_[i + 2] = (unsigned char)((pixels_[i + 2] * BACKDROP_BRIGHTNESS) >> 8);
+    }
+}
+
+void LetterboxFill::box_blur_pass(bool horizontal) {
+    scratch_ = pixels_;
+    int length = horizontal ? thumb_width_ : thumb_height_;
+    int lines = horizontal ? thumb_height_ : thumb_width_;
+    size_t step = horizontal ? 4 : (size_t)thumb_width_ * 4;
+    size_t line_step = horizontal ? (size_t)thumb_width_ * 4 : 4;
+    int taps = BLUR_RADIUS * 2 + 1;
+
+    for (int line = 0; line < lines; line++) {
+        const unsigned char* src = scratch_.data() + line * line_step;
+        unsigned char* dst = pixels_.data() + line * line_step;
+        for (int i = 0; i < length; i++) {
+            int sum[3] = { 0, 0, 0 };
+            for (int k = -BLUR_RADIUS; k <= BLUR_RADIUS; k++) {
+                // Clamp to the edge so the borders do not darken
+                const unsigned char* pixel = src + std::min(length - 1, std::max(0, i + k)) * step;
+                sum[0] += pixel[0];
+                sum[1] += pixel[1];
+                sum[2] += pixel[2];
+            }
+            dst[i * step + 0] = (unsigned char)(sum[0] / taps);
+            dst[i * step + 1] = (unsigned char)(sum[1] / taps);
+            dst[i * step + 2] = (unsigned char)(sum[2] / taps);
+        }
+    }
+}
+
+int LetterboxFill::get_bar_rects(int dst_width, int dst_height, const DirtyRect& content, DirtyRect* rects) {
+    int left = std::max(0, std::min(dst_width, content.x));
+    int top = std::max(0, std::min(dst_height, content.y));
+    int right = std::max(left, std::min(dst_width, content.x + content.width));
+    int bottom = std::max(top, std::min(dst_height, content.y + content.height));
+
+    int count = 0;
+    if (right == left || bottom == top) {
+        rects[count++] = { 0, 0, dst_width, dst_height };
+        return count;
+    }
+    if (top > 0) {
+        rects[count++] = { 0, 0, dst_width, top };
+    }
+    if (bottom < dst_height) {
+        rects[count++] = { 0, bottom, dst_width, dst_height - bottom };
+    }
+    if (left > 0) {
+        rects[count++] = { 0, top, left, bottom - top };
+    }
+    if (right < dst_width) {
+        rects[count++] = { right, top, dst_width - right, bottom - top };
+    }
+    return count;
+}
+
+bool LetterboxFill::paint_bars_bgra(unsigned char* dst, int dst_width, int dst_height, const DirtyRect& content,
+                                    bool flip_y, const PostEffectPass* effects, std::vector<DirtyRect>* painted) {
+    if (!dst || dst_width <= 0 || dst_height <= 0) {
+        return false;
+    }
+
+    auto state = std::find_if(painted_.begin(), painted_.end(),
+                              [dst](const PaintedBuffer& entry) { return entry.buffer == dst; });
+    bool unchanged = state != painted_.end() && state->width == dst_width &&
+                     state->height == dst_height && state->flip == flip_y &&
+                     state->generation == generation_ &&
+                     state->content.x == content.x && state->content.y == content.y &&
+                     state->content.width == content.width && state->content.height == content.height;
+    if (unchanged) {
+        return false;
+    }
+
+    if (state == painted_.end()) {
+        if (painted_.size() >= MAX_PAINTED_BUFFERS) {
+            painted_.erase(painted_.begin());
+        }
+        painted_.push_back(PaintedBuffer());
+        state = painted_.end() - 1;
+    }
+    state->buffer = dst;
+    state->width = dst_width;
+    state->height = dst_height;
+    state->content = content;
+    state->flip = flip_y;
+    state->generation = generation_;
+
+    DirtyRect bars[4];
+    int bar_count = get_bar_rects(dst_width, dst_height, content, bars);
+    if (bar_count == 0) {
+        return false;
+    }
+
+    size_t stride = (size_t)dst_width * 4;
+    bool backdrop = settings_.blur && has_image();
+    float scale = 1.0f;
+    if (backdrop) {
+        scale = std::max((float)dst_width / thumb_width_, (float)dst_height / thumb_height_);
+        column_index_.resize(dst_width);
+        column_weight_.resize(dst_width);
+        for (int x = 0; x < dst_width; x++) {
+            axis_tap(x, dst_width, thumb_width_, scale, column_index_[x], column_weight_[x]);
+        }
+    }
+    bool effects_active = effects && effects->is_active();
+
+    for (int i = 0; i < bar_count; i++) {
+        const DirtyRect& bar = bars[i];
+        for (int y = bar.y; y < bar.y + bar.height; y++) {
+            unsigned char* row = dst + (size_t)y * stride;
+            if (!backdrop) {
+                memset(row + (size_t)bar.x * 4, 0, (size_t)bar.width * 4);
+                continue;
+            }
+
+            int ty, wy;
+            axis_tap(flip_y ? dst_height - 1 - y : y, dst_height, thumb_height_, scale, ty, wy);
+            const unsigned char* upper = pixels_.data() + (size_t)ty * thumb_width_ * 4;
+            const unsigned char* lower = pixels_.data() + (size_t)std::min(ty + 1, thumb_height_ - 1) * thumb_width_ * 4;
+            int row_factor = effects_active ? effects->row_factor(y) : 256;
+
+            for (int x = bar.x; x < bar.x + bar.width; x++) {
+                int tx = column_index_[x];
+                int wx = column_weight_[x];
+                int tx1 = std::min(tx + 1, thumb_width_ - 1);
+                unsigned char* pixel = row + (size_t)x * 4;
+                // RGBA thumbnail -> BGRA output
+                for (int c = 0; c < 3; c++) {
+                    int top = upper[tx * 4 + c] + (((upper[tx1 * 4 + c] - upper[tx * 4 + c]) * wx) >> 8);
+                    int bottom = lower[tx * 4 + c] + (((lower[tx1 * 4 + c] - lower[tx * 4 + c]) * wx) >> 8);
+                    pixel[2 - c] = (unsigned char)(top + (((bottom - top) * wy) >> 8));
+                }
+                pixel[3] = 255;
+                if (effects_active) {
+                    effects->apply_bgra(pixel, x, row_factor);
+                }
+            }
+        }
+    }
+
+    if (painted) {
+        painted->assign(bars, bars + bar_count);
+    }
+    return true;
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <vector>
+#include <chrono>
+#include "tile_tracker.h"
+#include "video_frame.h"
+class PostEffectPass;
+
+// How FIT/DEFAULT bars are painted
+struct LetterboxSettings {
+    bool blur = true;           // false = plain black bars
+    int refresh_fps = 4;        // Blurred backdrop updates per second (video)
+};
+
+/**
+ * Blurred-fill letterbox ("blurred background" behind FIT content).
+ *
+ * The backdrop is never built at output resolution: a 1/DOWNSCALE thumbnail
+ * is sampled straight from the frame (four taps per block), box-blurred
+ * twice and only rebuilt refresh_fps times per second. paint_bars_bgra()
+ * upscales it bilinearly into the pixels outside the content rectangle and
+ * skips the work entirely when neither the thumbnail nor the layout changed,
+ * so the CPU presenters can leave the bars alone on most frames. The GL
+ * presenters upload get_pixels() as a tiny texture instead.
+ */
+class LetterboxFill {
+public:
+    static constexpr int DOWNSCALE = 16;
+
+    LetterboxFill();
+
+    void configure(const LetterboxSettings& settings);
+    bool is_enabled() const { return settings_.blur; }
+
+    // Output buffer contents were lost (new buffers) - repaint the bars next time
+    void invalidate() { painted_.clear(); }
+
+    // Rebuild the thumbnail from a new frame if the refresh interval elapsed,
+    // there is none yet, or the frame size changed. True when it changed.
+    bool update(const VideoFrame& frame);
+
+    bool has_image() const { return !pixels_.empty(); }
+    const unsigned char* get_pixels() const { return pixels_.data(); }     // RGBA
+    int get_width() const { return thumb_width_; }
+    int get_height() const { return thumb_height_; }
+
+    // Fill everything outside `content` of a BGRA buffer with the cover-scaled
+    // backdrop (black until there is one). Does nothing and returns false if
+    // the same bars were already painted into this buffer (tracked per buffer,
+    // so presenters rotating SHM buffers repaint each one); otherwise the
+    // painted rectangles are stored in `painted` when given.
+    bool paint_bars_bgra(unsigned char* dst, int dst_width, int dst_height, const DirtyRect& content,
+                         bool flip_y, const PostEffectPass* effects, std::vector<DirtyRect>* painted = nullptr);
+
+    // Up to four bar rectangles around `content` (top, bottom, left, right)
+    static int get_bar_rects(int dst_width, int dst_height, const DirtyRect& content, DirtyRect* rects);
+
+private:
+    LetterboxSettings settings_;
+    std::vector<unsigned char> pixels_;
+    std::vector<unsigned char> scratch_;
+    int thumb_width_;
+    int thumb_height_;
+    int source_width_;
+    int source_height_;
+    std::chrono::steady_clock::time_point last_refresh_;
+    unsigned long generation_;          // Bumped on every thumbnail rebuild
+
+    // What is currently in each output buffer the bars were painted into
+    struct PaintedBuffer {
+        const unsigned char* buffer;
+        int width;
+        int height;
+        DirtyRect content;
+        bool flip;
+        unsigned long generation;
+    };
+    static constexpr size_t MAX_PAINTED_BUFFERS = 4;   // Oldest forgotten beyond this
+    std::vector<PaintedBuffer> painted_;
+
+    // Bilinear taps per output column: left thumbnail column and weight (0-256)
+    std::vector<int> column_index_;
+    std::vector<int> column_weight_;
+
+    bool refresh_due(int width, int height);
+    void begin_thumbnail(int width, int height);
+    void sample_rgba(const VideoFrame& frame);  // Four taps per block
+    void sample_yuv(const VideoFrame& frame);   // One tap per block, converted in place
+    void blur_and_darken();
+    void box_blur_pass(bool horizontal);
+};
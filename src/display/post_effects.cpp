@@ -0,0 +1,51 @@
+#include "post_effects.h"
+#include <algorithm>
+#include <cmath>
+
+float PostEffects::vignette_axis_strength() const {
+    float strength = std::clamp(vignette, 0.0f, 1.0f);
+    return 1.0f - std::sqrt(1.0f - strength);
+}
+
+PostEffectPass::PostEffectPass()
+    : active_(false), vignette_(false), width_(0), height_(0), desaturate_(0) {
+    for (int i = 0; i < 256; i++) {
+        gain_r_[i] = gain_g_[i] = gain_b_[i] = (unsigned char)i;
+    }
+}
+
+void PostEffectPass::configure(const PostEffects& effects, int output_width, int output_height) {
+    active_ = !effects.is_identity() && output_width > 0 && output_height > 0;
+    width_ = output_width;
+    height_ = output_height;
+    desaturate_ = (int)std::lround(std::clamp(effects.desaturate, 0.0f, 1.0f) * 256.0f);
+
+    float brightness = 1.0f - std::clamp(effects.dim, 0.0f, 1.0f);
+    unsigned char* tables[3] = { gain_r_, gain_g_, gain_b_ };
+    for (int channel = 0; channel < 3; channel++) {
+        float gain = brightness * std::clamp(effects.tint[channel], 0.0f, 1.0f);
+        for (int i = 0; i < 256; i++) {
+            tables[channel][i] = (unsigned char)std::lround(i * gain);
+        }
+    }
+
+    vignette_ = active_ && effects.vignette > 0.0f;
+    if (vignette_) {
+        float axis_strength = effects.vignette_axis_strength();
+        build_falloff(column_factors_, output_width, axis_strength);
+        build_falloff(row_factors_, output_height, axis_strength);
+    } else {
+        column_factors_.clear();
+        row_factors_.clear();
+    }
+}
+
+void PostEffectPass::build_falloff(std::vector<uint16_t>& factors, int size, float strength) {
+    factors.resize(size);
+    for (int i = 0; i < size; i++) {
+        // 0 at the centre, 1 at the edges; quadratic so the middle stays untouched
+        float distance = size > 1 ? std::fabs(2.0f * i / (size - 1) - 1.0f) : 0.0f;
+        float factor = 1.0f - strength * distance * distance;
+        factors[i] = (uint16_t)std::lround(std::max(0.0f, factor) * 256.0f);
+    }
+}
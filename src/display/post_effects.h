@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Per-screen color effects (keep desktop icons readable over busy wallpapers).
+// All of them are folded into the pass that scales the frame onto the output,
+// so enabling them never adds another sweep over the output buffer.
+struct PostEffects {
+    float dim = 0.0f;                       // 0 = off, 1 = black
+    float desaturate = 0.0f;                // 0 = original colors, 1 = grayscale
+    float tint[3] = { 1.0f, 1.0f, 1.0f };   // Per-channel RGB multiplier
+    float vignette = 0.0f;                  // Edge darkening, 0 = off, 1 = black corners
+
+    bool is_identity() const {
+        return dim <= 0.0f && desaturate <= 0.0f && vignette <= 0.0f &&
+               tint[0] >= 1.0f && tint[1] >= 1.0f && tint[2] >= 1.0f;
+    }
+
+    // The vignette is separable (horizontal falloff * vertical falloff); each
+    // axis gets this strength so the corners end up at 1 - vignette
+    float vignette_axis_strength() const;
+};
+
+/**
+ * CPU side of PostEffects for the software scalers.
+ *
+ * configure() precomputes per-channel gain tables and separable vignette
+ * factors for one output size; apply_bgra() then touches a pixel that was
+ * just written (still in cache) with a few integer multiplies. The
+ * vignette is the product of a horizontal and a vertical falloff, which
+ * keeps it at one multiply per pixel.
+ */
+class PostEffectPass {
+public:
+    PostEffectPass();
+
+    void configure(const PostEffects& effects, int output_width, int output_height);
+    bool is_active() const { return active_; }
+    bool is_configured_for(int output_width, int output_height) const {
+        return width_ == output_width && height_ == output_height;
+    }
+
+    // Vignette factor of output row y (0-256), looked up once per row
+    int row_factor(int y) const {
+        return vignette_ ? row_factors_[y] : 256;
+    }
+
+    // In-place on one BGRA output pixel at column x
+    inline void apply_bgra(unsigned char* pixel, int x, int row_factor) const {
+        int b = pixel[0];
+        int g = pixel[1];
+        int r = pixel[2];
+
+        if (desaturate_ > 0) {
+            int luma = (77 * r + 150 * g + 29 * b) >> 8;
+            r += ((luma - r) * desaturate_) >> 8;
+            g += ((luma - g) * desaturate_) >> 8;
+            b += ((luma - b) * desaturate_) >> 8;
+        }
+
+        // Gain tables already include dim and tint
+        r = gain_r_[r];
+        g = gain_g_[g];
+        b = gain_b_[b];
+
+        if (vignette_) {
+            int factor = (column_factors_[x] * row_factor) >> 8;
+            r = (r * factor) >> 8;
+            g = (g * factor) >> 8;
+            b = (b * factor) >> 8;
+        }
+
+        pixel[0] = (unsigned char)b;
+        pixel[1] = (unsigned char)g;
+        pixel[2] = (unsigned char)r;
+    }
+
+private:
+    bool active_;
+    bool vignette_;
+    int width_;
+    int height_;
+    int desaturate_;                    // 0-256
+    unsigned char gain_r_[256];
+    unsigned char gain_g_[256];
+    unsigned char gain_b_[256];
+    std::vector<uint16_t> column_factors_;
+    std::vector<uint16_t> row_factors_;
+
+    static void build_falloff(std::vector<uint16_t>& factors, int size, float strength);
+};
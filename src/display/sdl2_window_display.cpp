@@ -1,14 +1,23 @@
 #include "sdl2_window_display.h"
+#include "display_backend.h"
+#include "../media_player.h"
 #include <iostream>
 #include <stdexcept>
 #include <cstring>
 #include <chrono>
 #include <thread>
+#include <algorithm>
+
+std::vector<SDL2WindowDisplay*> SDL2WindowDisplay::open_windows_;
 
 SDL2WindowDisplay::SDL2WindowDisplay(int x, int y, int width, int height) 
     : x_(x), y_(y), width_(width), height_(height),
-      initialized_(false), visible_(false), should_close_(false), 
-      window_(nullptr), renderer_(nullptr), current_texture_(nullptr),
+      initialized_(false), visible_(false), should_close_(false), geometry_changed_(false),
+      window_(nullptr), renderer_(nullptr),
+      last_render_time_(std::chrono::steady_clock::now()), fps_timer_start_(std::chrono::steady_clock::now()),
+      frames_skipped_(0), frames_rendered_(0), frame_presented_(true), current_texture_(nullptr),
+      texture_format_(0), texture_width_(0), texture_height_(0),
+      native_yuv_support_(false), software_renderer_(false),
       current_scaling_(ScalingMode::DEFAULT), target_fps_(0) {
 }
 
@@ -35,6 +44,7 @@ bool SDL2WindowDisplay::initialize() {
     
     initialized_ = true;
     visible_ = true;
+    open_windows_.push_back(this);
     
     std::cout << "DEBUG: SDL2 window display initialized successfully" << std::endl;
     return true;
@@ -45,6 +55,7 @@ void SDL2WindowDisplay::cleanup() {
         return;
     }
     
+    open_windows_.erase(std::remove(open_windows_.begin(), open_windows_.end(), this), open_windows_.end());
     cleanup_sdl();
     
     initialized_ = false;
@@ -86,7 +97,7 @@ bool SDL2WindowDisplay::render_image_data(const unsigned char* image_data, int i
     std::cout << "DEBUG: SDL2 rendering image: " << img_width << "x" << img_height << std::endl;
     
     // Create texture from image data
-    if (!create_texture_from_data(image_data, img_width, img_height)) {
+    if (!create_texture_from_data(image_data, img_width, img_height, img_width * 4)) {
         std::cerr << "ERROR: Failed to create texture from image data" << std::endl;
         return false;
     }
@@ -102,13 +113,39 @@ bool SDL2WindowDisplay::render_image_data(const unsigned char* image_data, int i
     return true;
 }
 
-bool SDL2WindowDisplay::render_video_frame(const unsigned char* frame_data, int frame_width, int frame_height, ScalingMode scaling) {
-    if (!initialized_ || !frame_data || !renderer_) {
+bool SDL2WindowDisplay::render_frame(const VideoFrame& frame, ScalingMode scaling) {
+    if (!initialized_ || !frame.is_valid() || !renderer_) {
         return false;
     }
     
+    frame_presented_ = wait_for_frame_slot();
+    if (!frame_presented_) {
+        return true; // Not an error; reported through was_frame_presented()
+    }
+    
+    if (frame.is_yuv()) {
+        // Upload Y/U/V planes as-is, the renderer handles conversion and scaling
+        if (!update_yuv_texture(frame)) {
+            std::cerr << "ERROR: Failed to upload YUV video frame" << std::endl;
+            return false;
+        }
+    } else if (!create_texture_from_data(frame.planes[0], frame.width, frame.height, frame.strides[0])) {
+        std::cerr << "ERROR: Failed to create texture from video frame data" << std::endl;
+        return false;
+    }
+    
+    present_frame(scaling);
+    return true;
+}
+
+bool SDL2WindowDisplay::supports_yuv_textures() const {
+    // The software renderer has no native YUV formats, but SDL converts
+    // YUV textures internally which keeps it usable for testing this path
+    return renderer_ && (native_yuv_support_ || software_renderer_);
+}
+
+bool SDL2WindowDisplay::wait_for_frame_slot() {
     // FRAME RATE CONTROL: Use high-precision steady_clock instead of SDL_GetTicks
-    static auto last_render_time = std::chrono::steady_clock::now();
     auto current_time = std::chrono::steady_clock::now();
     
     // Calculate target frame interval based on target FPS (in microseconds for precision)
@@ -118,27 +155,26 @@ bool SDL2WindowDisplay::render_video_frame(const unsigned char* frame_data, int
     // Skip frame if we're trying to render too soon (frame skipping)
     if (target_fps_ > 0 && target_interval.count() > 0) {
         auto time_since_last_render = std::chrono::duration_cast<std::chrono::microseconds>(
-            current_time - last_render_time);
+            current_time - last_render_time_);
             
         if (time_since_last_render < target_interval) {
             // Not time to render yet - skip this frame
-            static int frames_skipped = 0;
-            frames_skipped++;
+            frames_skipped_++;
             
             // Log skipped frames every 50 frames
-            if (frames_skipped % 50 == 0) {
-                std::cout << "SDL2 RENDERER: Skipped " << frames_skipped << " frames to maintain "
+            if (frames_skipped_ % 50 == 0) {
+                std::cout << "SDL2 RENDERER: Skipped " << frames_skipped_ << " frames to maintain "
                           << target_fps_ << " FPS" << std::endl;
                 std::cout << "    Time since last: " << time_since_last_render.count() 
                           << "μs, Target: " << target_interval.count() << "μs" << std::endl;
             }
-            return true; // Pretend we rendered it, but actually skip it
+            return false;
         }
         
         // Optional busy-wait for precision timing
         // This reduces jitter by waiting until we're exactly at the frame time
         int busy_wait_count = 0;
-        while (std::chrono::steady_clock::now() - last_render_time < target_interval) {
+        while (std::chrono::steady_clock::now() - last_render_time_ < target_interval) {
             std::this_thread::yield(); // Reduce CPU usage while busy waiting
             if (++busy_wait_count % 1000 == 0) break; // Safety limit on busy waiting
         }
@@ -147,23 +183,21 @@ bool SDL2WindowDisplay::render_video_frame(const unsigned char* frame_data, int
     // Track this render time - calculate next frame time precisely
     // This prevents timing drift by anchoring to the expected frame time
     if (target_fps_ > 0 && target_interval.count() > 0) {
-        last_render_time += target_interval; // Use expected time to prevent drift
+        last_render_time_ += target_interval; // Use expected time to prevent drift
         
         // If we're too far behind, reset to avoid spiral of death
-        if (current_time - last_render_time > std::chrono::milliseconds(200)) {
+        if (current_time - last_render_time_ > std::chrono::milliseconds(200)) {
             std::cout << "WARNING: Frame timing too far behind, resetting timer" << std::endl;
-            last_render_time = current_time;
+            last_render_time_ = current_time;
         }
     } else {
-        last_render_time = current_time; // No FPS limit, just use current time
-    }
-    
-    // Create texture from frame data
-    if (!create_texture_from_data(frame_data, frame_width, frame_height)) {
-        std::cerr << "ERROR: Failed to create texture from video frame data" << std::endl;
-        return false;
+        last_render_time_ = current_time; // No FPS limit, just use current time
     }
     
+    return true;
+}
+
+void SDL2WindowDisplay::present_frame(ScalingMode scaling) {
     // Clear screen and render
     SDL_SetRenderDrawColor(renderer_, 0, 0, 0, 255);
     SDL_RenderClear(renderer_);
@@ -177,16 +211,16 @@ bool SDL2WindowDisplay::render_video_frame(const unsigned char* frame_data, int
     SDL_RenderPresent(renderer_);
     
     // FPS debugging output with high-precision timing
-    static int frames_rendered = 0;
-    static auto fps_timer_start = std::chrono::steady_clock::now();
-    frames_rendered++;
+    auto current_time = std::chrono::steady_clock::now();
+    frames_rendered_++;
     
-    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(current_time - fps_timer_start);
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(current_time - fps_timer_start_);
     if (elapsed.count() >= 5000) { // Log every 5 seconds
-        float actual_fps = frames_rendered / (elapsed.count() / 1000.0f);
-        std::cout << "SDL2 RENDER: Rendered " << frames_rendered 
+        float actual_fps = frames_rendered_ / (elapsed.count() / 1000.0f);
+        std::cout << "SDL2 RENDER [window " << SDL_GetWindowID(window_) << "]: Rendered " << frames_rendered_ 
                   << " frames in " << (elapsed.count()/1000) 
-                  << "s (effective " << actual_fps << " FPS)" << std::endl;
+                  << "s (effective " << actual_fps << " FPS, "
+                  << (texture_format_ == SDL_PIXELFORMAT_RGBA32 ? "RGBA" : "YUV") << " upload)" << std::endl;
                   
         // If using frame rate limiting, log the target as well
         if (target_fps_ > 0) {
@@ -202,11 +236,9 @@ bool SDL2WindowDisplay::render_video_frame(const unsigned char* frame_data, int
         }
                   
         // Reset counters
-        frames_rendered = 0;
-        fps_timer_start = current_time;
+        frames_rendered_ = 0;
+        fps_timer_start_ = current_time;
     }
-    
-    return true;
 }
 
 void SDL2WindowDisplay::show_window() {
@@ -228,30 +260,68 @@ bool SDL2WindowDisplay::is_visible() const {
 }
 
 void SDL2WindowDisplay::handle_events() {
+    // SDL has a single event queue for all windows, so polling here directly
+    // would steal events meant for other preview windows
+    pump_events();
+}
+
+void SDL2WindowDisplay::pump_events() {
     SDL_Event event;
     while (SDL_PollEvent(&event)) {
-        switch (event.type) {
-            case SDL_QUIT:
-                should_close_ = true;
-                break;
-            case SDL_WINDOWEVENT:
-                if (event.window.event == SDL_WINDOWEVENT_CLOSE) {
-                    should_close_ = true;
-                }
-                break;
-            case SDL_KEYDOWN:
-                if (event.key.keysym.sym == SDLK_ESCAPE) {
-                    should_close_ = true;
-                }
+        if (event.type == SDL_QUIT) {
+            for (SDL2WindowDisplay* window : open_windows_) {
+                window->should_close_ = true;
+            }
+            continue;
+        }
+        
+        Uint32 window_id = 0;
+        if (event.type == SDL_WINDOWEVENT) {
+            window_id = event.window.windowID;
+        } else if (event.type == SDL_KEYDOWN) {
+            window_id = event.key.windowID;
+        } else {
+            continue;
+        }
+        
+        for (SDL2WindowDisplay* window : open_windows_) {
+            if (window->window_ && SDL_GetWindowID(window->window_) == window_id) {
+                window->handle_event(event);
                 break;
+            }
         }
     }
 }
 
+void SDL2WindowDisplay::handle_event(const SDL_Event& event) {
+    switch (event.type) {
+        case SDL_WINDOWEVENT:
+            if (event.window.event == SDL_WINDOWEVENT_CLOSE) {
+                should_close_ = true;
+            } else if (event.window.event == SDL_WINDOWEVENT_SIZE_CHANGED ||
+                       event.window.event == SDL_WINDOWEVENT_EXPOSED) {
+                // Contents must be redrawn even if the video is on a static stretch
+                geometry_changed_ = true;
+            }
+            break;
+        case SDL_KEYDOWN:
+            if (event.key.keysym.sym == SDLK_ESCAPE) {
+                should_close_ = true;
+            }
+            break;
+    }
+}
+
 bool SDL2WindowDisplay::should_close() const {
     return should_close_;
 }
 
+bool SDL2WindowDisplay::consume_geometry_change() {
+    bool changed = geometry_changed_;
+    geometry_changed_ = false;
+    return changed;
+}
+
 std::unique_ptr<DisplayOutput> SDL2WindowDisplay::create_window(int x, int y, int width, int height) {
     auto display = std::make_unique<SDL2WindowDisplay>(x, y, width, height);
     if (display->initialize()) {
@@ -263,8 +333,12 @@ std::unique_ptr<DisplayOutput> SDL2WindowDisplay::create_window(int x, int y, in
 // Private implementation methods
 
 bool SDL2WindowDisplay::init_sdl() {
-    // Initialize SDL2 with video subsystem
-    if (SDL_Init(SDL_INIT_VIDEO) < 0) {
+    // Global VSync disabling for SDL2 before any SDL initialization
+    // This ensures frame rate control works correctly in windowed mode
+    SDL_SetHintWithPriority(SDL_HINT_RENDER_VSYNC, "0", SDL_HINT_OVERRIDE);
+    
+    // Initialize SDL2 video subsystem (reference counted by SDL, one per window)
+    if (SDL_InitSubSystem(SDL_INIT_VIDEO) < 0) {
         std::cerr << "ERROR: SDL2 initialization failed: " << SDL_GetError() << std::endl;
         return false;
     }
@@ -291,6 +365,12 @@ bool SDL2WindowDisplay::create_window() {
     
     // Create renderer without the VSync flag for better FPS control
     renderer_ = SDL_CreateRenderer(window_, -1, SDL_RENDERER_ACCELERATED);
+    if (!renderer_) {
+        // No GPU renderer available (headless, llvmpipe-less setups) - use SDL's software renderer
+        std::cerr << "WARNING: Accelerated SDL2 renderer unavailable (" << SDL_GetError() 
+                  << "), falling back to software renderer" << std::endl;
+        renderer_ = SDL_CreateRenderer(window_, -1, SDL_RENDERER_SOFTWARE);
+    }
     if (!renderer_) {
         std::cerr << "ERROR: Failed to create SDL2 renderer: " << SDL_GetError() << std::endl;
         return false;
@@ -306,6 +386,18 @@ bool SDL2WindowDisplay::create_window() {
     if (SDL_GetRendererInfo(renderer_, &renderer_info) == 0) {
         std::cout << "DEBUG: SDL2 renderer created: " << renderer_info.name << std::endl;
         std::cout << "DEBUG: Initial VSync status: " << ((renderer_info.flags & SDL_RENDERER_PRESENTVSYNC) ? "ENABLED" : "DISABLED") << std::endl;
+        
+        // Check for native YUV texture support (GPU-side color conversion)
+        software_renderer_ = (renderer_info.flags & SDL_RENDERER_SOFTWARE) != 0 ||
+                             std::strcmp(renderer_info.name, "software") == 0;
+        for (Uint32 i = 0; i < renderer_info.num_texture_formats; i++) {
+            Uint32 format = renderer_info.texture_formats[i];
+            if (format == SDL_PIXELFORMAT_IYUV || format == SDL_PIXELFORMAT_YV12 || format == SDL_PIXELFORMAT_NV12) {
+                native_yuv_support_ = true;
+            }
+        }
+        std::cout << "DEBUG: YUV texture support: " 
+                  << (native_yuv_support_ ? "native" : (software_renderer_ ? "software conversion" : "none")) << std::endl;
     }
     
     return true;
@@ -316,6 +408,9 @@ void SDL2WindowDisplay::cleanup_sdl() {
         SDL_DestroyTexture(current_texture_);
         current_texture_ = nullptr;
     }
+    texture_format_ = 0;
+    texture_width_ = 0;
+    texture_height_ = 0;
     
     if (renderer_) {
         SDL_DestroyRenderer(renderer_);
@@ -327,41 +422,52 @@ void SDL2WindowDisplay::cleanup_sdl() {
         window_ = nullptr;
     }
     
-    SDL_Quit();
+    // Only shut SDL down once the last preview window is gone
+    SDL_QuitSubSystem(SDL_INIT_VIDEO);
+    if (open_windows_.empty()) {
+        SDL_Quit();
+    }
 }
 
-bool SDL2WindowDisplay::create_texture_from_data(const unsigned char* data, int width, int height) {
+bool SDL2WindowDisplay::ensure_texture(Uint32 format, int width, int height) {
     if (!renderer_) {
         return false;
     }
     
-    // OPTIMIZATION: Only recreate texture if dimensions changed
+    // OPTIMIZATION: Only recreate texture if format or dimensions changed
     // This prevents unnecessary texture creation/destruction every frame
-    static int last_width = 0;
-    static int last_height = 0;
-    
-    if (!current_texture_ || width != last_width || height != last_height) {
-        // Destroy existing texture only if dimensions changed
-        if (current_texture_) {
-            SDL_DestroyTexture(current_texture_);
-            current_texture_ = nullptr;
-        }
-        
-        // Create new texture (assuming RGBA format)
-        current_texture_ = SDL_CreateTexture(
-            renderer_,
-            SDL_PIXELFORMAT_RGBA32,
-            SDL_TEXTUREACCESS_STREAMING, // Use STREAMING for better performance
-            width, height
-        );
-        
-        if (!current_texture_) {
-            std::cerr << "ERROR: Failed to create SDL2 texture: " << SDL_GetError() << std::endl;
-            return false;
-        }
-        
-        last_width = width;
-        last_height = height;
+    if (current_texture_ && format == texture_format_ && 
+        width == texture_width_ && height == texture_height_) {
+        return true;
+    }
+    
+    if (current_texture_) {
+        SDL_DestroyTexture(current_texture_);
+        current_texture_ = nullptr;
+    }
+    
+    current_texture_ = SDL_CreateTexture(
+        renderer_,
+        format,
+        SDL_TEXTUREACCESS_STREAMING, // Use STREAMING for better performance
+        width, height
+    );
+    
+    if (!current_texture_) {
+        std::cerr << "ERROR: Failed to create SDL2 texture: " << SDL_GetError() << std::endl;
+        texture_format_ = 0;
+        return false;
+    }
+    
+    texture_format_ = format;
+    texture_width_ = width;
+    texture_height_ = height;
+    return true;
+}
+
+bool SDL2WindowDisplay::create_texture_from_data(const unsigned char* data, int width, int height, int stride) {
+    if (!ensure_texture(SDL_PIXELFORMAT_RGBA32, width, height)) {
+        return false;
     }
     
     // Upload data to texture - use more efficient method for streaming textures
@@ -375,20 +481,64 @@ bool SDL2WindowDisplay::create_texture_from_data(const unsigned char* data, int
         
         for (int y = 0; y < height; y++) {
             memcpy(dst, src, bytes_per_row);
-            src += bytes_per_row;
+            src += stride;
             dst += pitch;
         }
         
         SDL_UnlockTexture(current_texture_);
     } else {
         std::cerr << "ERROR: Failed to lock SDL2 texture: " << SDL_GetError() << std::endl;
-        current_texture_ = nullptr;
         return false;
     }
     
     return true;
 }
 
+bool SDL2WindowDisplay::update_yuv_texture(const VideoFrame& frame) {
+    bool nv12 = frame.format == VideoPixelFormat::NV12;
+    Uint32 format = nv12 ? SDL_PIXELFORMAT_NV12 : SDL_PIXELFORMAT_IYUV;
+    
+    // Must be set before texture creation; JPEG range for full-range sources,
+    // otherwise BT.601/BT.709 picked by resolution
+    SDL_SetYUVConversionMode(frame.full_range ? SDL_YUV_CONVERSION_JPEG : SDL_YUV_CONVERSION_AUTOMATIC);
+    
+    if (!ensure_texture(format, frame.width, frame.height)) {
+        return false;
+    }
+    
+    if (!nv12) {
+        return SDL_UpdateYUVTexture(current_texture_, nullptr,
+                                    frame.planes[0], frame.strides[0],
+                                    frame.planes[1], frame.strides[1],
+                                    frame.planes[2], frame.strides[2]) == 0;
+    }
+    
+#if SDL_VERSION_ATLEAST(2, 0, 16)
+    return SDL_UpdateNVTexture(current_texture_, nullptr,
+                               frame.planes[0], frame.strides[0],
+                               frame.planes[1], frame.strides[1]) == 0;
+#else
+    // Older SDL has no NV12 update call, copy the Y and UV planes through a lock
+    void* pixels;
+    int pitch;
+    if (SDL_LockTexture(current_texture_, nullptr, &pixels, &pitch) != 0) {
+        return false;
+    }
+    unsigned char* dst = static_cast<unsigned char*>(pixels);
+    for (int y = 0; y < frame.height; y++) {
+        memcpy(dst, frame.planes[0] + y * frame.strides[0], frame.width);
+        dst += pitch;
+    }
+    int uv_width = ((frame.width + 1) / 2) * 2;
+    for (int y = 0; y < (frame.height + 1) / 2; y++) {
+        memcpy(dst, frame.planes[1] + y * frame.strides[1], uv_width);
+        dst += pitch;
+    }
+    SDL_UnlockTexture(current_texture_);
+    return true;
+#endif
+}
+
 void SDL2WindowDisplay::render_current_texture(ScalingMode scaling) {
     if (!current_texture_ || !renderer_) {
         return;
@@ -520,3 +670,15 @@ void SDL2WindowDisplay::calculate_scaled_rect(int src_width, int src_height, int
         }
     }
 }
+
+// Module entry point (see display_backend.h)
+extern "C" const DisplayBackend* lwe_display_backend_sdl2() {
+    static const DisplayBackend backend = {
+        LWE_DISPLAY_BACKEND_ABI, "sdl2",
+        nullptr,
+        nullptr,
+        &SDL2WindowDisplay::create_window,
+        &SDL2WindowDisplay::pump_events
+    };
+    return &backend;
+}
@@ -4,6 +4,8 @@
 #include <SDL2/SDL.h>
 #include <memory>
 #include <string>
+#include <vector>
+#include <chrono>
 
 /**
  * SDL2-based window implementation
@@ -22,10 +24,13 @@ public:
     std::string get_name() const override;
     
     // Image rendering method
-    bool render_image_data(const unsigned char* image_data, int img_width, int img_height, ScalingMode scaling);
+    bool render_image_data(const unsigned char* image_data, int img_width, int img_height, ScalingMode scaling) override;
     
-    // Video frame rendering method  
-    bool render_video_frame(const unsigned char* frame_data, int frame_width, int frame_height, ScalingMode scaling);
+    // Video frame rendering: RGBA, or planar YUV where the renderer does the
+    // color conversion and scaling
+    bool render_frame(const VideoFrame& frame, ScalingMode scaling) override;
+    bool was_frame_presented() const override { return frame_presented_; }
+    bool supports_yuv_textures() const override;
     
     // Static factory method
     static std::unique_ptr<DisplayOutput> create_window(int x, int y, int width, int height);
@@ -37,10 +42,14 @@ public:
     
     // Event handling
     void handle_events();
-    bool should_close() const;
+    bool should_close() const override;
+    bool consume_geometry_change() override;
+    
+    // Shared event pump: polls SDL once and routes events to every open window
+    static void pump_events();
     
     // Frame rate control
-    void set_target_fps(int fps);
+    void set_target_fps(int fps) override;
 
 private:
     // Window properties
@@ -48,26 +57,47 @@ private:
     bool initialized_;
     bool visible_;
     bool should_close_;
+    bool geometry_changed_;     // Resized/exposed since the last consume_geometry_change()
     int target_fps_; // Target frame rate for windowed mode
     
     // SDL2 objects
     SDL_Window* window_;
     SDL_Renderer* renderer_;
     
+    // Per-window frame pacing and stats (each window paces independently)
+    std::chrono::steady_clock::time_point last_render_time_;
+    std::chrono::steady_clock::time_point fps_timer_start_;
+    int frames_skipped_;
+    int frames_rendered_;
+    bool frame_presented_;      // Last render_frame() was not skipped by pacing
+    
     // Texture for rendering
     SDL_Texture* current_texture_;
+    Uint32 texture_format_;
+    int texture_width_;
+    int texture_height_;
+    bool native_yuv_support_;   // Renderer lists a YUV texture format
+    bool software_renderer_;    // SDL software renderer (YUV converted internally)
     
     // Rendering state
     std::string current_media_path_;
     ScalingMode current_scaling_;
     
+    // All live windows, used to route events from the shared pump
+    static std::vector<SDL2WindowDisplay*> open_windows_;
+    
     // Private methods
+    void handle_event(const SDL_Event& event);
     bool init_sdl();
     bool create_window();
     void cleanup_sdl();
     
     // Rendering helpers
-    bool create_texture_from_data(const unsigned char* data, int width, int height);
+    bool ensure_texture(Uint32 format, int width, int height);
+    bool create_texture_from_data(const unsigned char* data, int width, int height, int stride);
+    bool update_yuv_texture(const VideoFrame& frame);
+    bool wait_for_frame_slot();
+    void present_frame(ScalingMode scaling);
     void render_current_texture(ScalingMode scaling);
     void calculate_scaled_rect(int src_width, int src_height, int dst_width, int dst_height, 
                               ScalingMode scaling, SDL_Rect& dst_rect);
@@ -0,0 +1,236 @@
+#include "span_compositor.h"
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <climits>
+
+extern "C" {
+#include <libswscale/swscale.h>
+}
+
+SpanCompositor::SpanCompositor()
+    : scaling_(ScalingMode::DEFAULT),
+      canvas_x_(0), canvas_y_(0), canvas_width_(0), canvas_height_(0) {}
+
+SpanCompositor::~SpanCompositor() {
+    cleanup();
+}
+
+bool SpanCompositor::initialize(const std::vector<SpanRegion>& regions, ScalingMode scaling) {
+    cleanup();
+
+    if (regions.empty()) {
+        std::cerr << "ERROR: Spanned wallpaper needs at least one output" << std::endl;
+        return false;
+    }
+
+    int min_x = INT_MAX, min_y = INT_MAX, max_x = INT_MIN, max_y = INT_MIN;
+    for (const auto& region : regions) {
+        if (region.width <= 0 || region.height <= 0) {
+            std::cerr << "ERROR: Output " << region.name << " has invalid geometry "
+                      << region.width << "x" << region.height << std::endl;
+            return false;
+        }
+        min_x = std::min(min_x, region.x);
+        min_y = std::min(min_y, region.y);
+        max_x = std::max(max_x, region.x + region.width);
+        max_y = std::max(max_y, region.y + region.height);
+
+        RegionState state;
+        state.region = region;
+        regions_.push_back(std::move(state));
+    }
+
+    canvas_x_ = min_x;
+    canvas_y_ = min_y;
+    canvas_width_ = max_x - min_x;
+    canvas_height_ = max_y - min_y;
+    scaling_ = scaling;
+
+    std::cout << "DEBUG: Span canvas " << canvas_width_ << "x" << canvas_height_
+              << " at " << canvas_x_ << "," << canvas_y_ << " across " << regions_.size() << " outputs" << std::endl;
+    for (const auto& state : regions_) {
+        std::cout << "DEBUG:   " << state.region.name << ": " << state.region.width << "x" << state.region.height
+                  << "+" << state.region.x << "+" << state.region.y << std::endl;
+    }
+    return true;
+}
+
+void SpanCompositor::cleanup() {
+    for (auto& state : regions_) {
+        if (state.sws_context) {
+            sws_freeContext(state.sws_context);
+            state.sws_context = nullptr;
+        }
+    }
+    regions_.clear();
+    canvas_x_ = canvas_y_ = canvas_width_ = canvas_height_ = 0;
+}
+
+void SpanCompositor::calculate_video_rect(int frame_width, int frame_height,
+                                          double& video_x, double& video_y,
+                                          double& video_width, double& video_height) const {
+    // Same placement rules as the single-output renderers, applied to the whole canvas
+    double canvas_aspect = (double)canvas_width_ / canvas_height_;
+    double frame_aspect = (double)frame_width / frame_height;
+
+    video_x = 0.0;
+    video_y = 0.0;
+    video_width = canvas_width_;
+    video_height = canvas_height_;
+
+    switch (scaling_) {
+        case ScalingMode::STRETCH:
+            break;
+
+        case ScalingMode::FILL:
+            if (frame_aspect > canvas_aspect) {
+                video_width = canvas_height_ * frame_aspect;
+                video_x = (canvas_width_ - video_width) / 2.0;
+            } else {
+                video_height = canvas_width_ / frame_aspect;
+                video_y = (canvas_height_ - video_height) / 2.0;
+            }
+            break;
+
+        case ScalingMode::FIT:
+        case ScalingMode::DEFAULT:
+        default:
+            if (frame_aspect > canvas_aspect) {
+                video_height = canvas_width_ / frame_aspect;
+                video_y = (canvas_height_ - video_height) / 2.0;
+            } else {
+                video_width = canvas_height_ * frame_aspect;
+                video_x = (canvas_width_ - video_width) / 2.0;
+            }
+            break;
+    }
+}
+
+bool SpanCompositor::update_mapping(RegionState& state, int frame_width, int frame_height) {
+    if (state.frame_width == frame_width && state.frame_height == frame_height) {
+        return true;
+    }
+
+    if (state.sws_context) {
+        sws_freeContext(state.sws_context);
+        state.sws_context = nullptr;
+    }
+
+    state.frame_width = frame_width;
+    state.frame_height = frame_height;
+    state.src_width = state.src_height = 0;
+    state.dst_width = state.dst_height = 0;
+
+    double video_x, video_y, video_width, video_height;
+    calculate_video_rect(frame_width, frame_height, video_x, video_y, video_width, video_height);
+
+    // Region rectangle relative to the canvas origin
+    double region_x = state.region.x - canvas_x_;
+    double region_y = state.region.y - canvas_y_;
+
+    double left = std::max(region_x, video_x);
+    double top = std::max(region_y, video_y);
+    double right = std::min(region_x + state.region.width, video_x + video_width);
+    double bottom = std::min(region_y + state.region.height, video_y + video_height);
+
+    if (right <= left || bottom <= top) {
+        // Video does not reach this output (e.g. letterbox area)
+        return true;
+    }
+
+    state.dst_x = (int)std::floor(left - region_x);
+    state.dst_y = (int)std::floor(top - region_y);
+    state.dst_width = std::min((int)std::lround(right - region_x), state.region.width) - state.dst_x;
+    state.dst_height = std::min((int)std::lround(bottom - region_y), state.region.height) - state.dst_y;
+
+    double scale_x = frame_width / video_width;
+    double scale_y = frame_height / video_height;
+    state.src_x = std::max(0, (int)std::floor((left - video_x) * scale_x));
+    state.src_y = std::max(0, (int)std::floor((top - video_y) * scale_y));
+    state.src_width = std::min(frame_width, (int)std::ceil((right - video_x) * scale_x)) - state.src_x;
+    state.src_height = std::min(frame_height, (int)std::ceil((bottom - video_y) * scale_y)) - state.src_y;
+
+    if (state.dst_width <= 0 || state.dst_height <= 0 || state.src_width <= 0 || state.src_height <= 0) {
+        state.dst_width = state.dst_height = 0;
+        return true;
+    }
+
+    state.sws_context = sws_getContext(state.src_width, state.src_height, AV_PIX_FMT_RGBA,
+                                       state.dst_width, state.dst_height, AV_PIX_FMT_RGBA,
+                                       SWS_BILINEAR, nullptr, nullptr, nullptr);
+    if (!state.sws_context) {
+        std::cerr << "ERROR: Failed to create span scaler for " << state.region.name << std::endl;
+        state.frame_width = state.frame_height = 0;
+        return false;
+    }
+
+    std::cout << "DEBUG: Span " << state.region.name << " crop " << state.src_width << "x" << state.src_height
+              << "+" << state.src_x << "+" << state.src_y << " -> " << state.dst_width << "x" << state.dst_height
+              << "+" << state.dst_x << "+" << state.dst_y << std::endl;
+    return true;
+}
+
+const unsigned char* SpanCompositor::compose_region(size_t index, const unsigned char* frame_data,
+                                                    int frame_width, int frame_height) {
+    if (index >= regions_.size()) {
+        return nullptr;
+    }
+
+    RegionState& state = regions_[index];
+    size_t size = (size_t)state.region.width * state.region.height * 4;
+    if (state.buffer.size() != size) {
+        state.buffer.assign(size, 0);
+    }
+
+    if (!compose_region_into(index, frame_data, frame_width, frame_height,
+                             state.buffer.data(), state.region.width * 4)) {
+        return nullptr;
+    }
+    return state.buffer.data();
+}
+
+bool SpanCompositor::compose_region_into(size_t index, const unsigned char* frame_data,
+                                         int frame_width, int frame_height,
+                                         unsigned char* dst, int dst_stride) {
+    if (index >= regions_.size() || !frame_data || !dst || frame_width <= 0 || frame_height <= 0) {
+        return false;
+    }
+
+    RegionState& state = regions_[index];
+    if (!update_mapping(state, frame_width, frame_height)) {
+        return false;
+    }
+
+    // Opaque black wherever the video does not cover the output
+    bool full_coverage = state.dst_x == 0 && state.dst_y == 0 &&
+                         state.dst_width == state.region.width && state.dst_height == state.region.height;
+    if (!full_coverage) {
+        static const unsigned char black[4] = { 0, 0, 0, 255 };
+        for (int y = 0; y < state.region.height; y++) {
+            unsigned char* row = dst + (size_t)y * dst_stride;
+            for (int x = 0; x < state.region.width; x++) {
+                std::memcpy(row + x * 4, black, 4);
+            }
+        }
+    }
+
+    if (!state.sws_context) {
+        return true;
+    }
+
+    // Offset the source pointer to the crop so only the visible part is scaled
+    int src_stride = frame_width * 4;
+    const uint8_t* src_planes[4] = {
+        frame_data + (size_t)state.src_y * src_stride + state.src_x * 4, nullptr, nullptr, nullptr
+    };
+    int src_strides[4] = { src_stride, 0, 0, 0 };
+    uint8_t* dst_planes[4] = {
+        dst + (size_t)state.dst_y * dst_stride + state.dst_x * 4, nullptr, nullptr, nullptr
+    };
+    int dst_strides[4] = { dst_stride, 0, 0, 0 };
+
+    sws_scale(state.sws_context, src_planes, src_strides, 0, state.src_height, dst_planes, dst_strides);
+    return true;
+}
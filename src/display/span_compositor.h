@@ -0,0 +1,71 @@
+#pragma once
+
+#include "display_manager.h"
+#include <vector>
+#include <string>
+
+struct SwsContext;
+
+// Rectangle of one monitor in desktop coordinates
+struct SpanRegion {
+    std::string name;
+    int x = 0;
+    int y = 0;
+    int width = 0;
+    int height = 0;
+};
+
+/**
+ * Spreads one decoded RGBA frame across several monitors.
+ *
+ * The video is placed on the bounding box of all regions according to the
+ * scaling mode; each region then gets only its own crop of the source frame,
+ * scaled once at that output's resolution. The frame is decoded once no
+ * matter how many outputs it covers.
+ */
+class SpanCompositor {
+public:
+    SpanCompositor();
+    ~SpanCompositor();
+
+    bool initialize(const std::vector<SpanRegion>& regions, ScalingMode scaling);
+    void cleanup();
+
+    size_t get_region_count() const { return regions_.size(); }
+    const SpanRegion& get_region(size_t index) const { return regions_[index].region; }
+
+    // Bounding box of every region
+    int get_canvas_x() const { return canvas_x_; }
+    int get_canvas_y() const { return canvas_y_; }
+    int get_canvas_width() const { return canvas_width_; }
+    int get_canvas_height() const { return canvas_height_; }
+
+    // Crop + scale the part of the frame that lands on region `index` into an
+    // internal RGBA buffer of the region's size
+    const unsigned char* compose_region(size_t index, const unsigned char* frame_data,
+                                        int frame_width, int frame_height);
+
+    // Same, but writes into caller memory (dst points at the region's top-left pixel)
+    bool compose_region_into(size_t index, const unsigned char* frame_data,
+                             int frame_width, int frame_height,
+                             unsigned char* dst, int dst_stride);
+
+private:
+    struct RegionState {
+        SpanRegion region;
+        SwsContext* sws_context = nullptr;
+        int frame_width = 0;        // Source size the mapping below was computed for
+        int frame_height = 0;
+        int src_x = 0, src_y = 0, src_width = 0, src_height = 0;   // Crop in source pixels
+        int dst_x = 0, dst_y = 0, dst_width = 0, dst_height = 0;   // Target inside the region
+        std::vector<unsigned char> buffer;
+    };
+
+    std::vector<RegionState> regions_;
+    ScalingMode scaling_;
+    int canvas_x_, canvas_y_, canvas_width_, canvas_height_;
+
+    bool update_mapping(RegionState& state, int frame_width, int frame_height);
+    void calculate_video_rect(int frame_width, int frame_height,
+                              double& video_x, double& video_y, double& video_width, double& video_height) const;
+};
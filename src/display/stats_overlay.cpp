@@ -0,0 +1,232 @@
+#include "stats_overlay.h"
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+#include <cctype>
+
+namespace {
+
+constexpr int GLYPH_WIDTH = 5;
+constexpr int GLYPH_HEIGHT = 7;
+constexpr int CELL_WIDTH = GLYPH_WIDTH + 1;
+constexpr int LINE_HEIGHT = GLYPH_HEIGHT + 2;
+constexpr int PIXEL_SCALE = 2;              // Each font pixel is 2x2 output pixels
+constexpr int PADDING = 3 * PIXEL_SCALE;
+constexpr unsigned char BACKGROUND = 0x20;
+constexpr unsigned char FOREGROUND = 0xf0;
+
+// 5x7 glyphs, one byte per row, bit 4 is the leftmost column
+const char GLYPH_CHARS[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ./-:%_?";
+const unsigned char GLYPHS[][GLYPH_HEIGHT] = {
+    { 0x0e, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0e },  // 0
+    { 0x04, 0x0c, 0x04, 0x04, 0x04, 0x04, 0x0e },  // 1
+    { 0x0e, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1f },  // 2
+    { 0x1f, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0e },  // 3
+    { 0x02, 0x06, 0x0a, 0x12, 0x1f, 0x02, 0x02 },  // 4
+    { 0x1f, 0x10, 0x1e, 0x01, 0x01, 0x11, 0x0e },  // 5
+    { 0x06, 0x08, 0x10, 0x1e, 0x11, 0x11, 0x0e },  // 6
+    { 0x1f, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08 },  // 7
+    { 0x0e, 0x11, 0x11, 0x0e, 0x11, 0x11, 0x0e },  // 8
+    { 0x0e, 0x11, 0x11, 0x0f, 0x01, 0x02, 0x0c },  // 9
+    { 0x0e, 0x11, 0x11, 0x1f, 0x11, 0x11, 0x11 },  // A
+    { 0x1e, 0x11, 0x11, 0x1e, 0x11, 0x11, 0x1e },  // B
+    { 0x0e, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0e },  // C
+    { 0x1c, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1c },  // D
+    { 0x1f, 0x10, 0x10, 0x1e, 0x10, 0x10, 0x1f },  // E
+    { 0x1f, 0x10, 0x10, 0x1e, 0x10, 0x10, 0x10 },  // F
+    { 0x0e, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0f },  // G
+    { 0x11, 0x11, 0x11, 0x1f, 0x11, 0x11, 0x11 },  // H
+    { 0x0e, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0e },  // I
+    { 0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0c },  // J
+    { 0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11 },  // K
+    { 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1f },  // L
+    { 0x11, 0x1b, 0x15, 0x15, 0x11, 0x11, 0x11 },  // M
+    { 0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11 },  // N
+    { 0x0e, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0e },  // O
+    { 0x1e, 0x11, 0x11, 0x1e, 0x10, 0x10, 0x10 },  // P
+    { 0x0e, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0d },  // Q
+    { 0x1e, 0x11, 0x11, 0x1e, 0x14, 0x12, 0x11 },  // R
+    { 0x0f, 0x10, 0x10, 0x0e, 0x01, 0x01, 0x1e },  // S
+    { 0x1f, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04 },  // T
+    { 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0e },  // U
+    { 0x11, 0x11, 0x11, 0x11, 0x11, 0x0a, 0x04 },  // V
+    { 0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0a },  // W
+    { 0x11, 0x11, 0x0a, 0x04, 0x0a, 0x11, 0x11 },  // X
+    { 0x11, 0x11, 0x11, 0x0a, 0x04, 0x04, 0x04 },  // Y
+    { 0x1f, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1f },  // Z
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x0c, 0x0c },  // .
+    { 0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x00 },  // /
+    { 0x00, 0x00, 0x00, 0x1f, 0x00, 0x00, 0x00 },  // -
+    { 0x00, 0x0c, 0x0c, 0x00, 0x0c, 0x0c, 0x00 },  // :
+    { 0x18, 0x19, 0x02, 0x04, 0x08, 0x13, 0x03 },  // %
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1f },  // _
+    { 0x0e, 0x11, 0x01, 0x02, 0x04, 0x00, 0x04 },  // ?
+};
+
+// nullptr for a space; anything the font lacks is drawn as '?'
+const unsigned char* find_glyph(char c) {
+    if (c == ' ') {
+        return nullptr;
+    }
+    c = (char)std::toupper((unsigned char)c);
+    const char* found = std::strchr(GLYPH_CHARS, c);
+    if (!found || c == '\0') {
+        found = std::strchr(GLYPH_CHARS, '?');
+    }
+    return GLYPHS[found - GLYPH_CHARS];
+}
+
+} // namespace
+
+StatsOverlay::StatsOverlay(const std::string& label)
+    : label_(label), target_fps_(0.0), window_start_(std::chrono::steady_clock::now()),
+      decode_total_ms_(0.0), decode_count_(0), scale_total_ms_(0.0), present_total_ms_(0.0),
+      present_count_(0), drop_count_(0), decoder_drops_(0), decoder_drops_base_(0),
+      queue_packets_(0), queue_seconds_(0.0), width_(0), height_(0), generation_(0),
+      drawn_buffer_(nullptr), drawn_generation_(0) {
+    // Something to show before the first window completes
+    render_text({ label_, "COLLECTING STATS" });
+}
+
+void StatsOverlay::record_decode(double ms) {
+    decode_total_ms_ += ms;
+    decode_count_++;
+}
+
+void StatsOverlay::record_drop() {
+    drop_count_++;
+}
+
+void StatsOverlay::set_decoder_drops(int total) {
+    decoder_drops_ = total;
+}
+
+void StatsOverlay::set_queue(size_t packets, double seconds) {
+    queue_packets_ = packets;
+    queue_seconds_ = seconds;
+}
+
+void StatsOverlay::record_scale(double ms) {
+    scale_total_ms_ += ms;
+}
+
+void StatsOverlay::record_present(double ms) {
+    present_total_ms_ += ms;
+    present_count_++;
+}
+
+double StatsOverlay::elapsed_ms(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+bool StatsOverlay::intersects(const DirtyRect& a, const DirtyRect& b) {
+    return a.x < b.x + b.width && b.x < a.x + a.width && a.y < b.y + b.height && b.y < a.y + a.height;
+}
+
+bool StatsOverlay::refresh() {
+    auto now = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(now - window_start_).count();
+    if (seconds < 1.0) {
+        return false;
+    }
+
+    char line[96];
+    std::vector<std::string> lines;
+    lines.push_back(label_);
+
+    double decode_ms = decode_count_ > 0 ? decode_total_ms_ / decode_count_ : 0.0;
+    double scale_ms = present_count_ > 0 ? scale_total_ms_ / present_count_ : 0.0;
+    double present_ms = present_count_ > 0 ? present_total_ms_ / present_count_ : 0.0;
+    std::snprintf(line, sizeof(line), "DEC %.2f SCALE %.2f PRES %.2f MS", decode_ms, scale_ms, present_ms);
+    lines.push_back(line);
+
+    int drops = drop_count_ + (decoder_drops_ - decoder_drops_base_);
+    if (target_fps_ > 0.0) {
+        std::snprintf(line, sizeof(line), "FPS %.1f/%.1f DROP %d", present_count_ / seconds, target_fps_, drops);
+    } else {
+        std::snprintf(line, sizeof(line), "FPS %.1f DROP %d", present_count_ / seconds, drops);
+    }
+    lines.push_back(line);
+
+    std::snprintf(line, sizeof(line), "QUEUE %zu PKT %.2f S", queue_packets_, queue_seconds_);
+    lines.push_back(line);
+
+    render_text(lines);
+
+    window_start_ = now;
+    decode_total_ms_ = scale_total_ms_ = present_total_ms_ = 0.0;
+    decode_count_ = present_count_ = drop_count_ = 0;
+    decoder_drops_base_ = decoder_drops_;
+    return true;
+}
+
+void StatsOverlay::render_text(const std::vector<std::string>& lines) {
+    size_t columns = 0;
+    for (const auto& text : lines) {
+        columns = std::max(columns, text.size());
+    }
+
+    // The box never shrinks: outputs that only redraw changed areas would
+    // otherwise keep the edge of a previous, wider HUD on screen
+    width_ = std::max(width_, PADDING * 2 + (int)columns * CELL_WIDTH * PIXEL_SCALE);
+    height_ = std::max(height_, PADDING * 2 + (int)lines.size() * LINE_HEIGHT * PIXEL_SCALE -
+                                (LINE_HEIGHT - GLYPH_HEIGHT) * PIXEL_SCALE);
+    pixels_.assign((size_t)width_ * height_ * 4, BACKGROUND);
+    for (size_t i = 3; i < pixels_.size(); i += 4) {
+        pixels_[i] = 0xff;
+    }
+
+    for (size_t line = 0; line < lines.size(); line++) {
+        int top = PADDING + (int)line * LINE_HEIGHT * PIXEL_SCALE;
+        for (size_t column = 0; column < lines[line].size(); column++) {
+            const unsigned char* glyph = find_glyph(lines[line][column]);
+            if (!glyph) {
+                continue;
+            }
+            int left = PADDING + (int)column * CELL_WIDTH * PIXEL_SCALE;
+            for (int gy = 0; gy < GLYPH_HEIGHT * PIXEL_SCALE; gy++) {
+                unsigned char bits = glyph[gy / PIXEL_SCALE];
+                unsigned char* row = pixels_.data() + ((size_t)(top + gy) * width_ + left) * 4;
+                for (int gx = 0; gx < GLYPH_WIDTH * PIXEL_SCALE; gx++) {
+                    if (bits & (0x10 >> (gx / PIXEL_SCALE))) {
+                        row[gx * 4 + 0] = row[gx * 4 + 1] = row[gx * 4 + 2] = FOREGROUND;
+                    }
+                }
+            }
+        }
+    }
+    generation_++;
+}
+
+DirtyRect StatsOverlay::get_rect(int dst_width, int dst_height) const {
+    DirtyRect rect;
+    rect.x = MARGIN;
+    rect.y = MARGIN;
+    rect.width = std::max(0, std::min(width_, dst_width - MARGIN));
+    rect.height = std::max(0, std::min(height_, dst_height - MARGIN));
+    return rect;
+}
+
+bool StatsOverlay::draw_bgra(unsigned char* dst, int dst_width, int dst_height, bool covered, DirtyRect* rect) {
+    bool changed = refresh();
+    if (!dst || (!covered && !changed && drawn_buffer_ == dst && drawn_generation_ == generation_)) {
+        return false;
+    }
+
+    DirtyRect area = get_rect(dst_width, dst_height);
+    if (area.width <= 0 || area.height <= 0) {
+        return false;
+    }
+
+    for (int y = 0; y < area.height; y++) {
+        memcpy(dst + ((size_t)(area.y + y) * dst_width + area.x) * 4,
+               pixels_.data() + (size_t)y * width_ * 4, (size_t)area.width * 4);
+    }
+
+    drawn_buffer_ = dst;
+    drawn_generation_ = generation_;
+    if (rect) {
+        *rect = area;
+    }
+    return true;
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstddef>
+#include "tile_tracker.h"
+
+/**
+ * On-wallpaper performance HUD (--stats-overlay).
+ *
+ * The application records decode times, skipped frames and queue depth; the
+ * display that owns the output records its scale and present times. Once a
+ * second the averages are rendered with a built-in 5x7 bitmap font into a
+ * small opaque image, so the per-frame cost is a copy of a few thousand
+ * pixels (CPU presenters) or one tiny textured quad (GL presenters).
+ *
+ * The image only uses gray levels, so its bytes read the same as BGRA and
+ * RGBA and can be copied into either kind of buffer unchanged.
+ */
+class StatsOverlay {
+public:
+    static constexpr int MARGIN = 8;            // Output pixels from the top-left corner
+
+    explicit StatsOverlay(const std::string& label);
+
+    // Application side
+    void record_decode(double ms);
+    void record_drop();                         // Decoded but never presented
+    void set_decoder_drops(int total);          // MediaPlayer's running count of late frames
+    void set_queue(size_t packets, double seconds);
+    void set_target_fps(double fps) { target_fps_ = fps; }
+
+    // Display side (one present = one frame on screen)
+    void record_scale(double ms);
+    void record_present(double ms);
+
+    // Re-render the HUD if the one-second window is over; true when the image changed
+    bool refresh();
+    const unsigned char* get_pixels() const { return pixels_.data(); }
+    int get_width() const { return width_; }
+    int get_height() const { return height_; }
+    unsigned long get_generation() const { return generation_; }
+
+    // HUD rectangle on a dst_width x dst_height output (clipped; may be empty)
+    DirtyRect get_rect(int dst_width, int dst_height) const;
+
+    // Copy the HUD into a BGRA buffer. Skipped (false) unless the caller just
+    // overwrote the HUD area (`covered`) or the text changed since the last copy
+    // into this buffer. `rect` receives the area to damage.
+    bool draw_bgra(unsigned char* dst, int dst_width, int dst_height, bool covered, DirtyRect* rect);
+
+    static double elapsed_ms(std::chrono::steady_clock::time_point start);
+    static bool intersects(const DirtyRect& a, const DirtyRect& b);
+
+private:
+    std::string label_;
+    double target_fps_;
+
+    // Current one-second window
+    std::chrono::steady_clock::time_point window_start_;
+    double decode_total_ms_;
+    int decode_count_;
+    double scale_total_ms_;
+    double present_total_ms_;
+    int present_count_;
+    int drop_count_;
+    int decoder_drops_;
+    int decoder_drops_base_;
+    size_t queue_packets_;
+    double queue_seconds_;
+
+    // Rendered HUD
+    std::vector<unsigned char> pixels_;
+    int width_;
+    int height_;
+    unsigned long generation_;
+    const unsigned char* drawn_buffer_;
+    unsigned long drawn_generation_;
+
+    void render_text(const std::vector<std::string>& lines);
+};
@@ -0,0 +1,186 @@
+#include "tile_tracker.h"
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+
+TileTracker::TileTracker()
+    : width_(0), height_(0), target_width_(0), target_height_(0), target_mode_(-1), valid_(false),
+      frames_full_(0), frames_partial_(0), frames_unchanged_(0), tiles_checked_(0), tiles_dirty_(0),
+      stats_start_(std::chrono::steady_clock::now()) {}
+
+void TileTracker::reset() {
+    valid_ = false;
+    dirty_rects_.clear();
+}
+
+void TileTracker::set_target(int width, int height, int mode) {
+    if (width != target_width_ || height != target_height_ || mode != target_mode_) {
+        target_width_ = width;
+        target_height_ = height;
+        target_mode_ = mode;
+        reset();
+    }
+}
+
+bool TileTracker::update(const unsigned char* frame, int width, int height) {
+    dirty_rects_.clear();
+    if (!frame || width <= 0 || height <= 0) {
+        return false;
+    }
+
+    size_t stride = (size_t)width * 4;
+    size_t size = stride * height;
+    int tiles_x = (width + TILE_SIZE - 1) / TILE_SIZE;
+    int tiles_y = (height + TILE_SIZE - 1) / TILE_SIZE;
+
+    if (!valid_ || width != width_ || height != height_ || previous_.size() != size) {
+        previous_.assign(frame, frame + size);
+        dirty_tiles_.assign((size_t)tiles_x * tiles_y, 0);
+        width_ = width;
+        height_ = height;
+        valid_ = true;
+        frames_full_++;
+        return false;
+    }
+
+    // Row-by-row memcmp per tile: glibc's memcmp is vectorized, and it bails out
+    // at the first difference so changed tiles cost little more than a copy
+    int dirty_count = 0;
+    for (int ty = 0; ty < tiles_y; ty++) {
+        int y0 = ty * TILE_SIZE;
+        int rows = std::min(TILE_SIZE, height - y0);
+        for (int tx = 0; tx < tiles_x; tx++) {
+            int x0 = tx * TILE_SIZE;
+            size_t row_bytes = (size_t)std::min(TILE_SIZE, width - x0) * 4;
+            size_t offset = (size_t)y0 * stride + (size_t)x0 * 4;
+
+            bool dirty = false;
+            for (int row = 0; row < rows; row++) {
+                size_t row_offset = offset + (size_t)row * stride;
+                if (dirty || std::memcmp(previous_.data() + row_offset, frame + row_offset, row_bytes) != 0) {
+                    // Keep the reference copy current for the rest of the tile
+                    std::memcpy(previous_.data() + row_offset, frame + row_offset, row_bytes);
+                    dirty = true;
+                }
+            }
+            if (dirty) {
+                dirty_count++;
+            }
+            dirty_tiles_[(size_t)ty * tiles_x + tx] = dirty ? 1 : 0;
+        }
+    }
+
+    int tile_count = tiles_x * tiles_y;
+    tiles_checked_ += tile_count;
+    tiles_dirty_ += dirty_count;
+
+    if (dirty_count == 0) {
+        frames_unchanged_++;
+        return true;
+    }
+    if (dirty_count * 100 > tile_count * FULL_REDRAW_PERCENT) {
+        frames_full_++;
+        return false;
+    }
+
+    build_rects(tiles_x, tiles_y);
+    frames_partial_++;
+    return true;
+}
+
+void TileTracker::build_rects(int tiles_x, int tiles_y) {
+    // Horizontal runs of dirty tiles per tile row, then runs with the same
+    // span in consecutive rows are merged into one taller rectangle
+    std::vector<DirtyRect> open_rects;
+    for (int ty = 0; ty < tiles_y; ty++) {
+        std::vector<DirtyRect> row_rects;
+        int tx = 0;
+        while (tx < tiles_x) {
+            if (!dirty_tiles_[(size_t)ty * tiles_x + tx]) {
+                tx++;
+                continue;
+            }
+            int start = tx;
+            while (tx < tiles_x && dirty_tiles_[(size_t)ty * tiles_x + tx]) {
+                tx++;
+            }
+            DirtyRect rect;
+            rect.x = start * TILE_SIZE;
+            rect.y = ty * TILE_SIZE;
+            rect.width = std::min(tx * TILE_SIZE, width_) - rect.x;
+            rect.height = std::min((ty + 1) * TILE_SIZE, height_) - rect.y;
+            row_rects.push_back(rect);
+        }
+
+        std::vector<DirtyRect> next_open;
+        for (auto& rect : row_rects) {
+            auto match = std::find_if(open_rects.begin(), open_rects.end(), [&](const DirtyRect& open) {
+                return open.x == rect.x && open.width == rect.width && open.y + open.height == rect.y;
+            });
+            if (match != open_rects.end()) {
+                rect.y = match->y;
+                rect.height += match->height;
+                open_rects.erase(match);
+            }
+            next_open.push_back(rect);
+        }
+        // Anything not extended by this row is finished
+        dirty_rects_.insert(dirty_rects_.end(), open_rects.begin(), open_rects.end());
+        open_rects.swap(next_open);
+    }
+    dirty_rects_.insert(dirty_rects_.end(), open_rects.begin(), open_rects.end());
+}
+
+bool TileTracker::map_to_output(const DirtyRect& rect, int src_width, int src_height,
+                                int render_x, int render_y, int render_width, int render_height,
+                                bool flip_y, int output_width, int output_height, DirtyRect& out) {
+    if (src_width <= 0 || src_height <= 0 || render_width <= 0 || render_height <= 0) {
+        return false;
+    }
+
+    // Output pixel (render_x + i) samples source column i * src_width / render_width,
+    // so source columns [x0, x1) are hit by i in [ceil(x0 * rw / sw), ceil(x1 * rw / sw))
+    long long src_x0 = rect.x;
+    long long src_x1 = rect.x + rect.width;
+    long long src_y0 = flip_y ? src_height - (rect.y + rect.height) : rect.y;
+    long long src_y1 = flip_y ? src_height - rect.y : rect.y + rect.height;
+
+    // One extra pixel on each side absorbs rounding at the edges
+    long long left = render_x + (src_x0 * render_width + src_width - 1) / src_width - 1;
+    long long right = render_x + (src_x1 * render_width + src_width - 1) / src_width + 1;
+    long long top = render_y + (src_y0 * render_height + src_height - 1) / src_height - 1;
+    long long bottom = render_y + (src_y1 * render_height + src_height - 1) / src_height + 1;
+
+    left = std::max<long long>(left, std::max(render_x, 0));
+    top = std::max<long long>(top, std::max(render_y, 0));
+    right = std::min<long long>(right, std::min(render_x + render_width, output_width));
+    bottom = std::min<long long>(bottom, std::min(render_y + render_height, output_height));
+    if (right <= left || bottom <= top) {
+        return false;
+    }
+
+    out.x = (int)left;
+    out.y = (int)top;
+    out.width = (int)(right - left);
+    out.height = (int)(bottom - top);
+    return true;
+}
+
+void TileTracker::log_stats(const std::string& label) {
+    auto now = std::chrono::steady_clock::now();
+    if (now - stats_start_ < std::chrono::seconds(5)) {
+        return;
+    }
+
+    int frames = frames_full_ + frames_partial_ + frames_unchanged_;
+    if (frames > 0) {
+        double dirty_percent = tiles_checked_ > 0 ? 100.0 * tiles_dirty_ / tiles_checked_ : 0.0;
+        std::cout << "DEBUG: " << label << " dirty tiles: " << frames_partial_ << " partial, "
+                  << frames_full_ << " full, " << frames_unchanged_ << " unchanged frames, "
+                  << (int)dirty_percent << "% of tiles changed" << std::endl;
+    }
+
+    frames_full_ = frames_partial_ = frames_unchanged_ = 0;
+    tiles_checked_ = tiles_dirty_ = 0;
+    stats_start_ = now;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <vector>
+#include <chrono>
+#include <string>
+
+// Rectangle in pixels (source frame or output buffer coordinates)
+struct DirtyRect {
+    int x = 0;
+    int y = 0;
+    int width = 0;
+    int height = 0;
+};
+
+/**
+ * Tile-level change detection for mostly static (cinemagraph) video.
+ *
+ * Each RGBA frame is compared with the previous one in TILE_SIZE x TILE_SIZE
+ * tiles; only tiles that differ are reported, merged into as few rectangles
+ * as possible. The CPU presenters rescale just those rectangles into their
+ * output buffer and hand the matching damage to the compositor / X server.
+ *
+ * The tracker also remembers what it is drawing into (output size and
+ * scaling): when that changes, or a new output buffer is created, call
+ * set_target()/reset() so the next frame is drawn in full.
+ */
+class TileTracker {
+public:
+    static constexpr int TILE_SIZE = 64;
+
+    TileTracker();
+
+    // Forget the previous frame - the next update() asks for a full redraw
+    void reset();
+
+    // Output the frames are drawn into; resets when any of it changes
+    void set_target(int width, int height, int mode);
+
+    // Compare a new RGBA frame with the previous one. Returns false when the
+    // whole frame must be redrawn (first frame, size change, or most tiles
+    // changed). Returns true when only get_dirty_rects() changed - which may
+    // be none at all.
+    bool update(const unsigned char* frame, int width, int height);
+    const std::vector<DirtyRect>& get_dirty_rects() const { return dirty_rects_; }
+
+    // Output-space rectangle covered by `rect` of a src_width x src_height frame
+    // drawn at render_x/render_y with render_width x render_height (nearest
+    // sampling, optionally flipped vertically), clipped to the output.
+    // Returns false if nothing of it lands on the output.
+    static bool map_to_output(const DirtyRect& rect, int src_width, int src_height,
+                              int render_x, int render_y, int render_width, int render_height,
+                              bool flip_y, int output_width, int output_height, DirtyRect& out);
+
+    // Per-output summary every 5 seconds
+    void log_stats(const std::string& label);
+
+private:
+    std::vector<unsigned char> previous_;
+    std::vector<unsigned char> dirty_tiles_;
+    std::vector<DirtyRect> dirty_rects_;
+    int width_;
+    int height_;
+    int target_width_;
+    int target_height_;
+    int target_mode_;
+    bool valid_;
+
+    // Stats
+    int frames_full_;
+    int frames_partial_;
+    int frames_unchanged_;
+    long long tiles_checked_;
+    long long tiles_dirty_;
+    std::chrono::steady_clock::time_point stats_start_;
+
+    static constexpr int FULL_REDRAW_PERCENT = 60;  // Partial updates stop paying off above this
+
+    void build_rects(int tiles_x, int tiles_y);
+};
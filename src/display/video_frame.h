@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+enum class VideoPixelFormat {
+    RGBA,       // Packed 8-bit RGBA in planes[0]
+    I420,       // Planar Y, U, V with 2x2 subsampled chroma
+    NV12        // Planar Y, interleaved UV in planes[1]
+};
+
+/**
+ * One picture handed to a DisplayOutput: plane pointers and row strides, the
+ * pixel format and color range, plus an optional owner that keeps the memory
+ * alive. Decoder frames are described in place (the owner holds a reference
+ * to the AVFrame buffers), so backends pick a path by format and read padded
+ * rows directly instead of the caller packing them first.
+ *
+ * Without an owner the planes are only valid until the producer's next frame.
+ */
+struct VideoFrame {
+    const unsigned char* planes[3] = { nullptr, nullptr, nullptr };
+    int strides[3] = { 0, 0, 0 };           // Bytes per row of each plane
+    int width = 0;
+    int height = 0;
+    VideoPixelFormat format = VideoPixelFormat::RGBA;
+    bool full_range = false;                // YUV: JPEG (0-255) range instead of MPEG (16-235)
+    std::shared_ptr<void> owner;            // Reference on the underlying buffer, may be empty
+
+    static VideoFrame rgba(const unsigned char* data, int width, int height, int stride = 0) {
+        VideoFrame frame;
+        frame.planes[0] = data;
+        frame.strides[0] = stride > 0 ? stride : width * 4;
+        frame.width = width;
+        frame.height = height;
+        return frame;
+    }
+
+    bool is_yuv() const { return format != VideoPixelFormat::RGBA; }
+
+    bool is_valid() const {
+        if (!planes[0] || width <= 0 || height <= 0) {
+            return false;
+        }
+        switch (format) {
+            case VideoPixelFormat::RGBA: return strides[0] >= width * 4;
+            case VideoPixelFormat::NV12: return planes[1] != nullptr;
+            case VideoPixelFormat::I420: return planes[1] != nullptr && planes[2] != nullptr;
+        }
+        return false;
+    }
+
+    // Tightly packed RGBA for the CPU kernels: the frame itself when its rows
+    // are contiguous, otherwise a copy in `scratch`. nullptr for YUV frames.
+    const unsigned char* packed_rgba(std::vector<unsigned char>& scratch) const {
+        if (format != VideoPixelFormat::RGBA || !planes[0]) {
+            return nullptr;
+        }
+        size_t row_bytes = (size_t)width * 4;
+        if ((size_t)strides[0] == row_bytes) {
+            return planes[0];
+        }
+        scratch.resize(row_bytes * height);
+        for (int y = 0; y < height; y++) {
+            std::memcpy(scratch.data() + y * row_bytes, planes[0] + (size_t)y * strides[0], row_bytes);
+        }
+        return scratch.data();
+    }
+};
@@ -1,17 +1,22 @@
 #include "wayland_display.h"
 #include "../../media_player.h"
+#include "../display_backend.h"
+#include "../stats_overlay.h"
 #include <iostream>
 #include <cstring>
 #include <unistd.h>
 #include <sys/mman.h>
 #include <fcntl.h>
 #include <cmath>
+#include <algorithm>
 #include <chrono>
 #include <thread>
+#include <poll.h>
 
 // Import protocol headers
 extern "C" {
 #include "xdg-shell-client-protocol.h"
+#include "xdg-output-unstable-v1-client-protocol.h"
 }
 
 // Use our wrapper to deal with namespace keyword issues
@@ -45,6 +50,11 @@ static const struct zwlr_layer_surface_v1_listener layer_surface_listener = {
     WaylandDisplay::layer_surface_closed
 };
 
+// Frame callback listener
+static const struct wl_callback_listener frame_callback_listener = {
+    WaylandDisplay::frame_callback_done
+};
+
 // Output listener
 static const struct wl_output_listener output_listener = {
     WaylandDisplay::output_geometry,
@@ -55,9 +65,19 @@ static const struct wl_output_listener output_listener = {
     WaylandDisplay::output_description
 };
 
+// XDG Output listener
+static const struct zxdg_output_v1_listener xdg_output_listener = {
+    WaylandDisplay::xdg_output_logical_position,
+    WaylandDisplay::xdg_output_logical_size,
+    WaylandDisplay::xdg_output_done,
+    WaylandDisplay::xdg_output_name,
+    WaylandDisplay::xdg_output_description
+};
+
 WaylandDisplay::WaylandDisplay(const std::string& output_name)
     : output_name_(output_name), display_(nullptr), registry_(nullptr), 
       compositor_(nullptr), surface_(nullptr), output_(nullptr), output_registry_name_(0),
+      xdg_output_manager_(nullptr), output_x_(0), output_y_(0),
       xdg_wm_base_(nullptr), xdg_surface_(nullptr), xdg_toplevel_(nullptr),
       layer_shell_(nullptr), layer_surface_(nullptr),
       egl_display_(EGL_NO_DISPLAY), egl_context_(EGL_NO_CONTEXT), 
@@ -66,17 +86,21 @@ WaylandDisplay::WaylandDisplay(const std::string& output_name)
       shm_data_(nullptr), shm_fd_(-1), shm_size_(0),
       image_renderer_(std::make_unique<WaylandImageRenderer>()),
       video_renderer_(std::make_unique<WaylandVideoRenderer>()),
+      dirty_tracking_(false), stats_overlay_(nullptr),
+      gl_video_active_(false), gl_frames_presented_(0), gl_frames_throttled_(0), frame_presented_(true),
       frame_callback_(nullptr), frame_callback_pending_(false),
       windowed_mode_(false), use_layer_shell_(true), prefer_egl_(true),
       x_(0), y_(0), width_(800), height_(600),
       output_width_(0), output_height_(0), scale_factor_(1),
       current_scaling_(ScalingMode::DEFAULT),
       pending_image_data_(nullptr), pending_image_width_(0), pending_image_height_(0), 
-      pending_scaling_(ScalingMode::DEFAULT), has_pending_render_(false) {}
+      pending_scaling_(ScalingMode::DEFAULT), has_pending_render_(false),
+      geometry_changed_(false) {}
 
 WaylandDisplay::WaylandDisplay(int x, int y, int width, int height)
     : output_name_("window"), display_(nullptr), registry_(nullptr),
       compositor_(nullptr), surface_(nullptr), output_(nullptr), output_registry_name_(0),
+      xdg_output_manager_(nullptr), output_x_(0), output_y_(0),
       xdg_wm_base_(nullptr), xdg_surface_(nullptr), xdg_toplevel_(nullptr),
       layer_shell_(nullptr), layer_surface_(nullptr),
       egl_display_(EGL_NO_DISPLAY), egl_context_(EGL_NO_CONTEXT),
@@ -85,19 +109,27 @@ WaylandDisplay::WaylandDisplay(int x, int y, int width, int height)
       shm_data_(nullptr), shm_fd_(-1), shm_size_(0),
       image_renderer_(std::make_unique<WaylandImageRenderer>()),
       video_renderer_(std::make_unique<WaylandVideoRenderer>()),
+      dirty_tracking_(false), stats_overlay_(nullptr),
+      gl_video_active_(false), gl_frames_presented_(0), gl_frames_throttled_(0), frame_presented_(true),
       frame_callback_(nullptr), frame_callback_pending_(false),
       windowed_mode_(true), use_layer_shell_(false), prefer_egl_(true),
       x_(x), y_(y), width_(width), height_(height),
       output_width_(width), output_height_(height), scale_factor_(1),
       current_scaling_(ScalingMode::DEFAULT),
       pending_image_data_(nullptr), pending_image_width_(0), pending_image_height_(0), 
-      pending_scaling_(ScalingMode::DEFAULT), has_pending_render_(false) {}
+      pending_scaling_(ScalingMode::DEFAULT), has_pending_render_(false),
+      geometry_changed_(false) {}
 
 WaylandDisplay::~WaylandDisplay() {
     cleanup();
 }
 
 bool WaylandDisplay::initialize() {
+    // get_output_by_name() already initializes; a second call must not open another connection
+    if (display_) {
+        return true;
+    }
+    
     if (!init_wayland()) {
         std::cerr << "Failed to initialize Wayland connection" << std::endl;
         return false;
@@ -145,12 +177,7 @@ bool WaylandDisplay::init_wayland() {
         use_layer_shell_ = false;
     }
     
-    // Try to initialize EGL, fallback to SHM if it fails
-    if (prefer_egl_ && !init_egl()) {
-        std::cout << "EGL initialization failed, using SHM fallback" << std::endl;
-        prefer_egl_ = false;
-    }
-    
+    // EGL is brought up later by enable_gl_video(), only for outputs that stream video
     return true;
 }
 
@@ -265,42 +292,17 @@ bool WaylandDisplay::init_window_mode() {
     xdg_surface_set_window_geometry(xdg_surface_, 0, 0, width_, height_);
     
     // Set up rendering buffers BEFORE committing
-    if (prefer_egl_ && egl_initialized_) {
-        egl_window_ = wl_egl_window_create(surface_, width_, height_);
-        if (!egl_window_) {
-            std::cerr << "ERROR: Failed to create wl_egl_window" << std::endl;
-            prefer_egl_ = false;
-        } else {
-            egl_surface_ = eglCreateWindowSurface(egl_display_, egl_config_, 
-                                                 (EGLNativeWindowType)egl_window_, nullptr);
-            if (egl_surface_ == EGL_NO_SURFACE) {
-                std::cerr << "ERROR: Failed to create EGL window surface: " << eglGetError() << std::endl;
-                wl_egl_window_destroy(egl_window_);
-                egl_window_ = nullptr;
-                prefer_egl_ = false;
-            }
-        }
+    if (!create_shm_buffer()) {
+        std::cerr << "Failed to create SHM buffer for window" << std::endl;
+        return false;
     }
     
-    if (!prefer_egl_) {
-        if (!create_shm_buffer()) {
-            std::cerr << "Failed to create SHM buffer for window" << std::endl;
-            return false;
-        }
-        
-        // Clear the buffer to a solid color so we have visible content
-        if (shm_data_) {
-            uint32_t* pixel_data = static_cast<uint32_t*>(shm_data_);
-            uint32_t color = 0xFF202020; // Dark gray background
-            for (int i = 0; i < width_ * height_; i++) {
-                pixel_data[i] = color;
-            }
-        }
-    } else {
-        // Even when EGL is preferred, create SHM buffer as fallback for CPU rendering
-        if (!create_shm_buffer()) {
-            std::cerr << "WARNING: Failed to create SHM buffer fallback" << std::endl;
-            // Don't fail here, continue with EGL-only mode
+    // Clear the buffer to a solid color so we have visible content
+    if (shm_data_) {
+        uint32_t* pixel_data = static_cast<uint32_t*>(shm_data_);
+        uint32_t color = 0xFF202020; // Dark gray background
+        for (int i = 0; i < width_ * height_; i++) {
+            pixel_data[i] = color;
         }
     }
     
@@ -352,6 +354,98 @@ bool WaylandDisplay::init_background_mode() {
     return true;
 }
 
+bool WaylandDisplay::enable_gl_video() {
+    if (gl_video_active_) {
+        return true;
+    }
+    if (!prefer_egl_ || windowed_mode_ || !surface_) {
+        return false;
+    }
+    
+    // Only tried once: a failed attempt leaves the output on SHM for good
+    if (!egl_initialized_ && !init_egl()) {
+        std::cout << "EGL initialization failed, using SHM fallback" << std::endl;
+        cleanup_egl();
+        prefer_egl_ = false;
+        return false;
+    }
+    
+    // Prefer streaming frames through GL; the SHM buffer remains the fallback
+    if (!init_gl_video_path()) {
+        std::cout << "INFO: GL video path unavailable, using CPU scaling into SHM" << std::endl;
+        cleanup_egl();
+        prefer_egl_ = false;
+        return false;
+    }
+    
+    return true;
+}
+
+bool WaylandDisplay::init_gl_video_path() {
+    egl_window_ = wl_egl_window_create(surface_, width_, height_);
+    if (!egl_window_) {
+        std::cerr << "ERROR: Failed to create wl_egl_window for background" << std::endl;
+        return false;
+    }
+    
+    egl_surface_ = eglCreateWindowSurface(egl_display_, egl_config_, (EGLNativeWindowType)egl_window_, nullptr);
+    if (egl_surface_ == EGL_NO_SURFACE) {
+        std::cerr << "ERROR: Failed to create EGL background surface: " << eglGetError() << std::endl;
+        cleanup_gl_video_path();
+        return false;
+    }
+    
+    if (!make_egl_current()) {
+        std::cerr << "ERROR: Failed to make EGL context current: " << eglGetError() << std::endl;
+        cleanup_gl_video_path();
+        return false;
+    }
+    
+    // Swaps are paced by wl_surface frame callbacks instead of blocking in eglSwapBuffers,
+    // so one slow output cannot stall the shared update loop
+    eglSwapInterval(egl_display_, 0);
+    
+    gl_renderer_ = std::make_unique<GLVideoRenderer>();
+    gl_renderer_->set_post_effects(post_effects_);
+    gl_renderer_->set_letterbox(letterbox_settings_);
+    gl_renderer_->set_stats_overlay(stats_overlay_);
+    if (!gl_renderer_->initialize()) {
+        cleanup_gl_video_path();
+        return false;
+    }
+    
+    gl_video_active_ = true;
+    gl_frames_presented_ = 0;
+    gl_frames_throttled_ = 0;
+    gl_stats_start_ = std::chrono::steady_clock::now();
+    std::cout << "DEBUG: Wayland background using GL video path (" << width_ << "x" << height_ << ")" << std::endl;
+    return true;
+}
+
+void WaylandDisplay::cleanup_gl_video_path() {
+    if (gl_renderer_) {
+        if (make_egl_current()) {
+            gl_renderer_->cleanup();
+        }
+        gl_renderer_.reset();
+    }
+    gl_video_active_ = false;
+    
+    if (egl_display_ != EGL_NO_DISPLAY) {
+        eglMakeCurrent(egl_display_, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    }
+    
+    if (egl_surface_ != EGL_NO_SURFACE) {
+        eglDestroySurface(egl_display_, egl_surface_);
+        egl_surface_ = EGL_NO_SURFACE;
+    }
+    
+    if (egl_window_) {
+        wl_egl_window_destroy(egl_window_);
+        egl_window_ = nullptr;
+    }
+}
+
 void WaylandDisplay::setup_layer_surface() {
     const char* app_id = "linux-wallpaperengine-ext";
     layer_surface_ = zwlr_layer_shell_get_layer_surface_wrapper(layer_shell_, surface_, output_,
@@ -392,6 +486,10 @@ bool WaylandDisplay::create_shm_buffer() {
     int stride = width_ * 4;
     shm_size_ = stride * height_;
     
+    // Fresh (empty) buffer: the next video frame must be drawn in full
+    tile_tracker_.reset();
+    video_renderer_->invalidate_letterbox();
+    
     shm_fd_ = memfd_create("wayland-shm", MFD_CLOEXEC);
     if (shm_fd_ < 0) {
         std::cerr << "Failed to create shared memory file" << std::endl;
@@ -432,7 +530,56 @@ bool WaylandDisplay::create_shm_buffer() {
 }
 
 bool WaylandDisplay::find_output_by_name() {
-    return output_ != nullptr;
+    if (outputs_.empty()) {
+        return false;
+    }
+    
+    WaylandOutputInfo* selected = nullptr;
+    bool names_known = false;
+    for (const auto& info : outputs_) {
+        if (!info->name.empty()) {
+            names_known = true;
+        }
+        if (info->name == output_name_) {
+            selected = info.get();
+            break;
+        }
+    }
+    
+    if (!selected) {
+        if (output_name_ == "default" || output_name_.empty()) {
+            selected = outputs_.front().get();
+        } else if (!names_known) {
+            // Compositor predates wl_output v4 names - keep the old behaviour
+            // of using the last advertised output
+            std::cerr << "WARNING: Compositor does not report output names, using last output for '"
+                      << output_name_ << "'" << std::endl;
+            selected = outputs_.back().get();
+        } else {
+            return false;
+        }
+    }
+    
+    output_ = selected->output;
+    output_registry_name_ = selected->registry_name;
+    scale_factor_ = selected->scale;
+    if (selected->logical_width > 0 && selected->logical_height > 0) {
+        output_x_ = selected->logical_x;
+        output_y_ = selected->logical_y;
+        output_width_ = selected->logical_width;
+        output_height_ = selected->logical_height;
+    } else {
+        // No xdg-output: wl_output's position is already logical, the mode is not
+        int scale = std::max(1, selected->scale);
+        output_x_ = selected->x;
+        output_y_ = selected->y;
+        output_width_ = selected->width / scale;
+        output_height_ = selected->height / scale;
+    }
+    
+    std::cout << "DEBUG: Using Wayland output '" << selected->name << "' at " << output_x_ << "," << output_y_
+              << " (" << output_width_ << "x" << output_height_ << ")" << std::endl;
+    return true;
 }
 
 void WaylandDisplay::cleanup() {
@@ -464,6 +611,23 @@ void WaylandDisplay::cleanup() {
         surface_ = nullptr;
     }
     
+    for (auto& info : outputs_) {
+        if (info->xdg_output) {
+            zxdg_output_v1_destroy(info->xdg_output);
+        }
+        if (info->output) {
+            wl_output_destroy(info->output);
+        }
+    }
+    outputs_.clear();
+    output_ = nullptr;
+    output_registry_name_ = 0;
+    
+    if (xdg_output_manager_) {
+        zxdg_output_manager_v1_destroy(xdg_output_manager_);
+        xdg_output_manager_ = nullptr;
+    }
+    
     if (registry_) {
         wl_registry_destroy(registry_);
         registry_ = nullptr;
@@ -476,6 +640,8 @@ void WaylandDisplay::cleanup() {
 }
 
 void WaylandDisplay::cleanup_egl() {
+    cleanup_gl_video_path();
+    
     if (egl_surface_ != EGL_NO_SURFACE) {
         eglDestroySurface(egl_display_, egl_surface_);
         egl_surface_ = EGL_NO_SURFACE;
@@ -532,6 +698,13 @@ bool WaylandDisplay::make_egl_current() {
     return eglMakeCurrent(egl_display_, egl_surface_, egl_surface_, egl_context_);
 }
 
+void WaylandDisplay::release_thread_context() {
+    // Every GL present starts with make_egl_current()
+    if (egl_initialized_ && egl_display_ != EGL_NO_DISPLAY) {
+        eglMakeCurrent(egl_display_, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    }
+}
+
 bool WaylandDisplay::set_background(const std::string& media_path, ScalingMode scaling) {
     current_scaling_ = scaling;
     return true;
@@ -539,15 +712,212 @@ bool WaylandDisplay::set_background(const std::string& media_path, ScalingMode s
 
 void WaylandDisplay::update() {
     if (display_) {
-        wl_display_dispatch_pending(display_);
+        if (gl_video_active_) {
+            // Frame callbacks have to be read from the socket without blocking
+            read_pending_events();
+        } else {
+            wl_display_dispatch_pending(display_);
+        }
         wl_display_flush(display_);
     }
 }
 
+void WaylandDisplay::read_pending_events() {
+    while (wl_display_prepare_read(display_) != 0) {
+        wl_display_dispatch_pending(display_);
+    }
+    wl_display_flush(display_);
+    
+    struct pollfd fd = { wl_display_get_fd(display_), POLLIN, 0 };
+    if (poll(&fd, 1, 0) > 0 && (fd.revents & POLLIN)) {
+        wl_display_read_events(display_);
+    } else {
+        wl_display_cancel_read(display_);
+    }
+    wl_display_dispatch_pending(display_);
+}
+
+void WaylandDisplay::request_frame_callback() {
+    if (!surface_ || frame_callback_) {
+        return;
+    }
+    
+    frame_callback_ = wl_surface_frame(surface_);
+    wl_callback_add_listener(frame_callback_, &frame_callback_listener, this);
+    frame_callback_pending_ = true;
+    frame_callback_requested_ = std::chrono::steady_clock::now();
+}
+
+void WaylandDisplay::handle_frame_callback() {
+    if (frame_callback_) {
+        wl_callback_destroy(frame_callback_);
+        frame_callback_ = nullptr;
+    }
+    frame_callback_pending_ = false;
+}
+
+bool WaylandDisplay::gl_frame_slot_available() {
+    read_pending_events();
+    
+    if (!frame_callback_pending_) {
+        return true;
+    }
+    
+    // Compositors may stop sending callbacks for hidden outputs - fall back to 1 fps
+    auto waited = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - frame_callback_requested_);
+    if (waited.count() >= FRAME_CALLBACK_TIMEOUT_MS) {
+        handle_frame_callback();
+        return true;
+    }
+    
+    return false;
+}
+
+bool WaylandDisplay::present_gl_frame(ScalingMode scaling) {
+    if (!gl_renderer_->draw(width_, height_, scaling)) {
+        return false;
+    }
+    if (stats_overlay_) {
+        stats_overlay_->record_scale(StatsOverlay::elapsed_ms(frame_start_));
+    }
+    
+    // The callback is committed together with the swap and fires when the
+    // compositor wants the next frame
+    auto present_start = std::chrono::steady_clock::now();
+    request_frame_callback();
+    if (!eglSwapBuffers(egl_display_, egl_surface_)) {
+        std::cerr << "ERROR: eglSwapBuffers failed: " << eglGetError() << std::endl;
+        handle_frame_callback();
+        return false;
+    }
+    gl_frames_presented_++;
+    if (stats_overlay_) {
+        stats_overlay_->record_present(StatsOverlay::elapsed_ms(present_start));
+    }
+    
+    auto now = std::chrono::steady_clock::now();
+    auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - gl_stats_start_);
+    if (elapsed.count() >= 5) {
+        std::cout << "WAYLAND GL: Presented " << gl_frames_presented_ << " frames, "
+                  << gl_frames_throttled_ << " skipped waiting for frame callbacks in "
+                  << elapsed.count() << "s on " << output_name_ << std::endl;
+        gl_frames_presented_ = 0;
+        gl_frames_throttled_ = 0;
+        gl_stats_start_ = now;
+    }
+    return true;
+}
+
+void WaylandDisplay::frame_callback_done(void* data, struct wl_callback* callback, uint32_t time) {
+    WaylandDisplay* display = static_cast<WaylandDisplay*>(data);
+    display->handle_frame_callback();
+}
+
 std::string WaylandDisplay::get_name() const {
     return output_name_;
 }
 
+bool WaylandDisplay::get_geometry(int& x, int& y, int& width, int& height) const {
+    if (windowed_mode_ || !output_) {
+        return false;
+    }
+    x = output_x_;
+    y = output_y_;
+    width = width_;
+    height = height_;
+    return true;
+}
+
+bool WaylandDisplay::set_dirty_tracking(bool enabled) {
+    if (enabled && gl_video_active_) {
+        // GL already owns the surface; it redraws the whole texture every frame
+        return false;
+    }
+    dirty_tracking_ = enabled;
+    tile_tracker_.reset();
+    if (enabled) {
+        // Partial updates rely on the SHM buffer keeping the previous frame
+        prefer_egl_ = false;
+        std::cout << "DEBUG: Tile dirty tracking enabled for " << output_name_ << std::endl;
+    }
+    return true;
+}
+
+bool WaylandDisplay::set_post_effects(const PostEffects& effects) {
+    post_effects_ = effects;
+    image_renderer_->set_post_effects(effects);
+    video_renderer_->set_post_effects(effects);
+    if (gl_renderer_) {
+        gl_renderer_->set_post_effects(effects);
+    }
+    return true;
+}
+
+bool WaylandDisplay::set_letterbox(const LetterboxSettings& settings) {
+    letterbox_settings_ = settings;
+    image_renderer_->set_letterbox(settings);
+    video_renderer_->set_letterbox(settings);
+    if (gl_renderer_) {
+        gl_renderer_->set_letterbox(settings);
+    }
+    return true;
+}
+
+bool WaylandDisplay::set_stats_overlay(StatsOverlay* overlay) {
+    stats_overlay_ = overlay;
+    if (gl_renderer_) {
+        gl_renderer_->set_stats_overlay(overlay);
+    }
+    return true;
+}
+
+void WaylandDisplay::draw_stats_overlay(bool dirty) {
+    if (!stats_overlay_ || !shm_data_) {
+        return;
+    }
+    
+    // A full redraw always covers the HUD; a partial one only when a damaged tile overlaps it
+    bool covered = !dirty;
+    if (dirty) {
+        DirtyRect hud = stats_overlay_->get_rect(width_, height_);
+        for (const auto& rect : damage_rects_) {
+            if (StatsOverlay::intersects(rect, hud)) {
+                covered = true;
+                break;
+            }
+        }
+    }
+    
+    DirtyRect drawn;
+    if (stats_overlay_->draw_bgra(static_cast<unsigned char*>(shm_data_), width_, height_, covered, &drawn) && dirty) {
+        damage_rects_.push_back(drawn);
+    }
+    stats_overlay_->record_scale(StatsOverlay::elapsed_ms(frame_start_));
+}
+
+void WaylandDisplay::commit_shm_frame(const std::vector<DirtyRect>* damage) {
+    auto present_start = std::chrono::steady_clock::now();
+    wl_surface_attach(surface_, buffer_, 0, 0);
+    if (damage) {
+        for (const auto& rect : *damage) {
+            wl_surface_damage_buffer(surface_, rect.x, rect.y, rect.width, rect.height);
+        }
+    } else {
+        wl_surface_damage(surface_, 0, 0, width_, height_);
+    }
+    wl_surface_commit(surface_);
+    if (stats_overlay_) {
+        stats_overlay_->record_present(StatsOverlay::elapsed_ms(present_start));
+    }
+}
+
+bool WaylandDisplay::consume_geometry_change() {
+    bool changed = geometry_changed_;
+    geometry_changed_ = false;
+    return changed;
+}
+
 // Clean rendering functions that delegate to specialized renderers
 bool WaylandDisplay::render_image_data(const unsigned char* image_data, int img_width, int img_height, ScalingMode scaling) {
     if (!image_data) {
@@ -557,6 +927,7 @@ bool WaylandDisplay::render_image_data(const unsigned char* image_data, int img_
     
     
     current_scaling_ = scaling;
+    frame_start_ = std::chrono::steady_clock::now();
     bool result = false;
     
     // Initialize image renderer if not already done
@@ -565,15 +936,17 @@ bool WaylandDisplay::render_image_data(const unsigned char* image_data, int img_
         return false;
     }
 
-    // For images, prefer CPU-based SHM rendering (reliable and fast for static images)
-    if (shm_data_) {
+    if (gl_video_active_ && make_egl_current()) {
+        // Image is uploaded once and scaled by the GPU
+        result = gl_renderer_->upload(VideoFrame::rgba(image_data, img_width, img_height)) && present_gl_frame(scaling);
+    } else if (shm_data_) {
+        // For images, prefer CPU-based SHM rendering (reliable and fast for static images)
         result = image_renderer_->render_image_shm(image_data, img_width, img_height,
                                                   shm_data_, width_, height_, scaling, windowed_mode_);
         
         if (result && surface_) {
-            wl_surface_attach(surface_, buffer_, 0, 0);
-            wl_surface_damage(surface_, 0, 0, width_, height_);
-            wl_surface_commit(surface_);
+            draw_stats_overlay(false);
+            commit_shm_frame(nullptr);
         }
     }
     
@@ -584,11 +957,18 @@ bool WaylandDisplay::render_image_data(const unsigned char* image_data, int img_
     return result;
 }
 
-bool WaylandDisplay::render_video_frame(const unsigned char* frame_data, int frame_width, int frame_height, ScalingMode scaling) {
-    if (!frame_data) {
+bool WaylandDisplay::render_frame(const VideoFrame& frame, ScalingMode scaling) {
+    if (!frame.is_valid()) {
         std::cerr << "ERROR: No video frame data provided" << std::endl;
         return false;
     }
+    frame_presented_ = true;
+    return frame.is_yuv() ? render_yuv_frame(frame, scaling) : render_rgba_frame(frame, scaling);
+}
+
+bool WaylandDisplay::render_rgba_frame(const VideoFrame& frame, ScalingMode scaling) {
+    int frame_width = frame.width;
+    int frame_height = frame.height;
     
     // Check for scaling mode changes (only log when actually changing)
     if (current_scaling_ != scaling) {
@@ -602,17 +982,51 @@ bool WaylandDisplay::render_video_frame(const unsigned char* frame_data, int fra
     }
     
     current_scaling_ = scaling;
+    frame_start_ = std::chrono::steady_clock::now();
     bool result = false;
     
-    // Use CPU-based SHM rendering (reliable and always works)
-    if (shm_data_) {
+    // Moving content is what justifies a GL context; bring it up on the first frame
+    if (!gl_video_active_ && prefer_egl_) {
+        enable_gl_video();
+    }
+    
+    if (gl_video_active_) {
+        // GPU scales the RGBA frame; skip entirely while the compositor has not asked for a frame
+        if (!gl_frame_slot_available()) {
+            gl_frames_throttled_++;
+            frame_presented_ = false;
+            if (stats_overlay_) {
+                stats_overlay_->record_drop();
+            }
+            return true;
+        }
+        if (make_egl_current()) {
+            // Padded rows are read in place through GL_UNPACK_ROW_LENGTH
+            result = gl_renderer_->upload(frame) && present_gl_frame(scaling);
+        }
+    } else if (shm_data_ && dirty_tracking_) {
+        // Only the tiles that changed are rescaled and damaged
+        const unsigned char* frame_data = frame.packed_rgba(packed_frame_);
+        result = video_renderer_->render_frame_data_shm_dirty(frame_data, frame_width, frame_height,
+                                                             shm_data_, width_, height_, scaling, windowed_mode_,
+                                                             tile_tracker_, damage_rects_);
+        
+        if (result) {
+            draw_stats_overlay(true);
+        }
+        if (result && surface_ && !damage_rects_.empty()) {
+            commit_shm_frame(&damage_rects_);
+        }
+        tile_tracker_.log_stats("Wayland " + output_name_);
+    } else if (shm_data_) {
+        // Use CPU-based SHM rendering (reliable and always works)
+        const unsigned char* frame_data = frame.packed_rgba(packed_frame_);
         result = video_renderer_->render_frame_data_shm(frame_data, frame_width, frame_height,
                                                        shm_data_, width_, height_, scaling, windowed_mode_);
         
         if (result && surface_) {
-            wl_surface_attach(surface_, buffer_, 0, 0);
-            wl_surface_damage(surface_, 0, 0, width_, height_);
-            wl_surface_commit(surface_);
+            draw_stats_overlay(false);
+            commit_shm_frame(nullptr);
         }
     }
     
@@ -623,6 +1037,34 @@ bool WaylandDisplay::render_video_frame(const unsigned char* frame_data, int fra
     return result;
 }
 
+bool WaylandDisplay::render_yuv_frame(const VideoFrame& frame, ScalingMode scaling) {
+    if (!gl_video_active_) {
+        return false;
+    }
+    
+    current_scaling_ = scaling;
+    frame_start_ = std::chrono::steady_clock::now();
+    
+    if (!gl_frame_slot_available()) {
+        gl_frames_throttled_++;
+        frame_presented_ = false;
+        if (stats_overlay_) {
+            stats_overlay_->record_drop();
+        }
+        return true;
+    }
+    
+    if (!make_egl_current()) {
+        std::cerr << "ERROR: Failed to make EGL context current" << std::endl;
+        return false;
+    }
+    
+    if (!gl_renderer_->upload(frame)) {
+        return false;
+    }
+    return present_gl_frame(scaling);
+}
+
 bool WaylandDisplay::render_video_enhanced(MediaPlayer* media_player, ScalingMode scaling) {
     if (!surface_ || !media_player) {
         return false;
@@ -697,11 +1139,31 @@ void WaylandDisplay::registry_global(void* data, struct wl_registry* registry, u
         display->layer_shell_ = static_cast<zwlr_layer_shell_v1*>(
             wl_registry_bind(registry, name, &zwlr_layer_shell_v1_interface, 1));
     } else if (strcmp(interface, wl_output_interface.name) == 0) {
-        display->output_ = static_cast<wl_output*>(
-            wl_registry_bind(registry, name, &wl_output_interface, 4));
-        display->output_registry_name_ = name;
-        wl_output_add_listener(display->output_, &output_listener, display);
+        // Track every output; find_output_by_name() picks one once names are known
+        auto info = std::make_unique<WaylandOutputInfo>();
+        info->display = display;
+        info->registry_name = name;
+        info->output = static_cast<wl_output*>(
+            wl_registry_bind(registry, name, &wl_output_interface, std::min<uint32_t>(version, 4)));
+        wl_output_add_listener(info->output, &output_listener, info.get());
+        watch_xdg_output(display, info.get());
+        display->outputs_.push_back(std::move(info));
+    } else if (strcmp(interface, zxdg_output_manager_v1_interface.name) == 0) {
+        display->xdg_output_manager_ = static_cast<zxdg_output_manager_v1*>(
+            wl_registry_bind(registry, name, &zxdg_output_manager_v1_interface, std::min<uint32_t>(version, 3)));
+        // Outputs may have been advertised before the manager
+        for (auto& info : display->outputs_) {
+            watch_xdg_output(display, info.get());
+        }
+    }
+}
+
+void WaylandDisplay::watch_xdg_output(WaylandDisplay* display, WaylandOutputInfo* info) {
+    if (!display->xdg_output_manager_ || !info->output || info->xdg_output) {
+        return;
     }
+    info->xdg_output = zxdg_output_manager_v1_get_xdg_output(display->xdg_output_manager_, info->output);
+    zxdg_output_v1_add_listener(info->xdg_output, &xdg_output_listener, info);
 }
 
 void WaylandDisplay::registry_global_remove(void* data, struct wl_registry* registry, uint32_t name) {
@@ -711,6 +1173,17 @@ void WaylandDisplay::registry_global_remove(void* data, struct wl_registry* regi
         display->output_ = nullptr;
         display->output_registry_name_ = 0;
     }
+    
+    for (auto it = display->outputs_.begin(); it != display->outputs_.end(); ++it) {
+        if ((*it)->registry_name == name) {
+            if ((*it)->xdg_output) {
+                zxdg_output_v1_destroy((*it)->xdg_output);
+            }
+            wl_output_destroy((*it)->output);
+            display->outputs_.erase(it);
+            break;
+        }
+    }
 }
 
 void WaylandDisplay::xdg_wm_base_ping(void* data, struct xdg_wm_base* xdg_wm_base, uint32_t serial) {
@@ -725,7 +1198,7 @@ void WaylandDisplay::xdg_surface_configure(void* data, struct xdg_surface* xdg_s
     // After acknowledging configure, make sure we have content and commit the surface
     if (display->surface_ && display->windowed_mode_) {
         // Ensure we have a buffer attached for windowed mode
-        if (!display->prefer_egl_ && display->buffer_) {
+        if (!display->gl_video_active_ && display->buffer_) {
             wl_surface_attach(display->surface_, display->buffer_, 0, 0);
         }
         
@@ -747,6 +1220,7 @@ void WaylandDisplay::xdg_toplevel_configure(void* data, struct xdg_toplevel* xdg
     std::cout << "DEBUG: XDG toplevel configure - width: " << width << ", height: " << height << std::endl;
     
     if (width > 0 && height > 0) {
+        display->geometry_changed_ = display->geometry_changed_ || width != display->width_ || height != display->height_;
         display->width_ = width;
         display->height_ = height;
         
@@ -755,7 +1229,7 @@ void WaylandDisplay::xdg_toplevel_configure(void* data, struct xdg_toplevel* xdg
         }
         
         // Recreate SHM buffer if needed for fallback rendering
-        if (!display->prefer_egl_ && display->windowed_mode_) {
+        if (!display->gl_video_active_ && display->windowed_mode_) {
             display->cleanup_shm();
             display->create_shm_buffer();
         }
@@ -785,9 +1259,14 @@ void WaylandDisplay::layer_surface_configure(void* data, struct zwlr_layer_surfa
     
     display->output_width_ = width;
     display->output_height_ = height;
+    display->geometry_changed_ = true;
     display->width_ = width;
     display->height_ = height;
     
+    if (display->egl_window_) {
+        wl_egl_window_resize(display->egl_window_, width, height, 0, 0);
+    }
+    
     zwlr_layer_surface_v1_ack_configure(layer_surface, serial);
 }
 
@@ -798,16 +1277,19 @@ void WaylandDisplay::layer_surface_closed(void* data, struct zwlr_layer_surface_
 void WaylandDisplay::output_geometry(void* data, struct wl_output* output, int32_t x, int32_t y,
                                     int32_t physical_width, int32_t physical_height, int32_t subpixel,
                                     const char* make, const char* model, int32_t transform) {
-    // Handle output geometry information
+    WaylandOutputInfo* info = static_cast<WaylandOutputInfo*>(data);
+    info->x = x;
+    info->y = y;
 }
 
 void WaylandDisplay::output_mode(void* data, struct wl_output* output, uint32_t flags,
                                 int32_t width, int32_t height, int32_t refresh) {
-    WaylandDisplay* display = static_cast<WaylandDisplay*>(data);
+    WaylandOutputInfo* info = static_cast<WaylandOutputInfo*>(data);
     
+    // Physical pixels: only the layer surface configure decides our buffer size
     if (flags & WL_OUTPUT_MODE_CURRENT) {
-        display->output_width_ = width;
-        display->output_height_ = height;
+        info->width = width;
+        info->height = height;
     }
 }
 
@@ -816,14 +1298,63 @@ void WaylandDisplay::output_done(void* data, struct wl_output* output) {
 }
 
 void WaylandDisplay::output_scale(void* data, struct wl_output* output, int32_t factor) {
-    WaylandDisplay* display = static_cast<WaylandDisplay*>(data);
-    display->scale_factor_ = factor;
+    WaylandOutputInfo* info = static_cast<WaylandOutputInfo*>(data);
+    info->scale = factor;
+    if (output == info->display->output_) {
+        info->display->scale_factor_ = factor;
+    }
 }
 
 void WaylandDisplay::output_name(void* data, struct wl_output* output, const char* name) {
-    // Handle output name
+    WaylandOutputInfo* info = static_cast<WaylandOutputInfo*>(data);
+    info->name = name ? name : "";
 }
 
 void WaylandDisplay::output_description(void* data, struct wl_output* output, const char* description) {
     // Handle output description
 }
+
+void WaylandDisplay::xdg_output_logical_position(void* data, struct zxdg_output_v1* xdg_output, int32_t x, int32_t y) {
+    WaylandOutputInfo* info = static_cast<WaylandOutputInfo*>(data);
+    info->logical_x = x;
+    info->logical_y = y;
+    if (info->output == info->display->output_) {
+        info->display->output_x_ = x;
+        info->display->output_y_ = y;
+    }
+}
+
+void WaylandDisplay::xdg_output_logical_size(void* data, struct zxdg_output_v1* xdg_output,
+                                             int32_t width, int32_t height) {
+    WaylandOutputInfo* info = static_cast<WaylandOutputInfo*>(data);
+    info->logical_width = width;
+    info->logical_height = height;
+}
+
+void WaylandDisplay::xdg_output_done(void* data, struct zxdg_output_v1* xdg_output) {
+    // Deprecated in v3 in favour of wl_output.done
+}
+
+void WaylandDisplay::xdg_output_name(void* data, struct zxdg_output_v1* xdg_output, const char* name) {
+    // wl_output v4 names are used; this only helps older compositors
+    WaylandOutputInfo* info = static_cast<WaylandOutputInfo*>(data);
+    if (info->name.empty() && name) {
+        info->name = name;
+    }
+}
+
+void WaylandDisplay::xdg_output_description(void* data, struct zxdg_output_v1* xdg_output, const char* description) {
+    // Handle output description
+}
+
+// Module entry point (see display_backend.h)
+extern "C" const DisplayBackend* lwe_display_backend_wayland() {
+    static const DisplayBackend backend = {
+        LWE_DISPLAY_BACKEND_ABI, "wayland",
+        &WaylandDisplay::get_outputs,
+        &WaylandDisplay::get_output_by_name,
+        &WaylandDisplay::create_window,
+        nullptr
+    };
+    return &backend;
+}
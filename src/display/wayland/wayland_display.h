@@ -3,6 +3,7 @@
 #include "../display_manager.h"
 #include "wayland_image_renderer.h"
 #include "wayland_video_renderer.h"
+#include "../gl_video_renderer.h"
 #include <wayland-client.h>
 #include <wayland-egl.h>
 #include <EGL/egl.h>
@@ -14,6 +15,7 @@ class MediaPlayer;
 #include <GL/gl.h>
 #include <vector>
 #include <memory>
+#include <chrono>
 
 // Forward declarations for protocols
 struct xdg_wm_base;
@@ -25,6 +27,27 @@ struct wl_buffer;
 struct zwlr_layer_shell_v1;
 struct zwlr_layer_surface_v1;
 struct wl_output;
+struct zxdg_output_manager_v1;
+struct zxdg_output_v1;
+
+class WaylandDisplay;
+
+// Per-output state collected from wl_output events before one is selected
+struct WaylandOutputInfo {
+    WaylandDisplay* display = nullptr;
+    struct wl_output* output = nullptr;
+    uint32_t registry_name = 0;
+    std::string name;           // Connector name (wl_output v4), e.g. "DP-1"
+    int32_t x = 0, y = 0;       // Position in the compositor's global space
+    int32_t width = 0, height = 0;  // Current mode, in physical pixels
+    int32_t scale = 1;
+    
+    // xdg-output: where the output sits in the logical (scaled) layout the
+    // compositor arranges outputs in - what spanning must use
+    struct zxdg_output_v1* xdg_output = nullptr;
+    int32_t logical_x = 0, logical_y = 0;
+    int32_t logical_width = 0, logical_height = 0;
+};
 
 class WaylandDisplay : public DisplayOutput {
 public:
@@ -37,18 +60,38 @@ public:
     bool set_background(const std::string& media_path, ScalingMode scaling) override;
     void update() override;
     std::string get_name() const override;
+    bool get_geometry(int& x, int& y, int& width, int& height) const override;
+    bool consume_geometry_change() override;
     
     // Image rendering method
-    bool render_image_data(const unsigned char* image_data, int img_width, int img_height, ScalingMode scaling);
+    bool render_image_data(const unsigned char* image_data, int img_width, int img_height, ScalingMode scaling) override;
+    
+    // Video frames: RGBA on the GL or SHM path, planar YUV straight to GL
+    // textures (shader converts and scales)
+    bool render_frame(const VideoFrame& frame, ScalingMode scaling) override;
+    bool was_frame_presented() const override { return frame_presented_; }
+    bool supports_yuv_textures() const override { return gl_video_active_; }
+    
+    // Create the EGL context and GL streaming path on first use (background
+    // outputs only). Static images stay on SHM and never pay for a context.
+    bool enable_gl_video() override;
+    
+    // SHM-only video with per-tile redraw and wl_surface_damage_buffer rects
+    bool set_dirty_tracking(bool enabled) override;
     
-    // Video frame rendering method
-    bool render_video_frame(const unsigned char* frame_data, int frame_width, int frame_height, ScalingMode scaling);
+    // Forwarded to the SHM scalers and the GL shader
+    bool set_post_effects(const PostEffects& effects) override;
+    
+    // Blurred-fill bars, on both the SHM and GL paths
+    bool set_letterbox(const LetterboxSettings& settings) override;
+    bool set_stats_overlay(StatsOverlay* overlay) override;
     
     // Enhanced video rendering with native FFmpeg support
     bool render_video_enhanced(MediaPlayer* media_player, ScalingMode scaling);
     
     // OpenGL context management
     bool make_egl_current();
+    void release_thread_context() override;
     
     // Static factory methods
     static std::vector<std::unique_ptr<DisplayOutput>> get_outputs();
@@ -63,6 +106,9 @@ private:
     struct wl_surface* surface_;
     struct wl_output* output_;
     uint32_t output_registry_name_;
+    std::vector<std::unique_ptr<WaylandOutputInfo>> outputs_;  // Every advertised wl_output
+    struct zxdg_output_manager_v1* xdg_output_manager_;
+    int output_x_, output_y_;               // Logical position of the selected output
     
     // XDG Shell (for windows)
     struct xdg_wm_base* xdg_wm_base_;
@@ -93,6 +139,29 @@ private:
     std::unique_ptr<WaylandImageRenderer> image_renderer_;
     std::unique_ptr<WaylandVideoRenderer> video_renderer_;          // CPU-based video rendering
     
+    // Tile dirty tracking for the SHM video path
+    bool dirty_tracking_;
+    TileTracker tile_tracker_;
+    std::vector<DirtyRect> damage_rects_;
+    std::vector<unsigned char> packed_frame_;   // Padded RGBA repacked for the SHM scalers
+    
+    PostEffects post_effects_;
+    LetterboxSettings letterbox_settings_;
+    
+    // Performance HUD (owned by the application); frame_start_ marks the start of the scale pass
+    StatsOverlay* stats_overlay_;
+    std::chrono::steady_clock::time_point frame_start_;
+    
+    // Streaming GL presentation (EGL surface on the layer surface); SHM stays as fallback
+    std::unique_ptr<GLVideoRenderer> gl_renderer_;
+    bool gl_video_active_;
+    int gl_frames_presented_;
+    int gl_frames_throttled_;
+    bool frame_presented_;          // Last render_frame() was not throttled
+    std::chrono::steady_clock::time_point gl_stats_start_;
+    std::chrono::steady_clock::time_point frame_callback_requested_;
+    static constexpr int FRAME_CALLBACK_TIMEOUT_MS = 1000;  // Hidden surfaces may never get a callback
+    
     // Frame callback for continuous rendering
     struct wl_callback* frame_callback_;
     bool frame_callback_pending_;
@@ -112,6 +181,7 @@ private:
     int pending_image_height_;
     ScalingMode pending_scaling_;
     bool has_pending_render_;
+    bool geometry_changed_;         // Configure changed the size since the last consume_geometry_change()
     
     // Initialization methods
     bool init_wayland();
@@ -121,6 +191,8 @@ private:
     bool create_shm_buffer();
     void setup_layer_surface();
     bool init_renderers();
+    bool init_gl_video_path();
+    void cleanup_gl_video_path();
     
     // Rendering methods (now delegate to specialized renderers)
     bool render_with_egl(const unsigned char* data, int width, int height, ScalingMode scaling, bool is_video = false);
@@ -129,6 +201,13 @@ private:
     // Frame callback methods
     void request_frame_callback();
     void handle_frame_callback();
+    bool gl_frame_slot_available();
+    bool present_gl_frame(ScalingMode scaling);
+    bool render_rgba_frame(const VideoFrame& frame, ScalingMode scaling);
+    bool render_yuv_frame(const VideoFrame& frame, ScalingMode scaling);
+    void draw_stats_overlay(bool dirty);
+    void commit_shm_frame(const std::vector<DirtyRect>* damage);
+    void read_pending_events();
     
     // Utility methods
     void cleanup_egl();
@@ -169,4 +248,12 @@ public:
     static void output_scale(void* data, struct wl_output* output, int32_t factor);
     static void output_name(void* data, struct wl_output* output, const char* name);
     static void output_description(void* data, struct wl_output* output, const char* description);
+    
+    // xdg-output event handlers (logical layout)
+    static void watch_xdg_output(WaylandDisplay* display, WaylandOutputInfo* info);
+    static void xdg_output_logical_position(void* data, struct zxdg_output_v1* xdg_output, int32_t x, int32_t y);
+    static void xdg_output_logical_size(void* data, struct zxdg_output_v1* xdg_output, int32_t width, int32_t height);
+    static void xdg_output_done(void* data, struct zxdg_output_v1* xdg_output);
+    static void xdg_output_name(void* data, struct zxdg_output_v1* xdg_output, const char* name);
+    static void xdg_output_description(void* data, struct zxdg_output_v1* xdg_output, const char* description);
 };
@@ -58,6 +58,16 @@ bool WaylandImageRenderer::render_image_shm(const unsigned char* image_data, int
                      static_cast<unsigned char*>(shm_data), surface_width, surface_height,
                      scaling, windowed_mode);
     
+    if (letterbox_.is_enabled()) {
+        // apply_scaling_shm cleared the buffer, so the bars always need painting
+        letterbox_.update(VideoFrame::rgba(data_to_use, final_width, final_height));
+        letterbox_.invalidate();
+        bool effects_active = !effects_.is_identity() && effect_pass_.is_active();
+        letterbox_.paint_bars_bgra(static_cast<unsigned char*>(shm_data), surface_width, surface_height,
+                                   calculate_content_rect(final_width, final_height, surface_width, surface_height, scaling),
+                                   windowed_mode, effects_active ? &effect_pass_ : nullptr);
+    }
+    
     // Clean up temporary data
     if (resized_data) {
         delete[] resized_data;
@@ -267,26 +277,23 @@ void WaylandImageRenderer::check_and_resize_image(const unsigned char* src_data,
     }
 }
 
-void WaylandImageRenderer::apply_scaling_shm(const unsigned char* src_data, int src_width, int src_height,
-                                            unsigned char* dst_data, int dst_width, int dst_height,
-                                            ScalingMode scaling, bool windowed_mode) {
-    std::cout << "DEBUG: Applying SHM scaling mode: " << static_cast<int>(scaling) << std::endl;
-    
+void WaylandImageRenderer::set_post_effects(const PostEffects& effects) {
+    effects_ = effects;
+    effect_pass_ = PostEffectPass();
+}
+
+void WaylandImageRenderer::calculate_layout(int src_width, int src_height, int dst_width, int dst_height,
+                                            ScalingMode scaling, int& render_width, int& render_height,
+                                            int& offset_x, int& offset_y) const {
     // Calculate scaling parameters based on mode
-    int render_width = dst_width;
-    int render_height = dst_height;
-    int offset_x = 0;
-    int offset_y = 0;
+    render_width = dst_width;
+    render_height = dst_height;
+    offset_x = 0;
+    offset_y = 0;
     
     float src_aspect = static_cast<float>(src_width) / src_height;
     float dst_aspect = static_cast<float>(dst_width) / dst_height;
     
-    // Clear the destination buffer first
-    uint32_t* dst_pixels = reinterpret_cast<uint32_t*>(dst_data);
-    for (int i = 0; i < dst_width * dst_height; i++) {
-        dst_pixels[i] = 0x00000000; // Transparent black
-    }
-    
     switch (scaling) {
         case ScalingMode::STRETCH:
             // Stretch to fill entire surface
@@ -330,11 +337,48 @@ void WaylandImageRenderer::apply_scaling_shm(const unsigned char* src_data, int
             }
             break;
     }
+}
+
+DirtyRect WaylandImageRenderer::calculate_content_rect(int src_width, int src_height, int dst_width, int dst_height,
+                                                       ScalingMode scaling) const {
+    DirtyRect content;
+    if (scaling == ScalingMode::FILL) {
+        // Cropped: the content covers the whole surface
+        content.width = dst_width;
+        content.height = dst_height;
+        return content;
+    }
+    calculate_layout(src_width, src_height, dst_width, dst_height, scaling,
+                     content.width, content.height, content.x, content.y);
+    return content;
+}
+
+void WaylandImageRenderer::apply_scaling_shm(const unsigned char* src_data, int src_width, int src_height,
+                                            unsigned char* dst_data, int dst_width, int dst_height,
+                                            ScalingMode scaling, bool windowed_mode) {
+    std::cout << "DEBUG: Applying SHM scaling mode: " << static_cast<int>(scaling) << std::endl;
+    
+    // Clear the destination buffer first
+    uint32_t* dst_pixels = reinterpret_cast<uint32_t*>(dst_data);
+    for (int i = 0; i < dst_width * dst_height; i++) {
+        dst_pixels[i] = 0x00000000; // Transparent black
+    }
+    
+    // Placement is shared with calculate_content_rect (letterbox bars)
+    int render_width, render_height, offset_x, offset_y;
+    calculate_layout(src_width, src_height, dst_width, dst_height, scaling,
+                     render_width, render_height, offset_x, offset_y);
     
     // Perform the scaling and copying with Y-axis flip
     float x_ratio = static_cast<float>(src_width) / render_width;
     float y_ratio = static_cast<float>(src_height) / render_height;
     
+    // Per-screen effects ride along in the same pixel loop (no second pass)
+    if (!effects_.is_identity() && !effect_pass_.is_configured_for(dst_width, dst_height)) {
+        effect_pass_.configure(effects_, dst_width, dst_height);
+    }
+    bool effects_active = !effects_.is_identity() && effect_pass_.is_active();
+    
     
     // ============================================================================
     // CRITICAL Y-AXIS ORIENTATION FIX FOR WAYLAND SHM IMAGE RENDERING
@@ -388,6 +432,10 @@ void WaylandImageRenderer::apply_scaling_shm(const unsigned char* src_data, int
             uint32_t a = src_data[src_idx + 3];
             
             dst_pixels[dst_idx] = (a << 24) | (r << 16) | (g << 8) | b;
+            if (effects_active) {
+                effect_pass_.apply_bgra(reinterpret_cast<unsigned char*>(&dst_pixels[dst_idx]), dst_x,
+                                        effect_pass_.row_factor(dst_y));
+            }
         }
     }
     
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "../display_manager.h"
+#include "../post_effects.h"
+#include "../letterbox_fill.h"
 #include <wayland-client.h>
 #include <wayland-egl.h>
 #include <memory>
@@ -31,6 +33,12 @@ public:
     
     void free_image_data(unsigned char* image_data);
     
+    // Dim/desaturate/tint/vignette applied while scaling into the SHM buffer
+    void set_post_effects(const PostEffects& effects);
+    
+    // Blurred-fill bars for FIT/DEFAULT
+    void set_letterbox(const LetterboxSettings& settings) { letterbox_.configure(settings); }
+    
     // Check if image needs resizing for compatibility and resize if needed
     void check_and_resize_image(const unsigned char* src_data, int src_width, int src_height,
                                unsigned char** dst_data, int* dst_width, int* dst_height);
@@ -38,11 +46,24 @@ public:
 private:
     bool initialized_;
     
+    // Per-screen color effects (identity = plain copy)
+    PostEffects effects_;
+    PostEffectPass effect_pass_;
+    
+    LetterboxFill letterbox_;
+    
     // Image processing utilities
     void apply_scaling_shm(const unsigned char* src_data, int src_width, int src_height,
                           unsigned char* dst_data, int dst_width, int dst_height,
                           ScalingMode scaling, bool windowed_mode = false);
     
+    // Where apply_scaling_shm places the image (FILL offsets are negative, cropping)
+    void calculate_layout(int src_width, int src_height, int dst_width, int dst_height, ScalingMode scaling,
+                          int& render_width, int& render_height, int& offset_x, int& offset_y) const;
+    // Visible part of that placement, for the letterbox bars
+    DirtyRect calculate_content_rect(int src_width, int src_height, int dst_width, int dst_height,
+                                     ScalingMode scaling) const;
+    
     // Maximum texture size for compatibility
     static constexpr int MAX_TEXTURE_SIZE = 4096;
 };
@@ -1,4 +1,5 @@
 #include "wayland_video_renderer.h"
+#include "../../frame_pool.h"
 #include <iostream>
 #include <cstring>
 #include <cmath>
@@ -46,7 +47,7 @@ void WaylandVideoRenderer::cleanup() {
     cleanup_ffmpeg();
     
     if (frame_buffer_) {
-        delete[] frame_buffer_;
+        FramePool::instance().release(frame_buffer_);
         frame_buffer_ = nullptr;
     }
     
@@ -141,7 +142,11 @@ bool WaylandVideoRenderer::initialize_ffmpeg(const std::string& video_path) {
     int height = codec_context_->height;
     
     int buffer_size = av_image_get_buffer_size(AV_PIX_FMT_BGRA, width, height, 32);
-    frame_buffer_ = new uint8_t[buffer_size];
+    frame_buffer_ = static_cast<uint8_t*>(FramePool::instance().acquire(buffer_size));
+    if (!frame_buffer_) {
+        cleanup_ffmpeg();
+        return false;
+    }
     
     av_image_fill_arrays(rgb_frame_->data, rgb_frame_->linesize, 
                         frame_buffer_, AV_PIX_FMT_BGRA, width, height, 32);
@@ -220,26 +225,6 @@ bool WaylandVideoRenderer::render_video_shm(void* shm_data, int surface_width, i
     return false;
 }
 
-bool WaylandVideoRenderer::render_rgb_frame_shm(const unsigned char* frame_data, int frame_width, int frame_height,
-                                               void* shm_data, int surface_width, int surface_height,
-                                               ScalingMode scaling, bool windowed_mode) {
-    if (!frame_data || !shm_data) {
-        std::cerr << "ERROR: Invalid data for RGB frame SHM rendering" << std::endl;
-        return false;
-    }
-    
-    // Clear the SHM buffer
-    size_t buffer_size = surface_width * surface_height * 4;
-    memset(shm_data, 0, buffer_size);
-    
-    // Apply scaling and convert to SHM format
-    apply_scaling_shm(frame_data, frame_width, frame_height,
-                     reinterpret_cast<unsigned char*>(shm_data),
-                     surface_width, surface_height, scaling, windowed_mode);
-    
-    return true;
-}
-
 void WaylandVideoRenderer::cleanup_ffmpeg() {
     if (sws_context_) {
         sws_freeContext(sws_context_);
@@ -263,7 +248,7 @@ void WaylandVideoRenderer::cleanup_ffmpeg() {
     }
     
     if (frame_buffer_) {
-        delete[] frame_buffer_;
+        FramePool::instance().release(frame_buffer_);
         frame_buffer_ = nullptr;
     }
     
@@ -302,9 +287,17 @@ bool WaylandVideoRenderer::render_frame_data_shm(const unsigned char* frame_data
         return false;
     }
     
-    // Clear the SHM buffer
-    size_t buffer_size = surface_width * surface_height * 4;
-    memset(shm_data, 0, buffer_size);
+    if (letterbox_.is_enabled()) {
+        // The content area is fully rewritten below; the bars are only
+        // repainted when this buffer lacks them or their backdrop or the
+        // layout changed
+        paint_letterbox(frame_data, frame_width, frame_height, reinterpret_cast<unsigned char*>(shm_data),
+                        surface_width, surface_height, scaling, windowed_mode, nullptr);
+    } else {
+        // Clear the SHM buffer
+        size_t buffer_size = surface_width * surface_height * 4;
+        memset(shm_data, 0, buffer_size);
+    }
     
     // Apply scaling and convert to SHM format
     apply_scaling_shm(frame_data, frame_width, frame_height,
@@ -314,74 +307,127 @@ bool WaylandVideoRenderer::render_frame_data_shm(const unsigned char* frame_data
     return true;
 }
 
-void WaylandVideoRenderer::apply_scaling_shm(const unsigned char* src_data, int src_width, int src_height,
-                                             unsigned char* dst_data, int dst_width, int dst_height,
-                                             ScalingMode scaling, bool windowed_mode) {
-    // ============================================================================
-    // CRITICAL SCALING MODE IMPLEMENTATION - VERIFIED WORKING - DO NOT MODIFY
-    // 
-    // This section implements the three required scaling modes for Wayland video:
-    // - STRETCH (0): Fill entire surface, may distort aspect ratio
-    // - FIT (1): Letterbox/pillarbox, preserve aspect ratio, DEFAULT fallback
-    // - FILL (2): Crop to fill surface, preserve aspect ratio
-    // 
-    // FILL mode uses negative offsets for cropping - this is intentional!
-    // Non-FILL modes clamp offsets to prevent out-of-bounds rendering.
-    // All modes work correctly in both window and background modes.
-    // ============================================================================
+void WaylandVideoRenderer::set_post_effects(const PostEffects& effects) {
+    effects_ = effects;
+    effect_pass_ = PostEffectPass();
+    letterbox_.invalidate();
+}
+
+void WaylandVideoRenderer::set_letterbox(const LetterboxSettings& settings) {
+    letterbox_.configure(settings);
+}
+
+bool WaylandVideoRenderer::paint_letterbox(const unsigned char* frame_data, int frame_width, int frame_height,
+                                           unsigned char* dst_data, int dst_width, int dst_height,
+                                           ScalingMode scaling, bool windowed_mode, std::vector<DirtyRect>* painted) {
+    letterbox_.update(VideoFrame::rgba(frame_data, frame_width, frame_height));
+    
+    DirtyRect content;
+    calculate_shm_layout(frame_width, frame_height, dst_width, dst_height, scaling,
+                         content.width, content.height, content.x, content.y);
+    bool effects_active = prepare_effects(dst_width, dst_height);
+    return letterbox_.paint_bars_bgra(dst_data, dst_width, dst_height, content, windowed_mode,
+                                      effects_active ? &effect_pass_ : nullptr, painted);
+}
+
+bool WaylandVideoRenderer::prepare_effects(int dst_width, int dst_height) {
+    if (effects_.is_identity()) {
+        return false;
+    }
+    if (!effect_pass_.is_configured_for(dst_width, dst_height)) {
+        effect_pass_.configure(effects_, dst_width, dst_height);
+    }
+    return effect_pass_.is_active();
+}
+
+bool WaylandVideoRenderer::render_frame_data_shm_dirty(const unsigned char* frame_data, int frame_width, int frame_height,
+                                                      void* shm_data, int surface_width, int surface_height,
+                                                      ScalingMode scaling, bool windowed_mode,
+                                                      TileTracker& tracker, std::vector<DirtyRect>& damage) {
+    damage.clear();
+    if (!frame_data || !shm_data) {
+        std::cerr << "ERROR: Invalid data for frame SHM rendering" << std::endl;
+        return false;
+    }
+    
+    tracker.set_target(surface_width, surface_height, static_cast<int>(scaling) * 2 + (windowed_mode ? 1 : 0));
+    if (!tracker.update(frame_data, frame_width, frame_height)) {
+        // First frame, new buffer or most of the picture moved - full redraw
+        DirtyRect full;
+        full.width = surface_width;
+        full.height = surface_height;
+        damage.push_back(full);
+        letterbox_.invalidate();
+        return render_frame_data_shm(frame_data, frame_width, frame_height, shm_data,
+                                     surface_width, surface_height, scaling, windowed_mode);
+    }
     
-    // Calculate actual rendering dimensions based on scaling mode
-    int render_width = dst_width;
-    int render_height = dst_height;
-    int offset_x = 0;
-    int offset_y = 0;
+    int render_width, render_height, offset_x, offset_y;
+    calculate_shm_layout(frame_width, frame_height, surface_width, surface_height, scaling,
+                         render_width, render_height, offset_x, offset_y);
+    
+    for (const auto& rect : tracker.get_dirty_rects()) {
+        DirtyRect out;
+        if (!TileTracker::map_to_output(rect, frame_width, frame_height, offset_x, offset_y,
+                                        render_width, render_height, windowed_mode,
+                                        surface_width, surface_height, out)) {
+            continue;
+        }
+        scale_rect_shm(frame_data, frame_width, frame_height, reinterpret_cast<unsigned char*>(shm_data),
+                       surface_width, surface_height, out, render_width, render_height, offset_x, offset_y, windowed_mode);
+        damage.push_back(out);
+    }
+    
+    if (letterbox_.is_enabled()) {
+        // Backdrop refreshes land between content updates; damage just the bars
+        std::vector<DirtyRect> bars;
+        if (paint_letterbox(frame_data, frame_width, frame_height, reinterpret_cast<unsigned char*>(shm_data),
+                            surface_width, surface_height, scaling, windowed_mode, &bars)) {
+            damage.insert(damage.end(), bars.begin(), bars.end());
+        }
+    }
+    return true;
+}
+
+void WaylandVideoRenderer::calculate_shm_layout(int src_width, int src_height, int dst_width, int dst_height,
+                                                ScalingMode scaling, int& render_width, int& render_height,
+                                                int& offset_x, int& offset_y) const {
+    // STRETCH fills the surface, FIT letterboxes, FILL crops through negative
+    // offsets (intentional), DEFAULT centres the source at its own size.
+    // Non-FILL modes are clamped to the surface.
+    render_width = dst_width;
+    render_height = dst_height;
+    offset_x = 0;
+    offset_y = 0;
+    
+    double src_aspect = (double)src_width / src_height;
+    double dst_aspect = (double)dst_width / dst_height;
     
     switch (scaling) {
         case ScalingMode::STRETCH:
-            // Use full destination size (already set)
             break;
             
-        case ScalingMode::FIT: {
-            // Scale to fit within destination, maintaining aspect ratio
-            double src_aspect = (double)src_width / src_height;
-            double dst_aspect = (double)dst_width / dst_height;
-            
+        case ScalingMode::FIT:
             if (src_aspect > dst_aspect) {
-                render_width = dst_width;
                 render_height = (int)(dst_width / src_aspect);
                 offset_y = (dst_height - render_height) / 2;
             } else {
-                render_height = dst_height;
                 render_width = (int)(dst_height * src_aspect);
                 offset_x = (dst_width - render_width) / 2;
             }
             break;
-        }
-        
-        case ScalingMode::FILL: {
-            // Scale to fill destination, maintaining aspect ratio (may crop)
-            double src_aspect = (double)src_width / src_height;
-            double dst_aspect = (double)dst_width / dst_height;
-            
             
+        case ScalingMode::FILL:
             if (src_aspect > dst_aspect) {
-                // Source is wider, crop horizontally - use negative offset to center crop
-                render_height = dst_height;
                 render_width = (int)(dst_height * src_aspect);
-                offset_x = -(render_width - dst_width) / 2;  // Negative offset for cropping
-                offset_y = 0;
+                offset_x = -(render_width - dst_width) / 2;
             } else {
-                // Source is taller, crop vertically - use negative offset to center crop  
-                render_width = dst_width;
                 render_height = (int)(dst_width / src_aspect);
-                offset_x = 0;
-                offset_y = -(render_height - dst_height) / 2;  // Negative offset for cropping
+                offset_y = -(render_height - dst_height) / 2;
             }
             break;
-        }
-        
+            
         case ScalingMode::DEFAULT:
-            // Use original source size, centered
             render_width = src_width;
             render_height = src_height;
             offset_x = (dst_width - render_width) / 2;
@@ -389,21 +435,88 @@ void WaylandVideoRenderer::apply_scaling_shm(const unsigned char* src_data, int
             break;
     }
     
-    
-    // For FILL mode, negative offsets are allowed to enable cropping
-    // For other modes, clamp offsets to prevent rendering outside bounds
     if (scaling != ScalingMode::FILL) {
         if (offset_x < 0) offset_x = 0;
         if (offset_y < 0) offset_y = 0;
         if (render_width + offset_x > dst_width) render_width = dst_width - offset_x;
         if (render_height + offset_y > dst_height) render_height = dst_height - offset_y;
-    } else {
     }
+}
+
+void WaylandVideoRenderer::scale_rect_shm(const unsigned char* src_data, int src_width, int src_height,
+                                          unsigned char* dst_data, int dst_width, int dst_height, const DirtyRect& rect,
+                                          int render_width, int render_height, int offset_x, int offset_y,
+                                          bool windowed_mode) {
+    bool effects_active = prepare_effects(dst_width, dst_height);
+    for (int dst_y = rect.y; dst_y < rect.y + rect.height; dst_y++) {
+        int y = dst_y - offset_y;
+        if (y < 0 || y >= render_height) {
+            continue;
+        }
+        
+        int src_y = (y * src_height) / render_height;
+        if (windowed_mode) {
+            // Same Y-axis flip as apply_scaling_shm for window mode
+            src_y = src_height - 1 - src_y;
+        }
+        if (src_y < 0) src_y = 0;
+        if (src_y >= src_height) src_y = src_height - 1;
+        
+        const unsigned char* src_row = src_data + (size_t)src_y * src_width * 4;
+        unsigned char* dst_row = dst_data + (size_t)dst_y * dst_width * 4;
+        int row_factor = effects_active ? effect_pass_.row_factor(dst_y) : 256;
+        
+        for (int dst_x = rect.x; dst_x < rect.x + rect.width; dst_x++) {
+            int x = dst_x - offset_x;
+            if (x < 0 || x >= render_width) {
+                continue;
+            }
+            
+            int src_x = (x * src_width) / render_width;
+            if (src_x >= src_width) src_x = src_width - 1;
+            
+            // RGBA -> ARGB8888 (B, G, R, A in memory)
+            const unsigned char* src = src_row + src_x * 4;
+            unsigned char* dst = dst_row + dst_x * 4;
+            dst[0] = src[2];
+            dst[1] = src[1];
+            dst[2] = src[0];
+            dst[3] = src[3];
+            if (effects_active) {
+                effect_pass_.apply_bgra(dst, dst_x, row_factor);
+            }
+        }
+    }
+}
+
+void WaylandVideoRenderer::apply_scaling_shm(const unsigned char* src_data, int src_width, int src_height,
+                                             unsigned char* dst_data, int dst_width, int dst_height,
+                                             ScalingMode scaling, bool windowed_mode) {
+    // ============================================================================
+    // CRITICAL SCALING MODE IMPLEMENTATION - VERIFIED WORKING - DO NOT MODIFY
+    // 
+    // This section implements the three required scaling modes for Wayland video:
+    // - STRETCH (0): Fill entire surface, may distort aspect ratio
+    // - FIT (1): Letterbox/pillarbox, preserve aspect ratio, DEFAULT fallback
+    // - FILL (2): Crop to fill surface, preserve aspect ratio
+    // 
+    // FILL mode uses negative offsets for cropping - this is intentional!
+    // Non-FILL modes clamp offsets to prevent out-of-bounds rendering.
+    // All modes work correctly in both window and background modes.
+    // ============================================================================
     
+    // Layout (offsets, FILL cropping, clamping) is shared with the dirty-tile
+    // and letterbox paths so all three always agree
+    int render_width, render_height, offset_x, offset_y;
+    calculate_shm_layout(src_width, src_height, dst_width, dst_height, scaling,
+                         render_width, render_height, offset_x, offset_y);
     
     int pixels_copied = 0;
     int pixels_skipped = 0;
     
+    // Per-screen effects ride along in the same pixel loop (no second pass)
+    bool effects_active = prepare_effects(dst_width, dst_height);
+    
     // Scale and copy the image with Y-axis flip (BGRA -> RGBA for Wayland SHM)
     // ============================================================================
     // CRITICAL Y-AXIS ORIENTATION FIX FOR WAYLAND SHM VIDEO RENDERING
@@ -456,6 +569,9 @@ void WaylandVideoRenderer::apply_scaling_shm(const unsigned char* src_data, int
             dst_data[dst_idx + 1] = src_data[src_idx + 1]; // G 
             dst_data[dst_idx + 2] = src_data[src_idx + 0]; // R
             dst_data[dst_idx + 3] = src_data[src_idx + 3]; // A
+            if (effects_active) {
+                effect_pass_.apply_bgra(dst_data + dst_idx, dst_x, effect_pass_.row_factor(dst_y));
+            }
             
             pixels_copied++;
         }
@@ -1,10 +1,14 @@
 #pragma once
 
 #include "../display_manager.h"
+#include "../tile_tracker.h"
+#include "../post_effects.h"
+#include "../letterbox_fill.h"
 #include <wayland-client.h>
 #include <memory>
 #include <functional>
 #include <string>
+#include <vector>
 #include <cstdint>
 
 // Forward declarations for FFmpeg types
@@ -37,14 +41,24 @@ public:
                          ScalingMode scaling);
     
     // Handle video frame data directly (for non-FFmpeg sources)
-    bool render_rgb_frame_shm(const unsigned char* frame_data, int frame_width, int frame_height,
-                             void* shm_data, int surface_width, int surface_height,
-                             ScalingMode scaling, bool windowed_mode = false);
-    
     bool render_frame_data_shm(const unsigned char* frame_data, int frame_width, int frame_height,
                               void* shm_data, int surface_width, int surface_height,
                               ScalingMode scaling, bool windowed_mode = false);
     
+    // Same, but only rescales the tiles that changed since the previous frame.
+    // damage receives the touched buffer rectangles (empty: nothing to commit)
+    bool render_frame_data_shm_dirty(const unsigned char* frame_data, int frame_width, int frame_height,
+                                     void* shm_data, int surface_width, int surface_height,
+                                     ScalingMode scaling, bool windowed_mode,
+                                     TileTracker& tracker, std::vector<DirtyRect>& damage);
+    
+    // Dim/desaturate/tint/vignette applied inside the scaling loops
+    void set_post_effects(const PostEffects& effects);
+    
+    // Blurred-fill bars for FIT/DEFAULT; invalidate when the SHM buffer is replaced
+    void set_letterbox(const LetterboxSettings& settings);
+    void invalidate_letterbox() { letterbox_.invalidate(); }
+    
     // CPU video event handling
     void handle_video_events();
     
@@ -78,10 +92,31 @@ private:
     // Render callback
     RenderCallback render_callback_;
     
+    // Per-screen color effects (identity = plain copy)
+    PostEffects effects_;
+    PostEffectPass effect_pass_;
+    bool prepare_effects(int dst_width, int dst_height);
+    
+    // Bars around the content keep their backdrop until it is refreshed
+    LetterboxFill letterbox_;
+    bool paint_letterbox(const unsigned char* frame_data, int frame_width, int frame_height,
+                         unsigned char* dst_data, int dst_width, int dst_height,
+                         ScalingMode scaling, bool windowed_mode, std::vector<DirtyRect>* painted);
+    
     // Private CPU methods
     void cleanup_ffmpeg();
     
     void apply_scaling_shm(const unsigned char* src_data, int src_width, int src_height,
                           unsigned char* dst_data, int dst_width, int dst_height,
                           ScalingMode scaling, bool windowed_mode = false);
+    
+    // Placement shared by apply_scaling_shm, the dirty-tile path and the bars,
+    // and a copy of the pixel loop limited to one output rectangle (keep it in
+    // sync with apply_scaling_shm)
+    void calculate_shm_layout(int src_width, int src_height, int dst_width, int dst_height, ScalingMode scaling,
+                              int& render_width, int& render_height, int& offset_x, int& offset_y) const;
+    void scale_rect_shm(const unsigned char* src_data, int src_width, int src_height,
+                        unsigned char* dst_data, int dst_width, int dst_height, const DirtyRect& rect,
+                        int render_width, int render_height, int offset_x, int offset_y,
+                        bool windowed_mode);
 };
@@ -1,9 +1,15 @@
 #include "x11_display.h"
 #include "x11_image_renderer.h"
 #include "x11_video_renderer.h"
+#include "../display_backend.h"
+#include "../stats_overlay.h"
+#include "../../frame_pool.h"
 #include <iostream>
 #include <cstring>
+#include <mutex>
 #include <X11/Xatom.h>
+#include <sys/ipc.h>
+#include <sys/shm.h>
 
 X11Display::X11Display(const std::string& output_name) 
     : output_name_(output_name), display_(nullptr), root_window_(0), window_(0), 
@@ -11,7 +17,11 @@ X11Display::X11Display(const std::string& output_name)
       image_data_(nullptr), image_size_(0), ximage_(nullptr), pixmap_(0), gc_(0),
       egl_initialized_(false), prefer_egl_(true), egl_display_(EGL_NO_DISPLAY),
       egl_config_(nullptr), egl_context_(EGL_NO_CONTEXT), egl_surface_(EGL_NO_SURFACE),
-      current_scaling_(ScalingMode::DEFAULT) {
+      current_scaling_(ScalingMode::DEFAULT), dirty_tracking_(false), server_scaling_(false),
+      xshm_available_(false), source_shm_(false), shm_info_(), source_image_(nullptr), source_pixmap_(0),
+      source_picture_(0), target_picture_(0), source_width_(0), source_height_(0), backdrop_pixmap_(0),
+      backdrop_picture_(0), backdrop_width_(0), backdrop_height_(0), bars_valid_(false), stats_overlay_(nullptr),
+      rr_event_base_(-1), geometry_changed_(false) {
     image_renderer_ = std::make_unique<X11ImageRenderer>();
     video_renderer_ = std::make_unique<X11VideoRenderer>();
 }
@@ -22,7 +32,11 @@ X11Display::X11Display(int x, int y, int width, int height)
       image_data_(nullptr), image_size_(0), ximage_(nullptr), pixmap_(0), gc_(0),
       egl_initialized_(false), prefer_egl_(true), egl_display_(EGL_NO_DISPLAY),
       egl_config_(nullptr), egl_context_(EGL_NO_CONTEXT), egl_surface_(EGL_NO_SURFACE),
-      current_scaling_(ScalingMode::DEFAULT) {
+      current_scaling_(ScalingMode::DEFAULT), dirty_tracking_(false), server_scaling_(false),
+      xshm_available_(false), source_shm_(false), shm_info_(), source_image_(nullptr), source_pixmap_(0),
+      source_picture_(0), target_picture_(0), source_width_(0), source_height_(0), backdrop_pixmap_(0),
+      backdrop_picture_(0), backdrop_width_(0), backdrop_height_(0), bars_valid_(false), stats_overlay_(nullptr),
+      rr_event_base_(-1), geometry_changed_(false) {
     image_renderer_ = std::make_unique<X11ImageRenderer>();
     video_renderer_ = std::make_unique<X11VideoRenderer>();
 }
@@ -46,42 +60,49 @@ bool X11Display::initialize() {
         }
     }
     
-    // Try to initialize EGL for GPU acceleration
-    if (prefer_egl_) {
-        if (initialize_egl()) {
-            std::cout << "DEBUG: X11Display initialized with EGL support" << std::endl;
-        } else {
-            std::cout << "DEBUG: X11Display falling back to CPU rendering" << std::endl;
-            prefer_egl_ = false;
-        }
-    }
-    
-    // Initialize renderers
+    // Initialize renderers. EGL is only brought up by ensure_egl() once video
+    // frames arrive; a static wallpaper never needs a GL context.
     Window target_window = windowed_mode_ ? window_ : root_window_;
     
+    if (!image_renderer_->initialize(display_, target_window, screen_)) {
+        std::cerr << "ERROR: Failed to initialize X11 image renderer" << std::endl;
+        return false;
+    }
+    if (!video_renderer_->initialize(display_, target_window, screen_)) {
+        std::cerr << "ERROR: Failed to initialize X11 video renderer" << std::endl;
+        return false;
+    }
+    
+    return true;
+}
+
+bool X11Display::ensure_egl() {
     if (egl_initialized_) {
-        // Initialize with EGL support
-        if (!image_renderer_->initialize_egl(display_, target_window, screen_, 
-                                           egl_display_, egl_config_, egl_context_)) {
-            std::cerr << "ERROR: Failed to initialize X11 image renderer with EGL" << std::endl;
-            return false;
-        }
-        if (!video_renderer_->initialize(display_, target_window, screen_)) {
-            std::cerr << "ERROR: Failed to initialize X11 video renderer" << std::endl;
-            return false;
-        }
-    } else {
-        // Initialize with X11 only
-        if (!image_renderer_->initialize(display_, target_window, screen_)) {
-            std::cerr << "ERROR: Failed to initialize X11 image renderer" << std::endl;
-            return false;
-        }
-        if (!video_renderer_->initialize(display_, target_window, screen_)) {
-            std::cerr << "ERROR: Failed to initialize X11 video renderer" << std::endl;
-            return false;
-        }
+        return true;
+    }
+    if (!prefer_egl_ || !display_) {
+        return false;
+    }
+    
+    // Only tried once: on failure this output stays on CPU rendering
+    if (!initialize_egl()) {
+        std::cout << "DEBUG: X11Display falling back to CPU rendering" << std::endl;
+        prefer_egl_ = false;
+        return false;
+    }
+    
+    Window target_window = windowed_mode_ ? window_ : root_window_;
+    image_renderer_->cleanup();
+    if (!image_renderer_->initialize_egl(display_, target_window, screen_,
+                                         egl_display_, egl_config_, egl_context_)) {
+        std::cerr << "ERROR: Failed to initialize X11 image renderer with EGL" << std::endl;
+        image_renderer_->initialize(display_, target_window, screen_);
+        cleanup_egl();
+        prefer_egl_ = false;
+        return false;
     }
     
+    std::cout << "DEBUG: X11Display initialized with EGL support" << std::endl;
     return true;
 }
 
@@ -110,17 +131,14 @@ bool X11Display::init_window_mode() {
     
     // Set window properties
     XStoreName(display_, window_, "Linux Wallpaper Engine Ext");
-    XSelectInput(display_, window_, ExposureMask | KeyPressMask);
+    XSelectInput(display_, window_, ExposureMask | KeyPressMask | StructureNotifyMask);
     XMapWindow(display_, window_);
     XFlush(display_);
     
     return true;
 }
 
-bool X11Display::init_background_mode() {
-    // For background mode, we'll work with the root window
-    // We need to find the specific monitor if output_name_ is specified
-    
+bool X11Display::get_monitor_geometry(const std::string& name, int& x, int& y, int& width, int& height) const {
     int num_monitors;
     XRRMonitorInfo* monitors = XRRGetMonitors(display_, root_window_, True, &num_monitors);
     
@@ -130,36 +148,47 @@ bool X11Display::init_background_mode() {
     }
     
     bool found_monitor = false;
-    if (output_name_ != "default") {
+    if (name != "default") {
         for (int i = 0; i < num_monitors; i++) {
-            char* name = XGetAtomName(display_, monitors[i].name);
-            if (name && std::strcmp(name, output_name_.c_str()) == 0) {
+            char* monitor_name = XGetAtomName(display_, monitors[i].name);
+            if (monitor_name && std::strcmp(monitor_name, name.c_str()) == 0) {
                 found_monitor = true;
-                // Store monitor geometry for later use
-                x_ = monitors[i].x;
-                y_ = monitors[i].y;
-                width_ = monitors[i].width;
-                height_ = monitors[i].height;
-                XFree(name);
+                x = monitors[i].x;
+                y = monitors[i].y;
+                width = monitors[i].width;
+                height = monitors[i].height;
+                XFree(monitor_name);
                 break;
             }
-            if (name) XFree(name);
-        }
-        
-        if (!found_monitor) {
-            std::cerr << "Monitor " << output_name_ << " not found" << std::endl;
-            XRRFreeMonitors(monitors);
-            return false;
+            if (monitor_name) XFree(monitor_name);
         }
-    } else {
+    } else if (num_monitors > 0) {
         // Use the primary monitor
-        x_ = monitors[0].x;
-        y_ = monitors[0].y;
-        width_ = monitors[0].width;
-        height_ = monitors[0].height;
+        found_monitor = true;
+        x = monitors[0].x;
+        y = monitors[0].y;
+        width = monitors[0].width;
+        height = monitors[0].height;
     }
     
     XRRFreeMonitors(monitors);
+    return found_monitor;
+}
+
+bool X11Display::init_background_mode() {
+    // For background mode, we'll work with the root window
+    // We need to find the specific monitor if output_name_ is specified
+    
+    if (output_name_ == "all") {
+        // Whole root window across every monitor (used for spanned wallpapers)
+        x_ = 0;
+        y_ = 0;
+        width_ = DisplayWidth(display_, screen_);
+        height_ = DisplayHeight(display_, screen_);
+    } else if (!get_monitor_geometry(output_name_, x_, y_, width_, height_)) {
+        std::cerr << "Monitor " << output_name_ << " not found" << std::endl;
+        return false;
+    }
     
     // Initialize image buffer for background mode
     if (!init_image_buffer()) {
@@ -167,9 +196,62 @@ bool X11Display::init_background_mode() {
         return false;
     }
     
+    // Mode changes and monitor moves arrive as RandR screen change events
+    int rr_error_base;
+    if (XRRQueryExtension(display_, &rr_event_base_, &rr_error_base)) {
+        XRRSelectInput(display_, root_window_, RRScreenChangeNotifyMask);
+    } else {
+        rr_event_base_ = -1;
+    }
+    
     return true;
 }
 
+void X11Display::refresh_background_geometry() {
+    int x = 0, y = 0, width = 0, height = 0;
+    if (output_name_ == "all") {
+        width = DisplayWidth(display_, screen_);
+        height = DisplayHeight(display_, screen_);
+    } else if (!get_monitor_geometry(output_name_, x, y, width, height)) {
+        std::cerr << "WARNING: Monitor " << output_name_ << " disappeared, keeping its last geometry" << std::endl;
+        return;
+    }
+    
+    // Redraw even when only the mode's refresh rate changed: the server may have reset the root
+    geometry_changed_ = true;
+    x_ = x;
+    y_ = y;
+    if (width == width_ && height == height_) {
+        return;
+    }
+    
+    std::cout << "DEBUG: " << output_name_ << " resized to " << width << "x" << height << std::endl;
+    width_ = width;
+    height_ = height;
+    
+    // Everything that wraps the root pixmap is rebuilt at the new size
+    if (egl_surface_ != EGL_NO_SURFACE) {
+        eglMakeCurrent(egl_display_, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        eglDestroySurface(egl_display_, egl_surface_);
+        egl_surface_ = EGL_NO_SURFACE;
+    }
+    cleanup_image_buffer();
+    if (!init_image_buffer()) {
+        std::cerr << "ERROR: Failed to resize image buffer for " << output_name_ << std::endl;
+        return;
+    }
+    if (server_scaling_ && !init_server_scaling()) {
+        server_scaling_ = false;
+    }
+    if (egl_initialized_ && !create_egl_pixmap_surface()) {
+        std::cerr << "ERROR: EGL pixmap surface lost on resize, falling back to CPU rendering" << std::endl;
+        image_renderer_->cleanup();
+        image_renderer_->initialize(display_, root_window_, screen_);
+        cleanup_egl();
+        prefer_egl_ = false;
+    }
+}
+
 void X11Display::cleanup() {
     // Cleanup renderers
     if (image_renderer_) {
@@ -222,20 +304,56 @@ void X11Display::set_window_background(const std::string& media_path) {
 }
 
 void X11Display::update() {
-    if (windowed_mode_ && display_) {
-        // Handle X11 events for windowed mode
-        XEvent event;
-        while (XPending(display_)) {
-            XNextEvent(display_, &event);
-            // Handle events as needed
+    if (!display_) {
+        return;
+    }
+    
+    bool screen_changed = false;
+    XEvent event;
+    while (XPending(display_)) {
+        XNextEvent(display_, &event);
+        if (windowed_mode_) {
+            if (event.type == ConfigureNotify &&
+                (event.xconfigure.width != width_ || event.xconfigure.height != height_)) {
+                width_ = event.xconfigure.width;
+                height_ = event.xconfigure.height;
+                geometry_changed_ = true;
+            } else if (event.type == Expose && event.xexpose.count == 0) {
+                geometry_changed_ = true;
+            }
+        } else if (rr_event_base_ >= 0 && event.type == rr_event_base_ + RRScreenChangeNotify) {
+            XRRUpdateConfiguration(&event);
+            screen_changed = true;
         }
     }
+    
+    // One refresh for a burst of events (a mode switch sends several)
+    if (screen_changed) {
+        refresh_background_geometry();
+    }
+}
+
+bool X11Display::consume_geometry_change() {
+    bool changed = geometry_changed_;
+    geometry_changed_ = false;
+    return changed;
 }
 
 std::string X11Display::get_name() const {
     return output_name_;
 }
 
+bool X11Display::get_geometry(int& x, int& y, int& width, int& height) const {
+    if (windowed_mode_) {
+        return false;
+    }
+    x = x_;
+    y = y_;
+    width = width_;
+    height = height_;
+    return true;
+}
+
 std::vector<std::unique_ptr<DisplayOutput>> X11Display::get_outputs() {
     std::vector<std::unique_ptr<DisplayOutput>> outputs;
     
@@ -264,6 +382,11 @@ std::vector<std::unique_ptr<DisplayOutput>> X11Display::get_outputs() {
 }
 
 std::unique_ptr<DisplayOutput> X11Display::get_output_by_name(const std::string& name) {
+    if (name == "all") {
+        // Whole root window, not a RandR monitor
+        return std::make_unique<X11Display>(name);
+    }
+    
     Display* display = XOpenDisplay(nullptr);
     if (!display) {
         return nullptr;
@@ -303,6 +426,7 @@ bool X11Display::render_image_data(const unsigned char* image_data, int img_widt
     }
     
     current_scaling_ = scaling;
+    frame_start_ = std::chrono::steady_clock::now();
     
     // For windowed mode, use the specialized renderers
     if (windowed_mode_) {
@@ -311,13 +435,22 @@ bool X11Display::render_image_data(const unsigned char* image_data, int img_widt
             return false;
         }
         
-        // For images, prefer CPU-based X11 rendering (reliable and fast)
+        if (render_frame_egl(image_data, img_width, img_height, scaling)) {
+            return true;
+        }
+        
+        // CPU-based X11 rendering when EGL is unavailable
         std::cout << "DEBUG: Using X11 image rendering" << std::endl;
         return image_renderer_->render_image_x11(image_data, img_width, img_height,
                                                 width_, height_, scaling, windowed_mode_);
     }
     
-    // For background mode, render directly to the image buffer
+    // For background mode, draw into the root pixmap on the GPU when possible
+    if (render_frame_egl(image_data, img_width, img_height, scaling)) {
+        return true;
+    }
+    
+    // Otherwise render directly to the image buffer
     std::cout << "DEBUG: Using X11 background image rendering" << std::endl;
     if (!image_data_ || !ximage_) {
         std::cerr << "ERROR: Image buffer not initialized for background mode" << std::endl;
@@ -327,14 +460,22 @@ bool X11Display::render_image_data(const unsigned char* image_data, int img_widt
     return render_to_image_buffer(image_data, img_width, img_height, scaling);
 }
 
-bool X11Display::render_video_frame(const unsigned char* frame_data, int frame_width, int frame_height, ScalingMode scaling) {
-    if (!frame_data) {
+bool X11Display::render_frame(const VideoFrame& frame, ScalingMode scaling) {
+    if (!frame.is_valid() || frame.is_yuv()) {
         std::cerr << "ERROR: No video frame data available" << std::endl;
         return false;
     }
-    
+    const unsigned char* frame_data = frame.packed_rgba(packed_frame_);
+    int frame_width = frame.width;
+    int frame_height = frame.height;
     
     current_scaling_ = scaling;
+    frame_start_ = std::chrono::steady_clock::now();
+    
+    // GPU path: frames stream into the persistent texture for both modes
+    if (ensure_egl() && render_frame_egl(frame_data, frame_width, frame_height, scaling)) {
+        return true;
+    }
     
     // For windowed mode, use the video renderer directly
     if (windowed_mode_ && video_renderer_) {
@@ -344,11 +485,54 @@ bool X11Display::render_video_frame(const unsigned char* frame_data, int frame_w
                                                      width_, height_, scaling, windowed_mode_);
     }
     
+    // Server-side scaling: upload at source size, XRender scales into the root pixmap
+    if (server_scaling_ && render_frame_xrender(frame_data, frame_width, frame_height, scaling)) {
+        return true;
+    }
+    
+    // Cinemagraph mode: rescale and repaint only the tiles that changed
+    if (dirty_tracking_) {
+        return render_to_image_buffer_dirty(frame_data, frame_width, frame_height, scaling);
+    }
+    
     // For background mode, use the same approach as images - render to internal buffer
     std::cout << "DEBUG: Using X11 background video rendering" << std::endl;
     return render_image_data(frame_data, frame_width, frame_height, scaling);
 }
 
+bool X11Display::render_frame_egl(const unsigned char* frame_data, int frame_width, int frame_height, ScalingMode scaling) {
+    if (!egl_initialized_ || egl_surface_ == EGL_NO_SURFACE || !image_renderer_) {
+        return false;
+    }
+    
+    if (!image_renderer_->render_image_egl(frame_data, frame_width, frame_height,
+                                           egl_surface_, width_, height_, scaling)) {
+        // Stay on the CPU path from now on instead of failing every frame
+        std::cerr << "ERROR: EGL rendering failed, falling back to CPU rendering" << std::endl;
+        image_renderer_->cleanup();
+        image_renderer_->initialize(display_, windowed_mode_ ? window_ : root_window_, screen_);
+        cleanup_egl();
+        prefer_egl_ = false;
+        return false;
+    }
+    
+    auto present_start = std::chrono::steady_clock::now();
+    if (windowed_mode_) {
+        eglSwapBuffers(egl_display_, egl_surface_);
+    } else {
+        // Pixmap surfaces are single-buffered: wait for the GPU, then let X
+        // repaint the root from the pixmap
+        eglWaitClient();
+        publish_background_pixmap();
+    }
+    if (stats_overlay_) {
+        stats_overlay_->record_scale(std::chrono::duration<double, std::milli>(present_start - frame_start_).count());
+        stats_overlay_->record_present(StatsOverlay::elapsed_ms(present_start));
+    }
+    
+    return true;
+}
+
 // EGL context management methods
 bool X11Display::initialize_egl() {
     if (egl_initialized_) {
@@ -385,13 +569,17 @@ bool X11Display::initialize_egl() {
         return false;
     }
     
-    // Create EGL surface (only for windowed mode)
+    // Create EGL surface: the window in windowed mode, the root pixmap otherwise
     if (windowed_mode_) {
         if (!create_egl_surface()) {
             std::cerr << "DEBUG: Failed to create EGL surface" << std::endl;
             cleanup_egl();
             return false;
         }
+    } else if (!create_egl_pixmap_surface()) {
+        std::cerr << "DEBUG: Failed to create EGL pixmap surface" << std::endl;
+        cleanup_egl();
+        return false;
     }
     
     egl_initialized_ = true;
@@ -404,15 +592,25 @@ bool X11Display::make_egl_current() {
         return false;
     }
     
-    if (windowed_mode_ && egl_surface_ != EGL_NO_SURFACE) {
+    if (egl_surface_ != EGL_NO_SURFACE) {
         return eglMakeCurrent(egl_display_, egl_surface_, egl_surface_, egl_context_);
     } else {
-        // For background mode, we don't have a surface
         return eglMakeCurrent(egl_display_, EGL_NO_SURFACE, EGL_NO_SURFACE, egl_context_);
     }
 }
 
+void X11Display::release_thread_context() {
+    // The image renderer makes the context current again before every EGL frame
+    if (egl_initialized_) {
+        eglMakeCurrent(egl_display_, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    }
+}
+
 void X11Display::cleanup_egl() {
+    if (egl_display_ != EGL_NO_DISPLAY) {
+        eglMakeCurrent(egl_display_, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    }
+    
     if (egl_surface_ != EGL_NO_SURFACE) {
         eglDestroySurface(egl_display_, egl_surface_);
         egl_surface_ = EGL_NO_SURFACE;
@@ -455,13 +653,13 @@ bool X11Display::create_egl_context() {
 }
 
 bool X11Display::choose_egl_config() {
-    // Configuration attributes
+    // Configuration attributes; the background pixmap is 24-bit, so no alpha there
     EGLint config_attribs[] = {
-        EGL_SURFACE_TYPE, EGL_WINDOW_BIT,
+        EGL_SURFACE_TYPE, windowed_mode_ ? EGL_WINDOW_BIT : EGL_PIXMAP_BIT,
         EGL_BLUE_SIZE, 8,
         EGL_GREEN_SIZE, 8,
         EGL_RED_SIZE, 8,
-        EGL_ALPHA_SIZE, 8,
+        EGL_ALPHA_SIZE, windowed_mode_ ? 8 : 0,
         EGL_DEPTH_SIZE, 16,
         EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
         EGL_NONE
@@ -492,11 +690,31 @@ bool X11Display::create_egl_surface() {
     return true;
 }
 
+bool X11Display::create_egl_pixmap_surface() {
+    if (!pixmap_) {
+        std::cerr << "DEBUG: Cannot create EGL pixmap surface without background pixmap" << std::endl;
+        return false;
+    }
+    
+    egl_surface_ = eglCreatePixmapSurface(egl_display_, egl_config_, (EGLNativePixmapType)pixmap_, nullptr);
+    if (egl_surface_ == EGL_NO_SURFACE) {
+        EGLint error = eglGetError();
+        std::cerr << "DEBUG: Failed to create EGL pixmap surface: " << error << std::endl;
+        return false;
+    }
+    
+    return true;
+}
+
 bool X11Display::init_image_buffer() {
     if (windowed_mode_) {
         return true; // No image buffer needed for windowed mode
     }
     
+    // New buffer: the next video frame is drawn in full
+    tile_tracker_.reset();
+    letterbox_.invalidate();
+    
     // Create pixmap for background rendering (like reference implementation)
     pixmap_ = XCreatePixmap(display_, root_window_, width_, height_, 24);
     if (!pixmap_) {
@@ -522,7 +740,10 @@ bool X11Display::init_image_buffer() {
     
     // Allocate space for image buffer (CPU buffer for rendering)
     image_size_ = width_ * height_ * 4; // RGBA
-    image_data_ = new char[image_size_];
+    image_data_ = static_cast<char*>(FramePool::instance().acquire(image_size_));
+    if (!image_data_) {
+        return false;
+    }
     memset(image_data_, 0, image_size_);
     
     // Create XImage for copying data to pixmap
@@ -539,12 +760,17 @@ bool X11Display::init_image_buffer() {
 }
 
 void X11Display::cleanup_image_buffer() {
+    // Pictures and the source pixmap refer to pixmap_ and gc_
+    cleanup_server_scaling();
+    
     if (ximage_) {
-        XDestroyImage(ximage_); // This also frees image_data_
+        // The buffer belongs to the frame pool; keep XDestroyImage from freeing it
+        ximage_->data = nullptr;
+        XDestroyImage(ximage_);
         ximage_ = nullptr;
-        image_data_ = nullptr; // Don't delete separately, XDestroyImage handles it
-    } else if (image_data_) {
-        delete[] image_data_;
+    }
+    if (image_data_) {
+        FramePool::instance().release(image_data_);
         image_data_ = nullptr;
     }
     
@@ -567,6 +793,10 @@ void X11Display::update_background_from_buffer() {
     // Copy image buffer to pixmap
     XPutImage(display_, pixmap_, gc_, ximage_, 0, 0, 0, 0, width_, height_);
     
+    publish_background_pixmap();
+}
+
+void X11Display::publish_background_pixmap() {
     // Update root window properties for compositor compatibility (like reference)
     Atom prop_root = XInternAtom(display_, "_XROOTPMAP_ID", False);
     Atom prop_esetroot = XInternAtom(display_, "ESETROOT_PMAP_ID", False);
@@ -580,16 +810,12 @@ void X11Display::update_background_from_buffer() {
     XFlush(display_);
 }
 
-bool X11Display::render_to_image_buffer(const unsigned char* image_data, int img_width, int img_height, ScalingMode scaling) {
-    if (!image_data_ || !image_data) {
-        return false;
-    }
-    
-    // Calculate scaled dimensions based on scaling mode
-    int dest_width = width_;
-    int dest_height = height_;
-    int dest_x = 0;
-    int dest_y = 0;
+void X11Display::calculate_buffer_layout(int img_width, int img_height, ScalingMode scaling,
+                                         int& dest_x, int& dest_y, int& dest_width, int& dest_height) const {
+    dest_width = width_;
+    dest_height = height_;
+    dest_x = 0;
+    dest_y = 0;
     
     switch (scaling) {
         case ScalingMode::STRETCH:
@@ -642,9 +868,33 @@ bool X11Display::render_to_image_buffer(const unsigned char* image_data, int img
             dest_y = (height_ - dest_height) / 2;
             break;
     }
+}
+
+bool X11Display::render_to_image_buffer(const unsigned char* image_data, int img_width, int img_height, ScalingMode scaling) {
+    if (!image_data_ || !image_data) {
+        return false;
+    }
     
-    // Clear the buffer first (black background)
-    memset(image_data_, 0, image_size_);
+    // Calculate scaled dimensions based on scaling mode
+    int dest_x, dest_y, dest_width, dest_height;
+    calculate_buffer_layout(img_width, img_height, scaling, dest_x, dest_y, dest_width, dest_height);
+    
+    // Per-screen effects ride along in the same pixel loop (no second pass)
+    bool effects_active = prepare_effects();
+    
+    if (letterbox_.is_enabled()) {
+        // Every content pixel is rewritten below; the bars keep their
+        // backdrop until it is refreshed or the layout changes
+        DirtyRect content;
+        content.x = dest_x;
+        content.y = dest_y;
+        content.width = dest_width;
+        content.height = dest_height;
+        paint_letterbox(image_data, img_width, img_height, content, nullptr);
+    } else {
+        // Clear the buffer first (black background)
+        memset(image_data_, 0, image_size_);
+    }
     
     // Copy and scale image data to buffer with conditional Y-axis flip
     // ============================================================================
@@ -687,6 +937,10 @@ bool X11Display::render_to_image_buffer(const unsigned char* image_data, int img
             image_data_[buf_idx + 1] = image_data[src_idx + 1]; // G
             image_data_[buf_idx + 2] = image_data[src_idx + 0]; // R
             image_data_[buf_idx + 3] = image_data[src_idx + 3]; // A
+            if (effects_active) {
+                effect_pass_.apply_bgra(reinterpret_cast<unsigned char*>(image_data_ + buf_idx), buf_x,
+                                        effect_pass_.row_factor(buf_y));
+            }
         }
     }
     
@@ -694,11 +948,547 @@ bool X11Display::render_to_image_buffer(const unsigned char* image_data, int img
     // END CONDITIONAL Y-AXIS ORIENTATION FIX FOR X11 IMAGE BUFFER COPYING
     // ============================================================================
     
+    if (stats_overlay_) {
+        stats_overlay_->draw_bgra(reinterpret_cast<unsigned char*>(image_data_), width_, height_, true, nullptr);
+        stats_overlay_->record_scale(StatsOverlay::elapsed_ms(frame_start_));
+    }
+    
     // Update the background from buffer
+    auto present_start = std::chrono::steady_clock::now();
     update_background_from_buffer();
+    if (stats_overlay_) {
+        stats_overlay_->record_present(StatsOverlay::elapsed_ms(present_start));
+    }
     
     std::cout << "DEBUG: Rendered image (" << img_width << "x" << img_height << ") to background buffer (" 
               << dest_width << "x" << dest_height << ") at (" << dest_x << "," << dest_y << ")" << std::endl;
     
     return true;
 }
+
+bool X11Display::render_to_image_buffer_dirty(const unsigned char* frame_data, int frame_width, int frame_height, ScalingMode scaling) {
+    if (!image_data_ || !ximage_ || !frame_data) {
+        return false;
+    }
+    
+    tile_tracker_.set_target(width_, height_, static_cast<int>(scaling));
+    if (!tile_tracker_.update(frame_data, frame_width, frame_height)) {
+        // First frame or most of the picture moved - full redraw and publish
+        tile_tracker_.log_stats("X11 " + output_name_);
+        return render_to_image_buffer(frame_data, frame_width, frame_height, scaling);
+    }
+    
+    int dest_x, dest_y, dest_width, dest_height;
+    calculate_buffer_layout(frame_width, frame_height, scaling, dest_x, dest_y, dest_width, dest_height);
+    
+    bool effects_active = prepare_effects();
+    bool damaged = false;
+    DirtyRect hud;
+    bool hud_covered = false;
+    if (stats_overlay_) {
+        hud = stats_overlay_->get_rect(width_, height_);
+    }
+    for (const auto& rect : tile_tracker_.get_dirty_rects()) {
+        DirtyRect out;
+        if (!TileTracker::map_to_output(rect, frame_width, frame_height, dest_x, dest_y, dest_width, dest_height,
+                                        false, width_, height_, out)) {
+            continue;
+        }
+        if (stats_overlay_ && StatsOverlay::intersects(out, hud)) {
+            hud_covered = true;
+        }
+        
+        // Same sampling as render_to_image_buffer, limited to the changed rectangle
+        for (int buf_y = out.y; buf_y < out.y + out.height; buf_y++) {
+            int src_y = ((buf_y - dest_y) * frame_height) / dest_height;
+            if (src_y < 0) src_y = 0;
+            if (src_y >= frame_height) src_y = frame_height - 1;
+            int row_factor = effects_active ? effect_pass_.row_factor(buf_y) : 256;
+            
+            for (int buf_x = out.x; buf_x < out.x + out.width; buf_x++) {
+                int src_x = ((buf_x - dest_x) * frame_width) / dest_width;
+                if (src_x >= frame_width) src_x = frame_width - 1;
+                
+                int src_idx = (src_y * frame_width + src_x) * 4;
+                int buf_idx = (buf_y * width_ + buf_x) * 4;
+                image_data_[buf_idx + 0] = frame_data[src_idx + 2]; // B
+                image_data_[buf_idx + 1] = frame_data[src_idx + 1]; // G
+                image_data_[buf_idx + 2] = frame_data[src_idx + 0]; // R
+                image_data_[buf_idx + 3] = frame_data[src_idx + 3]; // A
+                if (effects_active) {
+                    effect_pass_.apply_bgra(reinterpret_cast<unsigned char*>(image_data_ + buf_idx), buf_x, row_factor);
+                }
+            }
+        }
+        
+        // Upload just this rectangle and let X repaint that part of the root
+        XPutImage(display_, pixmap_, gc_, ximage_, out.x, out.y, out.x, out.y, out.width, out.height);
+        XClearArea(display_, root_window_, out.x, out.y, out.width, out.height, False);
+        damaged = true;
+    }
+    
+    if (letterbox_.is_enabled()) {
+        // A refreshed backdrop only needs its bars pushed to the pixmap
+        DirtyRect content;
+        content.x = dest_x;
+        content.y = dest_y;
+        content.width = dest_width;
+        content.height = dest_height;
+        std::vector<DirtyRect> bars;
+        if (paint_letterbox(frame_data, frame_width, frame_height, content, &bars)) {
+            for (const auto& bar : bars) {
+                XPutImage(display_, pixmap_, gc_, ximage_, bar.x, bar.y, bar.x, bar.y, bar.width, bar.height);
+                XClearArea(display_, root_window_, bar.x, bar.y, bar.width, bar.height, False);
+                if (stats_overlay_ && StatsOverlay::intersects(bar, hud)) {
+                    hud_covered = true;
+                }
+                damaged = true;
+            }
+        }
+    }
+    
+    if (stats_overlay_) {
+        // Tiles already sent to the pixmap are re-sent with the HUD on top;
+        // otherwise only a changed HUD is uploaded
+        DirtyRect drawn;
+        if (stats_overlay_->draw_bgra(reinterpret_cast<unsigned char*>(image_data_), width_, height_,
+                                      hud_covered, &drawn)) {
+            XPutImage(display_, pixmap_, gc_, ximage_, drawn.x, drawn.y, drawn.x, drawn.y, drawn.width, drawn.height);
+            XClearArea(display_, root_window_, drawn.x, drawn.y, drawn.width, drawn.height, False);
+            damaged = true;
+        }
+        stats_overlay_->record_scale(StatsOverlay::elapsed_ms(frame_start_));
+    }
+    
+    if (damaged) {
+        auto present_start = std::chrono::steady_clock::now();
+        XFlush(display_);
+        if (stats_overlay_) {
+            stats_overlay_->record_present(StatsOverlay::elapsed_ms(present_start));
+        }
+    }
+    tile_tracker_.log_stats("X11 " + output_name_);
+    return true;
+}
+
+bool X11Display::set_post_effects(const PostEffects& effects) {
+    if (windowed_mode_ || (!effects.is_identity() && (egl_initialized_ || server_scaling_))) {
+        return false;
+    }
+    post_effects_ = effects;
+    effect_pass_ = PostEffectPass();
+    letterbox_.invalidate();
+    if (!effects.is_identity()) {
+        // The fixed-function GL quad has no shader to fold effects into; the
+        // CPU scaler applies them in its per-pixel loop instead
+        prefer_egl_ = false;
+    }
+    return true;
+}
+
+bool X11Display::prepare_effects() {
+    if (post_effects_.is_identity()) {
+        return false;
+    }
+    if (!effect_pass_.is_configured_for(width_, height_)) {
+        effect_pass_.configure(post_effects_, width_, height_);
+    }
+    return effect_pass_.is_active();
+}
+
+bool X11Display::set_letterbox(const LetterboxSettings& settings) {
+    letterbox_.configure(settings);
+    image_renderer_->set_letterbox(settings);
+    return true;
+}
+
+bool X11Display::set_stats_overlay(StatsOverlay* overlay) {
+    stats_overlay_ = overlay;
+    image_renderer_->set_stats_overlay(overlay);
+    return true;
+}
+
+bool X11Display::paint_letterbox(const unsigned char* frame_data, int frame_width, int frame_height,
+                                 const DirtyRect& content, std::vector<DirtyRect>* painted) {
+    letterbox_.update(VideoFrame::rgba(frame_data, frame_width, frame_height));
+    bool effects_active = prepare_effects();
+    return letterbox_.paint_bars_bgra(reinterpret_cast<unsigned char*>(image_data_), width_, height_, content,
+                                      false, effects_active ? &effect_pass_ : nullptr, painted);
+}
+
+bool X11Display::set_dirty_tracking(bool enabled) {
+    if (windowed_mode_ || (enabled && egl_initialized_)) {
+        // Only the CPU root-pixmap path supports partial updates
+        return false;
+    }
+    dirty_tracking_ = enabled;
+    tile_tracker_.reset();
+    if (enabled) {
+        prefer_egl_ = false;
+        std::cout << "DEBUG: Tile dirty tracking enabled for " << output_name_ << std::endl;
+    }
+    return true;
+}
+
+bool X11Display::set_server_scaling(bool enabled) {
+    if (!enabled) {
+        cleanup_server_scaling();
+        server_scaling_ = false;
+        return true;
+    }
+    // Only the root pixmap path; effects and dirty tiles need the CPU scaler's pixel loop
+    if (windowed_mode_ || egl_initialized_ || dirty_tracking_ || !post_effects_.is_identity()) {
+        return false;
+    }
+    if (!init_server_scaling()) {
+        return false;
+    }
+    server_scaling_ = true;
+    prefer_egl_ = false;
+    std::cout << "DEBUG: XRender server-side scaling enabled for " << output_name_
+              << (xshm_available_ ? " (XShm upload)" : " (XPutImage upload)") << std::endl;
+    return true;
+}
+
+bool X11Display::init_server_scaling() {
+    if (!display_ || !pixmap_ || !gc_) {
+        return false;
+    }
+    
+    // Pad repeat (edge pixels under the bilinear filter) needs Render 0.10
+    int event_base, error_base, major = 0, minor = 0;
+    if (!XRenderQueryExtension(display_, &event_base, &error_base) ||
+        !XRenderQueryVersion(display_, &major, &minor) || (major == 0 && minor < 10)) {
+        std::cerr << "WARNING: X server has no usable XRender extension" << std::endl;
+        return false;
+    }
+    
+    XRenderPictFormat* format = XRenderFindStandardFormat(display_, PictStandardRGB24);
+    if (!format) {
+        return false;
+    }
+    target_picture_ = XRenderCreatePicture(display_, pixmap_, format, 0, nullptr);
+    if (!target_picture_) {
+        return false;
+    }
+    
+    // Shared memory only works with a local server; remote displays use XPutImage
+    xshm_available_ = XShmQueryExtension(display_);
+    bars_valid_ = false;
+    return true;
+}
+
+// The error handler is process-wide: under --scheduler two root outputs can
+// attach from different workers at once, so attaches take turns
+static std::mutex g_shm_attach_mutex;
+static bool g_shm_attach_failed = false;
+
+static int shm_attach_error_handler(Display*, XErrorEvent*) {
+    g_shm_attach_failed = true;
+    return 0;
+}
+
+bool X11Display::ensure_source_buffer(int width, int height) {
+    if (source_pixmap_ && width == source_width_ && height == source_height_) {
+        return true;
+    }
+    release_source_buffer();
+    
+    source_pixmap_ = XCreatePixmap(display_, root_window_, width, height, 24);
+    if (!source_pixmap_) {
+        return false;
+    }
+    XRenderPictureAttributes attributes;
+    attributes.repeat = RepeatPad;
+    source_picture_ = XRenderCreatePicture(display_, source_pixmap_, XRenderFindStandardFormat(display_, PictStandardRGB24),
+                                           CPRepeat, &attributes);
+    XRenderSetPictureFilter(display_, source_picture_, const_cast<char*>(FilterBilinear), nullptr, 0);
+    
+    Visual* visual = DefaultVisual(display_, screen_);
+    if (xshm_available_) {
+        source_image_ = XShmCreateImage(display_, visual, 24, ZPixmap, nullptr, &shm_info_, width, height);
+        if (source_image_) {
+            shm_info_.shmid = shmget(IPC_PRIVATE, (size_t)source_image_->bytes_per_line * height, IPC_CREAT | 0600);
+            shm_info_.shmaddr = shm_info_.shmid >= 0 ? static_cast<char*>(shmat(shm_info_.shmid, nullptr, 0))
+                                                     : reinterpret_cast<char*>(-1);
+            shm_info_.readOnly = False;
+            
+            // A server that cannot reach the segment answers with an error
+            // instead of failing the call; trap it rather than exiting
+            bool attached = false;
+            if (shm_info_.shmaddr != reinterpret_cast<char*>(-1)) {
+                source_image_->data = shm_info_.shmaddr;
+                std::lock_guard<std::mutex> lock(g_shm_attach_mutex);
+                g_shm_attach_failed = false;
+                XSync(display_, False);
+                XErrorHandler previous = XSetErrorHandler(shm_attach_error_handler);
+                XShmAttach(display_, &shm_info_);
+                XSync(display_, False);
+                XSetErrorHandler(previous);
+                attached = !g_shm_attach_failed;
+            }
+            if (shm_info_.shmid >= 0) {
+                // Freed by the kernel once both sides have detached
+                shmctl(shm_info_.shmid, IPC_RMID, nullptr);
+            }
+            
+            if (attached) {
+                source_shm_ = true;
+            } else {
+                std::cerr << "WARNING: XShm attach failed, uploading frames with XPutImage" << std::endl;
+                if (shm_info_.shmaddr != reinterpret_cast<char*>(-1)) {
+                    shmdt(shm_info_.shmaddr);
+                }
+                source_image_->data = nullptr;
+                XDestroyImage(source_image_);
+                source_image_ = nullptr;
+                xshm_available_ = false;
+            }
+        }
+    }
+    
+    if (!source_image_) {
+        char* data = static_cast<char*>(FramePool::instance().acquire((size_t)width * height * 4));
+        if (data) {
+            source_image_ = XCreateImage(display_, visual, 24, ZPixmap, 0, data, width, height, 32, 0);
+            if (!source_image_) {
+                FramePool::instance().release(data);
+            }
+        }
+    }
+    if (!source_image_) {
+        release_source_buffer();
+        return false;
+    }
+    
+    source_width_ = width;
+    source_height_ = height;
+    return true;
+}
+
+void X11Display::release_source_buffer() {
+    if (source_image_) {
+        if (source_shm_) {
+            XShmDetach(display_, &shm_info_);
+            XSync(display_, False);
+            shmdt(shm_info_.shmaddr);
+        } else {
+            FramePool::instance().release(source_image_->data);
+        }
+        source_image_->data = nullptr;
+        XDestroyImage(source_image_);
+        source_image_ = nullptr;
+        source_shm_ = false;
+    }
+    if (source_picture_) {
+        XRenderFreePicture(display_, source_picture_);
+        source_picture_ = 0;
+    }
+    if (source_pixmap_) {
+        XFreePixmap(display_, source_pixmap_);
+        source_pixmap_ = 0;
+    }
+    source_width_ = 0;
+    source_height_ = 0;
+}
+
+void X11Display::cleanup_server_scaling() {
+    if (!display_) {
+        return;
+    }
+    release_source_buffer();
+    if (backdrop_picture_) {
+        XRenderFreePicture(display_, backdrop_picture_);
+        backdrop_picture_ = 0;
+    }
+    if (backdrop_pixmap_) {
+        XFreePixmap(display_, backdrop_pixmap_);
+        backdrop_pixmap_ = 0;
+    }
+    backdrop_width_ = 0;
+    backdrop_height_ = 0;
+    if (target_picture_) {
+        XRenderFreePicture(display_, target_picture_);
+        target_picture_ = 0;
+    }
+    bars_valid_ = false;
+}
+
+bool X11Display::upload_backdrop() {
+    int width = letterbox_.get_width();
+    int height = letterbox_.get_height();
+    if (width != backdrop_width_ || height != backdrop_height_) {
+        if (backdrop_picture_) {
+            XRenderFreePicture(display_, backdrop_picture_);
+            backdrop_picture_ = 0;
+        }
+        if (backdrop_pixmap_) {
+            XFreePixmap(display_, backdrop_pixmap_);
+        }
+        backdrop_pixmap_ = XCreatePixmap(display_, root_window_, width, height, 24);
+        XRenderPictureAttributes attributes;
+        attributes.repeat = RepeatPad;
+        backdrop_picture_ = XRenderCreatePicture(display_, backdrop_pixmap_,
+                                                 XRenderFindStandardFormat(display_, PictStandardRGB24),
+                                                 CPRepeat, &attributes);
+        XRenderSetPictureFilter(display_, backdrop_picture_, const_cast<char*>(FilterBilinear), nullptr, 0);
+        backdrop_width_ = width;
+        backdrop_height_ = height;
+    }
+    if (!backdrop_picture_) {
+        return false;
+    }
+    
+    // The thumbnail is tiny: a plain XPutImage of its BGRA copy
+    const unsigned char* pixels = letterbox_.get_pixels();
+    backdrop_bgra_.resize((size_t)width * height * 4);
+    for (size_t i = 0; i < backdrop_bgra_.size(); i += 4) {
+        backdrop_bgra_[i + 0] = pixels[i + 2];
+        backdrop_bgra_[i + 1] = pixels[i + 1];
+        backdrop_bgra_[i + 2] = pixels[i + 0];
+        backdrop_bgra_[i + 3] = 255;
+    }
+    XImage* image = XCreateImage(display_, DefaultVisual(display_, screen_), 24, ZPixmap, 0,
+                                 reinterpret_cast<char*>(backdrop_bgra_.data()), width, height, 32, 0);
+    if (!image) {
+        return false;
+    }
+    XPutImage(display_, backdrop_pixmap_, gc_, image, 0, 0, 0, 0, width, height);
+    image->data = nullptr;
+    XDestroyImage(image);
+    return true;
+}
+
+void X11Display::composite_bars(const DirtyRect& content, bool backdrop_changed) {
+    bool same_layout = bars_valid_ && content.x == composited_content_.x && content.y == composited_content_.y &&
+                       content.width == composited_content_.width && content.height == composited_content_.height;
+    if (same_layout && !backdrop_changed) {
+        return;
+    }
+    
+    DirtyRect bars[4];
+    int count = LetterboxFill::get_bar_rects(width_, height_, content, bars);
+    bool blurred = letterbox_.is_enabled() && letterbox_.has_image() && backdrop_picture_;
+    
+    if (blurred) {
+        // Cover-scale the thumbnail over the whole output, as paint_bars_bgra does
+        double scale = std::max((double)width_ / backdrop_width_, (double)height_ / backdrop_height_);
+        int cover_x = (int)((width_ - backdrop_width_ * scale) / 2);
+        int cover_y = (int)((height_ - backdrop_height_ * scale) / 2);
+        XTransform transform = {{
+            { XDoubleToFixed(1.0 / scale), 0, 0 },
+            { 0, XDoubleToFixed(1.0 / scale), 0 },
+            { 0, 0, XDoubleToFixed(1.0) }
+        }};
+        XRenderSetPictureTransform(display_, backdrop_picture_, &transform);
+        for (int i = 0; i < count; i++) {
+            XRenderComposite(display_, PictOpSrc, backdrop_picture_, None, target_picture_,
+                             bars[i].x - cover_x, bars[i].y - cover_y, 0, 0,
+                             bars[i].x, bars[i].y, bars[i].width, bars[i].height);
+        }
+    } else {
+        XRenderColor black = { 0, 0, 0, 0xffff };
+        for (int i = 0; i < count; i++) {
+            XRenderFillRectangle(display_, PictOpSrc, target_picture_, &black,
+                                 bars[i].x, bars[i].y, bars[i].width, bars[i].height);
+        }
+    }
+    composited_content_ = content;
+    bars_valid_ = true;
+}
+
+bool X11Display::render_frame_xrender(const unsigned char* frame_data, int frame_width, int frame_height, ScalingMode scaling) {
+    if (!target_picture_ || !ensure_source_buffer(frame_width, frame_height)) {
+        // Stay on the CPU scaler from now on instead of failing every frame
+        std::cerr << "ERROR: XRender scaling unavailable, falling back to CPU scaling" << std::endl;
+        cleanup_server_scaling();
+        server_scaling_ = false;
+        return false;
+    }
+    
+    // The server may still be reading the previous frame out of the segment;
+    // by the next frame this round trip is normally already answered
+    if (source_shm_) {
+        XSync(display_, False);
+    }
+    
+    // RGBA -> BGRX at source resolution: the only per-pixel work left on the CPU
+    char* dst = source_image_->data;
+    for (int y = 0; y < frame_height; y++) {
+        const unsigned char* src_row = frame_data + (size_t)y * frame_width * 4;
+        unsigned char* dst_row = reinterpret_cast<unsigned char*>(dst + (size_t)y * source_image_->bytes_per_line);
+        for (int x = 0; x < frame_width; x++) {
+            dst_row[x * 4 + 0] = src_row[x * 4 + 2];
+            dst_row[x * 4 + 1] = src_row[x * 4 + 1];
+            dst_row[x * 4 + 2] = src_row[x * 4 + 0];
+            dst_row[x * 4 + 3] = 255;
+        }
+    }
+    if (source_shm_) {
+        XShmPutImage(display_, source_pixmap_, gc_, source_image_, 0, 0, 0, 0, frame_width, frame_height, False);
+    } else {
+        XPutImage(display_, source_pixmap_, gc_, source_image_, 0, 0, 0, 0, frame_width, frame_height);
+    }
+    
+    int dest_x, dest_y, dest_width, dest_height;
+    calculate_buffer_layout(frame_width, frame_height, scaling, dest_x, dest_y, dest_width, dest_height);
+    
+    // Destination -> source mapping; FILL crops by starting inside the source
+    XTransform transform = {{
+        { XDoubleToFixed((double)frame_width / dest_width), 0, 0 },
+        { 0, XDoubleToFixed((double)frame_height / dest_height), 0 },
+        { 0, 0, XDoubleToFixed(1.0) }
+    }};
+    XRenderSetPictureTransform(display_, source_picture_, &transform);
+    
+    DirtyRect content;
+    content.x = std::max(0, dest_x);
+    content.y = std::max(0, dest_y);
+    content.width = std::min(width_, dest_x + dest_width) - content.x;
+    content.height = std::min(height_, dest_y + dest_height) - content.y;
+    XRenderComposite(display_, PictOpSrc, source_picture_, None, target_picture_,
+                     content.x - dest_x, content.y - dest_y, 0, 0,
+                     content.x, content.y, content.width, content.height);
+    
+    bool backdrop_changed = false;
+    if (letterbox_.is_enabled() && letterbox_.update(VideoFrame::rgba(frame_data, frame_width, frame_height))) {
+        backdrop_changed = upload_backdrop();
+    }
+    composite_bars(content, backdrop_changed);
+    
+    if (stats_overlay_) {
+        // The composite just covered the HUD area; put it back on top
+        stats_overlay_->refresh();
+        DirtyRect hud = stats_overlay_->get_rect(width_, height_);
+        XImage* image = hud.width > 0 && hud.height > 0
+            ? XCreateImage(display_, DefaultVisual(display_, screen_), 24, ZPixmap, 0,
+                           const_cast<char*>(reinterpret_cast<const char*>(stats_overlay_->get_pixels())),
+                           stats_overlay_->get_width(), stats_overlay_->get_height(), 32, 0)
+            : nullptr;
+        if (image) {
+            XPutImage(display_, pixmap_, gc_, image, 0, 0, hud.x, hud.y, hud.width, hud.height);
+            image->data = nullptr;
+            XDestroyImage(image);
+        }
+        stats_overlay_->record_scale(StatsOverlay::elapsed_ms(frame_start_));
+    }
+    
+    auto present_start = std::chrono::steady_clock::now();
+    publish_background_pixmap();
+    if (stats_overlay_) {
+        stats_overlay_->record_present(StatsOverlay::elapsed_ms(present_start));
+    }
+    return true;
+}
+
+// Module entry point (see display_backend.h)
+extern "C" const DisplayBackend* lwe_display_backend_x11() {
+    static const DisplayBackend backend = {
+        LWE_DISPLAY_BACKEND_ABI, "x11",
+        &X11Display::get_outputs,
+        &X11Display::get_output_by_name,
+        &X11Display::create_window,
+        nullptr
+    };
+    return &backend;
+}
@@ -1,12 +1,16 @@
 #pragma once
 
 #include "../display_manager.h"
+#include "../tile_tracker.h"
 #include <X11/Xlib.h>
 #include <X11/extensions/Xrandr.h>
+#include <X11/extensions/Xrender.h>
+#include <X11/extensions/XShm.h>
 #include <EGL/egl.h>
 #include <EGL/eglext.h>
 #include <vector>
 #include <memory>
+#include <chrono>
 
 // Forward declarations for specialized renderers
 class X11ImageRenderer;
@@ -23,6 +27,13 @@ public:
     bool set_background(const std::string& media_path, ScalingMode scaling) override;
     void update() override;
     std::string get_name() const override;
+    bool get_geometry(int& x, int& y, int& width, int& height) const override;
+    
+    // RandR monitor rectangle by name ("default" = first monitor)
+    bool get_monitor_geometry(const std::string& name, int& x, int& y, int& width, int& height) const override;
+    
+    // RandR screen change (background) or ConfigureNotify/Expose (window), drained in update()
+    bool consume_geometry_change() override;
     
     // X11 specific methods for MPV integration
     Display* get_x11_display() const { return display_; }
@@ -31,14 +42,32 @@ public:
     bool is_windowed_mode() const { return windowed_mode_; }
     
     // Image rendering using specialized renderer
-    bool render_image_data(const unsigned char* image_data, int img_width, int img_height, ScalingMode scaling);
+    bool render_image_data(const unsigned char* image_data, int img_width, int img_height, ScalingMode scaling) override;
+    
+    // Video frame rendering using specialized renderer (RGBA only)
+    bool render_frame(const VideoFrame& frame, ScalingMode scaling) override;
+    
+    // Background mode only: per-tile XPutImage/XClearArea instead of full-root repaints
+    bool set_dirty_tracking(bool enabled) override;
+    
+    // Background mode only: frames are uploaded at source size (XShm when the
+    // server is local) and XRender scales them into the root pixmap
+    bool set_server_scaling(bool enabled) override;
+    
+    // Background mode only: effects are applied by the CPU root-pixmap scaler
+    bool set_post_effects(const PostEffects& effects) override;
+    
+    // Blurred-fill bars on the root-pixmap scaler and the EGL quad
+    bool set_letterbox(const LetterboxSettings& settings) override;
     
-    // Video frame rendering using specialized renderer
-    bool render_video_frame(const unsigned char* frame_data, int frame_width, int frame_height, ScalingMode scaling);
+    // HUD on the root-pixmap scaler and the EGL quad
+    bool set_stats_overlay(StatsOverlay* overlay) override;
     
     // EGL context management for GPU acceleration
     bool initialize_egl();
+    bool ensure_egl();          // Lazy initialize_egl() + renderer switch, tried once
     bool make_egl_current();
+    void release_thread_context() override;
     void cleanup_egl();
     
     // Static factory methods
@@ -72,7 +101,11 @@ private:
     bool init_image_buffer();
     void cleanup_image_buffer();
     void update_background_from_buffer();
+    void publish_background_pixmap();
     bool render_to_image_buffer(const unsigned char* image_data, int img_width, int img_height, ScalingMode scaling);
+    bool render_to_image_buffer_dirty(const unsigned char* frame_data, int frame_width, int frame_height, ScalingMode scaling);
+    void calculate_buffer_layout(int img_width, int img_height, ScalingMode scaling,
+                                 int& dest_x, int& dest_y, int& dest_width, int& dest_height) const;
     EGLDisplay egl_display_;
     EGLConfig egl_config_;
     EGLContext egl_context_;
@@ -85,13 +118,69 @@ private:
     // Current state
     ScalingMode current_scaling_;
     
+    // Tile dirty tracking (background CPU path)
+    bool dirty_tracking_;
+    TileTracker tile_tracker_;
+    std::vector<unsigned char> packed_frame_;   // Padded RGBA repacked for the CPU/EGL paths
+    
+    // Server-side scaling (--xrender): source-sized pixmap composited with a
+    // bilinear transform onto the root pixmap; bars from a thumbnail pixmap
+    bool server_scaling_;
+    bool xshm_available_;
+    bool source_shm_;                   // source_image_ lives in shm_info_ rather than the frame pool
+    XShmSegmentInfo shm_info_;
+    XImage* source_image_;
+    Pixmap source_pixmap_;
+    Picture source_picture_;
+    Picture target_picture_;
+    int source_width_;
+    int source_height_;
+    Pixmap backdrop_pixmap_;
+    Picture backdrop_picture_;
+    int backdrop_width_;
+    int backdrop_height_;
+    std::vector<unsigned char> backdrop_bgra_;
+    DirtyRect composited_content_;      // Content rectangle of the last frame; bars are kept until it moves
+    bool bars_valid_;
+    bool init_server_scaling();
+    bool ensure_source_buffer(int width, int height);
+    void release_source_buffer();
+    void cleanup_server_scaling();
+    bool upload_backdrop();
+    void composite_bars(const DirtyRect& content, bool backdrop_changed);
+    bool render_frame_xrender(const unsigned char* frame_data, int frame_width, int frame_height, ScalingMode scaling);
+    
+    // Per-screen color effects (CPU background path)
+    PostEffects post_effects_;
+    PostEffectPass effect_pass_;
+    bool prepare_effects();
+    
+    // Bars around FIT/DEFAULT content (CPU background path)
+    LetterboxFill letterbox_;
+    bool paint_letterbox(const unsigned char* frame_data, int frame_width, int frame_height,
+                         const DirtyRect& content, std::vector<DirtyRect>* painted);
+    
+    // Performance HUD (owned by the application); frame_start_ marks the start of the scale pass
+    StatsOverlay* stats_overlay_;
+    std::chrono::steady_clock::time_point frame_start_;
+    
+    // Output reconfiguration: RandR events arrive on the root window in background mode
+    int rr_event_base_;             // -1 when RandR events are not selected
+    bool geometry_changed_;         // Changed since the last consume_geometry_change()
+    
     bool init_x11();
     bool init_window_mode();
     bool init_background_mode();
+    void refresh_background_geometry();
     void set_window_background(const std::string& media_path);
     
     // EGL helpers
     bool create_egl_context();
     bool choose_egl_config();
     bool create_egl_surface();
+    bool create_egl_pixmap_surface();
+    
+    // GPU path: persistent texture drawn to the window surface, or straight
+    // into the background pixmap - no per-pixel CPU scaling
+    bool render_frame_egl(const unsigned char* frame_data, int frame_width, int frame_height, ScalingMode scaling);
 };
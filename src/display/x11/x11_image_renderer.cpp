@@ -1,4 +1,6 @@
 #include "x11_image_renderer.h"
+#include "../stats_overlay.h"
+#include "../../frame_pool.h"
 #include <iostream>
 #include <cstring>
 #include <cmath>
@@ -14,7 +16,10 @@ extern "C" {
 X11ImageRenderer::X11ImageRenderer()
     : initialized_(false), egl_mode_(false), x11_display_(nullptr), window_(0), screen_(0),
       graphics_context_(0), egl_display_(EGL_NO_DISPLAY), egl_config_(nullptr),
-      egl_context_(EGL_NO_CONTEXT), egl_surface_(EGL_NO_SURFACE), glew_initialized_(false) {}
+      egl_context_(EGL_NO_CONTEXT), egl_surface_(EGL_NO_SURFACE), glew_initialized_(false),
+      texture_(0), texture_width_(0), texture_height_(0), pbos_{0, 0, 0}, pbo_index_(0),
+      pbo_supported_(false), max_texture_size_(MAX_TEXTURE_SIZE), backdrop_texture_(0), backdrop_dirty_(false),
+      overlay_(nullptr), overlay_texture_(0), overlay_generation_(0) {}
 
 X11ImageRenderer::~X11ImageRenderer() {
     cleanup();
@@ -59,6 +64,8 @@ bool X11ImageRenderer::initialize_egl(Display* x11_display, Window window, int s
 }
 
 void X11ImageRenderer::cleanup() {
+    release_gl_resources();
+    
     if (graphics_context_) {
         XFreeGC(x11_display_, graphics_context_);
         graphics_context_ = 0;
@@ -156,9 +163,14 @@ bool X11ImageRenderer::render_image_x11(const unsigned char* image_data, int img
     // Scale the image data if needed
     unsigned char* scaled_data = nullptr;
     if (dest_width != img_width || dest_height != img_height) {
-        scaled_data = new unsigned char[dest_width * dest_height * bytes_per_pixel];
+        scaled_data = static_cast<unsigned char*>(
+            FramePool::instance().acquire((size_t)dest_width * dest_height * bytes_per_pixel));
+        if (!scaled_data) {
+            FramePool::instance().release(x11_data);
+            return false;
+        }
         apply_scaling_x11(x11_data, img_width, img_height, scaled_data, dest_width, dest_height, scaling, bytes_per_pixel, windowed_mode);
-        delete[] x11_data;
+        FramePool::instance().release(x11_data);
         x11_data = scaled_data;
     }
     
@@ -171,7 +183,7 @@ bool X11ImageRenderer::render_image_x11(const unsigned char* image_data, int img
                                  bytes_per_pixel * 8, dest_width * bytes_per_pixel);
     
     if (!ximage) {
-        delete[] x11_data;
+        FramePool::instance().release(x11_data);
         std::cerr << "ERROR: Failed to create XImage" << std::endl;
         return false;
     }
@@ -184,8 +196,10 @@ bool X11ImageRenderer::render_image_x11(const unsigned char* image_data, int img
     // Draw the image
     XPutImage(x11_display_, window_, graphics_context_, ximage, 0, 0, dest_x, dest_y, dest_width, dest_height);
     
-    // Cleanup
-    XDestroyImage(ximage); // This also frees x11_data
+    // Cleanup: the pixels belong to the frame pool, not to the XImage
+    ximage->data = nullptr;
+    XDestroyImage(ximage);
+    FramePool::instance().release(x11_data);
     XFlush(x11_display_);
     
     return true;
@@ -219,44 +233,48 @@ bool X11ImageRenderer::render_image_egl(const unsigned char* image_data, int img
         return false;
     }
     
-    // Set viewport
-    glViewport(0, 0, surface_width, surface_height);
+    egl_surface_ = egl_surface;
     
-    // Clear the background
-    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
-    glClear(GL_COLOR_BUFFER_BIT);
-    
-    // Check if image needs resizing for GPU compatibility
+    // Only frames beyond what the GPU can sample need a CPU downscale
     unsigned char* resized_data = nullptr;
     int final_width = img_width;
     int final_height = img_height;
-    
-    // EGL rendering is typically used for window mode, so default windowed_mode to true
-    check_and_resize_image(image_data, img_width, img_height, &resized_data, &final_width, &final_height, true);
+    if (img_width > max_texture_size_ || img_height > max_texture_size_) {
+        // The quad handles orientation, so no Y flip here
+        check_and_resize_image(image_data, img_width, img_height, &resized_data, &final_width, &final_height, false);
+    }
     const unsigned char* data_to_use = resized_data ? resized_data : image_data;
     
-    // Process image data for OpenGL
-    unsigned char* processed_data = nullptr;
-    process_image_for_opengl(data_to_use, final_width, final_height, &processed_data);
+    bool uploaded = upload_texture(data_to_use, final_width, final_height);
+    if (letterbox_.update(VideoFrame::rgba(data_to_use, final_width, final_height))) {
+        backdrop_dirty_ = true;
+    }
+    if (resized_data) delete[] resized_data;
+    if (!uploaded) {
+        std::cerr << "ERROR: Failed to upload OpenGL texture" << std::endl;
+        return false;
+    }
     
-    // Create OpenGL texture
-    unsigned int texture_id = 0;
-    create_opengl_texture(processed_data, final_width, final_height, &texture_id);
+    // Set viewport
+    glViewport(0, 0, surface_width, surface_height);
     
-    if (texture_id == 0) {
-        std::cerr << "ERROR: Failed to create OpenGL texture" << std::endl;
-        if (processed_data) delete[] processed_data;
-        if (resized_data) delete[] resized_data;
-        return false;
+    // Clear the background
+    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+    
+    // Bars only exist when the frame is fitted inside the surface
+    if (scaling != ScalingMode::STRETCH && scaling != ScalingMode::FILL) {
+        render_backdrop_quad(surface_width, surface_height);
     }
     
     // Render textured quad with scaling
+    glBindTexture(GL_TEXTURE_2D, texture_);
     render_textured_quad(final_width, final_height, surface_width, surface_height, scaling);
+    glBindTexture(GL_TEXTURE_2D, 0);
     
-    // Clean up
-    glDeleteTextures(1, &texture_id);
-    if (processed_data) delete[] processed_data;
-    if (resized_data) delete[] resized_data;
+    if (overlay_) {
+        render_overlay_quad(surface_width, surface_height);
+    }
     
     // Check for OpenGL errors
     GLenum gl_error = glGetError();
@@ -599,27 +617,189 @@ void X11ImageRenderer::apply_scaling_x11(const unsigned char* src_data, int src_
     }
 }
 
-void X11ImageRenderer::process_image_for_opengl(const unsigned char* src_data, int width, int height,
-                                               unsigned char** processed_data) {
-    // For OpenGL, we might need to flip the image vertically
-    // For now, just copy the data as-is
-    *processed_data = new unsigned char[width * height * 4];
-    memcpy(*processed_data, src_data, width * height * 4);
+bool X11ImageRenderer::upload_texture(const unsigned char* image_data, int width, int height) {
+    // (Re)allocate storage only when the frame size changes; every other
+    // call is a glTexSubImage2D into the existing texture
+    if (!texture_ || width != texture_width_ || height != texture_height_) {
+        if (!texture_) {
+            glGenTextures(1, &texture_);
+        }
+        glBindTexture(GL_TEXTURE_2D, texture_);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        texture_width_ = width;
+        texture_height_ = height;
+        std::cout << "DEBUG: Allocated persistent X11 texture " << width << "x" << height << std::endl;
+    } else {
+        glBindTexture(GL_TEXTURE_2D, texture_);
+    }
+    
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    size_t size = (size_t)width * height * 4;
+    
+    unsigned char* mapped = nullptr;
+    if (pbo_supported_) {
+        // Orphan the next buffer in the ring so the copy never waits on a
+        // transfer the driver is still reading from
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbos_[pbo_index_]);
+        pbo_index_ = (pbo_index_ + 1) % PBO_RING_SIZE;
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW);
+        mapped = static_cast<unsigned char*>(glMapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY));
+        if (!mapped) {
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        }
+    }
+    
+    if (mapped) {
+        memcpy(mapped, image_data, size);
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    } else {
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, image_data);
+    }
+    
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return glGetError() == GL_NO_ERROR;
+}
+
+void X11ImageRenderer::release_gl_resources() {
+    if (!texture_ && !pbos_[0] && !backdrop_texture_ && !overlay_texture_) {
+        return;
+    }
+    
+    // GL objects can only be deleted with their context current
+    if (egl_display_ == EGL_NO_DISPLAY || egl_context_ == EGL_NO_CONTEXT ||
+        !eglMakeCurrent(egl_display_, egl_surface_, egl_surface_, egl_context_)) {
+        texture_ = 0;
+        backdrop_texture_ = 0;
+        overlay_texture_ = 0;
+        pbos_[0] = pbos_[1] = pbos_[2] = 0;
+        texture_width_ = texture_height_ = 0;
+        glew_initialized_ = false;
+        return;
+    }
+    
+    if (texture_) {
+        glDeleteTextures(1, &texture_);
+        texture_ = 0;
+    }
+    if (pbos_[0]) {
+        glDeleteBuffers(PBO_RING_SIZE, pbos_);
+        pbos_[0] = pbos_[1] = pbos_[2] = 0;
+    }
+    if (backdrop_texture_) {
+        glDeleteTextures(1, &backdrop_texture_);
+        backdrop_texture_ = 0;
+    }
+    if (overlay_texture_) {
+        glDeleteTextures(1, &overlay_texture_);
+        overlay_texture_ = 0;
+    }
+    texture_width_ = texture_height_ = 0;
+    glew_initialized_ = false;
+}
+
+void X11ImageRenderer::render_backdrop_quad(int surface_width, int surface_height) {
+    if (!letterbox_.is_enabled() || !letterbox_.has_image()) {
+        return;
+    }
+    
+    if (!backdrop_texture_) {
+        glGenTextures(1, &backdrop_texture_);
+        glBindTexture(GL_TEXTURE_2D, backdrop_texture_);
+        // GL_LINEAR magnification of the blurred thumbnail is the whole upscale
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        backdrop_dirty_ = true;
+    } else {
+        glBindTexture(GL_TEXTURE_2D, backdrop_texture_);
+    }
+    if (backdrop_dirty_) {
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, letterbox_.get_width(), letterbox_.get_height(), 0,
+                     GL_RGBA, GL_UNSIGNED_BYTE, letterbox_.get_pixels());
+        backdrop_dirty_ = false;
+    }
+    
+    // Full-surface quad, thumbnail cover-cropped to the surface aspect
+    float thumb_aspect = static_cast<float>(letterbox_.get_width()) / letterbox_.get_height();
+    float surface_aspect = static_cast<float>(surface_width) / surface_height;
+    float span_u = thumb_aspect > surface_aspect ? surface_aspect / thumb_aspect : 1.0f;
+    float span_v = thumb_aspect > surface_aspect ? 1.0f : thumb_aspect / surface_aspect;
+    float u0 = 0.5f - span_u * 0.5f, u1 = 0.5f + span_u * 0.5f;
+    float v0 = 0.5f - span_v * 0.5f, v1 = 0.5f + span_v * 0.5f;
+    
+    float vertices[] = {
+        // Positions    // Texture coords
+        -1.0f, -1.0f,   u0, v1,  // Bottom-left
+         1.0f, -1.0f,   u1, v1,  // Bottom-right
+         1.0f,  1.0f,   u1, v0,  // Top-right
+        -1.0f,  1.0f,   u0, v0   // Top-left
+    };
+    unsigned int indices[] = { 0, 1, 2, 2, 3, 0 };
+    
+    glEnable(GL_TEXTURE_2D);
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    glVertexPointer(2, GL_FLOAT, 4 * sizeof(float), vertices);
+    glTexCoordPointer(2, GL_FLOAT, 4 * sizeof(float), vertices + 2);
+    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, indices);
+    glDisableClientState(GL_VERTEX_ARRAY);
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    glDisable(GL_TEXTURE_2D);
+    glBindTexture(GL_TEXTURE_2D, 0);
 }
 
-void X11ImageRenderer::create_opengl_texture(const unsigned char* image_data, int width, int height,
-                                            unsigned int* texture_id) {
-    glGenTextures(1, texture_id);
-    glBindTexture(GL_TEXTURE_2D, *texture_id);
-    
-    // Upload texture data
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image_data);
-    
-    // Set texture parameters
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+void X11ImageRenderer::render_overlay_quad(int surface_width, int surface_height) {
+    overlay_->refresh();
+    if (!overlay_texture_) {
+        glGenTextures(1, &overlay_texture_);
+        glBindTexture(GL_TEXTURE_2D, overlay_texture_);
+        // Drawn 1:1, so nearest sampling keeps the font crisp
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        overlay_generation_ = overlay_->get_generation() - 1;
+    } else {
+        glBindTexture(GL_TEXTURE_2D, overlay_texture_);
+    }
+    if (overlay_generation_ != overlay_->get_generation()) {
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, overlay_->get_width(), overlay_->get_height(), 0,
+                     GL_RGBA, GL_UNSIGNED_BYTE, overlay_->get_pixels());
+        overlay_generation_ = overlay_->get_generation();
+    }
+    
+    // Pixel-exact rectangle in the top-left corner
+    float left = -1.0f + 2.0f * StatsOverlay::MARGIN / surface_width;
+    float right = -1.0f + 2.0f * (StatsOverlay::MARGIN + overlay_->get_width()) / surface_width;
+    float top = 1.0f - 2.0f * StatsOverlay::MARGIN / surface_height;
+    float bottom = 1.0f - 2.0f * (StatsOverlay::MARGIN + overlay_->get_height()) / surface_height;
+    
+    float vertices[] = {
+        // Positions    // Texture coords
+        left,  bottom,  0.0f, 1.0f,  // Bottom-left
+        right, bottom,  1.0f, 1.0f,  // Bottom-right
+        right, top,     1.0f, 0.0f,  // Top-right
+        left,  top,     0.0f, 0.0f   // Top-left
+    };
+    unsigned int indices[] = { 0, 1, 2, 2, 3, 0 };
+    
+    glEnable(GL_TEXTURE_2D);
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    glVertexPointer(2, GL_FLOAT, 4 * sizeof(float), vertices);
+    glTexCoordPointer(2, GL_FLOAT, 4 * sizeof(float), vertices + 2);
+    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, indices);
+    glDisableClientState(GL_VERTEX_ARRAY);
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    glDisable(GL_TEXTURE_2D);
+    glBindTexture(GL_TEXTURE_2D, 0);
 }
 
 void X11ImageRenderer::render_textured_quad(int img_width, int img_height, int surface_width, int surface_height,
@@ -629,39 +809,43 @@ void X11ImageRenderer::render_textured_quad(int img_width, int img_height, int s
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     glEnable(GL_TEXTURE_2D);
     
-    // Calculate scaling based on mode
-    float scale_x = 1.0f, scale_y = 1.0f;
-    float offset_x = 0.0f, offset_y = 0.0f;
+    // Destination rectangle in pixels; GL clips whatever falls outside the surface
+    float quad_width = static_cast<float>(surface_width);
+    float quad_height = static_cast<float>(surface_height);
     
     switch (scaling) {
         case ScalingMode::STRETCH:
-            // Keep default scale (fills entire surface)
+            // Keep default size (fills entire surface)
             break;
-        case ScalingMode::FIT:
-            scale_x = scale_y = std::min(static_cast<float>(surface_width) / img_width,
-                                        static_cast<float>(surface_height) / img_height);
-            offset_x = (2.0f - 2.0f * scale_x * img_width / surface_width) / 2.0f;
-            offset_y = (2.0f - 2.0f * scale_y * img_height / surface_height) / 2.0f;
-            break;
-        case ScalingMode::FILL:
-            scale_x = scale_y = std::max(static_cast<float>(surface_width) / img_width,
-                                        static_cast<float>(surface_height) / img_height);
+        case ScalingMode::FILL: {
+            float scale = std::max(static_cast<float>(surface_width) / img_width,
+                                   static_cast<float>(surface_height) / img_height);
+            quad_width = img_width * scale;
+            quad_height = img_height * scale;
             break;
+        }
+        case ScalingMode::FIT:
         case ScalingMode::DEFAULT:
-        default:
-            scale_x = static_cast<float>(surface_width) / img_width;
-            scale_y = static_cast<float>(surface_height) / img_height;
+        default: {
+            float scale = std::min(static_cast<float>(surface_width) / img_width,
+                                   static_cast<float>(surface_height) / img_height);
+            quad_width = img_width * scale;
+            quad_height = img_height * scale;
             break;
+        }
     }
     
+    // Centered quad in normalized device coordinates
+    float half_x = quad_width / surface_width;
+    float half_y = quad_height / surface_height;
+    
     // Define vertices for a quad with texture coordinates
     float vertices[] = {
-        // Positions                                                                          // Texture coords
-        -1.0f + offset_x, -1.0f + offset_y,                                                  0.0f, 1.0f,  // Bottom-left
-        -1.0f + offset_x + 2.0f * scale_x * img_width / surface_width, -1.0f + offset_y,   1.0f, 1.0f,  // Bottom-right  
-        -1.0f + offset_x + 2.0f * scale_x * img_width / surface_width, 
-        -1.0f + offset_y + 2.0f * scale_y * img_height / surface_height,                    1.0f, 0.0f,  // Top-right
-        -1.0f + offset_x, -1.0f + offset_y + 2.0f * scale_y * img_height / surface_height, 0.0f, 0.0f   // Top-left
+        // Positions        // Texture coords
+        -half_x, -half_y,   0.0f, 1.0f,  // Bottom-left
+         half_x, -half_y,   1.0f, 1.0f,  // Bottom-right
+         half_x,  half_y,   1.0f, 0.0f,  // Top-right
+        -half_x,  half_y,   0.0f, 0.0f   // Top-left
     };
     
     unsigned int indices[] = {
@@ -693,14 +877,27 @@ bool X11ImageRenderer::init_glew_if_needed() {
         return true;
     }
     
+    // GLEW's GLX build reports an error under an EGL context even though the
+    // entry points resolved, so check the functions actually needed instead
+    glewExperimental = GL_TRUE;
     GLenum err = glewInit();
     if (err != GLEW_OK) {
-        std::cerr << "ERROR: Failed to initialize GLEW: " << glewGetErrorString(err) << std::endl;
-        return false;
+        std::cout << "DEBUG: glewInit reported: " << glewGetErrorString(err) << std::endl;
+    }
+    
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &max_texture_size_);
+    if (max_texture_size_ <= 0) {
+        max_texture_size_ = MAX_TEXTURE_SIZE;
+    }
+    
+    pbo_supported_ = glGenBuffers && glBufferData && glMapBuffer && glUnmapBuffer;
+    if (pbo_supported_) {
+        glGenBuffers(PBO_RING_SIZE, pbos_);
     }
     
     glew_initialized_ = true;
-    std::cout << "DEBUG: GLEW initialized successfully" << std::endl;
+    std::cout << "DEBUG: GLEW initialized successfully (max texture " << max_texture_size_
+              << (pbo_supported_ ? ", PBO streaming" : "") << ")" << std::endl;
     return true;
 }
 
@@ -714,7 +911,10 @@ void X11ImageRenderer::convert_rgba_to_x11_format(const unsigned char* src_data,
     
     if (*bytes_per_pixel == 4) {
         // 32-bit display - convert RGBA to BGRA
-        *dst_data = new unsigned char[width * height * 4];
+        *dst_data = static_cast<unsigned char*>(FramePool::instance().acquire((size_t)width * height * 4));
+        if (!*dst_data) {
+            return;
+        }
         
         for (int i = 0; i < width * height; i++) {
             int src_idx = i * 4;
@@ -727,7 +927,10 @@ void X11ImageRenderer::convert_rgba_to_x11_format(const unsigned char* src_data,
         }
     } else if (*bytes_per_pixel == 3) {
         // 24-bit display - convert RGBA to RGB
-        *dst_data = new unsigned char[width * height * 3];
+        *dst_data = static_cast<unsigned char*>(FramePool::instance().acquire((size_t)width * height * 3));
+        if (!*dst_data) {
+            return;
+        }
         
         for (int i = 0; i < width * height; i++) {
             int src_idx = i * 4;
@@ -740,7 +943,10 @@ void X11ImageRenderer::convert_rgba_to_x11_format(const unsigned char* src_data,
     } else {
         // Fallback - just copy as-is
         *bytes_per_pixel = 4;
-        *dst_data = new unsigned char[width * height * 4];
+        *dst_data = static_cast<unsigned char*>(FramePool::instance().acquire((size_t)width * height * 4));
+        if (!*dst_data) {
+            return;
+        }
         memcpy(*dst_data, src_data, width * height * 4);
     }
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../display_manager.h"
+#include "../letterbox_fill.h"
 #include <X11/Xlib.h>
 #include <X11/Xutil.h>
 #include <EGL/egl.h>
@@ -27,11 +28,19 @@ public:
                          int surface_width, int surface_height, ScalingMode scaling,
                          bool windowed_mode = true);
     
-    // Render static image using EGL/OpenGL (GPU-accelerated)
+    // Render static image or video frame using EGL/OpenGL (GPU-accelerated).
+    // The texture persists between calls and is updated in place, so video
+    // frames only cost one PBO copy; scaling happens on the GPU quad.
     bool render_image_egl(const unsigned char* image_data, int img_width, int img_height,
                          EGLSurface egl_surface, int surface_width, int surface_height,
                          ScalingMode scaling);
     
+    // Blurred backdrop behind FIT/DEFAULT frames on the EGL path
+    void set_letterbox(const LetterboxSettings& settings) { letterbox_.configure(settings); }
+    
+    // Performance HUD drawn over the frame on the EGL path (nullptr = off)
+    void set_stats_overlay(StatsOverlay* overlay) { overlay_ = overlay; }
+    
     // Utility functions for image processing
     bool load_image_from_file(const std::string& image_path, unsigned char** image_data,
                              int* width, int* height);
@@ -62,19 +71,38 @@ private:
     // OpenGL state
     bool glew_initialized_;
     
+    // Persistent texture streamed through a PBO ring (lives in egl_context_)
+    static constexpr int PBO_RING_SIZE = 3;
+    GLuint texture_;
+    int texture_width_;
+    int texture_height_;
+    GLuint pbos_[PBO_RING_SIZE];
+    int pbo_index_;
+    bool pbo_supported_;
+    GLint max_texture_size_;
+    
+    // Blurred thumbnail stretched behind the quad (same context)
+    LetterboxFill letterbox_;
+    GLuint backdrop_texture_;
+    bool backdrop_dirty_;
+    
+    // HUD texture, re-uploaded only when its text changes
+    StatsOverlay* overlay_;
+    GLuint overlay_texture_;
+    unsigned long overlay_generation_;
+    
     // Image processing utilities
     void apply_scaling_x11(const unsigned char* src_data, int src_width, int src_height,
                           unsigned char* dst_data, int dst_width, int dst_height,
                           ScalingMode scaling, int bytes_per_pixel, bool windowed_mode = true);
     
-    void process_image_for_opengl(const unsigned char* src_data, int width, int height,
-                                 unsigned char** processed_data);
-    
-    void create_opengl_texture(const unsigned char* image_data, int width, int height,
-                              unsigned int* texture_id);
+    bool upload_texture(const unsigned char* image_data, int width, int height);
+    void release_gl_resources();
     
     void render_textured_quad(int img_width, int img_height, int surface_width, int surface_height,
                              ScalingMode scaling);
+    void render_backdrop_quad(int surface_width, int surface_height);
+    void render_overlay_quad(int surface_width, int surface_height);
     
     bool init_glew_if_needed();
     
@@ -1,4 +1,5 @@
 #include "x11_video_renderer.h"
+#include "../../frame_pool.h"
 #include <iostream>
 #include <cstring>
 #include <cmath>
@@ -54,7 +55,7 @@ void X11VideoRenderer::cleanup() {
     }
     
     if (frame_buffer_) {
-        delete[] frame_buffer_;
+        FramePool::instance().release(frame_buffer_);
         frame_buffer_ = nullptr;
     }
     
@@ -149,7 +150,11 @@ bool X11VideoRenderer::initialize_ffmpeg(const std::string& video_path) {
     int height = codec_context_->height;
     
     int buffer_size = av_image_get_buffer_size(AV_PIX_FMT_BGRA, width, height, 32);
-    frame_buffer_ = new uint8_t[buffer_size];
+    frame_buffer_ = static_cast<uint8_t*>(FramePool::instance().acquire(buffer_size));
+    if (!frame_buffer_) {
+        cleanup_ffmpeg();
+        return false;
+    }
     
     av_image_fill_arrays(rgb_frame_->data, rgb_frame_->linesize, 
                         frame_buffer_, AV_PIX_FMT_BGRA, width, height, 32);
@@ -303,9 +308,14 @@ bool X11VideoRenderer::render_rgb_frame_x11(const unsigned char* frame_data, int
     // Scale the frame data if needed
     unsigned char* scaled_data = nullptr;
     if (dest_width != frame_width || dest_height != frame_height) {
-        scaled_data = new unsigned char[dest_width * dest_height * bytes_per_pixel];
+        scaled_data = static_cast<unsigned char*>(
+            FramePool::instance().acquire((size_t)dest_width * dest_height * bytes_per_pixel));
+        if (!scaled_data) {
+            FramePool::instance().release(x11_data);
+            return false;
+        }
         apply_scaling_x11(x11_data, frame_width, frame_height, scaled_data, dest_width, dest_height, scaling, bytes_per_pixel, windowed_mode);
-        delete[] x11_data;
+        FramePool::instance().release(x11_data);
         x11_data = scaled_data;
     }
     
@@ -318,7 +328,7 @@ bool X11VideoRenderer::render_rgb_frame_x11(const unsigned char* frame_data, int
                                  bytes_per_pixel * 8, dest_width * bytes_per_pixel);
     
     if (!ximage) {
-        delete[] x11_data;
+        FramePool::instance().release(x11_data);
         std::cerr << "ERROR: Failed to create XImage for video frame" << std::endl;
         return false;
     }
@@ -333,12 +343,16 @@ bool X11VideoRenderer::render_rgb_frame_x11(const unsigned char* frame_data, int
     
     if (result == BadDrawable || result == BadGC || result == BadMatch) {
         std::cerr << "ERROR: XPutImage failed with error code: " << result << std::endl;
+        ximage->data = nullptr;
         XDestroyImage(ximage);
+        FramePool::instance().release(x11_data);
         return false;
     }
     
-    // Cleanup
-    XDestroyImage(ximage); // This also frees x11_data
+    // Cleanup: the pixels go back to the frame pool for the next frame
+    ximage->data = nullptr;
+    XDestroyImage(ximage);
+    FramePool::instance().release(x11_data);
     XFlush(x11_display_);
     
     return true;
@@ -366,7 +380,7 @@ void X11VideoRenderer::cleanup_ffmpeg() {
     }
     
     if (frame_buffer_) {
-        delete[] frame_buffer_;
+        FramePool::instance().release(frame_buffer_);
         frame_buffer_ = nullptr;
     }
     
@@ -528,7 +542,10 @@ void X11VideoRenderer::convert_bgra_to_x11_format(const unsigned char* src_data,
     
     if (*bytes_per_pixel == 4) {
         // 32-bit display - convert BGRA to BGRA (X11 format)
-        *dst_data = new unsigned char[width * height * 4];
+        *dst_data = static_cast<unsigned char*>(FramePool::instance().acquire((size_t)width * height * 4));
+        if (!*dst_data) {
+            return;
+        }
         
         for (int i = 0; i < width * height; i++) {
             int src_idx = i * 4;
@@ -541,7 +558,10 @@ void X11VideoRenderer::convert_bgra_to_x11_format(const unsigned char* src_data,
         }
     } else if (*bytes_per_pixel == 3) {
         // 24-bit display - convert BGRA to BGR
-        *dst_data = new unsigned char[width * height * 3];
+        *dst_data = static_cast<unsigned char*>(FramePool::instance().acquire((size_t)width * height * 3));
+        if (!*dst_data) {
+            return;
+        }
         
         for (int i = 0; i < width * height; i++) {
             int src_idx = i * 4;
@@ -554,7 +574,10 @@ void X11VideoRenderer::convert_bgra_to_x11_format(const unsigned char* src_data,
     } else {
         // Fallback - expand BGRA to 32-bit BGRA
         *bytes_per_pixel = 4;
-        *dst_data = new unsigned char[width * height * 4];
+        *dst_data = static_cast<unsigned char*>(FramePool::instance().acquire((size_t)width * height * 4));
+        if (!*dst_data) {
+            return;
+        }
         
         for (int i = 0; i < width * height; i++) {
             int src_idx = i * 4;
@@ -0,0 +1,263 @@
+#include "frame_export.h"
+#include "frame_ring.h"
+#include <iostream>
+#include <chrono>
+#include <cstring>
+#include <cerrno>
+#include <cstdlib>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+FrameExportServer::FrameExportServer() : listen_fd_(-1), running_(false) {}
+
+FrameExportServer::~FrameExportServer() {
+    stop();
+}
+
+void FrameExportServer::add_ring(const std::string& screen_name, const FrameRing* ring) {
+    exports_.push_back({screen_name, ring});
+}
+
+std::string FrameExportServer::get_default_socket_path() {
+    const char* runtime_dir = getenv("XDG_RUNTIME_DIR");
+    if (runtime_dir && runtime_dir[0] == '/') {
+        return std::string(runtime_dir) + "/linux-wallpaperengine-ext/export.sock";
+    }
+    return "/tmp/linux-wallpaperengine-ext-" + std::to_string(getuid()) + "/export.sock";
+}
+
+// The directory may already exist: under /tmp another user can create it
+// first and then swap the socket that hands out the ring. Only a real
+// directory of ours that nobody else can write to is used; the default one
+// must be private altogether.
+bool FrameExportServer::is_trusted_directory(const std::string& directory, bool require_private) {
+    struct stat info;
+    if (lstat(directory.c_str(), &info) < 0) {
+        std::cerr << "ERROR: Failed to check " << directory << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+    mode_t forbidden = require_private ? (S_IRWXG | S_IRWXO) : (S_IWGRP | S_IWOTH);
+    if (!S_ISDIR(info.st_mode) || info.st_uid != getuid() || (info.st_mode & forbidden)) {
+        std::cerr << "ERROR: Refusing to export frames in " << directory << ": not a directory owned by this user"
+                  << (require_private ? " with mode 0700" : " and writable only by it") << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool FrameExportServer::start(const std::string& socket_path) {
+    if (running_) {
+        return true;
+    }
+
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (socket_path.size() >= sizeof(address.sun_path)) {
+        std::cerr << "ERROR: Export socket path is too long: " << socket_path << std::endl;
+        return false;
+    }
+    strncpy(address.sun_path, socket_path.c_str(), sizeof(address.sun_path) - 1);
+
+    // Private directory for the default path; a custom path's directory
+    // decides who may connect (e.g. a greeter's group)
+    size_t slash = socket_path.rfind('/');
+    if (slash != std::string::npos && slash > 0) {
+        std::string directory = socket_path.substr(0, slash);
+        if (mkdir(directory.c_str(), 0700) < 0 && errno != EEXIST) {
+            std::cerr << "ERROR: Failed to create " << directory << ": " << strerror(errno) << std::endl;
+            return false;
+        }
+        if (!is_trusted_directory(directory, socket_path == get_default_socket_path())) {
+            return false;
+        }
+    }
+
+    listen_fd_ = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listen_fd_ < 0) {
+        std::cerr << "ERROR: Failed to create export socket: " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    // A socket file left by a crashed instance is replaced; a live one is not
+    if (connect(listen_fd_, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) == 0) {
+        std::cerr << "ERROR: Another instance is already exporting frames on " << socket_path << std::endl;
+        close(listen_fd_);
+        listen_fd_ = -1;
+        return false;
+    }
+    close(listen_fd_);
+    unlink(socket_path.c_str());
+
+    listen_fd_ = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listen_fd_ < 0 ||
+        bind(listen_fd_, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) < 0 ||
+        listen(listen_fd_, 8) < 0) {
+        std::cerr << "ERROR: Failed to listen on " << socket_path << ": " << strerror(errno) << std::endl;
+        if (listen_fd_ >= 0) {
+            close(listen_fd_);
+            listen_fd_ = -1;
+        }
+        return false;
+    }
+    chmod(socket_path.c_str(), 0660);
+
+    socket_path_ = socket_path;
+    running_ = true;
+    thread_ = std::make_unique<std::thread>(&FrameExportServer::accept_loop, this);
+    std::cout << "Exporting " << exports_.size() << " screen(s) on " << socket_path << std::endl;
+    return true;
+}
+
+void FrameExportServer::stop() {
+    if (!running_) {
+        return;
+    }
+    running_ = false;
+    if (thread_ && thread_->joinable()) {
+        thread_->join();
+    }
+    thread_.reset();
+
+    close(listen_fd_);
+    listen_fd_ = -1;
+    unlink(socket_path_.c_str());
+    // Clients keep their mappings; the rings stay valid for them after we exit
+}
+
+void FrameExportServer::accept_loop() {
+    while (running_) {
+        struct pollfd pfd = { listen_fd_, POLLIN, 0 };
+        int ready = poll(&pfd, 1, 250);
+        if (ready <= 0) {
+            continue;
+        }
+
+        int client = accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+        if (client < 0) {
+            continue;
+        }
+        handle_client(client);
+        close(client);
+    }
+}
+
+void FrameExportServer::handle_client(int client) {
+    struct timeval timeout;
+    timeout.tv_sec = CLIENT_TIMEOUT_MS / 1000;
+    timeout.tv_usec = (CLIENT_TIMEOUT_MS % 1000) * 1000;
+    setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+    // Clients are served one at a time, so the whole conversation has a
+    // deadline: a client trickling bytes cannot hold the socket for long
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(CLIENT_DEADLINE_MS);
+
+    std::string pending;
+    int requests = 0;
+    char buffer[MAX_LINE];
+    while (running_ && requests < MAX_REQUESTS_PER_CLIENT && std::chrono::steady_clock::now() < deadline) {
+        size_t newline = pending.find('\n');
+        if (newline == std::string::npos) {
+            if (pending.size() >= MAX_LINE) {
+                send_line(client, "ERROR request too long");
+                return;
+            }
+            auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+                deadline - std::chrono::steady_clock::now());
+            struct pollfd pfd = { client, POLLIN, 0 };
+            if (remaining.count() <= 0 || poll(&pfd, 1, static_cast<int>(remaining.count())) <= 0) {
+                return;     // Out of time
+            }
+            ssize_t received = recv(client, buffer, sizeof(buffer), MSG_DONTWAIT);
+            if (received <= 0) {
+                return;     // Closed or failed
+            }
+            pending.append(buffer, received);
+            continue;
+        }
+
+        std::string request = pending.substr(0, newline);
+        pending.erase(0, newline + 1);
+        if (!request.empty() && request.back() == '\r') {
+            request.pop_back();
+        }
+        requests++;
+
+        if (request == "LIST") {
+            for (const Export& entry : exports_) {
+                if (!send_line(client, "SCREEN " + entry.name + " " + std::to_string(entry.ring->get_frame_rate()))) {
+                    return;
+                }
+            }
+            if (!send_line(client, "END")) {
+                return;
+            }
+        } else if (request.compare(0, 5, "OPEN ") == 0) {
+            std::string name = request.substr(5);
+            const Export* found = nullptr;
+            for (const Export& entry : exports_) {
+                if (entry.name == name) {
+                    found = &entry;
+                }
+            }
+            if (!found) {
+                if (!send_line(client, "ERROR unknown screen " + name)) {
+                    return;
+                }
+                continue;
+            }
+
+            // The ring is sealed (FrameRing::seal), which is what keeps clients
+            // out of it; the read-only reopen just hands out no write access
+            std::string proc_path = "/proc/self/fd/" + std::to_string(found->ring->get_fd());
+            int read_only = open(proc_path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (read_only < 0) {
+                std::cerr << "WARNING: Could not reopen export ring " << name << ": " << strerror(errno) << std::endl;
+                if (!send_line(client, "ERROR ring unavailable")) {
+                    return;
+                }
+                continue;
+            }
+            bool sent = send_line(client, "OK " + name, read_only);
+            close(read_only);
+            if (!sent) {
+                return;
+            }
+            std::cout << "DEBUG: Export client opened " << name << std::endl;
+        } else {
+            if (!send_line(client, "ERROR unknown request")) {
+                return;
+            }
+        }
+    }
+}
+
+bool FrameExportServer::send_line(int client, const std::string& line, int fd) {
+    std::string data = line + "\n";
+    struct iovec iov;
+    iov.iov_base = const_cast<char*>(data.data());
+    iov.iov_len = data.size();
+
+    struct msghdr message;
+    memset(&message, 0, sizeof(message));
+    message.msg_iov = &iov;
+    message.msg_iovlen = 1;
+
+    char control[CMSG_SPACE(sizeof(int))];
+    if (fd >= 0) {
+        memset(control, 0, sizeof(control));
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+        struct cmsghdr* header = CMSG_FIRSTHDR(&message);
+        header->cmsg_level = SOL_SOCKET;
+        header->cmsg_type = SCM_RIGHTS;
+        header->cmsg_len = CMSG_LEN(sizeof(int));
+        memcpy(CMSG_DATA(header), &fd, sizeof(int));
+    }
+
+    return sendmsg(client, &message, MSG_NOSIGNAL) == static_cast<ssize_t>(data.size());
+}
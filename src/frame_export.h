@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+class FrameRing;
+
+// --export: hands each screen's frame ring to other local processes (lock
+// screens, login greeters, wallpaper pickers) so they can show the running
+// wallpaper without decoding it again.
+//
+// Handshake on a Unix stream socket, one text line per request:
+//   LIST          -> "SCREEN <name> <fps>" per exported screen, then "END"
+//   OPEN <name>   -> "OK <name>" carrying a read-only memfd (SCM_RIGHTS),
+//                    or "ERROR <reason>"
+//
+// The memfd is a FrameRing (frame_ring.h): a one-page header followed by
+// RGBA slots at the decoded source size. It is sealed against writes and
+// shrinking, so clients can only map it PROT_READ; they never pin, and copy
+// the newest frame and check it: read `latest`, read that
+// slot's sequence (odd = being written, retry), copy, then accept the copy
+// only if the sequence is unchanged. The header's frame counter is a shared
+// futex to wait on, and a changed layout serial means the slots grew (remap).
+class FrameExportServer {
+public:
+    FrameExportServer();
+    ~FrameExportServer();
+
+    // Rings are registered before start() and must outlive stop()
+    void add_ring(const std::string& screen_name, const FrameRing* ring);
+
+    bool start(const std::string& socket_path);
+    void stop();
+
+    // $XDG_RUNTIME_DIR/linux-wallpaperengine-ext/export.sock
+    static std::string get_default_socket_path();
+
+private:
+    struct Export {
+        std::string name;
+        const FrameRing* ring;
+    };
+
+    static constexpr int MAX_REQUESTS_PER_CLIENT = 32;
+    static constexpr int CLIENT_TIMEOUT_MS = 1000;     // Per send; a stalled client is dropped, not waited for
+    static constexpr int CLIENT_DEADLINE_MS = 2000;    // Whole connection, however slowly the client trickles requests
+    static constexpr size_t MAX_LINE = 256;
+
+    static bool is_trusted_directory(const std::string& directory, bool require_private);
+    void accept_loop();
+    void handle_client(int client);
+    bool send_line(int client, const std::string& line, int fd = -1);
+
+    std::vector<Export> exports_;
+    std::string socket_path_;
+    int listen_fd_;
+    std::unique_ptr<std::thread> thread_;
+    std::atomic<bool> running_;
+};
@@ -0,0 +1,231 @@
+#include "frame_pool.h"
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <sys/mman.h>
+
+#ifndef MAP_HUGE_2MB
+#define MAP_HUGE_2MB (21 << 26)
+#endif
+
+static constexpr size_t PAGE_SIZE_BYTES = 4096;
+
+static uint64_t now_ms() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+FramePool& FramePool::instance() {
+    static FramePool pool;
+    return pool;
+}
+
+FramePool::FramePool()
+    : huge_pages_(HugePageMode::THP), cached_bytes_(0), hits_(0), misses_(0), huge_blocks_(0),
+      last_stats_ms_(now_ms()) {}
+
+FramePool::~FramePool() {
+    trim();
+}
+
+void FramePool::set_huge_pages(HugePageMode mode) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    huge_pages_ = mode;
+}
+
+bool FramePool::parse_huge_page_mode(const std::string& value, HugePageMode* mode) {
+    if (value == "off") {
+        *mode = HugePageMode::OFF;
+    } else if (value == "thp") {
+        *mode = HugePageMode::THP;
+    } else if (value == "hugetlb") {
+        *mode = HugePageMode::HUGETLB;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// Small buffers round up to whole pages, frame-sized ones to whole huge pages,
+// so nearby resolutions (odd heights, padded strides) share a class
+size_t FramePool::size_class(size_t bytes) {
+    if (bytes >= HUGE_PAGE_SIZE) {
+        return (bytes + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+    }
+    return (bytes + PAGE_SIZE_BYTES - 1) & ~(PAGE_SIZE_BYTES - 1);
+}
+
+void* FramePool::allocate_block(size_t size, bool* mapped) {
+    *mapped = false;
+    if (size < HUGE_PAGE_SIZE || huge_pages_ == HugePageMode::OFF) {
+        return aligned_alloc(size < HUGE_PAGE_SIZE ? ALIGNMENT : PAGE_SIZE_BYTES, size);
+    }
+
+    if (huge_pages_ == HugePageMode::HUGETLB) {
+        void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_HUGE_2MB, -1, 0);
+        if (data != MAP_FAILED) {
+            *mapped = true;
+            huge_blocks_++;
+            return data;
+        }
+        // Nothing reserved in /proc/sys/vm/nr_hugepages: warn once, then use THP
+        static bool warned = false;
+        if (!warned) {
+            std::cerr << "WARNING: No hugetlb pages available (" << strerror(errno)
+                      << "), falling back to transparent huge pages" << std::endl;
+            warned = true;
+        }
+    }
+
+    // Over-map by one huge page and trim, so the block starts on a 2 MiB
+    // boundary and khugepaged can back all of it
+    size_t span = size + HUGE_PAGE_SIZE;
+    void* raw = mmap(nullptr, span, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) {
+        return nullptr;
+    }
+    uintptr_t start = reinterpret_cast<uintptr_t>(raw);
+    uintptr_t aligned = (start + HUGE_PAGE_SIZE - 1) & ~static_cast<uintptr_t>(HUGE_PAGE_SIZE - 1);
+    if (aligned > start) {
+        munmap(raw, aligned - start);
+    }
+    size_t tail = span - (aligned - start) - size;
+    if (tail > 0) {
+        munmap(reinterpret_cast<void*>(aligned + size), tail);
+    }
+
+    void* data = reinterpret_cast<void*>(aligned);
+    madvise(data, size, MADV_HUGEPAGE);
+    *mapped = true;
+    huge_blocks_++;
+    return data;
+}
+
+void FramePool::free_block(void* data, const Block& block) {
+    if (block.mapped) {
+        munmap(data, block.size);
+    } else {
+        free(data);
+    }
+}
+
+void* FramePool::acquire(size_t bytes) {
+    if (bytes == 0) {
+        return nullptr;
+    }
+    size_t size = size_class(bytes);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto list = free_lists_.find(size);
+    if (list != free_lists_.end() && !list->second.empty()) {
+        void* data = list->second.back();
+        list->second.pop_back();
+        cached_bytes_ -= size;
+        hits_++;
+        log_stats();
+        return data;
+    }
+
+    bool mapped = false;
+    void* data = allocate_block(size, &mapped);
+    if (!data) {
+        std::cerr << "ERROR: Failed to allocate " << size / 1024 << " KiB frame buffer" << std::endl;
+        return nullptr;
+    }
+    blocks_[data] = Block{size, mapped};
+    misses_++;
+    log_stats();
+    return data;
+}
+
+void FramePool::release(void* data) {
+    if (!data) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto block = blocks_.find(data);
+    if (block == blocks_.end()) {
+        std::cerr << "ERROR: Released a buffer that did not come from the frame pool" << std::endl;
+        return;
+    }
+
+    size_t size = block->second.size;
+    std::vector<void*>& list = free_lists_[size];
+    if (list.size() >= MAX_CACHED_PER_CLASS || cached_bytes_ + size > MAX_CACHED_BYTES) {
+        free_block(data, block->second);
+        blocks_.erase(block);
+        return;
+    }
+    list.push_back(data);
+    cached_bytes_ += size;
+}
+
+void FramePool::trim() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& list : free_lists_) {
+        for (void* data : list.second) {
+            auto block = blocks_.find(data);
+            if (block != blocks_.end()) {
+                free_block(data, block->second);
+                blocks_.erase(block);
+            }
+        }
+    }
+    free_lists_.clear();
+    cached_bytes_ = 0;
+}
+
+void FramePool::log_stats() {
+    uint64_t now = now_ms();
+    if (now - last_stats_ms_ >= 5000) {
+        std::cout << "FRAME POOL: " << hits_ << " reused, " << misses_ << " allocated, " << blocks_.size()
+                  << " blocks live (" << huge_blocks_ << " huge-page backed), " << cached_bytes_ / 1024
+                  << " KiB cached" << std::endl;
+        hits_ = 0;
+        misses_ = 0;
+        last_stats_ms_ = now;
+    }
+}
+
+FrameBuffer& FrameBuffer::operator=(FrameBuffer&& other) noexcept {
+    if (this != &other) {
+        reset();
+        data_ = other.data_;
+        size_ = other.size_;
+        other.data_ = nullptr;
+        other.size_ = 0;
+    }
+    return *this;
+}
+
+bool FrameBuffer::ensure(size_t bytes) {
+    if (data_ && size_ >= bytes) {
+        return true;
+    }
+    reset();
+    data_ = static_cast<unsigned char*>(FramePool::instance().acquire(bytes));
+    if (!data_) {
+        return false;
+    }
+    size_ = bytes;
+    return true;
+}
+
+void FrameBuffer::reset() {
+    if (data_) {
+        FramePool::instance().release(data_);
+        data_ = nullptr;
+        size_ = 0;
+    }
+}
+
+unsigned char* FrameBuffer::detach() {
+    unsigned char* data = data_;
+    data_ = nullptr;
+    size_ = 0;
+    return data;
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// How buffers of HUGE_PAGE_SIZE and up are backed
+enum class HugePageMode {
+    OFF,        // Regular pages
+    THP,        // Anonymous mapping aligned to 2 MiB with MADV_HUGEPAGE (default)
+    HUGETLB     // Reserved hugetlbfs pages (MAP_HUGETLB), THP if none are free
+};
+
+/**
+ * Process-wide pool for frame-sized buffers (decoder RGBA output, scaler
+ * targets, X11 image buffers).
+ *
+ * Blocks are 64-byte aligned and kept on per-size-class free lists when
+ * released, so a stage that needs the same buffer every frame gets it back
+ * without touching the allocator or faulting pages in again. Blocks of 2 MiB
+ * and up are mapped 2 MiB-aligned and backed by huge pages: a 4K RGBA frame
+ * then spans 16 TLB entries instead of ~8000, which is what the scalers
+ * spend their misses on.
+ */
+class FramePool {
+public:
+    static constexpr size_t ALIGNMENT = 64;
+    static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+    static constexpr size_t MAX_CACHED_BYTES = 256 * 1024 * 1024;  // Free-list budget across all classes
+    static constexpr size_t MAX_CACHED_PER_CLASS = 4;
+
+    static FramePool& instance();
+
+    void set_huge_pages(HugePageMode mode);
+    static bool parse_huge_page_mode(const std::string& value, HugePageMode* mode);
+
+    // At least `bytes` of 64-byte aligned memory (nullptr on failure)
+    void* acquire(size_t bytes);
+    // Back onto its free list; nullptr is ignored
+    void release(void* data);
+    // Drop every cached block
+    void trim();
+
+private:
+    struct Block {
+        size_t size;            // Size class actually allocated
+        bool mapped;            // mmap (huge page eligible) rather than aligned_alloc
+    };
+
+    FramePool();
+    ~FramePool();
+    FramePool(const FramePool&) = delete;
+    FramePool& operator=(const FramePool&) = delete;
+
+    std::mutex mutex_;
+    HugePageMode huge_pages_;
+    std::map<size_t, std::vector<void*>> free_lists_;
+    std::unordered_map<void*, Block> blocks_;       // Every live block, handed out or cached
+    size_t cached_bytes_;
+
+    // Logged with the pool's stats line every 5s of activity
+    uint64_t hits_;
+    uint64_t misses_;
+    uint64_t huge_blocks_;
+    uint64_t last_stats_ms_;
+
+    static size_t size_class(size_t bytes);
+    void* allocate_block(size_t size, bool* mapped);
+    void free_block(void* data, const Block& block);
+    void log_stats();
+};
+
+// Owning handle for one pooled buffer
+class FrameBuffer {
+public:
+    FrameBuffer() : data_(nullptr), size_(0) {}
+    ~FrameBuffer() { reset(); }
+
+    FrameBuffer(FrameBuffer&& other) noexcept : data_(other.data_), size_(other.size_) {
+        other.data_ = nullptr;
+        other.size_ = 0;
+    }
+    FrameBuffer& operator=(FrameBuffer&& other) noexcept;
+    FrameBuffer(const FrameBuffer&) = delete;
+    FrameBuffer& operator=(const FrameBuffer&) = delete;
+
+    // Keeps the current block when it is already big enough (contents are
+    // not preserved otherwise)
+    bool ensure(size_t bytes);
+    void reset();
+
+    unsigned char* data() const { return data_; }
+    size_t size() const { return size_; }
+    // Hand the block to someone who will FramePool::release() it
+    unsigned char* detach();
+
+private:
+    unsigned char* data_;
+    size_t size_;
+};
@@ -0,0 +1,390 @@
+#include "frame_ring.h"
+#include <iostream>
+#include <cstring>
+#include <cerrno>
+#include <climits>
+#include <new>
+#include <thread>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free && std::atomic<uint64_t>::is_always_lock_free,
+              "frame ring atomics are shared between processes and must be lock-free");
+
+static size_t page_align(size_t size) {
+    return (size + 4095) & ~static_cast<size_t>(4095);
+}
+
+FrameRing::FrameRing()
+    : fd_(-1), header_(nullptr), mapping_(nullptr), mapping_size_(0), mapped_layout_(0),
+      slot_count_(0), reader_count_(0), slot_size_(0), latest_(-1), sealed_(false),
+      frames_published_(0), frames_without_slot_(0), stats_start_(std::chrono::steady_clock::now()) {}
+
+FrameRing::~FrameRing() {
+    close();
+}
+
+bool FrameRing::create(const std::string& name, int reader_count, int spare_slots) {
+    if (reader_count < 0 || reader_count > MAX_READERS) {
+        std::cerr << "ERROR: Frame ring supports 0 - " << MAX_READERS << " readers, got " << reader_count << std::endl;
+        return false;
+    }
+    if (reader_count == 0 && spare_slots == 0) {
+        std::cerr << "ERROR: Frame ring needs at least one reader or one spare slot" << std::endl;
+        return false;
+    }
+    if (spare_slots < 0 || reader_count + 2 + spare_slots > MAX_SLOTS) {
+        std::cerr << "ERROR: Frame ring supports up to " << MAX_SLOTS << " slots, got "
+                  << reader_count + 2 + spare_slots << std::endl;
+        return false;
+    }
+    close();
+
+    fd_ = memfd_create(("lwe-ring-" + name).c_str(), MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (fd_ < 0) {
+        std::cerr << "ERROR: Failed to create frame ring memfd: " << strerror(errno) << std::endl;
+        return false;
+    }
+    if (ftruncate(fd_, HEADER_SIZE) < 0) {
+        std::cerr << "ERROR: Failed to size frame ring: " << strerror(errno) << std::endl;
+        close();
+        return false;
+    }
+
+    void* mapping = mmap(nullptr, HEADER_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (mapping == MAP_FAILED) {
+        std::cerr << "ERROR: Failed to map frame ring: " << strerror(errno) << std::endl;
+        close();
+        return false;
+    }
+    mapping_ = static_cast<unsigned char*>(mapping);
+    mapping_size_ = HEADER_SIZE;
+    header_ = new (mapping_) Header();
+
+    header_->magic = MAGIC;
+    header_->version = VERSION;
+    strncpy(header_->name, name.c_str(), sizeof(header_->name) - 1);
+    reader_count_ = reader_count;
+    slot_count_ = reader_count + 2 + spare_slots;
+    slot_size_ = 0;
+    latest_ = -1;
+    header_->reader_count = reader_count_;
+    header_->slot_count = slot_count_;
+    header_->latest.store(latest_);
+    mapped_layout_ = header_->layout_serial.load();
+    return true;
+}
+
+bool FrameRing::seal() {
+    if (!header_ || reader_count_ > 0) {
+        return false;
+    }
+    // Growing stays possible for resize_slots(), which extends our existing
+    // writable mapping with mremap() rather than mapping the memfd again
+    if (fcntl(fd_, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_FUTURE_WRITE | F_SEAL_SEAL) < 0) {
+        std::cerr << "ERROR: Failed to seal frame ring " << get_name() << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+    sealed_ = true;
+    return true;
+}
+
+bool FrameRing::attach(int fd) {
+    close();
+    fd_ = fd;
+
+    struct stat st;
+    if (fstat(fd_, &st) < 0 || static_cast<size_t>(st.st_size) < HEADER_SIZE) {
+        std::cerr << "ERROR: Not a frame ring (fd " << fd << ")" << std::endl;
+        close();
+        return false;
+    }
+
+    void* mapping = mmap(nullptr, HEADER_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (mapping == MAP_FAILED) {
+        std::cerr << "ERROR: Failed to map frame ring: " << strerror(errno) << std::endl;
+        close();
+        return false;
+    }
+    mapping_ = static_cast<unsigned char*>(mapping);
+    mapping_size_ = HEADER_SIZE;
+    header_ = reinterpret_cast<Header*>(mapping_);
+
+    if (header_->magic != MAGIC || header_->version != VERSION ||
+        header_->reader_count > MAX_READERS || header_->slot_count < header_->reader_count + 2 ||
+        header_->slot_count > MAX_SLOTS) {
+        std::cerr << "ERROR: Frame ring header is invalid or from another version" << std::endl;
+        close();
+        return false;
+    }
+    reader_count_ = header_->reader_count;
+    slot_count_ = header_->slot_count;
+
+    mapped_layout_ = header_->layout_serial.load();
+    if (header_->slot_size.load() > 0) {
+        return map_slots();
+    }
+    return true;
+}
+
+void FrameRing::close() {
+    if (mapping_) {
+        munmap(mapping_, mapping_size_);
+        mapping_ = nullptr;
+        mapping_size_ = 0;
+        header_ = nullptr;
+    }
+    slot_count_ = 0;
+    reader_count_ = 0;
+    slot_size_ = 0;
+    latest_ = -1;
+    sealed_ = false;
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+std::string FrameRing::get_name() const {
+    if (!header_) {
+        return std::string();
+    }
+    return std::string(header_->name, strnlen(header_->name, sizeof(header_->name)));
+}
+
+int FrameRing::get_reader_count() const {
+    return header_ ? static_cast<int>(reader_count_) : 0;
+}
+
+bool FrameRing::map_slots() {
+    // Reader side. Remember the layout first: if it changes again we simply remap next time
+    uint32_t layout = header_->layout_serial.load();
+    size_t slot_size = header_->slot_size.load();
+    size_t size = HEADER_SIZE + slot_count_ * slot_size;
+
+    struct stat st;
+    if (fstat(fd_, &st) < 0 || static_cast<size_t>(st.st_size) < size) {
+        std::cerr << "ERROR: Frame ring is smaller than its slot layout" << std::endl;
+        return false;
+    }
+
+    void* mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (mapping == MAP_FAILED) {
+        std::cerr << "ERROR: Failed to map frame ring slots: " << strerror(errno) << std::endl;
+        return false;
+    }
+    munmap(mapping_, mapping_size_);
+    mapping_ = static_cast<unsigned char*>(mapping);
+    mapping_size_ = size;
+    header_ = reinterpret_cast<Header*>(mapping_);
+    mapped_layout_ = layout;
+    slot_size_ = slot_size;
+    return true;
+}
+
+unsigned char* FrameRing::slot_data(int slot) const {
+    return mapping_ + HEADER_SIZE + static_cast<size_t>(slot) * slot_size_;
+}
+
+bool FrameRing::resize_slots(size_t frame_bytes) {
+    // Hide the current frame and wait for readers to let go of their slots;
+    // they only pin one for the length of a present
+    latest_ = -1;
+    header_->latest.store(latest_);
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(200);
+    for (;;) {
+        bool pinned = false;
+        for (uint32_t i = 0; i < reader_count_; i++) {
+            pinned = pinned || header_->pins[i].load() != 0;
+        }
+        if (!pinned) {
+            break;
+        }
+        if (std::chrono::steady_clock::now() > deadline) {
+            std::cerr << "WARNING: Frame ring " << get_name() << " readers still busy, retrying resize" << std::endl;
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    // Slots only ever grow, so readers still holding the old mapping never
+    // touch memory past the end of the file
+    size_t slot_size = page_align(frame_bytes);
+    size_t size = HEADER_SIZE + slot_count_ * slot_size;
+    if (ftruncate(fd_, size) < 0) {
+        std::cerr << "ERROR: Failed to grow frame ring: " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    // Grow the writable mapping in place: a sealed memfd refuses new ones
+    void* mapping = mremap(mapping_, mapping_size_, size, MREMAP_MAYMOVE);
+    if (mapping == MAP_FAILED) {
+        std::cerr << "ERROR: Failed to map grown frame ring: " << strerror(errno) << std::endl;
+        return false;
+    }
+    mapping_ = static_cast<unsigned char*>(mapping);
+    mapping_size_ = size;
+    header_ = reinterpret_cast<Header*>(mapping_);
+    slot_size_ = slot_size;
+
+    header_->slot_size.store(slot_size_);
+    mapped_layout_ = header_->layout_serial.fetch_add(1) + 1;
+
+    std::cout << "DEBUG: Frame ring " << get_name() << " slots resized to " << slot_size_ / 1024 << " KiB x "
+              << slot_count_ << std::endl;
+    return true;
+}
+
+int FrameRing::pick_write_slot() const {
+    // Round robin from the newest slot: a frame stays intact for as long as
+    // possible, which is what readers copying without a pin rely on
+    uint32_t first = latest_ < 0 ? 0 : static_cast<uint32_t>(latest_) + 1;
+    for (uint32_t n = 0; n < slot_count_; n++) {
+        uint32_t slot = (first + n) % slot_count_;
+        if (static_cast<int32_t>(slot) == latest_) {
+            continue;
+        }
+        bool pinned = false;
+        for (uint32_t i = 0; i < reader_count_ && !pinned; i++) {
+            pinned = header_->pins[i].load() == slot + 1;
+        }
+        if (!pinned) {
+            return static_cast<int>(slot);
+        }
+    }
+    return -1;
+}
+
+bool FrameRing::publish(const unsigned char* rgba, int width, int height, uint64_t serial) {
+    if (!header_ || !rgba || width <= 0 || height <= 0) {
+        return false;
+    }
+
+    size_t frame_bytes = static_cast<size_t>(width) * height * 4;
+    if (frame_bytes > slot_size_ && !resize_slots(frame_bytes)) {
+        return false;
+    }
+
+    int slot = pick_write_slot();
+    if (slot < 0) {
+        // Cannot happen with reader_count + 2 slots unless a reader died holding a pin
+        frames_without_slot_++;
+        log_stats();
+        return false;
+    }
+
+    // Sequence odd around the write: a reader without a pin that copied
+    // from this slot meanwhile sees it change and retries
+    Slot& meta = header_->slots[slot];
+    meta.sequence.fetch_add(1);
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(slot_data(slot), rgba, frame_bytes);
+    meta.width = width;
+    meta.height = height;
+    meta.stride = width * 4;
+    meta.serial = serial;
+    meta.sequence.fetch_add(1);
+
+    // Publishing the index releases the slot contents to readers
+    latest_ = slot;
+    header_->latest.store(latest_);
+    header_->frame_counter.fetch_add(1);
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&header_->frame_counter), FUTEX_WAKE, INT_MAX,
+            nullptr, nullptr, 0);
+
+    frames_published_++;
+    log_stats();
+    return true;
+}
+
+void FrameRing::set_frame_rate(double fps) {
+    if (header_) {
+        header_->frame_rate_milli.store(static_cast<uint32_t>(fps * 1000.0));
+    }
+}
+
+double FrameRing::get_frame_rate() const {
+    return header_ ? header_->frame_rate_milli.load() / 1000.0 : 0.0;
+}
+
+bool FrameRing::acquire(int reader, FrameRingView* view) {
+    if (!header_ || !view || reader < 0 || reader >= static_cast<int>(reader_count_)) {
+        return false;
+    }
+
+    for (int attempt = 0; attempt < 4; attempt++) {
+        int32_t slot = header_->latest.load();
+        if (slot < 0 || slot >= static_cast<int32_t>(slot_count_)) {
+            return false;
+        }
+
+        // Pin, then confirm the slot is still the newest: the writer never
+        // starts on the newest slot, nor on one it saw pinned
+        header_->pins[reader].store(slot + 1);
+        if (header_->latest.load() != slot) {
+            header_->pins[reader].store(0);
+            continue;
+        }
+
+        if (mapped_layout_ != header_->layout_serial.load() && !map_slots()) {
+            header_->pins[reader].store(0);
+            return false;
+        }
+
+        const Slot& meta = header_->slots[slot];
+        view->data = slot_data(slot);
+        view->width = meta.width;
+        view->height = meta.height;
+        view->stride = meta.stride;
+        view->serial = meta.serial;
+        return true;
+    }
+    return false;
+}
+
+void FrameRing::release(int reader) {
+    if (header_ && reader >= 0 && reader < static_cast<int>(reader_count_)) {
+        header_->pins[reader].store(0);
+    }
+}
+
+void FrameRing::clear_reader(int reader) {
+    release(reader);
+}
+
+uint32_t FrameRing::get_counter() const {
+    return header_ ? header_->frame_counter.load() : 0;
+}
+
+bool FrameRing::wait_for_frame(uint32_t seen, int timeout_ms) const {
+    if (!header_) {
+        return false;
+    }
+    if (header_->frame_counter.load() != seen) {
+        return true;
+    }
+
+    // Shared (non-private) futex: the writer lives in another process
+    struct timespec timeout;
+    timeout.tv_sec = timeout_ms / 1000;
+    timeout.tv_nsec = (timeout_ms % 1000) * 1000000L;
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&header_->frame_counter), FUTEX_WAIT, seen,
+            &timeout, nullptr, 0);
+    return header_->frame_counter.load() != seen;
+}
+
+void FrameRing::log_stats() {
+    auto now = std::chrono::steady_clock::now();
+    auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - stats_start_);
+    if (elapsed.count() >= 5) {
+        std::cout << "FRAME RING: " << get_name() << " published " << frames_published_ << " frames ("
+                  << frames_without_slot_ << " dropped, no free slot) in " << elapsed.count() << "s" << std::endl;
+        frames_published_ = 0;
+        frames_without_slot_ = 0;
+        stats_start_ = now;
+    }
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// One published frame as seen by a reader; valid until release()
+struct FrameRingView {
+    const unsigned char* data = nullptr;    // RGBA
+    int width = 0;
+    int height = 0;
+    int stride = 0;                         // Bytes per row
+    uint64_t serial = 0;                    // Producer's frame serial (changes when the picture changes)
+};
+
+// Single-producer, multi-reader ring of RGBA frames in a memfd.
+// The mapping is shared between processes (the memfd is inherited across
+// fork), so a decoded frame is copied once into the ring and every reader
+// presents straight from it. Readers always take the newest frame and pin
+// its slot while using it; the writer never overwrites the newest or a
+// pinned slot, which is why there are at least reader_count + 2 slots. A
+// 32-bit counter in the header doubles as a futex so readers can sleep until
+// the next frame instead of polling.
+// Readers that cannot pin (export clients, see FrameExportServer) validate
+// their copy against the slot sequence instead. The writer keeps the slot
+// layout to itself and only mirrors it into the header, so nothing a reader
+// writes there can steer publish() out of bounds; seal() additionally stops
+// other processes from writing to or shrinking the memfd at all.
+class FrameRing {
+public:
+    static constexpr int MAX_READERS = 14;
+    static constexpr int MAX_SLOTS = MAX_READERS + 2;
+
+    FrameRing();
+    ~FrameRing();
+
+    FrameRing(const FrameRing&) = delete;
+    FrameRing& operator=(const FrameRing&) = delete;
+
+    // Create a new ring with room for `reader_count` concurrent readers.
+    // `spare_slots` are extra slots beyond the reader_count + 2 the pins
+    // need, giving readers that copy without pinning longer before the
+    // writer comes around to the slot they read. Frame slots are sized on
+    // the first publish().
+    bool create(const std::string& name, int reader_count, int spare_slots = 0);
+
+    // Map an existing ring from an inherited or received memfd (takes ownership)
+    bool attach(int fd);
+
+    // Writer side, right after create() of a ring without pinning readers:
+    // seals the memfd so that no descriptor to it, including ones handed to
+    // untrusted clients, can be mapped writable or shrink it
+    bool seal();
+
+    void close();
+    bool is_open() const { return header_ != nullptr; }
+    int get_fd() const { return fd_; }
+    std::string get_name() const;
+    int get_reader_count() const;
+
+    // Writer side
+    bool publish(const unsigned char* rgba, int width, int height, uint64_t serial);
+    void set_frame_rate(double fps);
+
+    // Reader side: pin the newest frame (false if there is none yet)
+    bool acquire(int reader, FrameRingView* view);
+    void release(int reader);
+    double get_frame_rate() const;
+
+    // Frame counter doubles as the futex word
+    uint32_t get_counter() const;
+    // Sleep until the counter moves past `seen` or the timeout passes; true on a new frame
+    bool wait_for_frame(uint32_t seen, int timeout_ms) const;
+
+    // A reader process died holding a pin (supervisor side)
+    void clear_reader(int reader);
+
+private:
+    struct Slot {
+        uint32_t width;
+        uint32_t height;
+        uint32_t stride;
+        std::atomic<uint32_t> sequence;     // Odd while the writer fills the slot (read-only readers)
+        uint64_t serial;
+    };
+
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        char name[32];
+        uint32_t slot_count;
+        uint32_t reader_count;
+        std::atomic<uint32_t> frame_counter;        // Bumped on every publish (futex word)
+        std::atomic<uint32_t> layout_serial;        // Bumped when the slots are resized
+        std::atomic<uint64_t> slot_size;            // Bytes per slot, page aligned
+        std::atomic<int32_t> latest;                // Newest complete slot, -1 = none
+        std::atomic<uint32_t> frame_rate_milli;     // Producer's frame rate * 1000
+        std::atomic<uint32_t> pins[MAX_READERS];    // Slot + 1 each reader is using, 0 = none
+        Slot slots[MAX_SLOTS];
+    };
+
+    static constexpr uint32_t MAGIC = 0x4c574652;   // "LWFR"
+    static constexpr uint32_t VERSION = 2;
+    static constexpr size_t HEADER_SIZE = 4096;
+    static_assert(sizeof(Header) <= HEADER_SIZE, "frame ring header must fit in one page");
+
+    int fd_;
+    Header* header_;
+    unsigned char* mapping_;
+    size_t mapping_size_;
+    uint32_t mapped_layout_;
+
+    // Slot layout as this process knows it; the writer's copy is authoritative
+    // and the header only mirrors it for readers
+    uint32_t slot_count_;
+    uint32_t reader_count_;
+    size_t slot_size_;
+    int32_t latest_;
+    bool sealed_;
+
+    // Writer stats (logged every 5s)
+    int frames_published_;
+    int frames_without_slot_;
+    std::chrono::steady_clock::time_point stats_start_;
+
+    bool map_slots();
+    bool resize_slots(size_t frame_bytes);
+    int pick_write_slot() const;
+    unsigned char* slot_data(int slot) const;
+    void log_stats();
+};
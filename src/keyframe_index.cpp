@@ -0,0 +1,212 @@
+#include "keyframe_index.h"
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+#include <cstdlib>
+#include <cstdio>
+#include <unistd.h>
+#include <sys/stat.h>
+
+KeyframeIndex::KeyframeIndex()
+    : complete_(false), stream_index_(-1), file_size_(0), file_mtime_(0) {}
+
+std::string KeyframeIndex::get_cache_directory() {
+    const char* cache_home = getenv("XDG_CACHE_HOME");
+    if (cache_home && cache_home[0] == '/') {
+        return std::string(cache_home) + "/linux-wallpaperengine-ext";
+    }
+    const char* home = getenv("HOME");
+    if (home && home[0]) {
+        return std::string(home) + "/.cache/linux-wallpaperengine-ext";
+    }
+    return std::string();
+}
+
+bool KeyframeIndex::identify(const std::string& media_path, std::string* path, int64_t* size, int64_t* mtime) {
+    std::error_code error;
+    std::filesystem::path absolute = std::filesystem::absolute(media_path, error);
+    if (error) {
+        return false;
+    }
+
+    struct stat st;
+    if (stat(absolute.c_str(), &st) < 0) {
+        return false;
+    }
+    *path = absolute.lexically_normal().string();
+    *size = st.st_size;
+    *mtime = st.st_mtime;
+    return true;
+}
+
+// FNV-1a, only used to turn a path into a file name
+std::string KeyframeIndex::hash_key(const std::string& text) {
+    uint64_t hash = 1469598103934665603ULL;
+    for (unsigned char c : text) {
+        hash = (hash ^ c) * 1099511628211ULL;
+    }
+    char name[17];
+    snprintf(name, sizeof(name), "%016llx", (unsigned long long)hash);
+    return name;
+}
+
+bool KeyframeIndex::load(const std::string& media_path, int stream_index) {
+    reset();
+    stream_index_ = stream_index;
+    if (!identify(media_path, &path_, &file_size_, &file_mtime_)) {
+        path_.clear();
+        return false;
+    }
+
+    std::string directory = get_cache_directory();
+    if (directory.empty()) {
+        return false;
+    }
+    std::ifstream file(directory + "/keyframes/" + hash_key(path_) + ".idx", std::ios::binary);
+    if (!file) {
+        return false;
+    }
+
+    uint32_t magic = 0, version = 0, path_length = 0;
+    int32_t stored_stream = -1;
+    int64_t stored_size = 0, stored_mtime = 0;
+    uint64_t count = 0;
+    file.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+    file.read(reinterpret_cast<char*>(&version), sizeof(version));
+    file.read(reinterpret_cast<char*>(&stored_stream), sizeof(stored_stream));
+    file.read(reinterpret_cast<char*>(&stored_size), sizeof(stored_size));
+    file.read(reinterpret_cast<char*>(&stored_mtime), sizeof(stored_mtime));
+    file.read(reinterpret_cast<char*>(&path_length), sizeof(path_length));
+    if (!file || magic != MAGIC || version != VERSION || path_length > 4096) {
+        return false;
+    }
+    std::string stored_path(path_length, '\0');
+    file.read(&stored_path[0], path_length);
+    file.read(reinterpret_cast<char*>(&count), sizeof(count));
+
+    // A different (or since modified) file, or a hash collision: rebuild
+    if (!file || stored_path != path_ || stored_stream != stream_index || stored_size != file_size_ ||
+        stored_mtime != file_mtime_ || count == 0 || count > (64u << 20)) {
+        return false;
+    }
+
+    keyframes_.resize(count);
+    file.read(reinterpret_cast<char*>(keyframes_.data()), count * sizeof(int64_t));
+    if (!file || !std::is_sorted(keyframes_.begin(), keyframes_.end())) {
+        reset();
+        return false;
+    }
+    complete_ = true;
+    std::cout << "DEBUG: Loaded keyframe index (" << keyframes_.size() << " keyframes) for " << path_ << std::endl;
+    return true;
+}
+
+bool KeyframeIndex::save() const {
+    std::string directory = get_cache_directory();
+    if (!complete_ || keyframes_.empty() || path_.empty() || directory.empty()) {
+        return false;
+    }
+
+    std::error_code error;
+    std::filesystem::create_directories(directory + "/keyframes", error);
+    if (error) {
+        std::cerr << "WARNING: Could not create keyframe cache directory: " << error.message() << std::endl;
+        return false;
+    }
+
+    // Written aside and renamed, so another instance never reads half a file
+    std::string target = directory + "/keyframes/" + hash_key(path_) + ".idx";
+    std::string temporary = target + ".tmp" + std::to_string(getpid());
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        uint32_t path_length = static_cast<uint32_t>(path_.size());
+        int32_t stream = stream_index_;
+        uint64_t count = keyframes_.size();
+        file.write(reinterpret_cast<const char*>(&MAGIC), sizeof(MAGIC));
+        file.write(reinterpret_cast<const char*>(&VERSION), sizeof(VERSION));
+        file.write(reinterpret_cast<const char*>(&stream), sizeof(stream));
+        file.write(reinterpret_cast<const char*>(&file_size_), sizeof(file_size_));
+        file.write(reinterpret_cast<const char*>(&file_mtime_), sizeof(file_mtime_));
+        file.write(reinterpret_cast<const char*>(&path_length), sizeof(path_length));
+        file.write(path_.data(), path_length);
+        file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+        file.write(reinterpret_cast<const char*>(keyframes_.data()), count * sizeof(int64_t));
+        if (!file) {
+            std::cerr << "WARNING: Could not write keyframe index " << temporary << std::endl;
+            file.close();
+            std::remove(temporary.c_str());
+            return false;
+        }
+    }
+    if (std::rename(temporary.c_str(), target.c_str()) != 0) {
+        std::remove(temporary.c_str());
+        return false;
+    }
+
+    std::cout << "DEBUG: Saved keyframe index (" << keyframes_.size() << " keyframes) for " << path_ << std::endl;
+    return true;
+}
+
+void KeyframeIndex::add(int64_t pts) {
+    if (keyframes_.empty() || pts > keyframes_.back()) {
+        keyframes_.push_back(pts);
+    }
+}
+
+void KeyframeIndex::reset() {
+    keyframes_.clear();
+    complete_ = false;
+}
+
+int64_t KeyframeIndex::find(int64_t pts) const {
+    if (keyframes_.empty()) {
+        return 0;
+    }
+    auto next = std::upper_bound(keyframes_.begin(), keyframes_.end(), pts);
+    return next == keyframes_.begin() ? keyframes_.front() : *(next - 1);
+}
+
+bool KeyframeIndex::save_resume_position(const std::string& media_path, const std::string& screen_name, double seconds) {
+    std::string path, directory = get_cache_directory();
+    int64_t size, mtime;
+    if (directory.empty() || !identify(media_path, &path, &size, &mtime)) {
+        return false;
+    }
+
+    std::error_code error;
+    std::filesystem::create_directories(directory + "/resume", error);
+    if (error) {
+        return false;
+    }
+
+    std::string target = directory + "/resume/" + hash_key(path + "|" + screen_name);
+    std::string temporary = target + ".tmp" + std::to_string(getpid());
+    {
+        std::ofstream file(temporary, std::ios::trunc);
+        file << path << "\n" << seconds << "\n";
+        if (!file) {
+            file.close();
+            std::remove(temporary.c_str());
+            return false;
+        }
+    }
+    return std::rename(temporary.c_str(), target.c_str()) == 0;
+}
+
+bool KeyframeIndex::load_resume_position(const std::string& media_path, const std::string& screen_name, double* seconds) {
+    std::string path, directory = get_cache_directory();
+    int64_t size, mtime;
+    if (directory.empty() || !identify(media_path, &path, &size, &mtime)) {
+        return false;
+    }
+
+    std::ifstream file(directory + "/resume/" + hash_key(path + "|" + screen_name));
+    std::string stored_path;
+    double position = 0.0;
+    if (!std::getline(file, stored_path) || stored_path != path || !(file >> position) || position < 0.0) {
+        return false;
+    }
+    *seconds = position;
+    return true;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Keyframe positions of a video's stream, built by the demux thread on the
+// first full pass and persisted in the cache directory. With it a seek goes
+// straight to the keyframe at or before the target, so it costs one GOP of
+// decoding instead of the demuxer scanning forward from an earlier index point.
+//
+// Entries are keyed on the file's absolute path, size and modification time;
+// a file that changed on disk simply gets a new index.
+class KeyframeIndex {
+public:
+    KeyframeIndex();
+
+    // Load a persisted index for this file/stream (false if there is none yet).
+    // Also remembers the key so a later save() knows where to write.
+    bool load(const std::string& media_path, int stream_index);
+    bool save() const;
+
+    // Building (demux thread): keyframe pts in stream time base, ascending
+    void add(int64_t pts);
+    void reset();
+    void set_complete(bool complete) { complete_ = complete; }
+    bool is_complete() const { return complete_; }
+
+    bool empty() const { return keyframes_.empty(); }
+    const std::vector<int64_t>& get_keyframes() const { return keyframes_; }
+
+    // Last keyframe at or before `pts` (the first one if `pts` is earlier)
+    int64_t find(int64_t pts) const;
+
+    // Where a screen stopped playing this file, for --start resume
+    static bool save_resume_position(const std::string& media_path, const std::string& screen_name, double seconds);
+    static bool load_resume_position(const std::string& media_path, const std::string& screen_name, double* seconds);
+
+    // $XDG_CACHE_HOME/linux-wallpaperengine-ext (empty if there is no home);
+    // decoder profiles and thumbnails are kept next to the indexes
+    static std::string get_cache_directory();
+
+    // Canonical path, size and mtime of a media file, and the name its cache
+    // entries are stored under (shared with the thumbnailer)
+    static bool identify(const std::string& media_path, std::string* path, int64_t* size, int64_t* mtime);
+    static std::string hash_key(const std::string& text);
+
+private:
+    static constexpr uint32_t MAGIC = 0x4c574b49;   // "LWKI"
+    static constexpr uint32_t VERSION = 1;
+
+    std::vector<int64_t> keyframes_;
+    bool complete_;
+
+    // Identity of the indexed file
+    std::string path_;
+    int stream_index_;
+    int64_t file_size_;
+    int64_t file_mtime_;
+};
@@ -1,19 +1,26 @@
 #include "application.h"
 #include "argument_parser.h"
+#include "supervisor.h"
+#include "decoder_profile.h"
+#include "thumbnailer.h"
+#include "media_probe.h"
 #include <iostream>
 #include <signal.h>
 #include <memory>
 #include <clocale>
 #include <clocale>
-#include <SDL2/SDL.h>
 
 // Global application instance for signal handling
 std::unique_ptr<Application> g_app;
+std::unique_ptr<Supervisor> g_supervisor;     // --isolate: workers run the Application instead
 
 void signal_handler(int signal) {
     if (g_app) {
         g_app->handle_signal(signal);
     }
+    if (g_supervisor) {
+        g_supervisor->handle_signal(signal);
+    }
 }
 
 void setup_signal_handlers() {
@@ -33,10 +40,6 @@ int main(int argc, char* argv[]) {
         // Set locale for numeric formatting consistency
         setlocale(LC_NUMERIC, "C");
         
-        // Global VSync disabling for SDL2 before any SDL initialization
-        // This ensures frame rate control works correctly in windowed mode
-        SDL_SetHintWithPriority(SDL_HINT_RENDER_VSYNC, "0", SDL_HINT_OVERRIDE);
-        
         print_version();
         std::cout << std::endl;
         
@@ -51,6 +54,37 @@ int main(int argc, char* argv[]) {
             return 1;
         }
         
+        // Before anything allocates frames; forked workers inherit the mode
+        FramePool::instance().set_huge_pages(config.huge_pages);
+        
+        if (config.command == "autotune") {
+            return DecoderProfiles::run_autotune(config.command_args);
+        }
+        if (config.command == "thumbnail") {
+            return Thumbnailer::run(config.thumbnail, config.command_args);
+        }
+        if (config.command == "probe") {
+            return MediaProbe::run(config.probe, config.command_args);
+        }
+        
+        if (!config.isolate_mode.empty()) {
+            // Each screen (or decoder group) gets its own worker process
+            g_supervisor = std::make_unique<Supervisor>();
+            setup_signal_handlers();
+            if (!g_supervisor->initialize(config)) {
+                std::cerr << "Failed to initialize supervisor" << std::endl;
+                return 1;
+            }
+            
+            std::cout << "Press Ctrl+C to exit" << std::endl;
+            std::cout << std::endl;
+            
+            int result = g_supervisor->run();
+            g_supervisor.reset();
+            std::cout << "Goodbye!" << std::endl;
+            return result;
+        }
+        
         // Create and initialize application
         g_app = std::make_unique<Application>();
         
@@ -1,21 +1,26 @@
 #include "media_player.h"
-#include "audio/pulse_audio.h"
+#include "audio/audio_output.h"
+#include "frame_pool.h"
+#include "decoder_profile.h"
 #include <iostream>
 #include <filesystem>
 #include <algorithm>
 #include <cctype>
 #include <cstring>
+#include <cstdlib>
 #include <clocale>
 #include <chrono>
 #include <vector>
 #include <memory>
 #include <iomanip>
 #include <thread>
+#include <cmath>
 
 extern "C" {
 #include <libavformat/avformat.h>
 #include <libavcodec/avcodec.h>
 #include <libavutil/imgutils.h>
+#include <libavutil/pixdesc.h>
 #include <libswscale/swscale.h>
 }
 
@@ -25,14 +30,27 @@ MediaPlayer::MediaPlayer()
       media_type_(MediaType::UNKNOWN), image_data_(nullptr),
       format_context_(nullptr), codec_context_(nullptr), codec_(nullptr),
       frame_(nullptr), rgb_frame_(nullptr), sws_context_(nullptr),
-      video_stream_index_(-1), frame_buffer_(nullptr),
+      sws_flags_(0), video_stream_index_(-1), frame_buffer_(nullptr),
       audio_codec_context_(nullptr), audio_codec_(nullptr), audio_stream_index_(-1),
       decoder_initialized_(false), frame_rate_(30.0), current_time_(0.0),
       frame_duration_(1.0/30.0), target_frame_rate_(30.0), target_frame_duration_(1.0/30.0),
       last_decode_time_(0.0), video_time_(0.0), frame_rate_limiting_enabled_(false),
-      frame_available_(false), volume_(100), muted_(false),
+      frame_available_(false), yuv_output_enabled_(false), last_frame_is_yuv_(false),
+      volume_(100), muted_(false),
       audio_player_(nullptr), audio_frame_(nullptr), audio_playback_enabled_(false),
-      audio_thread_(nullptr), audio_thread_running_(false) {}
+      audio_thread_(nullptr), audio_thread_running_(false),
+      packet_queue_(nullptr), demux_thread_(nullptr), demux_thread_running_(false),
+      video_packet_(nullptr), playback_speed_(1.0), skip_to_keyframe_(false),
+      frames_dropped_(0), packets_skipped_(0),
+      frame_serial_(0), last_frame_hash_(0), last_frame_hash_valid_(false),
+      last_frame_width_(0), last_frame_height_(0), last_frame_format_(-1), frames_elided_(0),
+      ping_pong_(false), reversing_(false), reverse_done_(false), reverse_fill_complete_(false),
+      reverse_cache_limit_(0), reverse_keep_every_(1), reverse_gop_frames_(0),
+      reverse_end_pts_(0.0), reverse_start_time_(0.0),
+      seek_request_(-1.0), seek_marker_target_(-1.0), seek_target_pts_(-1.0), audio_seek_request_(-1.0),
+      pacing_last_display_(std::chrono::steady_clock::now()), pacing_stats_start_(pacing_last_display_),
+      pacing_frames_skipped_(0), pacing_frames_displayed_(0), pacing_frames_processed_(0),
+      extraction_log_counter_(0), audio_write_errors_(0) {}
 
 MediaPlayer::~MediaPlayer() {
     cleanup();
@@ -51,13 +69,8 @@ bool MediaPlayer::initialize() {
         ffmpeg_initialized = true;
     }
     
-    // Create audio player for audio playback
-    audio_player_ = std::make_unique<PulseAudio>();
-    if (!audio_player_->initialize()) {
-        std::cerr << "Warning: Failed to initialize audio player. Audio playback will be disabled." << std::endl;
-        audio_player_.reset();
-    }
-    
+    // The PulseAudio connection is opened by load_media() only for files
+    // that actually carry an audio stream
     initialized_ = true;
     return true;
 }
@@ -151,9 +164,9 @@ void MediaPlayer::set_muted(bool muted) {
     muted_ = muted;
     std::cout << "DEBUG: MediaPlayer mute set to " << (muted_ ? "ON" : "OFF") << std::endl;
     
-    // Apply to audio stream if active
+    // Apply to audio stream if active (audio is not time-stretched, keep it silent off 1x)
     if (audio_player_ && audio_playback_enabled_) {
-        audio_player_->set_playback_muted(muted_);
+        audio_player_->set_playback_muted(muted_ || playback_speed_ != 1.0);
     }
 }
 
@@ -185,6 +198,64 @@ void MediaPlayer::set_fps_limit(int fps) {
     }
 }
 
+void MediaPlayer::set_playback_speed(double speed) {
+    playback_speed_ = std::max(MIN_PLAYBACK_SPEED, std::min(MAX_PLAYBACK_SPEED, speed));
+    std::cout << "DEBUG: Playback speed set to " << playback_speed_ << "x" << std::endl;
+    
+    apply_decoder_skip_mode();
+    
+    // Restart the PTS clock so the new rate applies from the current frame on
+    playback_start_time_ = 0.0;
+    
+    if (audio_player_ && audio_playback_enabled_) {
+        if (playback_speed_ != 1.0) {
+            std::cout << "INFO: Audio muted while playback speed is not 1x" << std::endl;
+        }
+        audio_player_->set_playback_muted(muted_ || playback_speed_ != 1.0);
+    }
+}
+
+double MediaPlayer::get_playback_speed() const {
+    return playback_speed_;
+}
+
+void MediaPlayer::seek(double seconds) {
+    if (media_type_ != MediaType::VIDEO || !decoder_initialized_) {
+        return;
+    }
+    double duration = get_duration();
+    if (duration > 0.0 && seconds >= duration) {
+        seconds = std::fmod(seconds, duration);
+    }
+    seek_request_ = std::max(0.0, seconds);
+    // The audio thread reads its own demuxer; it follows before its next read
+    audio_seek_request_ = seek_request_.load();
+    std::cout << "DEBUG: Seeking to " << std::fixed << std::setprecision(2) << seek_request_.load()
+              << "s" << std::defaultfloat << std::endl;
+}
+
+double MediaPlayer::get_duration() const {
+    if (!format_context_ || format_context_->duration <= 0) {
+        return 0.0;
+    }
+    return format_context_->duration / (double)AV_TIME_BASE;
+}
+
+void MediaPlayer::set_ping_pong(bool enabled) {
+    ping_pong_ = enabled;
+    std::cout << "DEBUG: Loop mode " << (enabled ? "ping-pong" : "normal") << std::endl;
+}
+
+void MediaPlayer::apply_decoder_skip_mode() {
+    if (!codec_context_) {
+        return;
+    }
+    
+    // At 2x and above every other frame is never shown at native display rates,
+    // so let the decoder throw away frames nothing else references
+    codec_context_->skip_frame = playback_speed_ >= 2.0 ? AVDISCARD_NONREF : AVDISCARD_DEFAULT;
+}
+
 bool MediaPlayer::is_playing() const {
     return playing_;
 }
@@ -258,6 +329,57 @@ bool MediaPlayer::get_video_frame(unsigned char** frame_data, int* width, int* h
     return get_video_frame_ffmpeg(frame_data, width, height);
 }
 
+static bool is_yuv_passthrough_format(int format) {
+    return format == AV_PIX_FMT_YUV420P || format == AV_PIX_FMT_YUVJ420P || format == AV_PIX_FMT_NV12;
+}
+
+bool MediaPlayer::supports_yuv_output() const {
+    // Reverse frames are presented from the cache through the RGBA conversion
+    return decoder_initialized_ && codec_context_ && !ping_pong_ &&
+           is_yuv_passthrough_format(codec_context_->pix_fmt);
+}
+
+void MediaPlayer::set_yuv_output(bool enabled) {
+    yuv_output_enabled_ = enabled;
+    // The other output buffer is stale, the next frame must be converted
+    last_frame_hash_valid_ = false;
+    std::cout << "DEBUG: YUV passthrough output " << (enabled ? "enabled" : "disabled") << std::endl;
+}
+
+bool MediaPlayer::get_video_frame_yuv(VideoFrame* frame) {
+    if (!initialized_ || !has_video_ || !decoder_initialized_ || !frame || !yuv_output_enabled_) {
+        return false;
+    }
+    
+    if (!extract_next_frame() || !last_frame_is_yuv_) {
+        return false;
+    }
+    
+    // A new reference on the decoder's buffers (no pixel copy) keeps the planes
+    // valid for as long as the caller holds the descriptor
+    AVFrame* reference = av_frame_clone(frame_);
+    if (!reference) {
+        return false;
+    }
+    
+    bool nv12 = reference->format == AV_PIX_FMT_NV12;
+    frame->planes[0] = reference->data[0];
+    frame->planes[1] = reference->data[1];
+    frame->planes[2] = nv12 ? nullptr : reference->data[2];
+    frame->strides[0] = reference->linesize[0];
+    frame->strides[1] = reference->linesize[1];
+    frame->strides[2] = nv12 ? 0 : reference->linesize[2];
+    frame->width = reference->width;
+    frame->height = reference->height;
+    frame->format = nv12 ? VideoPixelFormat::NV12 : VideoPixelFormat::I420;
+    frame->full_range = reference->format == AV_PIX_FMT_YUVJ420P || reference->color_range == AVCOL_RANGE_JPEG;
+    frame->owner = std::shared_ptr<void>(reference, [](void* owned) {
+        AVFrame* owned_frame = static_cast<AVFrame*>(owned);
+        av_frame_free(&owned_frame);
+    });
+    return true;
+}
+
 bool MediaPlayer::set_x11_window(void* display, unsigned long window, int screen) {
     // Store X11 window context for potential video rendering integration
     // For now, this is a no-op since we're using FFmpeg CPU rendering
@@ -345,8 +467,24 @@ bool MediaPlayer::setup_ffmpeg_decoder() {
         std::cout << "DEBUG: No audio stream found in media" << std::endl;
     }
     
-    // Find decoder
-    codec_ = avcodec_find_decoder(format_context_->streams[video_stream_index_]->codecpar->codec_id);
+    // Find decoder: the one `autotune` measured fastest for this codec and
+    // size on this machine, otherwise whichever FFmpeg registered first
+    AVCodecParameters* video_parameters = format_context_->streams[video_stream_index_]->codecpar;
+    DecoderProfile profile;
+    bool tuned = DecoderProfiles::lookup(avcodec_get_name(video_parameters->codec_id),
+                                         video_parameters->width, video_parameters->height, &profile);
+    codec_ = nullptr;
+    if (tuned) {
+        codec_ = avcodec_find_decoder_by_name(profile.decoder.c_str());
+        if (!codec_ || codec_->id != video_parameters->codec_id) {
+            std::cerr << "WARNING: Tuned decoder " << profile.decoder << " is not available, using the default" << std::endl;
+            codec_ = nullptr;
+            tuned = false;
+        }
+    }
+    if (!codec_) {
+        codec_ = avcodec_find_decoder(video_parameters->codec_id);
+    }
     if (!codec_) {
         std::cerr << "Unsupported codec" << std::endl;
         avformat_close_input(&format_context_);
@@ -369,6 +507,16 @@ bool MediaPlayer::setup_ffmpeg_decoder() {
         return false;
     }
     
+    sws_flags_ = SWS_BILINEAR;
+    if (tuned) {
+        codec_context_->thread_count = profile.threads;
+        codec_context_->thread_type = profile.slice_threads ? FF_THREAD_SLICE : FF_THREAD_FRAME;
+        sws_flags_ = profile.sws_flags;
+        std::cout << "DEBUG: Using tuned decoder profile: " << profile.decoder << ", " << profile.threads
+                  << (profile.slice_threads ? " slice" : " frame") << " threads, "
+                  << DecoderProfiles::sws_flags_name(profile.sws_flags) << " scaler" << std::endl;
+    }
+    
     // Open codec
     if (avcodec_open2(codec_context_, codec_, nullptr) < 0) {
         std::cerr << "Could not open codec" << std::endl;
@@ -393,6 +541,17 @@ bool MediaPlayer::setup_ffmpeg_decoder() {
                                   << audio_codec_context_->sample_rate << "Hz, " 
                                   << audio_codec_context_->ch_layout.nb_channels << " channels" << std::endl;
                         
+                        // Connect to PulseAudio on first use
+                        if (!audio_player_) {
+                            audio_player_ = create_audio_output();
+                            if (audio_player_ && !audio_player_->initialize()) {
+                                audio_player_.reset();
+                            }
+                            if (!audio_player_) {
+                                std::cerr << "Warning: Failed to initialize audio player. Audio playback will be disabled." << std::endl;
+                            }
+                        }
+                        
                         // Create PulseAudio stream for audio playback
                         if (audio_player_) {
                             if (audio_player_->create_audio_stream(audio_codec_context_->sample_rate, 
@@ -478,9 +637,10 @@ bool MediaPlayer::setup_ffmpeg_decoder() {
         }
     }
     
-    // Allocate buffer for RGB frame
+    // Allocate buffer for RGB frame (pooled: reopening the same file or a loop
+    // restart gets the same huge-page backed block back)
     int buffer_size = av_image_get_buffer_size(AV_PIX_FMT_RGBA, width_, height_, 1);
-    frame_buffer_ = (unsigned char*)av_malloc(buffer_size);
+    frame_buffer_ = (unsigned char*)FramePool::instance().acquire(buffer_size);
     if (!frame_buffer_) {
         std::cerr << "Could not allocate frame buffer" << std::endl;
         cleanup_ffmpeg_decoder();
@@ -493,13 +653,22 @@ bool MediaPlayer::setup_ffmpeg_decoder() {
     // Create scaling context with vertical flip to fix coordinate system differences
     sws_context_ = sws_getContext(width_, height_, codec_context_->pix_fmt,
                                  width_, height_, AV_PIX_FMT_RGBA,
-                                 SWS_BILINEAR, nullptr, nullptr, nullptr);
+                                 sws_flags_, nullptr, nullptr, nullptr);
     if (!sws_context_) {
         std::cerr << "Could not create scaling context" << std::endl;
         cleanup_ffmpeg_decoder();
         return false;
     }
     
+    apply_decoder_skip_mode();
+    
+    // Start demux read-ahead so decoding is decoupled from file I/O
+    if (!start_demux_thread()) {
+        std::cerr << "Could not start demux read-ahead thread" << std::endl;
+        cleanup_ffmpeg_decoder();
+        return false;
+    }
+    
     decoder_initialized_ = true;
     
     // Initialize timing variables for PTS-based playback
@@ -511,6 +680,7 @@ bool MediaPlayer::setup_ffmpeg_decoder() {
     last_display_time_ = 0.0;
     last_frame_pts_ = 0.0;
     has_cached_frame_ = false;
+    last_frame_hash_valid_ = false;
     
     std::cout << "DEBUG: Video decoder initialized with PTS timing" << std::endl;
     
@@ -518,13 +688,20 @@ bool MediaPlayer::setup_ffmpeg_decoder() {
 }
 
 void MediaPlayer::cleanup_ffmpeg_decoder() {
+    // Demux thread reads from format_context_, stop it before anything is freed
+    stop_demux_thread();
+    clear_reverse_cache();
+    seek_request_ = -1.0;
+    seek_target_pts_ = -1.0;
+    audio_seek_request_ = -1.0;
+    
     if (sws_context_) {
         sws_freeContext(sws_context_);
         sws_context_ = nullptr;
     }
     
     if (frame_buffer_) {
-        av_free(frame_buffer_);
+        FramePool::instance().release(frame_buffer_);
         frame_buffer_ = nullptr;
     }
     
@@ -636,7 +813,7 @@ bool MediaPlayer::load_image_ffmpeg(const std::string& image_path) {
     int rgb_buffer_size;
     rgb_buffer_size = av_image_get_buffer_size(AV_PIX_FMT_RGBA, width_, height_, 1);
     free_image_data();
-    image_data_ = (unsigned char*)av_malloc(rgb_buffer_size);
+    image_data_ = (unsigned char*)FramePool::instance().acquire(rgb_buffer_size);
     if (!image_data_) {
         std::cerr << "Could not allocate image buffer" << std::endl;
         goto cleanup;
@@ -694,7 +871,7 @@ bool MediaPlayer::load_video_ffmpeg(const std::string& video_path) {
 
 void MediaPlayer::free_image_data() {
     if (image_data_) {
-        av_free(image_data_);
+        FramePool::instance().release(image_data_);
         image_data_ = nullptr;
     }
 }
@@ -708,10 +885,27 @@ bool MediaPlayer::extract_next_frame() {
     auto now = std::chrono::high_resolution_clock::now();
     double current_real_time = std::chrono::duration<double>(now.time_since_epoch()).count();
     
-    // Initialize playback start time on first frame
+    // Initialize playback start time on first frame (or after a speed change,
+    // continuing from the frame currently on screen)
     if (playback_start_time_ == 0.0) {
-        playback_start_time_ = current_real_time;
-        video_pts_ = 0.0;
+        playback_start_time_ = current_real_time - (has_cached_frame_ ? last_frame_pts_ / playback_speed_ : 0.0);
+        if (!has_cached_frame_) {
+            video_pts_ = 0.0;
+        }
+    }
+    
+    // Ping-pong: the way back is presented from the GOP caches
+    if (reversing_) {
+        return extract_reverse_frame(current_real_time);
+    }
+    
+    // Slow motion: keep presenting the current frame until the next one is due
+    // instead of decoding (and converting) it early
+    if (playback_speed_ < 1.0 && has_cached_frame_ && media_type_ == MediaType::VIDEO) {
+        double next_frame_time = playback_start_time_ + (last_frame_pts_ + frame_duration_) / playback_speed_;
+        if (current_real_time < next_frame_time) {
+            return true;
+        }
     }
     
     // When frame rate limiting is active (target_display_fps_ < frame_rate_),
@@ -720,67 +914,221 @@ bool MediaPlayer::extract_next_frame() {
     bool fps_limiting_active = frame_rate_limiting_enabled_;
     
     // Log status periodically to ensure frames are being processed at native rate
-    static int frame_counter = 0;
-    if (++frame_counter % 300 == 0) { // Log every ~300 frames
+    if (++extraction_log_counter_ % 300 == 0) { // Log every ~300 frames
+        PacketQueueStats queue_stats = get_demux_queue_stats();
         std::cout << "Frame extraction: Processing at native rate (" << frame_rate_ 
                   << " fps), FPS limiting " << (fps_limiting_active ? "ON" : "OFF")
                   << ", Target display: " << target_display_fps_ << " fps" << std::endl;
+        if (frames_elided_ > 0) {
+            std::cout << "    Duplicate frames elided (no conversion/present): " << frames_elided_ << std::endl;
+        }
+        if (playback_speed_ != 1.0) {
+            std::cout << "    Playback speed: " << playback_speed_ << "x, dropped late frames: " << frames_dropped_
+                      << ", packets skipped (GOP jumps): " << packets_skipped_ << std::endl;
+        }
+        std::cout << "    Demux queue: " << queue_stats.packets << " packets, "
+                  << (queue_stats.bytes / 1024) << " KiB, "
+                  << std::fixed << std::setprecision(2) << queue_stats.seconds << "s buffered, "
+                  << queue_stats.underruns << " underruns" << std::defaultfloat << std::endl;
     }
     
-    AVPacket packet;
-    while (av_read_frame(format_context_, &packet) >= 0) {
-        if (packet.stream_index == video_stream_index_) {
-            if (avcodec_send_packet(codec_context_, &packet) >= 0) {
-                if (avcodec_receive_frame(codec_context_, frame_) >= 0) {
-                    // Calculate frame PTS in seconds
-                    AVRational time_base = format_context_->streams[video_stream_index_]->time_base;
-                    double frame_pts = frame_->pts * av_q2d(time_base);
-                    
-                    if (!fps_limiting_active) {
-                        // Only do timing control when NOT FPS limiting (i.e., running at native speed)
-                        double expected_time = playback_start_time_ + frame_pts;
-                        
-                        // If we're ahead of schedule, wait (this maintains proper video speed)
-                        if (current_real_time < expected_time) {
-                            double wait_time = expected_time - current_real_time;
-                            if (wait_time > 0.0 && wait_time < 0.1) { // Wait max 100ms
-                                std::this_thread::sleep_for(std::chrono::duration<double>(wait_time));
-                            }
-                        }
-                    } else {
-                        // When FPS limiting is active, we don't pause for timing
-                        // Instead, we process frames as quickly as possible and let
-                        // should_display_frame() control which frames to actually show
-                        // This ensures that in window mode, frames are still processed
-                        // at the native rate even if displayed at a different rate
+    int consecutive_drops = 0;
+    while (true) {
+        PacketQueue::PopResult result = packet_queue_->pop(video_packet_);
+        if (result == PacketQueue::PopResult::ABORTED) {
+            return false;
+        }
+        if (result == PacketQueue::PopResult::LOOP) {
+            // End of file, demux thread already rewound - restart timing for continuous playback
+            avcodec_flush_buffers(codec_context_);
+            skip_to_keyframe_ = false;
+            last_frame_hash_valid_ = false;
+            video_pts_ = 0.0;
+            auto loop_now = std::chrono::high_resolution_clock::now();
+            current_real_time = std::chrono::duration<double>(loop_now.time_since_epoch()).count();
+            playback_start_time_ = current_real_time; // Reset timing for loop
+            continue;
+        }
+        if (result == PacketQueue::PopResult::SEGMENT) {
+            // Ping-pong: end of the forward pass, the reversed GOPs follow
+            begin_reverse();
+            return extract_reverse_frame(current_real_time);
+        }
+        if (result == PacketQueue::PopResult::SEEK) {
+            apply_seek_marker();
+            continue;
+        }
+        
+        // GOP jump: nothing is decoded until the next keyframe arrives
+        if (skip_to_keyframe_) {
+            if (!(video_packet_->flags & AV_PKT_FLAG_KEY)) {
+                packets_skipped_++;
+                av_packet_unref(video_packet_);
+                continue;
+            }
+            // Drop the late frames still queued for reordering and the references the
+            // skipped packets would have updated, so decoding restarts clean at the keyframe
+            avcodec_flush_buffers(codec_context_);
+            skip_to_keyframe_ = false;
+        }
+        
+        if (avcodec_send_packet(codec_context_, video_packet_) >= 0) {
+            if (avcodec_receive_frame(codec_context_, frame_) >= 0) {
+                // Calculate frame PTS in seconds
+                AVRational time_base = format_context_->streams[video_stream_index_]->time_base;
+                double frame_pts = frame_->pts * av_q2d(time_base);
+                
+                // Seek: the GOP is decoded from its keyframe, only the target is shown
+                if (seek_target_pts_ >= 0.0) {
+                    if (frame_pts + frame_duration_ / 2 < seek_target_pts_) {
+                        av_packet_unref(video_packet_);
+                        continue;
                     }
+                    seek_target_pts_ = -1.0;
+                    auto seek_now = std::chrono::high_resolution_clock::now();
+                    current_real_time = std::chrono::duration<double>(seek_now.time_since_epoch()).count();
+                    playback_start_time_ = current_real_time - frame_pts / playback_speed_;
+                }
+                
+                if (playback_speed_ > 1.0) {
+                    // Fast playback: frames that are already late are dropped before the
+                    // RGBA conversion, and if we are far behind the rest of the GOP is skipped
+                    auto decode_now = std::chrono::high_resolution_clock::now();
+                    double decode_time = std::chrono::duration<double>(decode_now.time_since_epoch()).count();
+                    double lateness = decode_time - (playback_start_time_ + frame_pts / playback_speed_);
                     
-                    // Update video clock with current frame PTS
-                    video_pts_ = frame_pts;
+                    if (lateness > GOP_SKIP_LATENESS) {
+                        skip_to_keyframe_ = true;
+                    }
+                    if (lateness > frame_duration_ / playback_speed_ && consecutive_drops < MAX_CONSECUTIVE_DROPS) {
+                        consecutive_drops++;
+                        frames_dropped_++;
+                        av_packet_unref(video_packet_);
+                        continue;
+                    }
+                }
+                
+                if (!fps_limiting_active) {
+                    // Only do timing control when NOT FPS limiting (i.e., running at native speed)
+                    double expected_time = playback_start_time_ + frame_pts / playback_speed_;
                     
+                    // If we're ahead of schedule, wait (this maintains proper video speed)
+                    if (current_real_time < expected_time) {
+                        double wait_time = expected_time - current_real_time;
+                        if (wait_time > 0.0 && wait_time < 0.1) { // Wait max 100ms
+                            std::this_thread::sleep_for(std::chrono::duration<double>(wait_time));
+                        }
+                    }
+                } else {
+                    // When FPS limiting is active, we don't pause for timing
+                    // Instead, we process frames as quickly as possible and let
+                    // should_display_frame() control which frames to actually show
+                    // This ensures that in window mode, frames are still processed
+                    // at the native rate even if displayed at a different rate
+                }
+                
+                // Update video clock with current frame PTS
+                video_pts_ = frame_pts;
+                
+                // Renderer consumes planar YUV directly - skip CPU color conversion
+                bool frame_is_yuv = yuv_output_enabled_ && is_yuv_passthrough_format(frame_->format);
+                
+                // Static stretch: the picture did not change, so the converted buffer
+                // and whatever is on screen are still current - keep the serial as is
+                if (is_duplicate_frame(video_packet_->size, frame_is_yuv)) {
+                    frames_elided_++;
+                    av_packet_unref(video_packet_);
+                    has_cached_frame_ = true;
+                    last_frame_pts_ = frame_pts;
+                    return true;
+                }
+                
+                last_frame_is_yuv_ = frame_is_yuv;
+                frame_serial_++;
+                
+                if (!last_frame_is_yuv_) {
                     // Standard RGBA conversion without flipping
                     uint8_t* dst_data[4] = { rgb_frame_->data[0], nullptr, nullptr, nullptr };
                     int dst_linesize[4] = { rgb_frame_->linesize[0], 0, 0, 0 };
                     
                     sws_scale(sws_context_, frame_->data, frame_->linesize, 0, height_,
                              dst_data, dst_linesize);
-                    
-                    av_packet_unref(&packet);
-                    has_cached_frame_ = true;
-                    last_frame_pts_ = frame_pts;
-                    
-                    return true;
                 }
+                
+                av_packet_unref(video_packet_);
+                has_cached_frame_ = true;
+                last_frame_pts_ = frame_pts;
+                
+                return true;
             }
         }
-        av_packet_unref(&packet);
+        av_packet_unref(video_packet_);
+    }
+}
+
+// FNV-1a over every visible byte of every plane (row padding excluded), so a
+// change confined to a few pixels - a cinemagraph's moving corner - still
+// yields a different hash. Only skip candidates pay for the full pass.
+static bool frame_content_hash(const AVFrame* frame, uint64_t* hash) {
+    AVPixelFormat format = static_cast<AVPixelFormat>(frame->format);
+    const AVPixFmtDescriptor* desc = av_pix_fmt_desc_get(format);
+    int planes = av_pix_fmt_count_planes(format);
+    if (!desc || planes <= 0) {
+        return false;
     }
     
-    // End of file, loop back to beginning for continuous playback
-    av_seek_frame(format_context_, video_stream_index_, 0, AVSEEK_FLAG_BACKWARD);
-    video_pts_ = 0.0;
-    playback_start_time_ = current_real_time; // Reset timing for loop
-    return extract_next_frame();
+    uint64_t h = 1469598103934665603ULL;
+    for (int plane = 0; plane < planes; plane++) {
+        int row_bytes = av_image_get_linesize(format, frame->width, plane);
+        if (!frame->data[plane] || row_bytes <= 0) {
+            return false;
+        }
+        bool chroma = (plane == 1 || plane == 2) && !(desc->flags & AV_PIX_FMT_FLAG_RGB);
+        int plane_height = chroma ? -((-frame->height) >> desc->log2_chroma_h) : frame->height;
+        for (int y = 0; y < plane_height; y++) {
+            const uint8_t* row = frame->data[plane] + (ptrdiff_t)y * frame->linesize[plane];
+            int x = 0;
+            for (; x + 8 <= row_bytes; x += 8) {
+                uint64_t word;
+                std::memcpy(&word, row + x, sizeof(word));
+                h = (h ^ word) * 1099511628211ULL;
+            }
+            for (; x < row_bytes; x++) {
+                h = (h ^ row[x]) * 1099511628211ULL;
+            }
+        }
+    }
+    *hash = h;
+    return true;
+}
+
+bool MediaPlayer::is_duplicate_frame(int packet_size, bool yuv_frame) {
+    // Never elide across a geometry/format change, the first frame after a
+    // load or loop, or when the frame goes to a different output buffer
+    bool comparable = last_frame_hash_valid_ && has_cached_frame_ &&
+                      frame_->width == last_frame_width_ && frame_->height == last_frame_height_ &&
+                      frame_->format == last_frame_format_ && yuv_frame == last_frame_is_yuv_;
+    last_frame_width_ = frame_->width;
+    last_frame_height_ = frame_->height;
+    last_frame_format_ = frame_->format;
+    
+    // Decoder hint: skipped-macroblock P/B frames encode to a handful of bytes.
+    // Normally-sized packets are real motion and are not hashed at all, which
+    // also means the next candidate has nothing to compare against
+    int hint_bytes = std::max(DUPLICATE_PACKET_MIN_BYTES, (width_ * height_) / DUPLICATE_PACKET_PIXELS_PER_BYTE);
+    bool hinted = packet_size <= hint_bytes && frame_->pict_type != AV_PICTURE_TYPE_I;
+    if (!hinted) {
+        last_frame_hash_valid_ = false;
+        return false;
+    }
+    
+    uint64_t hash = 0;
+    bool hashed = frame_content_hash(frame_, &hash);
+    bool duplicate = comparable && hashed && hash == last_frame_hash_;
+    
+    last_frame_hash_ = hash;
+    last_frame_hash_valid_ = hashed;
+    return duplicate;
 }
 
 bool MediaPlayer::is_supported_format(const std::string& file_path) {
@@ -800,41 +1148,393 @@ bool MediaPlayer::get_video_frame_native(AVFrame** frame) {
     // Extract the next frame using FFmpeg directly
     // This avoids the RGB conversion that happens in get_video_frame_ffmpeg
     
+    // Packets come from the demux read-ahead queue (video stream only)
+    while (packet_queue_->pop(video_packet_) == PacketQueue::PopResult::PACKET) {
+        // Send packet to decoder
+        int ret = avcodec_send_packet(codec_context_, video_packet_);
+        if (ret < 0) {
+            av_packet_unref(video_packet_);
+            continue;
+        }
+        
+        // Receive decoded frame
+        ret = avcodec_receive_frame(codec_context_, frame_);
+        av_packet_unref(video_packet_);
+        if (ret == 0) {
+            // Successfully decoded frame
+            *frame = frame_;
+            
+            // Update timing
+            current_time_ += frame_duration_;
+            
+            return true;
+        }
+    }
+    
+    // End of stream (demuxer looped) or queue aborted
+    avcodec_flush_buffers(codec_context_);
+    return false;
+}
+
+bool MediaPlayer::start_demux_thread() {
+    if (!packet_queue_) {
+        packet_queue_ = std::make_unique<PacketQueue>(DEMUX_QUEUE_MAX_BYTES, DEMUX_QUEUE_MAX_SECONDS);
+    } else {
+        packet_queue_->reset();
+    }
+    
+    if (!video_packet_) {
+        video_packet_ = av_packet_alloc();
+        if (!video_packet_) {
+            return false;
+        }
+    }
+    
+    // A previously built index makes the first seek (resume, random start) one GOP
+    keyframe_index_.load(current_media_, video_stream_index_);
+    
+    demux_thread_running_ = true;
+    demux_thread_ = std::make_unique<std::thread>(&MediaPlayer::demux_thread_function, this);
+    return true;
+}
+
+void MediaPlayer::stop_demux_thread() {
+    if (demux_thread_running_) {
+        demux_thread_running_ = false;
+        // Wake the thread if it is blocked on a full queue
+        if (packet_queue_) {
+            packet_queue_->abort();
+        }
+        if (demux_thread_ && demux_thread_->joinable()) {
+            demux_thread_->join();
+        }
+        demux_thread_.reset();
+    }
+    
+    if (packet_queue_) {
+        packet_queue_->flush();
+    }
+    
+    if (video_packet_) {
+        av_packet_free(&video_packet_);
+    }
+}
+
+void MediaPlayer::demux_thread_function() {
+    std::cout << "DEBUG: Demux read-ahead thread started (max " 
+              << (DEMUX_QUEUE_MAX_BYTES / (1024 * 1024)) << " MiB / " 
+              << DEMUX_QUEUE_MAX_SECONDS << "s)" << std::endl;
+    
     AVPacket* packet = av_packet_alloc();
-    if (!packet) {
-        return false;
+    AVRational time_base = format_context_->streams[video_stream_index_]->time_base;
+    bool read_since_loop = false;
+    bool pass_from_start = true;        // Only a pass that began at 0 can complete the index
+    std::vector<int64_t> keyframes;     // Keyframe pts of the current forward pass
+    
+    while (demux_thread_running_ && packet) {
+        double seek_target = seek_request_.exchange(-1.0);
+        if (seek_target >= 0.0) {
+            int64_t target = (int64_t)(seek_target / av_q2d(time_base));
+            int64_t keyframe = keyframe_index_.empty() ? target : keyframe_index_.find(target);
+            if (av_seek_frame(format_context_, video_stream_index_, keyframe, AVSEEK_FLAG_BACKWARD) < 0) {
+                std::cerr << "WARNING: Seek to " << seek_target << "s failed" << std::endl;
+                continue;
+            }
+            seek_marker_target_ = seek_target;
+            if (!packet_queue_->push_seek_marker()) {
+                break;
+            }
+            keyframes.clear();
+            if (!keyframe_index_.is_complete()) {
+                // Rebuilt on the next pass from the start
+                keyframe_index_.reset();
+                pass_from_start = false;
+            }
+            read_since_loop = true;
+            continue;
+        }
+        
+        if (av_read_frame(format_context_, packet) < 0) {
+            // End of file (or read error), rewind and tell the decoder where the loop happened
+            if (read_since_loop && pass_from_start && !keyframe_index_.is_complete() && !keyframe_index_.empty()) {
+                keyframe_index_.set_complete(true);
+                keyframe_index_.save();
+            }
+            
+            if (!read_since_loop) {
+                // Nothing readable since the last rewind, avoid spinning on a broken file
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            } else if (ping_pong_ && !keyframes.empty()) {
+                // A complete index also covers the GOPs before a seek
+                const std::vector<int64_t>& reverse_keyframes =
+                    keyframe_index_.is_complete() ? keyframe_index_.get_keyframes() : keyframes;
+                if (!packet_queue_->push_segment_marker() || !demux_reverse_pass(packet, reverse_keyframes) ||
+                    !packet_queue_->push_loop_marker()) {
+                    break;
+                }
+            } else if (!packet_queue_->push_loop_marker()) {
+                break;
+            }
+            av_seek_frame(format_context_, video_stream_index_, 0, AVSEEK_FLAG_BACKWARD);
+            read_since_loop = false;
+            pass_from_start = true;
+            keyframes.clear();
+            continue;
+        }
+        
+        // Audio is demuxed separately by the audio thread, only queue video packets
+        if (packet->stream_index != video_stream_index_) {
+            av_packet_unref(packet);
+            continue;
+        }
+        
+        if ((packet->flags & AV_PKT_FLAG_KEY) && packet->pts != AV_NOPTS_VALUE &&
+            (keyframes.empty() || packet->pts > keyframes.back())) {
+            keyframes.push_back(packet->pts);
+            if (pass_from_start && !keyframe_index_.is_complete()) {
+                keyframe_index_.add(packet->pts);
+            }
+        }
+        read_since_loop = true;
+        double duration = packet->duration > 0 ? packet->duration * av_q2d(time_base) : frame_duration_;
+        if (!packet_queue_->push(packet, duration)) {
+            av_packet_unref(packet);
+            break;
+        }
     }
     
-    while (av_read_frame(format_context_, packet) >= 0) {
-        if (packet->stream_index == video_stream_index_) {
-            // Send packet to decoder
-            int ret = avcodec_send_packet(codec_context_, packet);
-            if (ret < 0) {
+    if (packet) {
+        av_packet_free(&packet);
+    }
+    
+    std::cout << "DEBUG: Demux read-ahead thread ended" << std::endl;
+}
+
+bool MediaPlayer::demux_reverse_pass(AVPacket* packet, const std::vector<int64_t>& keyframes) {
+    AVRational time_base = format_context_->streams[video_stream_index_]->time_base;
+    
+    // Last GOP first; each one is read from its keyframe up to the next one
+    // and closed with a SEGMENT marker so the decoder knows it is complete
+    for (size_t g = keyframes.size(); g-- > 0;) {
+        if (!demux_thread_running_) {
+            return false;
+        }
+        if (av_seek_frame(format_context_, video_stream_index_, keyframes[g], AVSEEK_FLAG_BACKWARD) < 0) {
+            std::cerr << "WARNING: Ping-pong seek failed, skipping GOP " << g << std::endl;
+            continue;
+        }
+        
+        bool in_gop = false;
+        while (demux_thread_running_ && av_read_frame(format_context_, packet) >= 0) {
+            if (packet->stream_index != video_stream_index_) {
                 av_packet_unref(packet);
                 continue;
             }
+            bool keyframe = (packet->flags & AV_PKT_FLAG_KEY) != 0;
+            if (!in_gop) {
+                // The seek may land on an earlier keyframe than the one asked for
+                in_gop = keyframe && packet->pts == keyframes[g];
+                if (!in_gop) {
+                    av_packet_unref(packet);
+                    continue;
+                }
+            } else if (keyframe && packet->pts != keyframes[g]) {
+                av_packet_unref(packet);
+                break;
+            }
             
-            // Receive decoded frame
-            ret = avcodec_receive_frame(codec_context_, frame_);
-            if (ret == 0) {
-                // Successfully decoded frame
-                *frame = frame_;
-                av_packet_free(&packet);
-                
-                // Update timing
-                current_time_ += frame_duration_;
-                
-                return true;
+            double duration = packet->duration > 0 ? packet->duration * av_q2d(time_base) : frame_duration_;
+            if (!packet_queue_->push(packet, duration)) {
+                av_packet_unref(packet);
+                return false;
             }
         }
-        av_packet_unref(packet);
+        if (!packet_queue_->push_segment_marker()) {
+            return false;
+        }
+    }
+    return demux_thread_running_;
+}
+
+void MediaPlayer::begin_reverse() {
+    // The tail frames still buffered in the decoder were never shown going
+    // forward, so the turnaround happens on the last frame that was
+    avcodec_flush_buffers(codec_context_);
+    skip_to_keyframe_ = false;
+    clear_reverse_cache();
+    reversing_ = true;
+    reverse_end_pts_ = last_frame_pts_;
+    reverse_start_time_ = playback_start_time_ + last_frame_pts_ / playback_speed_;
+    
+    int frame_bytes = av_image_get_buffer_size(codec_context_->pix_fmt, width_, height_, 1);
+    reverse_cache_limit_ = frame_bytes > 0 ? std::max<size_t>(2, PINGPONG_CACHE_MAX_BYTES / 2 / frame_bytes) : 2;
+    std::cout << "DEBUG: Ping-pong reverse pass started (up to " << reverse_cache_limit_
+              << " cached frames per GOP)" << std::endl;
+}
+
+void MediaPlayer::cache_reverse_frame() {
+    AVRational time_base = format_context_->streams[video_stream_index_]->time_base;
+    double frame_pts = frame_->pts * av_q2d(time_base);
+    
+    // Only the turnaround GOP reaches past the frame shown last
+    if (frame_pts >= reverse_end_pts_ || reverse_gop_frames_++ % reverse_keep_every_ != 0) {
+        av_frame_unref(frame_);
+        return;
     }
     
-    // End of stream or error
-    av_packet_free(&packet);
+    AVFrame* cached = av_frame_clone(frame_);
+    av_frame_unref(frame_);
+    if (!cached) {
+        return;
+    }
+    reverse_filling_.push_back(cached);
     
-    // End of stream or error
-    return false;
+    // GOP longer than the cache: keep every other frame from here on, so the
+    // way back plays at a lower frame rate instead of growing without bound
+    if (reverse_filling_.size() > reverse_cache_limit_) {
+        size_t kept = 0;
+        for (size_t i = 0; i < reverse_filling_.size(); i++) {
+            if (i % 2 == 0) {
+                reverse_filling_[kept++] = reverse_filling_[i];
+            } else {
+                av_frame_free(&reverse_filling_[i]);
+            }
+        }
+        reverse_filling_.resize(kept);
+        reverse_keep_every_ *= 2;
+    }
+}
+
+bool MediaPlayer::extract_reverse_frame(double current_real_time) {
+    bool fps_limiting_active = frame_rate_limiting_enabled_;
+    AVRational time_base = format_context_->streams[video_stream_index_]->time_base;
+    int consecutive_drops = 0;
+    
+    while (true) {
+        // Fill: a couple of frames of the next GOP per presented frame, or the
+        // whole GOP when nothing is left to present
+        int budget = PINGPONG_DECODES_PER_CALL;
+        while (!reverse_fill_complete_ && !reverse_done_ && (budget > 0 || reverse_presenting_.empty())) {
+            PacketQueue::PopResult result = packet_queue_->pop(video_packet_);
+            if (result == PacketQueue::PopResult::ABORTED) {
+                return false;
+            }
+            if (result == PacketQueue::PopResult::LOOP) {
+                reverse_done_ = true;
+                break;
+            }
+            if (result == PacketQueue::PopResult::SEEK) {
+                apply_seek_marker();
+                return extract_next_frame();
+            }
+            if (result == PacketQueue::PopResult::SEGMENT) {
+                // GOP complete: drain the frames the decoder still holds
+                avcodec_send_packet(codec_context_, nullptr);
+                while (avcodec_receive_frame(codec_context_, frame_) >= 0) {
+                    cache_reverse_frame();
+                }
+                avcodec_flush_buffers(codec_context_);
+                reverse_fill_complete_ = true;
+                break;
+            }
+            if (avcodec_send_packet(codec_context_, video_packet_) >= 0) {
+                while (avcodec_receive_frame(codec_context_, frame_) >= 0) {
+                    cache_reverse_frame();
+                    budget--;
+                }
+            }
+            av_packet_unref(video_packet_);
+        }
+        
+        if (reverse_presenting_.empty()) {
+            if (reverse_fill_complete_) {
+                reverse_presenting_.swap(reverse_filling_);
+                reverse_fill_complete_ = false;
+                reverse_keep_every_ = 1;
+                reverse_gop_frames_ = 0;
+                continue;
+            }
+            if (reverse_done_) {
+                // Back at the start: forward playback resumes like a normal loop
+                clear_reverse_cache();
+                avcodec_flush_buffers(codec_context_);
+                last_frame_hash_valid_ = false;
+                video_pts_ = 0.0;
+                playback_start_time_ = current_real_time;
+                return extract_next_frame();
+            }
+            continue;
+        }
+        
+        AVFrame* cached = reverse_presenting_.back();
+        double frame_pts = cached->pts * av_q2d(time_base);
+        double expected_time = reverse_start_time_ + (reverse_end_pts_ - frame_pts) / playback_speed_;
+        
+        auto present_now = std::chrono::high_resolution_clock::now();
+        current_real_time = std::chrono::duration<double>(present_now.time_since_epoch()).count();
+        if (!fps_limiting_active && current_real_time - expected_time > frame_duration_ / playback_speed_ &&
+            reverse_presenting_.size() > 1 && consecutive_drops < MAX_CONSECUTIVE_DROPS) {
+            consecutive_drops++;
+            frames_dropped_++;
+            av_frame_free(&cached);
+            reverse_presenting_.pop_back();
+            continue;
+        }
+        
+        if (!fps_limiting_active && current_real_time < expected_time) {
+            double wait_time = expected_time - current_real_time;
+            if (wait_time < 0.1) { // Wait max 100ms, same as forward
+                std::this_thread::sleep_for(std::chrono::duration<double>(wait_time));
+            }
+        }
+        
+        uint8_t* dst_data[4] = { rgb_frame_->data[0], nullptr, nullptr, nullptr };
+        int dst_linesize[4] = { rgb_frame_->linesize[0], 0, 0, 0 };
+        sws_scale(sws_context_, cached->data, cached->linesize, 0, height_, dst_data, dst_linesize);
+        
+        last_frame_is_yuv_ = false;
+        frame_serial_++;
+        video_pts_ = frame_pts;
+        last_frame_pts_ = frame_pts;
+        has_cached_frame_ = true;
+        
+        av_frame_free(&cached);
+        reverse_presenting_.pop_back();
+        return true;
+    }
+}
+
+void MediaPlayer::apply_seek_marker() {
+    avcodec_flush_buffers(codec_context_);
+    clear_reverse_cache();
+    skip_to_keyframe_ = false;
+    last_frame_hash_valid_ = false;
+    seek_target_pts_ = seek_marker_target_;
+    video_pts_ = seek_target_pts_;
+    last_frame_pts_ = seek_target_pts_;
+}
+
+void MediaPlayer::clear_reverse_cache() {
+    for (AVFrame* cached : reverse_filling_) {
+        av_frame_free(&cached);
+    }
+    for (AVFrame* cached : reverse_presenting_) {
+        av_frame_free(&cached);
+    }
+    reverse_filling_.clear();
+    reverse_presenting_.clear();
+    reversing_ = false;
+    reverse_done_ = false;
+    reverse_fill_complete_ = false;
+    reverse_keep_every_ = 1;
+    reverse_gop_frames_ = 0;
+}
+
+PacketQueueStats MediaPlayer::get_demux_queue_stats() const {
+    if (!packet_queue_) {
+        return PacketQueueStats();
+    }
+    return packet_queue_->get_stats();
 }
 
 bool MediaPlayer::process_audio_frame() {
@@ -934,6 +1634,16 @@ void MediaPlayer::audio_thread_function() {
     // Audio processing loop
     AVPacket* packet = av_packet_alloc();
     while (audio_thread_running_ && packet) {
+        // Start position and later seeks, so audio stays with the video
+        double seek_target = audio_seek_request_.exchange(-1.0);
+        if (seek_target >= 0.0) {
+            int64_t target = (int64_t)(seek_target * AV_TIME_BASE);
+            if (av_seek_frame(audio_format_context, -1, target, AVSEEK_FLAG_BACKWARD) < 0) {
+                std::cerr << "WARNING: Audio seek to " << seek_target << "s failed" << std::endl;
+            }
+            avcodec_flush_buffers(audio_codec_context);
+        }
+        
         // Check if playback is active and not muted
         if (!playing_ || muted_) {
             std::this_thread::sleep_for(std::chrono::milliseconds(10));
@@ -1034,61 +1744,55 @@ void MediaPlayer::process_audio_frame_data(AVFrame* frame, AVCodecContext* codec
     // Send audio data to PulseAudio
     if (!audio_player_->write_audio_data(output_buffer.data(), output_size)) {
         // If write fails, don't spam errors, just continue
-        static int error_count = 0;
-        if (error_count < 5) {
+        if (audio_write_errors_ < 5) {
             std::cerr << "WARNING: Failed to write audio data" << std::endl;
-            error_count++;
+            audio_write_errors_++;
         }
     }
 }
 
 bool MediaPlayer::should_display_frame() {
     // Use steady_clock for more accurate timing and prevent drift
-    static auto last_display_time = std::chrono::steady_clock::now();
-    static int frames_skipped = 0;
-    static int frames_displayed = 0;
-    static int frames_processed = 0;
-    static auto last_stats_time = std::chrono::steady_clock::now();
     auto now = std::chrono::steady_clock::now();
     
     // Always count processed frames regardless of display decision
-    frames_processed++;
+    pacing_frames_processed_++;
     
     // IMPORTANT: When frame rate limiting is disabled, always display frames
     // This is critical for:
     // 1. When target FPS matches or exceeds native video FPS
     // 2. When using SDL2 window display (which does its own frame rate limiting)
     if (!frame_rate_limiting_enabled_) {
-        frames_displayed++;
+        pacing_frames_displayed_++;
         return true;
     }
     
     // Calculate time since last display
-    auto time_since_last_display = std::chrono::duration_cast<std::chrono::microseconds>(now - last_display_time);
+    auto time_since_last_display = std::chrono::duration_cast<std::chrono::microseconds>(now - pacing_last_display_);
     
     // Calculate target frame interval based on display FPS (in microseconds for precision)
     auto target_interval = std::chrono::microseconds(static_cast<int64_t>(1000000.0 / target_display_fps_));
     
     // If enough time has passed according to display FPS, we should display
     if (time_since_last_display >= target_interval) {
-        last_display_time = now;
-        frames_displayed++;
+        pacing_last_display_ = now;
+        pacing_frames_displayed_++;
         
         // Print frame skipping stats every 5 seconds
-        auto stats_elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - last_stats_time);
+        auto stats_elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - pacing_stats_start_);
         if (stats_elapsed.count() >= 5) {
             // Always print stats for debugging purposes
-            double actual_display_fps = frames_displayed / static_cast<double>(stats_elapsed.count());
-            double actual_processed_fps = frames_processed / static_cast<double>(stats_elapsed.count());
+            double actual_display_fps = pacing_frames_displayed_ / static_cast<double>(stats_elapsed.count());
+            double actual_processed_fps = pacing_frames_processed_ / static_cast<double>(stats_elapsed.count());
             
             if (frame_rate_limiting_enabled_) {
                 double expected_skip_ratio = 1.0 - (target_display_fps_ / frame_rate_);
                 int expected_frames = static_cast<int>(frame_rate_ * stats_elapsed.count()); // Total frames in period
                 int expected_skipped = static_cast<int>(expected_frames * expected_skip_ratio);
                 
-                std::cout << "FRAME SKIP STATS: Displayed " << frames_displayed 
-                          << " frames, skipped " << frames_skipped 
-                          << " frames, processed " << frames_processed << " frames in "
+                std::cout << "FRAME SKIP STATS: Displayed " << pacing_frames_displayed_ 
+                          << " frames, skipped " << pacing_frames_skipped_ 
+                          << " frames, processed " << pacing_frames_processed_ << " frames in "
                           << stats_elapsed.count() << "s" << std::endl;
                 std::cout << "    Display FPS: " << actual_display_fps 
                           << ", Processing FPS: " << actual_processed_fps
@@ -1096,18 +1800,18 @@ bool MediaPlayer::should_display_frame() {
                           << ", Native: " << frame_rate_ << std::endl;
                           
                 std::cout << "    Expected skip ratio: " << (expected_skip_ratio * 100) << "%, "
-                          << "Actual skip ratio: " << ((frames_processed - frames_displayed) * 100.0 / frames_processed) << "%"
+                          << "Actual skip ratio: " << ((pacing_frames_processed_ - pacing_frames_displayed_) * 100.0 / pacing_frames_processed_) << "%"
                           << std::endl;
             } else {
-                std::cout << "FPS STATS: Displayed " << frames_displayed << " frames in "
+                std::cout << "FPS STATS: Displayed " << pacing_frames_displayed_ << " frames in "
                           << stats_elapsed.count() << "s (Effective FPS: " << actual_display_fps
                           << ", Target: " << target_display_fps_ << ")" << std::endl;
             }
             
-            frames_skipped = 0;
-            frames_displayed = 0;
-            frames_processed = 0;
-            last_stats_time = now;
+            pacing_frames_skipped_ = 0;
+            pacing_frames_displayed_ = 0;
+            pacing_frames_processed_ = 0;
+            pacing_stats_start_ = now;
         }
         
         return true;
@@ -1115,11 +1819,11 @@ bool MediaPlayer::should_display_frame() {
     
     // Count skipped frames for diagnostics and print more detailed frame skip information
     if (frame_rate_limiting_enabled_) {
-        frames_skipped++;
+        pacing_frames_skipped_++;
         
         // Every 50 skipped frames in a row, print a message to confirm frame skipping is working
-        if (frames_skipped % 50 == 0) {
-            std::cout << "Frame skipping active: Skipped " << frames_skipped 
+        if (pacing_frames_skipped_ % 50 == 0) {
+            std::cout << "Frame skipping active: Skipped " << pacing_frames_skipped_ 
                       << " consecutive frames (Target FPS: " << target_display_fps_ 
                       << ", Native FPS: " << frame_rate_ << ")" << std::endl;
         }
@@ -3,7 +3,14 @@
 #include <string>
 #include <memory>
 #include <thread>
+#include <vector>
 #include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "packet_queue.h"
+#include "keyframe_index.h"
+#include "display/video_frame.h"
 
 // Forward declarations for FFmpeg
 extern "C" {
@@ -11,12 +18,13 @@ struct AVFormatContext;
 struct AVCodecContext;
 struct AVCodec;
 struct AVFrame;
+struct AVPacket;
 struct SwsContext;
 struct AVRational;
 }
 
-// Forward declaration for PulseAudio
-class PulseAudio;
+// Forward declaration for the audio backend interface
+class AudioOutput;
 
 enum class MediaType {
     VIDEO,
@@ -42,6 +50,24 @@ public:
     void set_muted(bool muted);     // Audio mute control  
     void set_fps_limit(int fps);    // Frame rate limiting for video playback
     
+    // Playback rate (0.25x-4x). Above 1x the decoder skips work (non-reference
+    // frames, rest of the GOP when late); below 1x the current frame is held
+    void set_playback_speed(double speed);
+    double get_playback_speed() const;
+    
+    // Ping-pong loop: at the end of the file play back to the start in reverse
+    // instead of jumping to it. Each GOP is decoded forward once into a bounded
+    // frame cache that is then presented backwards.
+    void set_ping_pong(bool enabled);
+    bool get_ping_pong() const { return ping_pong_; }
+    
+    // Accurate seek, used for --start. The demux thread jumps to the keyframe at
+    // or before the target (from the persisted keyframe index once it exists);
+    // frames up to the target are decoded but never converted or shown
+    void seek(double seconds);
+    double get_position() const { return video_pts_; }
+    double get_duration() const;
+    
     bool is_playing() const;
     bool is_video() const;
     bool is_audio_enabled() const;
@@ -63,6 +89,14 @@ public:
     // Get video frame data (primary method - uses best available method)
     bool get_video_frame(unsigned char** frame_data, int* width, int* height);
     
+    // YUV passthrough: skip sws_scale RGBA conversion when the renderer
+    // can consume planar YUV directly (I420/NV12 decoder output only)
+    bool supports_yuv_output() const;
+    void set_yuv_output(bool enabled);
+    // Describes the decoded planes in place; the descriptor's owner holds a
+    // reference on the decoder buffers, so no pixels are copied
+    bool get_video_frame_yuv(VideoFrame* frame);
+    
     // Set X11 window for video rendering context
     bool set_x11_window(void* display, unsigned long window, int screen);
     
@@ -81,6 +115,18 @@ public:
     // Display timing control
     bool should_display_frame(); // Check if it's time to display current frame based on display FPS
 
+    // Demux read-ahead queue depth (for stats reporting)
+    PacketQueueStats get_demux_queue_stats() const;
+    
+    // Duplicate-frame elision: the serial only advances when the decoded picture
+    // actually changed, so callers can skip presenting a frame they already showed
+    uint64_t get_frame_serial() const { return frame_serial_; }
+    int get_frames_elided() const { return frames_elided_; }
+    
+    // For the stats overlay
+    double get_frame_rate() const { return frame_rate_; }
+    int get_frames_dropped() const { return frames_dropped_; }
+
 private:
     bool initialized_;
     bool playing_;
@@ -103,6 +149,7 @@ private:
     AVFrame* frame_;
     AVFrame* rgb_frame_;
     SwsContext* sws_context_;
+    int sws_flags_;                 // Scaler algorithm (SWS_BILINEAR unless a decoder profile says otherwise)
     int video_stream_index_;
     unsigned char* frame_buffer_;
     
@@ -137,12 +184,16 @@ private:
     double last_display_time_;       // When we last displayed a frame
     bool has_cached_frame_;          // Whether we have a decoded frame ready
     
+    // YUV passthrough (RGBA conversion skipped for current frame)
+    bool yuv_output_enabled_;
+    bool last_frame_is_yuv_;
+    
     // Audio control
     int volume_;        // 0-100
     bool muted_;
     
     // Audio playback
-    std::unique_ptr<PulseAudio> audio_player_;
+    std::unique_ptr<AudioOutput> audio_player_;
     AVFrame* audio_frame_;          // Frame for audio decoding
     bool audio_playback_enabled_;   // Whether audio playback is active
     
@@ -151,6 +202,70 @@ private:
     std::atomic<bool> audio_thread_running_;
     std::string audio_file_path_;   // Separate path for audio thread
     
+    // Demux read-ahead: a dedicated thread reads packets ahead of the decoder
+    // so storage latency spikes are absorbed by the queue
+    static constexpr size_t DEMUX_QUEUE_MAX_BYTES = 32 * 1024 * 1024;
+    static constexpr double DEMUX_QUEUE_MAX_SECONDS = 2.0;
+    std::unique_ptr<PacketQueue> packet_queue_;
+    std::unique_ptr<std::thread> demux_thread_;
+    std::atomic<bool> demux_thread_running_;
+    AVPacket* video_packet_;        // Packet popped from the queue for decoding
+    
+    // Playback rate control
+    static constexpr double MIN_PLAYBACK_SPEED = 0.25;
+    static constexpr double MAX_PLAYBACK_SPEED = 4.0;
+    static constexpr double GOP_SKIP_LATENESS = 0.5;  // Seconds behind schedule before jumping to the next keyframe
+    static constexpr int MAX_CONSECUTIVE_DROPS = 8;   // Late frames dropped before one is shown anyway
+    double playback_speed_;
+    bool skip_to_keyframe_;         // Dropping packets until the next keyframe (GOP jump)
+    int frames_dropped_;            // Decoded late and never converted/presented
+    int packets_skipped_;           // Never decoded because of a GOP jump
+    
+    // Duplicate-frame elision (static stretches skip sws conversion and present)
+    static constexpr int DUPLICATE_PACKET_MIN_BYTES = 64;     // Packets this small are always duplicate candidates
+    static constexpr int DUPLICATE_PACKET_PIXELS_PER_BYTE = 4096; // Larger frames allow proportionally larger skip packets
+    uint64_t frame_serial_;         // Bumped whenever a changed frame is converted
+    uint64_t last_frame_hash_;      // Full-frame hash of the last skip-candidate picture
+    bool last_frame_hash_valid_;    // False after load/loop/format change - next frame is never elided
+    int last_frame_width_;
+    int last_frame_height_;
+    int last_frame_format_;
+    int frames_elided_;             // Decoded but identical to the previous frame
+    
+    // Ping-pong loop. The demux thread replays the keyframe index backwards, one
+    // GOP at a time between SEGMENT markers; the decoder fills one cache while the
+    // previous GOP is presented from the other, so every frame is decoded once.
+    static constexpr size_t PINGPONG_CACHE_MAX_BYTES = 512 * 1024 * 1024; // Both caches together
+    static constexpr int PINGPONG_DECODES_PER_CALL = 2;  // Fill work spread across presented frames
+    std::atomic<bool> ping_pong_;
+    bool reversing_;                // Presenting from the reverse caches
+    bool reverse_done_;             // Demuxer sent the LOOP marker, forward play resumes once drained
+    bool reverse_fill_complete_;    // The filling cache holds a whole GOP
+    std::vector<AVFrame*> reverse_filling_;     // GOP being decoded (pts ascending)
+    std::vector<AVFrame*> reverse_presenting_;  // GOP on screen, shown from the back
+    size_t reverse_cache_limit_;    // Frames per cache before decimating
+    int reverse_keep_every_;        // Decimation step for the GOP being filled
+    int reverse_gop_frames_;        // Frames decoded in the GOP being filled
+    double reverse_end_pts_;        // Turnaround frame (last shown forward)
+    double reverse_start_time_;     // Real time the turnaround frame was due
+    
+    // Seeking
+    KeyframeIndex keyframe_index_;      // Loaded before the demux thread starts, then owned by it
+    std::atomic<double> seek_request_;  // Target in seconds for the demux thread, < 0 = none
+    std::atomic<double> seek_marker_target_; // Target of the last SEEK marker queued
+    double seek_target_pts_;            // Decoder: frames before this are dropped, < 0 = none
+    std::atomic<double> audio_seek_request_; // Same target for the audio thread's own demuxer
+    
+    // Display pacing and log throttling. Kept per player: with --scheduler
+    // screens are decoded concurrently on different workers.
+    std::chrono::steady_clock::time_point pacing_last_display_;
+    std::chrono::steady_clock::time_point pacing_stats_start_;
+    int pacing_frames_skipped_;
+    int pacing_frames_displayed_;
+    int pacing_frames_processed_;
+    int extraction_log_counter_;
+    int audio_write_errors_;        // Audio thread
+    
     // Private methods
     bool setup_ffmpeg_decoder();
     void cleanup_ffmpeg_decoder();
@@ -161,6 +276,17 @@ private:
     bool decode_next_video_frame();  // Decode next frame when needed based on PTS
     bool process_audio_frame();  // Process and output audio frames
     void audio_thread_function(); // Audio processing thread function
+    bool start_demux_thread();    // Start read-ahead thread for the video stream
+    void stop_demux_thread();     // Stop read-ahead thread and drop queued packets
+    void demux_thread_function(); // Demux read-ahead thread function
+    bool demux_reverse_pass(AVPacket* packet, const std::vector<int64_t>& keyframes); // Ping-pong GOP replay
+    void apply_decoder_skip_mode(); // Set codec skip_frame from playback_speed_
+    void begin_reverse();           // Forward pass ended, switch to the reverse caches
+    bool extract_reverse_frame(double current_real_time); // Ping-pong counterpart of extract_next_frame()
+    void cache_reverse_frame();     // Clone frame_ into the filling cache (decimating if full)
+    void clear_reverse_cache();
+    void apply_seek_marker();       // SEEK popped: flush and decode up to the new target
+    bool is_duplicate_frame(int packet_size, bool yuv_frame); // Hint + full-frame hash check, updates the stored hash
     void process_audio_frame_data(AVFrame* frame, AVCodecContext* codec_ctx); // Helper for audio conversion
     double get_master_clock();   // Get master clock time for sync
     double get_video_clock();    // Get video clock time
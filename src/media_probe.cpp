@@ -0,0 +1,403 @@
+#include "media_probe.h"
+#include "decoder_profile.h"
+#include "media_player.h"
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <ctime>
+#include <fstream>
+#include <malloc.h>
+#include <unistd.h>
+
+extern "C" {
+#include <libavformat/avformat.h>
+#include <libavcodec/avcodec.h>
+#include <libavutil/imgutils.h>
+#include <libavutil/pixdesc.h>
+#include <libswscale/swscale.h>
+}
+
+// Playback holds a decoded frame, the converted one and the one on screen
+static constexpr int FRAMES_IN_FLIGHT = 3;
+// MediaPlayer's demux queue: this many seconds of packets, capped in bytes
+static constexpr double DEMUX_QUEUE_SECONDS = 2.0;
+static constexpr int64_t DEMUX_QUEUE_MAX_BYTES = 32 * 1024 * 1024;
+
+namespace {
+
+struct ProbeContext {
+    AVFormatContext* format = nullptr;
+    AVCodecContext* codec = nullptr;
+    AVFrame* frame = nullptr;
+    AVPacket* packet = nullptr;
+    SwsContext* convert = nullptr;
+    std::vector<SwsContext*> scalers;
+
+    ~ProbeContext() {
+        for (SwsContext* scaler : scalers) {
+            sws_freeContext(scaler);
+        }
+        sws_freeContext(convert);
+        av_packet_free(&packet);
+        av_frame_free(&frame);
+        avcodec_free_context(&codec);
+        avformat_close_input(&format);
+    }
+};
+
+// One screen the wallpaper would be shown on
+struct ProbeOutput {
+    int width = 0;
+    int height = 0;
+    int scaled_width = 0;       // Pixels the CPU scaler writes: the fitted image, or the
+    int scaled_height = 0;      // whole output for stretch and (cropped) fill
+    std::vector<uint8_t> buffer;
+    double cpu_seconds = 0.0;
+};
+
+double cpu_seconds(clockid_t clock) {
+    struct timespec now;
+    clock_gettime(clock, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+// Resident set right now (not the lifetime peak, which earlier files would set)
+double current_rss_mib() {
+    std::ifstream statm("/proc/self/statm");
+    long size = 0, resident = 0;
+    if (!(statm >> size >> resident)) {
+        return 0.0;
+    }
+    return resident * (double)sysconf(_SC_PAGESIZE) / (1024.0 * 1024.0);
+}
+
+double mib(int64_t bytes) {
+    return bytes / (1024.0 * 1024.0);
+}
+
+void fit_output(ProbeOutput* output, int width, int height, const std::string& scaling) {
+    output->scaled_width = output->width;
+    output->scaled_height = output->height;
+    if (scaling == "fit" || scaling == "default") {
+        double scale = std::min((double)output->width / width, (double)output->height / height);
+        output->scaled_width = std::max(1, (int)(width * scale));
+        output->scaled_height = std::max(1, (int)(height * scale));
+    }
+}
+
+}
+
+int MediaProbe::run(const ProbeSettings& settings, const std::vector<std::string>& paths) {
+    av_log_set_level(AV_LOG_ERROR);
+
+    int failed = 0;
+    for (const auto& path : paths) {
+        if (!probe(settings, path)) {
+            failed++;
+        }
+        // Hand the previous file's buffers back, so the next one's growth
+        // is not hidden by reused heap pages
+        malloc_trim(0);
+    }
+    return failed > 0 ? 1 : 0;
+}
+
+bool MediaProbe::probe(const ProbeSettings& settings, const std::string& path) {
+    double rss_before = current_rss_mib();
+    MediaPlayer detector;
+    bool image = detector.detect_media_type(path) == MediaType::IMAGE;
+
+    ProbeContext context;
+    int stream_index = -1;
+    if (avformat_open_input(&context.format, path.c_str(), nullptr, nullptr) >= 0 &&
+        avformat_find_stream_info(context.format, nullptr) >= 0) {
+        stream_index = av_find_best_stream(context.format, AVMEDIA_TYPE_VIDEO, -1, -1, nullptr, 0);
+    }
+    if (stream_index < 0) {
+        std::cerr << "ERROR: No image or video stream in " << path << std::endl;
+        return false;
+    }
+    AVStream* stream = context.format->streams[stream_index];
+    const AVCodecParameters* params = stream->codecpar;
+    int width = params->width;
+    int height = params->height;
+    std::string codec_name = avcodec_get_name(params->codec_id);
+
+    // Frame rate as MediaPlayer picks it
+    double native_fps = 30.0;
+    if (stream->r_frame_rate.num > 0 && stream->r_frame_rate.den > 0) {
+        native_fps = av_q2d(stream->r_frame_rate);
+    } else if (stream->avg_frame_rate.num > 0 && stream->avg_frame_rate.den > 0) {
+        native_fps = av_q2d(stream->avg_frame_rate);
+    }
+    double target_fps = settings.fps > 0 ? settings.fps : native_fps;
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "PROBE: " << path << std::endl;
+    const AVPixFmtDescriptor* descriptor = av_pix_fmt_desc_get((AVPixelFormat)params->format);
+    std::cout << "  media:    " << (image ? "image" : "video") << ", " << codec_name << " " << width << "x" << height;
+    if (descriptor) {
+        std::cout << ", " << descriptor->comp[0].depth << "-bit " << descriptor->name;
+    }
+    if (!image) {
+        std::cout << ", " << native_fps << " fps";
+        if (context.format->duration > 0) {
+            std::cout << ", " << context.format->duration / (double)AV_TIME_BASE << " s";
+        }
+    }
+    std::cout << std::endl;
+
+    // GOP structure from the packet flags: keyframe spacing decides how far
+    // seeks and the lateness skip jump, reordering means B-frames
+    int64_t bit_rate = context.format->bit_rate > 0 ? context.format->bit_rate : params->bit_rate;
+    context.packet = av_packet_alloc();
+    context.frame = av_frame_alloc();
+    if (!context.packet || !context.frame) {
+        return false;
+    }
+    if (!image) {
+        int packets = 0;
+        int last_keyframe = -1;
+        int keyframe_gaps = 0;
+        int64_t gap_total = 0;
+        int gap_max = 0;
+        int64_t last_pts = AV_NOPTS_VALUE;
+        bool reordered = params->video_delay > 0;
+        while (packets < GOP_SAMPLE_PACKETS && av_read_frame(context.format, context.packet) >= 0) {
+            if (context.packet->stream_index == stream_index) {
+                if (context.packet->flags & AV_PKT_FLAG_KEY) {
+                    if (last_keyframe >= 0) {
+                        int gap = packets - last_keyframe;
+                        gap_total += gap;
+                        gap_max = std::max(gap_max, gap);
+                        keyframe_gaps++;
+                    }
+                    last_keyframe = packets;
+                }
+                if (context.packet->pts != AV_NOPTS_VALUE) {
+                    if (last_pts != AV_NOPTS_VALUE && context.packet->pts < last_pts) {
+                        reordered = true;
+                    }
+                    last_pts = context.packet->pts;
+                }
+                packets++;
+            }
+            av_packet_unref(context.packet);
+        }
+
+        std::cout << "  gop:      ";
+        if (keyframe_gaps > 0) {
+            double average = (double)gap_total / keyframe_gaps;
+            std::cout << "keyframe every " << average << " frames (" << average / native_fps << " s, max " << gap_max << ")";
+        } else if (last_keyframe == 0 && packets == 1) {
+            std::cout << "single frame";
+        } else {
+            std::cout << "one keyframe in the first " << packets << " frames (long GOP, slow seeks and loops)";
+        }
+        std::cout << ", " << (reordered ? "B-frames" : "no B-frames") << std::endl;
+
+        int64_t start = stream->start_time != AV_NOPTS_VALUE ? stream->start_time : 0;
+        av_seek_frame(context.format, stream_index, start, AVSEEK_FLAG_BACKWARD);
+    }
+
+    // The decoder setup playback would use
+    DecoderProfile profile;
+    bool tuned = DecoderProfiles::lookup(codec_name, width, height, &profile);
+    const AVCodec* decoder = tuned ? avcodec_find_decoder_by_name(profile.decoder.c_str()) : nullptr;
+    if (!decoder || decoder->id != params->codec_id) {
+        decoder = avcodec_find_decoder(params->codec_id);
+        tuned = false;
+    }
+    context.codec = decoder ? avcodec_alloc_context3(decoder) : nullptr;
+    if (!context.codec || avcodec_parameters_to_context(context.codec, params) < 0) {
+        std::cerr << "ERROR: Unsupported codec " << codec_name << " in " << path << std::endl;
+        return false;
+    }
+    int sws_flags = SWS_BILINEAR;
+    if (tuned) {
+        context.codec->thread_count = profile.threads;
+        context.codec->thread_type = profile.slice_threads ? FF_THREAD_SLICE : FF_THREAD_FRAME;
+        sws_flags = profile.sws_flags;
+    }
+    if (avcodec_open2(context.codec, decoder, nullptr) < 0) {
+        std::cerr << "ERROR: Could not open decoder " << decoder->name << " for " << path << std::endl;
+        return false;
+    }
+    std::cout << "  decoder:  " << decoder->name << ", " << std::max(1, context.codec->thread_count) << " "
+              << (context.codec->thread_type == FF_THREAD_SLICE ? "slice" : "frame") << " thread(s), "
+              << DecoderProfiles::sws_flags_name(sws_flags) << " scaler"
+              << (tuned ? " (autotune profile)" : " (defaults, run autotune for a tuned profile)") << std::endl;
+
+    std::vector<ProbeOutput> outputs;
+    for (const auto& size : settings.outputs) {
+        ProbeOutput output;
+        output.width = size.first;
+        output.height = size.second;
+        fit_output(&output, width, height, settings.scaling);
+        outputs.push_back(std::move(output));
+    }
+    if (outputs.empty()) {
+        ProbeOutput output;
+        output.width = output.scaled_width = width;
+        output.height = output.scaled_height = height;
+        outputs.push_back(std::move(output));
+    }
+
+    // Timed sample: decode, convert to RGBA at source size as MediaPlayer
+    // does, then scale into every output as the CPU renderers do. Decoder
+    // threads are included by taking process CPU time; convert and scale
+    // run on this thread and are timed on it alone.
+    std::vector<uint8_t> rgba(av_image_get_buffer_size(AV_PIX_FMT_RGBA, width, height, 1));
+    uint8_t* rgba_data[4];
+    int rgba_linesize[4];
+    av_image_fill_arrays(rgba_data, rgba_linesize, rgba.data(), AV_PIX_FMT_RGBA, width, height, 1);
+
+    int decoded = 0;
+    bool flushed = false;
+    double convert_seconds = 0.0;
+    double first_frame_ms = 0.0;
+    auto open_time = std::chrono::steady_clock::now();
+    auto start = open_time;
+    double process_start = cpu_seconds(CLOCK_PROCESS_CPUTIME_ID);
+    int sample_frames = image ? 0 : SAMPLE_FRAMES;
+    while (decoded <= sample_frames) {
+        if (decoded > 0 &&
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() > SAMPLE_SECONDS) {
+            break;
+        }
+
+        int ret = avcodec_receive_frame(context.codec, context.frame);
+        if (ret == 0) {
+            AVFrame* frame = context.frame;
+            if (!context.convert) {
+                context.convert = sws_getContext(frame->width, frame->height, (AVPixelFormat)frame->format, width, height,
+                                                 AV_PIX_FMT_RGBA, sws_flags, nullptr, nullptr, nullptr);
+                for (auto& output : outputs) {
+                    context.scalers.push_back(sws_getContext(width, height, AV_PIX_FMT_RGBA, output.scaled_width,
+                                                             output.scaled_height, AV_PIX_FMT_BGRA, sws_flags,
+                                                             nullptr, nullptr, nullptr));
+                    output.buffer.resize((size_t)output.scaled_width * output.scaled_height * 4);
+                }
+                if (!context.convert ||
+                    std::find(context.scalers.begin(), context.scalers.end(), nullptr) != context.scalers.end()) {
+                    std::cerr << "ERROR: Could not convert frames of " << path << std::endl;
+                    return false;
+                }
+            }
+
+            // The first picture pays for filling frame threads; the clock starts after it
+            bool timed = decoded > 0;
+            if (!timed) {
+                first_frame_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - open_time).count();
+            }
+            double thread_start = cpu_seconds(CLOCK_THREAD_CPUTIME_ID);
+            sws_scale(context.convert, frame->data, frame->linesize, 0, frame->height, rgba_data, rgba_linesize);
+            double thread_now = cpu_seconds(CLOCK_THREAD_CPUTIME_ID);
+            if (timed) {
+                convert_seconds += thread_now - thread_start;
+            }
+            for (size_t i = 0; i < outputs.size(); i++) {
+                uint8_t* scaled_data[4] = { outputs[i].buffer.data(), nullptr, nullptr, nullptr };
+                int scaled_linesize[4] = { outputs[i].scaled_width * 4, 0, 0, 0 };
+                thread_start = thread_now;
+                sws_scale(context.scalers[i], rgba_data, rgba_linesize, 0, height, scaled_data, scaled_linesize);
+                thread_now = cpu_seconds(CLOCK_THREAD_CPUTIME_ID);
+                if (timed) {
+                    outputs[i].cpu_seconds += thread_now - thread_start;
+                }
+            }
+            av_frame_unref(frame);
+
+            if (!timed) {
+                start = std::chrono::steady_clock::now();
+                process_start = cpu_seconds(CLOCK_PROCESS_CPUTIME_ID);
+            }
+            decoded++;
+            continue;
+        }
+        if (ret != AVERROR(EAGAIN) || flushed) {
+            break;
+        }
+
+        if (av_read_frame(context.format, context.packet) < 0) {
+            avcodec_send_packet(context.codec, nullptr);
+            flushed = true;
+            continue;
+        }
+        if (context.packet->stream_index == stream_index) {
+            avcodec_send_packet(context.codec, context.packet);
+        }
+        av_packet_unref(context.packet);
+    }
+    if (decoded == 0) {
+        std::cerr << "ERROR: Could not decode a frame of " << path << std::endl;
+        return false;
+    }
+
+    // Memory: the decoder's working set as measured (RSS growth with the
+    // decoder still open, minus our own buffers), plus what playback adds on
+    // top per frame and output
+    int64_t rgba_bytes = rgba.size();
+    int64_t output_bytes = 0;
+    for (const auto& output : outputs) {
+        output_bytes += output.buffer.size();
+    }
+    double decoder_mib = std::max(0.0, current_rss_mib() - rss_before - mib(rgba_bytes + output_bytes));
+    int64_t frame_bytes = rgba_bytes * (image ? 1 : FRAMES_IN_FLIGHT);
+    int64_t queue_bytes = image || bit_rate <= 0 ? 0
+                        : std::min<int64_t>(DEMUX_QUEUE_MAX_BYTES, (int64_t)(bit_rate / 8 * DEMUX_QUEUE_SECONDS));
+    double memory_mib = decoder_mib + mib(frame_bytes + output_bytes + queue_bytes);
+    int cores = std::max(1u, std::thread::hardware_concurrency());
+
+    if (image) {
+        // Decoded and scaled once; nothing runs per frame afterwards
+        std::cout << "  cost:     " << first_frame_ms << " ms once to decode and scale, then idle" << std::endl;
+        std::cout << "  memory:   ~" << memory_mib << " MiB (decoder " << decoder_mib << ", image " << mib(frame_bytes)
+                  << ", outputs " << mib(output_bytes) << ")" << std::endl;
+        std::cout << "  verdict:  smooth" << std::endl;
+        return true;
+    }
+
+    int timed_frames = decoded - 1;
+    double wall_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (timed_frames < 1 || wall_seconds <= 0.0) {
+        std::cerr << "ERROR: Too few frames in " << path << " to time" << std::endl;
+        return false;
+    }
+    double scale_seconds = 0.0;
+    for (const auto& output : outputs) {
+        scale_seconds += output.cpu_seconds;
+    }
+    double process_seconds = cpu_seconds(CLOCK_PROCESS_CPUTIME_ID) - process_start;
+    double decode_seconds = std::max(0.0, process_seconds - convert_seconds - scale_seconds);
+    double pipeline_fps = timed_frames / wall_seconds;
+
+    // Per frame CPU time at the target rate, as a share of one core
+    auto percent = [&](double seconds) { return seconds / timed_frames * target_fps * 100.0; };
+    auto per_frame_ms = [&](double seconds) { return seconds / timed_frames * 1000.0; };
+    std::cout << "  target:   " << target_fps << " fps, " << settings.scaling << ", " << outputs.size() << " output(s)" << std::endl;
+    std::cout << "  decode:   " << per_frame_ms(decode_seconds) << " ms CPU/frame -> " << percent(decode_seconds) << "% of a core" << std::endl;
+    std::cout << "  convert:  " << per_frame_ms(convert_seconds) << " ms CPU/frame -> " << percent(convert_seconds) << "% of a core" << std::endl;
+    for (const auto& output : outputs) {
+        std::cout << "  scale:    " << output.width << "x" << output.height << " (" << output.scaled_width << "x"
+                  << output.scaled_height << " drawn): " << per_frame_ms(output.cpu_seconds) << " ms CPU/frame -> "
+                  << percent(output.cpu_seconds) << "% of a core (CPU renderers; GL and --xrender scale off the CPU)" << std::endl;
+    }
+    double total_percent = percent(process_seconds);
+    std::cout << "  cpu:      ~" << total_percent << "% of a core, " << total_percent / cores << "% of " << cores
+              << " cores; sample ran at " << pipeline_fps << " fps (" << pipeline_fps / target_fps << "x realtime)" << std::endl;
+    std::cout << "  memory:   ~" << memory_mib << " MiB (decoder " << decoder_mib << ", frames " << mib(frame_bytes)
+              << ", outputs " << mib(output_bytes) << ", packet queue " << mib(queue_bytes) << ")" << std::endl;
+
+    // Headroom covers the renderer, audio and other screens sharing the cores
+    const char* verdict = "too slow";
+    if (pipeline_fps >= target_fps * SMOOTH_HEADROOM && total_percent / cores < 50.0) {
+        verdict = "smooth";
+    } else if (pipeline_fps >= target_fps) {
+        verdict = "tight";
+    }
+    std::cout << "  verdict:  " << verdict << std::endl;
+    return true;
+}
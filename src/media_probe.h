@@ -0,0 +1,31 @@
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+struct ProbeSettings {
+    int fps = -1;                               // -1 = native frame rate, as --fps
+    std::string scaling = "fit";                // stretch, fit, fill, default
+    std::vector<std::pair<int, int>> outputs;   // Output sizes; empty = source size
+};
+
+// `probe <media>...`: reports a wallpaper's codec, resolution, bit depth and
+// GOP structure, then decodes a short timed sample with the decoder setup
+// playback would use (the `autotune` profile if there is one) and estimates
+// the CPU and memory it needs at the given FPS, scaling and output sizes.
+// The last line per file is a verdict a picker UI can act on before
+// switching: "smooth", "tight" or "too slow".
+class MediaProbe {
+public:
+    // Returns the process exit code
+    static int run(const ProbeSettings& settings, const std::vector<std::string>& paths);
+
+private:
+    static constexpr int GOP_SAMPLE_PACKETS = 1000;     // Read from the start to measure keyframe spacing
+    static constexpr int SAMPLE_FRAMES = 120;           // Timed decode, after the first frame
+    static constexpr double SAMPLE_SECONDS = 2.0;       // Or until this much time has passed
+    static constexpr double SMOOTH_HEADROOM = 1.5;      // Decode rate over target FPS needed for "smooth"
+
+    static bool probe(const ProbeSettings& settings, const std::string& path);
+};
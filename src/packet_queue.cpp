@@ -0,0 +1,142 @@
+#include "packet_queue.h"
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+}
+
+PacketQueue::PacketQueue(size_t max_bytes, double max_seconds)
+    : max_bytes_(max_bytes), max_seconds_(max_seconds),
+      bytes_(0), seconds_(0.0), underruns_(0), aborted_(false) {}
+
+PacketQueue::~PacketQueue() {
+    abort();
+    flush();
+}
+
+bool PacketQueue::is_full() const {
+    // Always accept at least one packet so oversized keyframes cannot deadlock
+    if (entries_.empty()) {
+        return false;
+    }
+    return bytes_ >= max_bytes_ || seconds_ >= max_seconds_;
+}
+
+bool PacketQueue::push(AVPacket* packet, double duration) {
+    AVPacket* queued = av_packet_alloc();
+    if (!queued) {
+        return false;
+    }
+    av_packet_move_ref(queued, packet);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_full_.wait(lock, [this] { return aborted_ || !is_full(); });
+    if (aborted_) {
+        lock.unlock();
+        av_packet_free(&queued);
+        return false;
+    }
+
+    entries_.push_back({queued, duration, PopResult::PACKET});
+    bytes_ += queued->size;
+    seconds_ += duration;
+    not_empty_.notify_one();
+    return true;
+}
+
+bool PacketQueue::push_loop_marker() {
+    return push_marker(PopResult::LOOP);
+}
+
+bool PacketQueue::push_segment_marker() {
+    return push_marker(PopResult::SEGMENT);
+}
+
+bool PacketQueue::push_seek_marker() {
+    return push_marker(PopResult::SEEK);
+}
+
+bool PacketQueue::push_marker(PopResult marker) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (aborted_) {
+        return false;
+    }
+    if (marker == PopResult::SEEK) {
+        drop_entries();
+    }
+    entries_.push_back({nullptr, 0.0, marker});
+    not_empty_.notify_one();
+    return true;
+}
+
+PacketQueue::PopResult PacketQueue::pop(AVPacket* packet) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (entries_.empty() && !aborted_) {
+        underruns_++;
+    }
+    not_empty_.wait(lock, [this] { return aborted_ || !entries_.empty(); });
+    if (aborted_) {
+        return PopResult::ABORTED;
+    }
+
+    Entry entry = entries_.front();
+    entries_.pop_front();
+    not_full_.notify_one();
+
+    if (!entry.packet) {
+        return entry.marker;
+    }
+
+    bytes_ -= entry.packet->size;
+    seconds_ -= entry.duration;
+    if (entries_.empty()) {
+        // Avoid accumulating floating point drift
+        bytes_ = 0;
+        seconds_ = 0.0;
+    }
+    lock.unlock();
+
+    av_packet_move_ref(packet, entry.packet);
+    av_packet_free(&entry.packet);
+    return PopResult::PACKET;
+}
+
+void PacketQueue::abort() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    aborted_ = true;
+    not_empty_.notify_all();
+    not_full_.notify_all();
+}
+
+void PacketQueue::flush() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    drop_entries();
+}
+
+void PacketQueue::drop_entries() {
+    for (auto& entry : entries_) {
+        if (entry.packet) {
+            av_packet_free(&entry.packet);
+        }
+    }
+    entries_.clear();
+    bytes_ = 0;
+    seconds_ = 0.0;
+    not_full_.notify_all();
+}
+
+void PacketQueue::reset() {
+    flush();
+    std::lock_guard<std::mutex> lock(mutex_);
+    aborted_ = false;
+    underruns_ = 0;
+}
+
+PacketQueueStats PacketQueue::get_stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    PacketQueueStats stats;
+    stats.packets = entries_.size();
+    stats.bytes = bytes_;
+    stats.seconds = seconds_;
+    stats.underruns = underruns_;
+    return stats;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+
+// Forward declarations for FFmpeg
+extern "C" {
+struct AVPacket;
+}
+
+// Snapshot of the read-ahead queue, used for stats reporting
+struct PacketQueueStats {
+    size_t packets = 0;          // Packets currently buffered
+    size_t bytes = 0;            // Compressed bytes currently buffered
+    double seconds = 0.0;        // Media time currently buffered
+    size_t underruns = 0;        // Times the decoder found the queue empty
+};
+
+// Bounded, thread-safe FIFO of demuxed packets.
+// The demux thread pushes packets until either the byte or the duration limit
+// is reached; the decoder pops them independently so I/O stalls are absorbed
+// by the buffered packets instead of showing up as dropped frames.
+class PacketQueue {
+public:
+    enum class PopResult {
+        PACKET,     // A packet was moved into the caller's AVPacket
+        LOOP,       // Demuxer reached end of stream and rewound to the start
+        SEGMENT,    // Ping-pong: end of the forward pass, or of one reversed GOP
+        SEEK,       // Demuxer jumped, everything queued before this was dropped
+        ABORTED     // Queue was aborted (player shutting down)
+    };
+
+    PacketQueue(size_t max_bytes, double max_seconds);
+    ~PacketQueue();
+
+    // Takes ownership of the packet's data (the source packet is left blank).
+    // Blocks while the queue is full; returns false if the queue was aborted.
+    bool push(AVPacket* packet, double duration);
+
+    // Marks the point where the demuxer looped back to the beginning
+    bool push_loop_marker();
+
+    // Marks a segment boundary in the ping-pong loop (see MediaPlayer)
+    bool push_segment_marker();
+
+    // Drops everything still queued and marks where the packets after a seek begin
+    bool push_seek_marker();
+
+    // Blocks until a packet or marker is available
+    PopResult pop(AVPacket* packet);
+
+    void abort();        // Wake up and release all waiters
+    void flush();        // Drop all buffered packets
+    void reset();        // Clear abort state so the queue can be reused
+
+    PacketQueueStats get_stats() const;
+
+private:
+    struct Entry {
+        AVPacket* packet;   // nullptr for markers
+        double duration;
+        PopResult marker;   // What pop() reports for a marker
+    };
+
+    bool push_marker(PopResult marker);
+    void drop_entries();    // Caller holds mutex_
+
+    bool is_full() const;
+
+    std::deque<Entry> entries_;
+    mutable std::mutex mutex_;
+    std::condition_variable not_empty_;
+    std::condition_variable not_full_;
+
+    size_t max_bytes_;
+    double max_seconds_;
+    size_t bytes_;
+    double seconds_;
+    size_t underruns_;
+    bool aborted_;
+};
@@ -0,0 +1,294 @@
+#include "supervisor.h"
+#include "application.h"
+#include "media_player.h"
+#include <iostream>
+#include <map>
+#include <cstring>
+#include <cerrno>
+#include <thread>
+#include <algorithm>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/prctl.h>
+
+// The worker's own Application, for its signal handler (one per process)
+static Application* g_worker_app = nullptr;
+
+static void worker_signal_handler(int signal) {
+    if (g_worker_app) {
+        g_worker_app->handle_signal(signal);
+    }
+}
+
+Supervisor::Supervisor() : should_exit_(false) {}
+
+Supervisor::~Supervisor() {
+    stop_workers();
+}
+
+bool Supervisor::initialize(const Config& config) {
+    config_ = config;
+    if (config_.export_frames) {
+        // Every worker would compete for the one export socket
+        std::cerr << "WARNING: --export is not supported with --isolate, frames will not be exported" << std::endl;
+        config_.export_frames = false;
+    }
+    plan_workers();
+    if (workers_.empty()) {
+        std::cerr << "ERROR: No screens to run" << std::endl;
+        return false;
+    }
+
+    std::cout << "Supervisor: " << workers_.size() << " worker processes, "
+              << rings_.size() << " shared decoder group(s)" << std::endl;
+    return true;
+}
+
+void Supervisor::plan_workers() {
+    const auto& screens = config_.screen_configs;
+    std::vector<bool> grouped(screens.size(), false);
+
+    if (config_.isolate_mode == "group") {
+        // Same file, same pacing: one decode can feed all of them. Spanned
+        // screens already decode once for all their outputs.
+        MediaPlayer probe;
+        std::map<std::string, std::vector<size_t>> groups;
+        for (size_t i = 0; i < screens.size(); i++) {
+            // Random start offsets exist to keep screens apart, so they never share a decoder
+            if (screens[i].span_outputs.empty() && screens[i].start_position != "random" &&
+                probe.detect_media_type(screens[i].media_path) == MediaType::VIDEO) {
+                std::string key = screens[i].media_path + "|" + std::to_string(screens[i].fps) + "|" +
+                                  std::to_string(screens[i].speed) + "|" + (screens[i].ping_pong ? "pingpong" : "normal") + "|" + screens[i].start_position;
+                groups[key].push_back(i);
+            }
+        }
+
+        for (const auto& group : groups) {
+            const auto& members = group.second;
+            for (size_t begin = 0; begin + 1 < members.size(); begin += FrameRing::MAX_READERS) {
+                size_t count = std::min(members.size() - begin, static_cast<size_t>(FrameRing::MAX_READERS));
+                if (count < 2) {
+                    break;
+                }
+
+                auto ring = std::make_unique<FrameRing>();
+                std::string ring_name = "group" + std::to_string(rings_.size());
+                if (!ring->create(ring_name, static_cast<int>(count))) {
+                    continue;   // These screens fall back to one decoder each
+                }
+
+                // The decoder worker carries the group's audio (settings of its first screen)
+                Worker decoder;
+                decoder.name = "decoder:" + ring_name;
+                decoder.screen = screens[members[begin]];
+                decoder.screen.screen_name = decoder.name;
+                decoder.screen.dirty_tiles = false;
+                decoder.screen.xrender = false;
+                decoder.screen.stats_overlay = false;
+                decoder.screen.frame_ring_fd = ring->get_fd();
+                decoder.screen.frame_ring_reader = -1;
+                decoder.ring = static_cast<int>(rings_.size());
+                workers_.push_back(decoder);
+
+                for (size_t j = 0; j < count; j++) {
+                    size_t index = members[begin + j];
+                    Worker presenter;
+                    presenter.name = screens[index].screen_name;
+                    presenter.screen = screens[index];
+                    presenter.screen.frame_ring_fd = ring->get_fd();
+                    presenter.screen.frame_ring_reader = static_cast<int>(j);
+                    presenter.ring = decoder.ring;
+                    workers_.push_back(presenter);
+                    grouped[index] = true;
+                }
+                rings_.push_back(std::move(ring));
+            }
+        }
+    }
+
+    for (size_t i = 0; i < screens.size(); i++) {
+        if (!grouped[i]) {
+            Worker worker;
+            worker.name = screens[i].screen_name;
+            worker.screen = screens[i];
+            workers_.push_back(worker);
+        }
+    }
+}
+
+bool Supervisor::spawn(Worker& worker) {
+    // Anything still buffered would otherwise be printed by both processes
+    std::cout.flush();
+    std::cerr.flush();
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        std::cerr << "ERROR: Failed to fork worker " << worker.name << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    if (pid == 0) {
+        Config worker_config = config_;
+        worker_config.isolate_mode.clear();
+        worker_config.scheduler_workers = -1;   // One screen per process, nothing to share
+        worker_config.screen_configs.assign(1, worker.screen);
+        int code = run_worker(worker_config);
+        std::cout.flush();
+        std::cerr.flush();
+        // Skip the supervisor's destructors and atexit handlers inherited by the copy
+        _exit(code);
+    }
+
+    worker.pid = pid;
+    worker.started = std::chrono::steady_clock::now();
+    std::cout << "Supervisor: started worker " << worker.name << " (pid " << pid << ")" << std::endl;
+    return true;
+}
+
+int Supervisor::run_worker(const Config& config) {
+    // Never outlive the supervisor
+    prctl(PR_SET_PDEATHSIG, SIGTERM);
+
+    Application app;
+    g_worker_app = &app;
+    signal(SIGINT, worker_signal_handler);
+    signal(SIGTERM, worker_signal_handler);
+    signal(SIGHUP, worker_signal_handler);
+
+    if (!app.initialize(config)) {
+        std::cerr << "Failed to initialize worker" << std::endl;
+        app.shutdown();
+        g_worker_app = nullptr;
+        return 1;
+    }
+    app.run();
+    app.shutdown();
+    g_worker_app = nullptr;
+    return 0;
+}
+
+int Supervisor::run() {
+    for (auto& worker : workers_) {
+        spawn(worker);
+    }
+
+    while (!should_exit_) {
+        int status = 0;
+        pid_t pid = waitpid(-1, &status, WNOHANG);
+        if (pid > 0) {
+            for (auto& worker : workers_) {
+                if (worker.pid == pid) {
+                    handle_exit(worker, status);
+                    break;
+                }
+            }
+            continue;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        bool any_active = false;
+        for (auto& worker : workers_) {
+            if (worker.finished) {
+                continue;
+            }
+            any_active = true;
+            if (worker.pid < 0 && now >= worker.restart_at) {
+                spawn(worker);
+            }
+        }
+        if (!any_active) {
+            std::cout << "Supervisor: all workers exited" << std::endl;
+            break;
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    }
+
+    stop_workers();
+    return 0;
+}
+
+void Supervisor::handle_exit(Worker& worker, int status) {
+    worker.pid = -1;
+
+    // A presenter that died mid-present must not keep its slot pinned
+    if (worker.ring >= 0 && worker.screen.frame_ring_reader >= 0) {
+        rings_[worker.ring]->clear_reader(worker.screen.frame_ring_reader);
+    }
+    if (should_exit_) {
+        return;
+    }
+
+    if (WIFEXITED(status) && WEXITSTATUS(status) == 0) {
+        std::cout << "Supervisor: worker " << worker.name << " exited" << std::endl;
+        worker.finished = true;
+        return;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    if (now - worker.started >= std::chrono::seconds(STABLE_RUN_S)) {
+        worker.restarts = 0;
+    }
+    int delay = std::min(MAX_RESTART_DELAY_S, 1 << std::min(worker.restarts, 5));
+    worker.restarts++;
+    worker.restart_at = now + std::chrono::seconds(delay);
+
+    if (WIFSIGNALED(status)) {
+        std::cerr << "WARNING: Worker " << worker.name << " killed by signal " << WTERMSIG(status)
+                  << ", restarting in " << delay << "s" << std::endl;
+    } else {
+        std::cerr << "WARNING: Worker " << worker.name << " exited with status " << WEXITSTATUS(status)
+                  << ", restarting in " << delay << "s" << std::endl;
+    }
+}
+
+void Supervisor::stop_workers() {
+    bool any_running = false;
+    for (auto& worker : workers_) {
+        if (worker.pid > 0) {
+            kill(worker.pid, SIGTERM);
+            any_running = true;
+        }
+    }
+    if (!any_running) {
+        return;
+    }
+
+    // Give workers time to release their outputs, then stop waiting
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(3);
+    for (;;) {
+        bool waiting = false;
+        for (auto& worker : workers_) {
+            if (worker.pid > 0) {
+                int status = 0;
+                if (waitpid(worker.pid, &status, WNOHANG) == worker.pid) {
+                    worker.pid = -1;
+                } else {
+                    waiting = true;
+                }
+            }
+        }
+        if (!waiting) {
+            break;
+        }
+        if (std::chrono::steady_clock::now() >= deadline) {
+            for (auto& worker : workers_) {
+                if (worker.pid > 0) {
+                    std::cerr << "WARNING: Worker " << worker.name << " did not stop, killing it" << std::endl;
+                    kill(worker.pid, SIGKILL);
+                    waitpid(worker.pid, nullptr, 0);
+                    worker.pid = -1;
+                }
+            }
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    std::cout << "Supervisor: all workers stopped" << std::endl;
+}
+
+void Supervisor::handle_signal(int signal) {
+    std::cout << "Received signal " << signal << ", stopping workers..." << std::endl;
+    should_exit_ = true;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "argument_parser.h"
+#include "frame_ring.h"
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <sys/types.h>
+
+// --isolate: runs every screen in its own worker process instead of one
+// thread per screen in a shared process, so a crash or a stalled decoder only
+// takes out its own output. Dead workers are restarted with a backoff.
+//
+// In "group" mode, screens that play the same video with the same timing share
+// one decoder worker; it publishes RGBA frames into a memfd FrameRing and the
+// presenter workers for those screens display them from shared memory.
+class Supervisor {
+public:
+    Supervisor();
+    ~Supervisor();
+
+    bool initialize(const Config& config);
+    int run();
+
+    void handle_signal(int signal);
+
+private:
+    struct Worker {
+        std::string name;
+        ScreenConfig screen;            // The single screen this worker runs
+        int ring = -1;                  // Index into rings_, -1 = self-contained
+        pid_t pid = -1;
+        int restarts = 0;
+        bool finished = false;          // Exited cleanly; not restarted
+        std::chrono::steady_clock::time_point started;
+        std::chrono::steady_clock::time_point restart_at;
+    };
+
+    static constexpr int MAX_RESTART_DELAY_S = 30;
+    static constexpr int STABLE_RUN_S = 60;     // A worker that ran this long starts its backoff over
+
+    Config config_;
+    std::vector<Worker> workers_;
+    std::vector<std::unique_ptr<FrameRing>> rings_;
+    std::atomic<bool> should_exit_;
+
+    void plan_workers();
+    bool spawn(Worker& worker);
+    void handle_exit(Worker& worker, int status);
+    void stop_workers();
+
+    static int run_worker(const Config& config);
+};
@@ -0,0 +1,224 @@
+#include "task_scheduler.h"
+#include <iostream>
+#include <algorithm>
+#include <system_error>
+
+TaskScheduler::TaskScheduler()
+    : running_(false), stopping_(false), active_(0), tasks_run_(0), tasks_stolen_(0),
+      deadlines_missed_(0), max_lateness_ms_(0.0) {}
+
+TaskScheduler::~TaskScheduler() {
+    stop();
+}
+
+bool TaskScheduler::start(int workers) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_) {
+        return true;
+    }
+
+    if (workers <= 0) {
+        workers = static_cast<int>(std::thread::hardware_concurrency());
+        if (workers <= 0) {
+            workers = 1;
+        }
+    }
+
+    stopping_ = false;
+    queues_.assign(workers, std::vector<Task>());
+    stats_start_ = Clock::now();
+    try {
+        for (int i = 0; i < workers; i++) {
+            workers_.emplace_back(&TaskScheduler::worker_loop, this, i);
+        }
+    } catch (const std::system_error& e) {
+        std::cerr << "ERROR: Failed to start scheduler worker: " << e.what() << std::endl;
+        if (workers_.empty()) {
+            return false;
+        }
+        // Run with the workers we got; tasks for the missing ones are remapped in submit()
+        queues_.resize(workers_.size());
+    }
+
+    running_ = true;
+    std::cout << "DEBUG: Task scheduler started with " << workers_.size() << " workers" << std::endl;
+    return true;
+}
+
+void TaskScheduler::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) {
+            return;
+        }
+        stopping_ = true;
+    }
+    wakeup_.notify_all();
+
+    for (auto& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    workers_.clear();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    queues_.clear();
+    running_ = false;
+    stopping_ = false;
+}
+
+void TaskScheduler::submit(Task task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (queues_.empty()) {
+            return;
+        }
+        int worker = task.worker;
+        if (worker < 0 || worker >= static_cast<int>(queues_.size())) {
+            worker = (worker < 0 ? -worker : worker) % static_cast<int>(queues_.size());
+        }
+        task.worker = worker;
+        queues_[worker].push_back(std::move(task));
+    }
+    // Idle workers sleep until their own next task or the next one they may
+    // steal, both of which this can move earlier
+    wakeup_.notify_all();
+}
+
+bool TaskScheduler::take_task(int index, Clock::time_point now, Task* task, bool* stolen) {
+    // Own queue first: earliest deadline among the ready tasks
+    std::vector<Task>& own = queues_[index];
+    auto best = own.end();
+    for (auto it = own.begin(); it != own.end(); ++it) {
+        if ((stopping_ || it->ready <= now) && (best == own.end() || it->deadline < best->deadline)) {
+            best = it;
+        }
+    }
+    if (best != own.end()) {
+        *task = std::move(*best);
+        own.erase(best);
+        *stolen = false;
+        return true;
+    }
+
+    // Nothing due here: take the most urgent unpinned task another worker has
+    // left waiting past the steal delay
+    int victim = -1;
+    size_t victim_pos = 0;
+    for (int q = 0; q < static_cast<int>(queues_.size()); q++) {
+        if (q == index) {
+            continue;
+        }
+        const std::vector<Task>& queue = queues_[q];
+        for (size_t i = 0; i < queue.size(); i++) {
+            const Task& candidate = queue[i];
+            if (candidate.pinned || (!stopping_ && candidate.ready + STEAL_DELAY > now)) {
+                continue;
+            }
+            if (victim < 0 || candidate.deadline < queues_[victim][victim_pos].deadline) {
+                victim = q;
+                victim_pos = i;
+            }
+        }
+    }
+    if (victim < 0) {
+        return false;
+    }
+
+    std::vector<Task>& queue = queues_[victim];
+    *task = std::move(queue[victim_pos]);
+    queue.erase(queue.begin() + victim_pos);
+    *stolen = true;
+    return true;
+}
+
+TaskScheduler::Clock::time_point TaskScheduler::next_wakeup(int index) const {
+    Clock::time_point wakeup = Clock::time_point::max();
+    for (int q = 0; q < static_cast<int>(queues_.size()); q++) {
+        for (const Task& task : queues_[q]) {
+            if (q == index) {
+                wakeup = std::min(wakeup, task.ready);
+            } else if (!task.pinned) {
+                wakeup = std::min(wakeup, task.ready + STEAL_DELAY);
+            }
+        }
+    }
+    return wakeup;
+}
+
+void TaskScheduler::worker_loop(int index) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        Clock::time_point now = Clock::now();
+        Task task;
+        bool stolen = false;
+        if (take_task(index, now, &task, &stolen)) {
+            active_++;
+            lock.unlock();
+
+            task.run();
+            Clock::time_point finished = Clock::now();
+
+            lock.lock();
+            active_--;
+            tasks_run_++;
+            if (stolen) {
+                tasks_stolen_++;
+            }
+            if (finished > task.deadline) {
+                deadlines_missed_++;
+                double lateness_ms = std::chrono::duration<double, std::milli>(finished - task.deadline).count();
+                max_lateness_ms_ = std::max(max_lateness_ms_, lateness_ms);
+            }
+            log_stats(finished);
+            if (stopping_) {
+                // A task run while draining may have queued follow-up work elsewhere
+                wakeup_.notify_all();
+            }
+            continue;
+        }
+
+        if (stopping_) {
+            bool drained = active_ == 0 &&
+                std::all_of(queues_.begin(), queues_.end(),
+                            [](const std::vector<Task>& queue) { return queue.empty(); });
+            if (drained) {
+                break;
+            }
+            wakeup_.wait(lock);
+            continue;
+        }
+
+        Clock::time_point wakeup = next_wakeup(index);
+        if (wakeup == Clock::time_point::max()) {
+            wakeup_.wait(lock);
+        } else {
+            wakeup_.wait_until(lock, wakeup);
+        }
+    }
+    lock.unlock();
+    // Let the other workers see the drained state
+    wakeup_.notify_all();
+}
+
+void TaskScheduler::log_stats(Clock::time_point now) {
+    auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - stats_start_);
+    if (elapsed.count() < STATS_INTERVAL_S) {
+        return;
+    }
+
+    std::cout << "SCHEDULER: " << tasks_run_ << " tasks on " << workers_.size() << " workers in "
+              << elapsed.count() << "s, " << tasks_stolen_ << " stolen, " << deadlines_missed_
+              << " missed deadlines";
+    if (deadlines_missed_ > 0) {
+        std::cout << " (worst " << max_lateness_ms_ << "ms late)";
+    }
+    std::cout << std::endl;
+
+    tasks_run_ = 0;
+    tasks_stolen_ = 0;
+    deadlines_missed_ = 0;
+    max_lateness_ms_ = 0.0;
+    stats_start_ = now;
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed pool of worker threads running short tasks in earliest-deadline-first
+// order. Every task has a home worker; pinned tasks only ever run there (GL
+// contexts and display connections stay on one thread), the others may be
+// stolen by an idle worker once they have been ready for STEAL_DELAY.
+// Used by --scheduler so many screens share cores-many threads instead of the
+// single update loop running every screen in turn.
+class TaskScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Task {
+        std::function<void()> run;
+        Clock::time_point ready;        // Not started before this
+        Clock::time_point deadline;     // Orders the queues; finishing later counts as a miss
+        int worker = 0;                 // Home worker
+        bool pinned = false;            // Never stolen
+    };
+
+    TaskScheduler();
+    ~TaskScheduler();
+
+    // workers <= 0: one per online core
+    bool start(int workers);
+
+    // Runs whatever is still queued (ignoring ready times), then joins the workers
+    void stop();
+
+    void submit(Task task);
+
+    int get_worker_count() const { return static_cast<int>(workers_.size()); }
+
+private:
+    static constexpr std::chrono::microseconds STEAL_DELAY{1000};   // Home worker's head start
+    static constexpr int STATS_INTERVAL_S = 5;
+
+    void worker_loop(int index);
+    bool take_task(int index, Clock::time_point now, Task* task, bool* stolen);  // Caller holds mutex_
+    Clock::time_point next_wakeup(int index) const;                              // Caller holds mutex_
+    void log_stats(Clock::time_point now);                                       // Caller holds mutex_
+
+    std::vector<std::thread> workers_;
+    std::vector<std::vector<Task>> queues_;     // One per worker, unsorted (they stay short)
+    mutable std::mutex mutex_;
+    std::condition_variable wakeup_;
+    bool running_;
+    bool stopping_;
+    int active_;                                // Tasks currently running
+
+    uint64_t tasks_run_;
+    uint64_t tasks_stolen_;
+    uint64_t deadlines_missed_;
+    double max_lateness_ms_;
+    Clock::time_point stats_start_;
+};
@@ -0,0 +1,584 @@
+#include "thumbnailer.h"
+#include "keyframe_index.h"
+#include "media_player.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <cstdio>
+#include <unistd.h>
+
+extern "C" {
+#include <libavformat/avformat.h>
+#include <libavcodec/avcodec.h>
+#include <libavutil/opt.h>
+#include <libswscale/swscale.h>
+}
+
+static constexpr int KEYFRAME_CANDIDATES = 3;           // Sampled at 25/50/75% of the duration
+static constexpr int KEYFRAME_SEARCH_PACKETS = 256;     // Read past each seek point looking for one
+static constexpr int PREVIEW_FPS = 12;
+
+namespace {
+
+// Source being sampled, released in any exit order
+struct SourceContext {
+    AVFormatContext* format = nullptr;
+    AVCodecContext* codec = nullptr;
+    AVFrame* frame = nullptr;
+    AVPacket* packet = nullptr;
+    int stream = -1;
+    bool flushed = false;
+
+    ~SourceContext() {
+        av_packet_free(&packet);
+        av_frame_free(&frame);
+        avcodec_free_context(&codec);
+        avformat_close_input(&format);
+    }
+};
+
+// Encoder (and muxer, for previews) writing one output file
+struct OutputContext {
+    AVFormatContext* format = nullptr;
+    AVCodecContext* codec = nullptr;
+    AVFrame* frame = nullptr;
+    AVPacket* packet = nullptr;
+    SwsContext* sws = nullptr;
+
+    ~OutputContext() {
+        sws_freeContext(sws);
+        av_packet_free(&packet);
+        av_frame_free(&frame);
+        avcodec_free_context(&codec);
+        if (format) {
+            if (format->pb) {
+                avio_closep(&format->pb);
+            }
+            avformat_free_context(format);
+        }
+    }
+};
+
+// Longest edge down to `size` (never up), aspect kept; 4:2:0 video needs even sizes
+void fit_size(int width, int height, int size, bool even, int* out_width, int* out_height) {
+    double scale = std::min(1.0, (double)size / std::max(width, height));
+    *out_width = std::max(1, (int)(width * scale + 0.5));
+    *out_height = std::max(1, (int)(height * scale + 0.5));
+    if (even) {
+        *out_width = std::max(2, *out_width & ~1);
+        *out_height = std::max(2, *out_height & ~1);
+    }
+}
+
+bool open_source(const std::string& path, int size, SourceContext* source) {
+    if (avformat_open_input(&source->format, path.c_str(), nullptr, nullptr) < 0 ||
+        avformat_find_stream_info(source->format, nullptr) < 0) {
+        return false;
+    }
+    source->stream = av_find_best_stream(source->format, AVMEDIA_TYPE_VIDEO, -1, -1, nullptr, 0);
+    if (source->stream < 0) {
+        return false;
+    }
+    for (unsigned int i = 0; i < source->format->nb_streams; i++) {
+        if ((int)i != source->stream) {
+            source->format->streams[i]->discard = AVDISCARD_ALL;
+        }
+    }
+
+    const AVCodecParameters* params = source->format->streams[source->stream]->codecpar;
+    const AVCodec* decoder = avcodec_find_decoder(params->codec_id);
+    if (!decoder) {
+        return false;
+    }
+    source->codec = avcodec_alloc_context3(decoder);
+    if (!source->codec || avcodec_parameters_to_context(source->codec, params) < 0) {
+        return false;
+    }
+
+    // The parallelism is across files, one decoder thread each keeps memory flat
+    source->codec->thread_count = 1;
+    // JPEG and a few others decode straight to 1/2, 1/4 or 1/8 size
+    int lowres = 0;
+    while (lowres < decoder->max_lowres && (std::max(params->width, params->height) >> (lowres + 1)) >= size) {
+        lowres++;
+    }
+    source->codec->lowres = lowres;
+
+    if (avcodec_open2(source->codec, decoder, nullptr) < 0) {
+        return false;
+    }
+    source->frame = av_frame_alloc();
+    source->packet = av_packet_alloc();
+    return source->frame && source->packet;
+}
+
+bool decode_next(SourceContext* source) {
+    av_frame_unref(source->frame);
+    while (true) {
+        int ret = avcodec_receive_frame(source->codec, source->frame);
+        if (ret == 0) {
+            return true;
+        }
+        if (ret != AVERROR(EAGAIN) || source->flushed) {
+            return false;
+        }
+
+        if (av_read_frame(source->format, source->packet) < 0) {
+            avcodec_send_packet(source->codec, nullptr);
+            source->flushed = true;
+            continue;
+        }
+        if (source->packet->stream_index == source->stream) {
+            avcodec_send_packet(source->codec, source->packet);
+        }
+        av_packet_unref(source->packet);
+    }
+}
+
+// Videos tend to open on a fade or a logo. Of a few keyframes spread over the
+// file the largest one usually shows the most detail; only packets are read
+// to compare them, and just the winner is decoded.
+void seek_representative(SourceContext* source) {
+    AVStream* stream = source->format->streams[source->stream];
+    if (source->format->duration <= 0) {
+        return;
+    }
+
+    int64_t best_pts = AV_NOPTS_VALUE;
+    int best_size = -1;
+    for (int i = 1; i <= KEYFRAME_CANDIDATES; i++) {
+        int64_t target = av_rescale_q(source->format->duration * i / (KEYFRAME_CANDIDATES + 1),
+                                      AVRational{1, AV_TIME_BASE}, stream->time_base);
+        if (stream->start_time != AV_NOPTS_VALUE) {
+            target += stream->start_time;
+        }
+        if (av_seek_frame(source->format, source->stream, target, AVSEEK_FLAG_BACKWARD) < 0) {
+            continue;
+        }
+        for (int n = 0; n < KEYFRAME_SEARCH_PACKETS && av_read_frame(source->format, source->packet) >= 0; n++) {
+            bool keyframe = source->packet->stream_index == source->stream && (source->packet->flags & AV_PKT_FLAG_KEY);
+            if (keyframe && source->packet->size > best_size) {
+                best_size = source->packet->size;
+                best_pts = source->packet->pts != AV_NOPTS_VALUE ? source->packet->pts : source->packet->dts;
+            }
+            av_packet_unref(source->packet);
+            if (keyframe) {
+                break;
+            }
+        }
+    }
+
+    // Back to the start if nothing could be sampled (unseekable streams)
+    int64_t position = best_pts;
+    if (position == AV_NOPTS_VALUE) {
+        position = stream->start_time != AV_NOPTS_VALUE ? stream->start_time : 0;
+    }
+    av_seek_frame(source->format, source->stream, position, AVSEEK_FLAG_BACKWARD);
+    avcodec_flush_buffers(source->codec);
+}
+
+// Send one frame (nullptr = flush) and mux whatever packets come out
+bool encode_frame(OutputContext* output, AVStream* stream, AVFrame* frame) {
+    if (avcodec_send_frame(output->codec, frame) < 0) {
+        return false;
+    }
+    while (true) {
+        int ret = avcodec_receive_packet(output->codec, output->packet);
+        if (ret == AVERROR(EAGAIN) || ret == AVERROR_EOF) {
+            return true;
+        }
+        if (ret < 0) {
+            return false;
+        }
+        av_packet_rescale_ts(output->packet, output->codec->time_base, stream->time_base);
+        output->packet->stream_index = stream->index;
+        if (av_interleaved_write_frame(output->format, output->packet) < 0) {
+            return false;
+        }
+    }
+}
+
+// Written aside and renamed so pickers never load a half-written file
+std::string temporary_path(const std::string& path) {
+    return path + ".tmp" + std::to_string(getpid());
+}
+
+bool write_png(const AVFrame* frame, int size, const std::string& path) {
+    int width, height;
+    fit_size(frame->width, frame->height, size, false, &width, &height);
+
+    OutputContext png;
+    const AVCodec* encoder = avcodec_find_encoder(AV_CODEC_ID_PNG);
+    png.codec = encoder ? avcodec_alloc_context3(encoder) : nullptr;
+    png.frame = av_frame_alloc();
+    png.packet = av_packet_alloc();
+    if (!png.codec || !png.frame || !png.packet) {
+        return false;
+    }
+    png.codec->width = width;
+    png.codec->height = height;
+    png.codec->pix_fmt = AV_PIX_FMT_RGB24;
+    png.codec->time_base = AVRational{1, 1};
+    if (avcodec_open2(png.codec, encoder, nullptr) < 0) {
+        return false;
+    }
+
+    png.frame->format = AV_PIX_FMT_RGB24;
+    png.frame->width = width;
+    png.frame->height = height;
+    if (av_frame_get_buffer(png.frame, 0) < 0) {
+        return false;
+    }
+
+    // Area averaging: the downscale happens in this single conversion pass
+    png.sws = sws_getContext(frame->width, frame->height, (AVPixelFormat)frame->format, width, height,
+                             AV_PIX_FMT_RGB24, SWS_AREA, nullptr, nullptr, nullptr);
+    if (!png.sws) {
+        return false;
+    }
+    sws_scale(png.sws, frame->data, frame->linesize, 0, frame->height, png.frame->data, png.frame->linesize);
+    png.frame->pts = 0;
+
+    if (avcodec_send_frame(png.codec, png.frame) < 0 || avcodec_send_frame(png.codec, nullptr) < 0 ||
+        avcodec_receive_packet(png.codec, png.packet) < 0) {
+        return false;
+    }
+
+    std::string temporary = temporary_path(path);
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(png.packet->data), png.packet->size);
+        if (!file) {
+            file.close();
+            std::remove(temporary.c_str());
+            return false;
+        }
+    }
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        std::remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
+
+// Continues from the frame the still was taken from, thinned to PREVIEW_FPS
+bool write_preview(SourceContext* source, int size, double seconds, const std::string& path) {
+    AVRational source_time_base = source->format->streams[source->stream]->time_base;
+    int width, height;
+    fit_size(source->frame->width, source->frame->height, size, true, &width, &height);
+
+    const AVCodec* encoder = avcodec_find_encoder_by_name("libx264");
+    if (!encoder) {
+        encoder = avcodec_find_encoder(AV_CODEC_ID_MPEG4);
+    }
+    if (!encoder) {
+        return false;
+    }
+
+    OutputContext output;
+    std::string temporary = temporary_path(path);
+    if (avformat_alloc_output_context2(&output.format, nullptr, "mp4", temporary.c_str()) < 0) {
+        return false;
+    }
+    AVStream* stream = avformat_new_stream(output.format, nullptr);
+    output.codec = avcodec_alloc_context3(encoder);
+    output.frame = av_frame_alloc();
+    output.packet = av_packet_alloc();
+    if (!stream || !output.codec || !output.frame || !output.packet) {
+        return false;
+    }
+
+    output.codec->width = width;
+    output.codec->height = height;
+    output.codec->pix_fmt = AV_PIX_FMT_YUV420P;
+    output.codec->time_base = AVRational{1, PREVIEW_FPS};
+    output.codec->framerate = AVRational{PREVIEW_FPS, 1};
+    output.codec->gop_size = PREVIEW_FPS;
+    output.codec->thread_count = 1;
+    if (encoder->id == AV_CODEC_ID_H264) {
+        av_opt_set(output.codec->priv_data, "preset", "veryfast", 0);
+        av_opt_set(output.codec->priv_data, "crf", "28", 0);
+    } else {
+        output.codec->bit_rate = (int64_t)width * height * 3;
+    }
+    if (output.format->oformat->flags & AVFMT_GLOBALHEADER) {
+        output.codec->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
+    }
+    if (avcodec_open2(output.codec, encoder, nullptr) < 0 ||
+        avcodec_parameters_from_context(stream->codecpar, output.codec) < 0) {
+        return false;
+    }
+    stream->time_base = output.codec->time_base;
+
+    output.frame->format = AV_PIX_FMT_YUV420P;
+    output.frame->width = width;
+    output.frame->height = height;
+    if (av_frame_get_buffer(output.frame, 0) < 0 ||
+        avio_open(&output.format->pb, temporary.c_str(), AVIO_FLAG_WRITE) < 0) {
+        return false;
+    }
+    if (avformat_write_header(output.format, nullptr) < 0) {
+        std::remove(temporary.c_str());
+        return false;
+    }
+
+    bool ok = true;
+    int64_t start_pts = AV_NOPTS_VALUE;
+    int64_t written = 0;
+    do {
+        const AVFrame* frame = source->frame;
+        int64_t pts = frame->best_effort_timestamp != AV_NOPTS_VALUE ? frame->best_effort_timestamp : frame->pts;
+        if (start_pts == AV_NOPTS_VALUE) {
+            start_pts = pts;
+        }
+        double time = pts == AV_NOPTS_VALUE ? (double)written / PREVIEW_FPS
+                                            : (pts - start_pts) * av_q2d(source_time_base);
+        if (time >= seconds) {
+            break;
+        }
+        if (time + 1e-6 < (double)written / PREVIEW_FPS) {
+            continue;   // Between two preview frames
+        }
+
+        output.sws = sws_getCachedContext(output.sws, frame->width, frame->height, (AVPixelFormat)frame->format,
+                                          width, height, AV_PIX_FMT_YUV420P, SWS_AREA, nullptr, nullptr, nullptr);
+        if (!output.sws || av_frame_make_writable(output.frame) < 0) {
+            ok = false;
+            break;
+        }
+        sws_scale(output.sws, frame->data, frame->linesize, 0, frame->height, output.frame->data, output.frame->linesize);
+        output.frame->pts = written++;
+        if (!encode_frame(&output, stream, output.frame)) {
+            ok = false;
+            break;
+        }
+    } while (decode_next(source));
+
+    ok = ok && written > 0 && encode_frame(&output, stream, nullptr) && av_write_trailer(output.format) == 0;
+    avio_closep(&output.format->pb);
+    if (!ok || std::rename(temporary.c_str(), path.c_str()) != 0) {
+        std::remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
+
+}
+
+std::string Thumbnailer::get_default_output_dir() {
+    std::string directory = KeyframeIndex::get_cache_directory();
+    return directory.empty() ? std::string() : directory + "/thumbnails";
+}
+
+bool Thumbnailer::collect(const std::vector<std::string>& paths, std::vector<Entry>* entries) {
+    MediaPlayer probe;
+    auto add = [&](const std::filesystem::path& file) {
+        MediaType type = probe.detect_media_type(file.string());
+        if (type == MediaType::UNKNOWN) {
+            return;
+        }
+        Entry entry;
+        if (!KeyframeIndex::identify(file.string(), &entry.path, &entry.size, &entry.mtime)) {
+            return;
+        }
+        entry.key = KeyframeIndex::hash_key(entry.path);
+        entry.video = type == MediaType::VIDEO;
+        entries->push_back(entry);
+    };
+
+    for (const auto& path : paths) {
+        std::error_code error;
+        if (std::filesystem::is_directory(path, error)) {
+            auto options = std::filesystem::directory_options::skip_permission_denied;
+            for (auto it = std::filesystem::recursive_directory_iterator(path, options, error);
+                 !error && it != std::filesystem::recursive_directory_iterator(); it.increment(error)) {
+                if (it->is_regular_file(error)) {
+                    add(it->path());
+                }
+            }
+        } else if (std::filesystem::is_regular_file(path, error)) {
+            add(path);
+        } else {
+            std::cerr << "ERROR: No such file or directory: " << path << std::endl;
+        }
+    }
+
+    // Overlapping arguments list the same file twice
+    std::sort(entries->begin(), entries->end(), [](const Entry& a, const Entry& b) { return a.path < b.path; });
+    entries->erase(std::unique(entries->begin(), entries->end(),
+                               [](const Entry& a, const Entry& b) { return a.path == b.path; }),
+                   entries->end());
+    return !entries->empty();
+}
+
+// One line per source: key size mtime video|image path (the path takes the rest of the line)
+bool Thumbnailer::load_index(const std::string& output_dir, std::map<std::string, Entry>* index) {
+    index->clear();
+    std::ifstream file(output_dir + "/index");
+    if (!file) {
+        return false;
+    }
+
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::istringstream fields(line);
+        Entry entry;
+        std::string kind;
+        if (!(fields >> entry.key >> entry.size >> entry.mtime >> kind)) {
+            continue;
+        }
+        fields.get();
+        std::getline(fields, entry.path);
+        if (entry.path.empty()) {
+            continue;
+        }
+        entry.video = kind == "video";
+        (*index)[entry.path] = entry;
+    }
+    return true;
+}
+
+bool Thumbnailer::save_index(const std::string& output_dir, const std::map<std::string, Entry>& index) {
+    std::string path = output_dir + "/index";
+    std::string temporary = temporary_path(path);
+    {
+        std::ofstream file(temporary, std::ios::trunc);
+        file << "# key size mtime kind path (written by thumbnail; <key>.png, <key>.mp4 for previews)\n";
+        for (const auto& item : index) {
+            const Entry& entry = item.second;
+            file << entry.key << " " << entry.size << " " << entry.mtime << " "
+                 << (entry.video ? "video" : "image") << " " << entry.path << "\n";
+        }
+        if (!file) {
+            file.close();
+            std::remove(temporary.c_str());
+            return false;
+        }
+    }
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        std::remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool Thumbnailer::generate(const Entry& entry, const ThumbnailSettings& settings, const std::string& output_dir) {
+    SourceContext source;
+    if (!open_source(entry.path, settings.size, &source)) {
+        std::cerr << "ERROR: Could not open " << entry.path << std::endl;
+        return false;
+    }
+    if (entry.video) {
+        seek_representative(&source);
+    }
+    if (!decode_next(&source)) {
+        std::cerr << "ERROR: Could not decode a frame of " << entry.path << std::endl;
+        return false;
+    }
+
+    std::string base = output_dir + "/" + entry.key;
+    if (!write_png(source.frame, settings.size, base + ".png")) {
+        std::cerr << "ERROR: Could not write the thumbnail of " << entry.path << std::endl;
+        return false;
+    }
+    if (entry.video && settings.preview_seconds > 0.0 &&
+        !write_preview(&source, settings.size, settings.preview_seconds, base + ".mp4")) {
+        std::cerr << "ERROR: Could not write the preview of " << entry.path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int Thumbnailer::run(const ThumbnailSettings& settings, const std::vector<std::string>& paths) {
+    av_log_set_level(AV_LOG_ERROR);
+
+    std::string output_dir = settings.output_dir.empty() ? get_default_output_dir() : settings.output_dir;
+    std::error_code error;
+    if (!output_dir.empty()) {
+        std::filesystem::create_directories(output_dir, error);
+    }
+    if (output_dir.empty() || error) {
+        std::cerr << "ERROR: Could not create thumbnail directory " << output_dir << std::endl;
+        return 1;
+    }
+
+    std::vector<Entry> entries;
+    if (!collect(paths, &entries)) {
+        std::cerr << "ERROR: No images or videos found" << std::endl;
+        return 1;
+    }
+
+    // Same size and mtime as last time, outputs still there: nothing to do
+    std::map<std::string, Entry> index;
+    load_index(output_dir, &index);
+    std::vector<const Entry*> work;
+    for (const Entry& entry : entries) {
+        auto known = index.find(entry.path);
+        std::string base = output_dir + "/" + entry.key;
+        bool unchanged = known != index.end() && known->second.size == entry.size &&
+                         known->second.mtime == entry.mtime && std::filesystem::exists(base + ".png", error) &&
+                         (!entry.video || settings.preview_seconds <= 0.0 || std::filesystem::exists(base + ".mp4", error));
+        if (!unchanged) {
+            work.push_back(&entry);
+        }
+    }
+
+    int jobs = settings.jobs > 0 ? settings.jobs : (int)std::max(1u, std::thread::hardware_concurrency());
+    jobs = std::max(1, std::min(jobs, (int)work.size()));
+    std::cout << "THUMBNAIL: " << entries.size() << " files, " << entries.size() - work.size() << " unchanged, "
+              << work.size() << " to generate with " << jobs << " workers" << std::endl;
+
+    // Workers pull the next file until the list runs out
+    std::atomic<size_t> next(0);
+    std::atomic<int> generated(0);
+    std::atomic<int> failed(0);
+    std::vector<char> succeeded(work.size(), 0);
+    std::vector<std::thread> workers;
+    for (int i = 0; i < jobs && !work.empty(); i++) {
+        workers.emplace_back([&]() {
+            for (size_t item = next++; item < work.size(); item = next++) {
+                succeeded[item] = generate(*work[item], settings, output_dir);
+                (succeeded[item] ? generated : failed)++;
+            }
+        });
+    }
+
+    auto last_report = std::chrono::steady_clock::now();
+    while ((size_t)(generated + failed) < work.size()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        auto now = std::chrono::steady_clock::now();
+        if (now - last_report >= std::chrono::seconds(5)) {
+            std::cout << "THUMBNAIL: " << generated + failed << "/" << work.size() << " done, "
+                      << failed << " failed" << std::endl;
+            last_report = now;
+        }
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    // Failures leave the index so the next run retries them
+    for (size_t i = 0; i < work.size(); i++) {
+        if (succeeded[i]) {
+            index[work[i]->path] = *work[i];
+        } else {
+            index.erase(work[i]->path);
+        }
+    }
+    if (!save_index(output_dir, index)) {
+        std::cerr << "ERROR: Could not write " << output_dir << "/index" << std::endl;
+        return 1;
+    }
+
+    std::cout << "THUMBNAIL: " << generated << " generated, " << failed << " failed, "
+              << entries.size() - work.size() << " unchanged in " << output_dir << std::endl;
+    return failed > 0 ? 1 : 0;
+}
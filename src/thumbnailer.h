@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+struct ThumbnailSettings {
+    std::string output_dir;         // Empty = <cache>/thumbnails
+    int size = 320;                 // Longest edge of stills and previews, never upscaled
+    double preview_seconds = 0.0;   // Length of the MP4 preview clip per video, 0 = stills only
+    int jobs = 0;                   // Files processed at once, 0 = one per core
+};
+
+// `thumbnail <file|dir>...`: a PNG still per wallpaper (and optionally a
+// short MP4 preview per video) for picker UIs, named after the file's cache
+// key and listed in <output>/index together with the source's size and mtime
+// so unchanged files are skipped on the next run.
+//
+// Files are spread over a fixed pool of workers, each decoding single
+// threaded with one file open at a time, so a library of thousands keeps
+// every core busy at a bounded memory cost. Videos are sampled at a
+// representative keyframe instead of decoding from the start, and pictures
+// are shrunk while decoding (lowres) and converting rather than afterwards.
+class Thumbnailer {
+public:
+    // Returns the process exit code
+    static int run(const ThumbnailSettings& settings, const std::vector<std::string>& paths);
+
+private:
+    struct Entry {
+        std::string path;           // Canonical source path
+        std::string key;            // Output file name without extension
+        int64_t size = 0;
+        int64_t mtime = 0;
+        bool video = false;
+    };
+
+    static std::string get_default_output_dir();
+    static bool collect(const std::vector<std::string>& paths, std::vector<Entry>* entries);
+    static bool load_index(const std::string& output_dir, std::map<std::string, Entry>* index);
+    static bool save_index(const std::string& output_dir, const std::map<std::string, Entry>& index);
+
+    static bool generate(const Entry& entry, const ThumbnailSettings& settings, const std::string& output_dir);
+};